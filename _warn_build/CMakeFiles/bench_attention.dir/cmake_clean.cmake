@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_attention.dir/benchmarks/bench_attention.cc.o"
+  "CMakeFiles/bench_attention.dir/benchmarks/bench_attention.cc.o.d"
+  "bench_attention"
+  "bench_attention.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_attention.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_bucket_policy.dir/benchmarks/bench_bucket_policy.cc.o"
+  "CMakeFiles/bench_bucket_policy.dir/benchmarks/bench_bucket_policy.cc.o.d"
+  "bench_bucket_policy"
+  "bench_bucket_policy.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_bucket_policy.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_embedding_load.dir/benchmarks/bench_embedding_load.cc.o"
+  "CMakeFiles/bench_embedding_load.dir/benchmarks/bench_embedding_load.cc.o.d"
+  "bench_embedding_load"
+  "bench_embedding_load.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_embedding_load.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
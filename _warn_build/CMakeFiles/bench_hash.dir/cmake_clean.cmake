@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_hash.dir/benchmarks/bench_hash.cc.o"
+  "CMakeFiles/bench_hash.dir/benchmarks/bench_hash.cc.o.d"
+  "bench_hash"
+  "bench_hash.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_hash.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_hogwild.dir/benchmarks/bench_hogwild.cc.o"
+  "CMakeFiles/bench_hogwild.dir/benchmarks/bench_hogwild.cc.o.d"
+  "bench_hogwild"
+  "bench_hogwild.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_hogwild.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
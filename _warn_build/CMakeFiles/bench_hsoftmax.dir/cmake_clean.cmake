@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_hsoftmax.dir/benchmarks/bench_hsoftmax.cc.o"
+  "CMakeFiles/bench_hsoftmax.dir/benchmarks/bench_hsoftmax.cc.o.d"
+  "bench_hsoftmax"
+  "bench_hsoftmax.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_hsoftmax.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_lowrank.dir/benchmarks/bench_lowrank.cc.o"
+  "CMakeFiles/bench_lowrank.dir/benchmarks/bench_lowrank.cc.o.d"
+  "bench_lowrank"
+  "bench_lowrank.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_lowrank.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
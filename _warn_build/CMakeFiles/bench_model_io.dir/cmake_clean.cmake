@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_model_io.dir/benchmarks/bench_model_io.cc.o"
+  "CMakeFiles/bench_model_io.dir/benchmarks/bench_model_io.cc.o.d"
+  "bench_model_io"
+  "bench_model_io.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_model_io.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
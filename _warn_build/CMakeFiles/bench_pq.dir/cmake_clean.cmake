@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_pq.dir/benchmarks/bench_pq.cc.o"
+  "CMakeFiles/bench_pq.dir/benchmarks/bench_pq.cc.o.d"
+  "bench_pq"
+  "bench_pq.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_pq.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
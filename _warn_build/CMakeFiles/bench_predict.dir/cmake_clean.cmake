@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_predict.dir/benchmarks/bench_predict.cc.o"
+  "CMakeFiles/bench_predict.dir/benchmarks/bench_predict.cc.o.d"
+  "bench_predict"
+  "bench_predict.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_predict.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
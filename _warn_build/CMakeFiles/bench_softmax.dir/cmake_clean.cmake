@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_softmax.dir/benchmarks/bench_softmax.cc.o"
+  "CMakeFiles/bench_softmax.dir/benchmarks/bench_softmax.cc.o.d"
+  "bench_softmax"
+  "bench_softmax.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_softmax.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_sparse.dir/benchmarks/bench_sparse.cc.o"
+  "CMakeFiles/bench_sparse.dir/benchmarks/bench_sparse.cc.o.d"
+  "bench_sparse"
+  "bench_sparse.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_sparse.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
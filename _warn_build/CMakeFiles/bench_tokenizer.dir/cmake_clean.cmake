@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_tokenizer.dir/benchmarks/bench_tokenizer.cc.o"
+  "CMakeFiles/bench_tokenizer.dir/benchmarks/bench_tokenizer.cc.o.d"
+  "bench_tokenizer"
+  "bench_tokenizer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_tokenizer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
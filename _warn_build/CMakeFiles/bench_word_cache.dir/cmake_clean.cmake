@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_word_cache.dir/benchmarks/bench_word_cache.cc.o"
+  "CMakeFiles/bench_word_cache.dir/benchmarks/bench_word_cache.cc.o.d"
+  "bench_word_cache"
+  "bench_word_cache.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_word_cache.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/example_usage.dir/example_usage.cc.o"
+  "CMakeFiles/example_usage.dir/example_usage.cc.o.d"
+  "example_usage"
+  "example_usage.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/example_usage.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
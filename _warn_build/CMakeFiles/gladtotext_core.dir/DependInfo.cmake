@@ -0,0 +1,47 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/core/classifier/hierarchical_softmax.cc" "CMakeFiles/gladtotext_core.dir/core/classifier/hierarchical_softmax.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/classifier/hierarchical_softmax.cc.o.d"
+  "/root/repo/core/classifier/iclassifier.cc" "CMakeFiles/gladtotext_core.dir/core/classifier/iclassifier.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/classifier/iclassifier.cc.o.d"
+  "/root/repo/core/classifier/linear_classifier.cc" "CMakeFiles/gladtotext_core.dir/core/classifier/linear_classifier.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/classifier/linear_classifier.cc.o.d"
+  "/root/repo/core/classifier/lowrank_classifier.cc" "CMakeFiles/gladtotext_core.dir/core/classifier/lowrank_classifier.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/classifier/lowrank_classifier.cc.o.d"
+  "/root/repo/core/classifier/sparse_classifier.cc" "CMakeFiles/gladtotext_core.dir/core/classifier/sparse_classifier.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/classifier/sparse_classifier.cc.o.d"
+  "/root/repo/core/config/model_config.cc" "CMakeFiles/gladtotext_core.dir/core/config/model_config.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/config/model_config.cc.o.d"
+  "/root/repo/core/embedding/embedding_table.cc" "CMakeFiles/gladtotext_core.dir/core/embedding/embedding_table.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/embedding/embedding_table.cc.o.d"
+  "/root/repo/core/embedding/product_quantizer.cc" "CMakeFiles/gladtotext_core.dir/core/embedding/product_quantizer.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/embedding/product_quantizer.cc.o.d"
+  "/root/repo/core/encoder/attention_sentence_encoder.cc" "CMakeFiles/gladtotext_core.dir/core/encoder/attention_sentence_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/encoder/attention_sentence_encoder.cc.o.d"
+  "/root/repo/core/encoder/mean_sentence_encoder.cc" "CMakeFiles/gladtotext_core.dir/core/encoder/mean_sentence_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/encoder/mean_sentence_encoder.cc.o.d"
+  "/root/repo/core/encoder/vocab_index.cc" "CMakeFiles/gladtotext_core.dir/core/encoder/vocab_index.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/encoder/vocab_index.cc.o.d"
+  "/root/repo/core/encoder/word_encoder.cc" "CMakeFiles/gladtotext_core.dir/core/encoder/word_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/encoder/word_encoder.cc.o.d"
+  "/root/repo/core/encoder/word_vector_cache.cc" "CMakeFiles/gladtotext_core.dir/core/encoder/word_vector_cache.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/encoder/word_vector_cache.cc.o.d"
+  "/root/repo/core/hashing/batch_hash.cc" "CMakeFiles/gladtotext_core.dir/core/hashing/batch_hash.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/hashing/batch_hash.cc.o.d"
+  "/root/repo/core/inference/predictor.cc" "CMakeFiles/gladtotext_core.dir/core/inference/predictor.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/inference/predictor.cc.o.d"
+  "/root/repo/core/io/model_file.cc" "CMakeFiles/gladtotext_core.dir/core/io/model_file.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/io/model_file.cc.o.d"
+  "/root/repo/core/loss/negative_sampling.cc" "CMakeFiles/gladtotext_core.dir/core/loss/negative_sampling.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/loss/negative_sampling.cc.o.d"
+  "/root/repo/core/serving/batch_server.cc" "CMakeFiles/gladtotext_core.dir/core/serving/batch_server.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/serving/batch_server.cc.o.d"
+  "/root/repo/core/serving/line_server.cc" "CMakeFiles/gladtotext_core.dir/core/serving/line_server.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/serving/line_server.cc.o.d"
+  "/root/repo/core/simd/kernels.cc" "CMakeFiles/gladtotext_core.dir/core/simd/kernels.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/simd/kernels.cc.o.d"
+  "/root/repo/core/tokenizer/simd_tokenizer.cc" "CMakeFiles/gladtotext_core.dir/core/tokenizer/simd_tokenizer.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/tokenizer/simd_tokenizer.cc.o.d"
+  "/root/repo/core/training/simple_trainer.cc" "CMakeFiles/gladtotext_core.dir/core/training/simple_trainer.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/training/simple_trainer.cc.o.d"
+  "/root/repo/core/training/sparse_trainer.cc" "CMakeFiles/gladtotext_core.dir/core/training/sparse_trainer.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/training/sparse_trainer.cc.o.d"
+  "/root/repo/core/training/streaming_loader.cc" "CMakeFiles/gladtotext_core.dir/core/training/streaming_loader.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/training/streaming_loader.cc.o.d"
+  "/root/repo/core/utils/aligned_alloc.cc" "CMakeFiles/gladtotext_core.dir/core/utils/aligned_alloc.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/utils/aligned_alloc.cc.o.d"
+  "/root/repo/core/utils/logger.cc" "CMakeFiles/gladtotext_core.dir/core/utils/logger.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/utils/logger.cc.o.d"
+  "/root/repo/core/utils/mapped_file.cc" "CMakeFiles/gladtotext_core.dir/core/utils/mapped_file.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/utils/mapped_file.cc.o.d"
+  "/root/repo/core/utils/rng.cc" "CMakeFiles/gladtotext_core.dir/core/utils/rng.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/utils/rng.cc.o.d"
+  "/root/repo/core/utils/thread_pool.cc" "CMakeFiles/gladtotext_core.dir/core/utils/thread_pool.cc.o" "gcc" "CMakeFiles/gladtotext_core.dir/core/utils/thread_pool.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
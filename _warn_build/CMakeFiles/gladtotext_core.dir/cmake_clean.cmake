@@ -0,0 +1,67 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gladtotext_core.dir/core/classifier/hierarchical_softmax.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/hierarchical_softmax.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/iclassifier.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/iclassifier.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/linear_classifier.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/linear_classifier.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/lowrank_classifier.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/lowrank_classifier.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/sparse_classifier.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/classifier/sparse_classifier.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/config/model_config.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/config/model_config.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/embedding/embedding_table.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/embedding/embedding_table.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/embedding/product_quantizer.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/embedding/product_quantizer.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/attention_sentence_encoder.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/attention_sentence_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/mean_sentence_encoder.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/mean_sentence_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/vocab_index.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/vocab_index.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/word_encoder.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/word_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/word_vector_cache.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/encoder/word_vector_cache.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/hashing/batch_hash.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/hashing/batch_hash.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/inference/predictor.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/inference/predictor.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/io/model_file.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/io/model_file.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/loss/negative_sampling.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/loss/negative_sampling.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/serving/batch_server.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/serving/batch_server.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/serving/line_server.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/serving/line_server.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/simd/kernels.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/simd/kernels.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/tokenizer/simd_tokenizer.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/tokenizer/simd_tokenizer.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/training/simple_trainer.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/training/simple_trainer.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/training/sparse_trainer.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/training/sparse_trainer.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/training/streaming_loader.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/training/streaming_loader.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/utils/aligned_alloc.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/utils/aligned_alloc.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/utils/logger.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/utils/logger.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/utils/mapped_file.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/utils/mapped_file.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/utils/rng.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/utils/rng.cc.o.d"
+  "CMakeFiles/gladtotext_core.dir/core/utils/thread_pool.cc.o"
+  "CMakeFiles/gladtotext_core.dir/core/utils/thread_pool.cc.o.d"
+  "libgladtotext_core.a"
+  "libgladtotext_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gladtotext_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
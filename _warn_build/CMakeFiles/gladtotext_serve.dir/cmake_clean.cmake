@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gladtotext_serve.dir/tools/gladtotext_serve.cc.o"
+  "CMakeFiles/gladtotext_serve.dir/tools/gladtotext_serve.cc.o.d"
+  "gladtotext_serve"
+  "gladtotext_serve.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gladtotext_serve.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,50 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/test_attention_sentence_encoder.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_attention_sentence_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_attention_sentence_encoder.cc.o.d"
+  "/root/repo/tests/test_edge_cases.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_edge_cases.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_edge_cases.cc.o.d"
+  "/root/repo/tests/test_embedding.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_embedding.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_embedding.cc.o.d"
+  "/root/repo/tests/test_hash.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_hash.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_hash.cc.o.d"
+  "/root/repo/tests/test_hierarchical_softmax.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_hierarchical_softmax.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_hierarchical_softmax.cc.o.d"
+  "/root/repo/tests/test_integration.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_integration.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_integration.cc.o.d"
+  "/root/repo/tests/test_kernels.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_kernels.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_kernels.cc.o.d"
+  "/root/repo/tests/test_linear_classifier.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_linear_classifier.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_linear_classifier.cc.o.d"
+  "/root/repo/tests/test_lowrank_classifier.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_lowrank_classifier.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_lowrank_classifier.cc.o.d"
+  "/root/repo/tests/test_mean_sentence_encoder.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_mean_sentence_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_mean_sentence_encoder.cc.o.d"
+  "/root/repo/tests/test_model_config.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_model_config.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_model_config.cc.o.d"
+  "/root/repo/tests/test_model_file.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_model_file.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_model_file.cc.o.d"
+  "/root/repo/tests/test_negative_sampling.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_negative_sampling.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_negative_sampling.cc.o.d"
+  "/root/repo/tests/test_ngram.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_ngram.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_ngram.cc.o.d"
+  "/root/repo/tests/test_phonetic_encoder.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_phonetic_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_phonetic_encoder.cc.o.d"
+  "/root/repo/tests/test_predictor.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_predictor.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_predictor.cc.o.d"
+  "/root/repo/tests/test_product_quantizer.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_product_quantizer.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_product_quantizer.cc.o.d"
+  "/root/repo/tests/test_rng.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_rng.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_rng.cc.o.d"
+  "/root/repo/tests/test_serving.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_serving.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_serving.cc.o.d"
+  "/root/repo/tests/test_softmax.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_softmax.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_softmax.cc.o.d"
+  "/root/repo/tests/test_sparse_classifier.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_sparse_classifier.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_sparse_classifier.cc.o.d"
+  "/root/repo/tests/test_streaming_loader.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_streaming_loader.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_streaming_loader.cc.o.d"
+  "/root/repo/tests/test_tokenizer.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_tokenizer.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_tokenizer.cc.o.d"
+  "/root/repo/tests/test_topk.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_topk.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_topk.cc.o.d"
+  "/root/repo/tests/test_training_determinism.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_training_determinism.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_training_determinism.cc.o.d"
+  "/root/repo/tests/test_training_overfit.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_training_overfit.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_training_overfit.cc.o.d"
+  "/root/repo/tests/test_vocab_index.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_vocab_index.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_vocab_index.cc.o.d"
+  "/root/repo/tests/test_word_encoder.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_word_encoder.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_word_encoder.cc.o.d"
+  "/root/repo/tests/test_word_vector_cache.cc" "CMakeFiles/gladtotext_tests.dir/tests/test_word_vector_cache.cc.o" "gcc" "CMakeFiles/gladtotext_tests.dir/tests/test_word_vector_cache.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/CMakeFiles/gladtotext_core.dir/DependInfo.cmake"
+  "/root/repo/_warn_build/external/googletest/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  "/root/repo/_warn_build/external/googletest/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
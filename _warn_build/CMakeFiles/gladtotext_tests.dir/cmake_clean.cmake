@@ -0,0 +1,67 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gladtotext_tests.dir/tests/test_attention_sentence_encoder.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_attention_sentence_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_edge_cases.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_edge_cases.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_embedding.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_embedding.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_hash.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_hash.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_hierarchical_softmax.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_hierarchical_softmax.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_integration.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_integration.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_kernels.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_kernels.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_linear_classifier.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_linear_classifier.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_lowrank_classifier.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_lowrank_classifier.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_mean_sentence_encoder.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_mean_sentence_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_model_config.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_model_config.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_model_file.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_model_file.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_negative_sampling.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_negative_sampling.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_ngram.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_ngram.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_phonetic_encoder.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_phonetic_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_predictor.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_predictor.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_product_quantizer.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_product_quantizer.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_rng.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_rng.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_serving.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_serving.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_softmax.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_softmax.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_sparse_classifier.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_sparse_classifier.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_streaming_loader.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_streaming_loader.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_tokenizer.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_tokenizer.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_topk.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_topk.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_training_determinism.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_training_determinism.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_training_overfit.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_training_overfit.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_vocab_index.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_vocab_index.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_word_encoder.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_word_encoder.cc.o.d"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_word_vector_cache.cc.o"
+  "CMakeFiles/gladtotext_tests.dir/tests/test_word_vector_cache.cc.o.d"
+  "gladtotext_tests"
+  "gladtotext_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gladtotext_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
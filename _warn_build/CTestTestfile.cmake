@@ -0,0 +1,9 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_warn_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(gladtotext_tests "/root/repo/_warn_build/gladtotext_tests")
+set_tests_properties(gladtotext_tests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;98;add_test;/root/repo/CMakeLists.txt;0;")
+subdirs("external/googletest")
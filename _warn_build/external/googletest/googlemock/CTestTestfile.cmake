@@ -0,0 +1,7 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/external/googletest/googlemock
+# Build directory: /root/repo/_warn_build/external/googletest/googlemock
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("../googletest")
@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/external/googletest/googletest
+# Build directory: /root/repo/_warn_build/external/googletest/googletest
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
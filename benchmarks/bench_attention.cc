@@ -0,0 +1,173 @@
+// AttentionSentenceEncoder vs MeanSentenceEncoder: held-out accuracy after
+// the same training budget, and encode latency (single and batched).
+//
+// Task: each sentence hides one class keyword among 4..max_len noise words
+// drawn from a Zipf-like vocabulary, so mean pooling dilutes the signal
+// more the longer the sentence is.
+//
+//   bench_attention [train_samples] [epochs] [dim] [heads] [max_len] [train_embedding]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/attention_sentence_encoder.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+std::vector<Sample> keyword_corpus(int n,
+                                   int classes,
+                                   int max_len,
+                                   const std::vector<std::string>& noise,
+                                   const std::vector<std::string>& keywords,
+                                   uint64_t seed)
+{
+    RNG rng(seed);
+    float log_v = std::log(static_cast<float>(noise.size()));
+    int per_class = static_cast<int>(keywords.size()) / classes;
+
+    std::vector<Sample> data(n);
+    for (auto& s : data) {
+        s.label = static_cast<int>(rng.uniform(0.0f, classes - 0.001f));
+        int len = 4 + static_cast<int>(rng.uniform(0.0f, max_len - 3.001f));
+        int at = static_cast<int>(rng.uniform(0.0f, len - 0.001f));
+
+        for (int w = 0; w < len; ++w) {
+            if (w > 0)
+                s.text += ' ';
+            if (w == at) {
+                int k = static_cast<int>(rng.uniform(0.0f, per_class - 0.001f));
+                s.text += keywords[s.label * per_class + k];
+            } else {
+                int idx = static_cast<int>(
+                    std::exp(rng.uniform(0.0f, log_v))) - 1;
+                s.text += noise[idx];
+            }
+        }
+    }
+    return data;
+}
+
+struct Result {
+    double accuracy;
+    double encode_us;
+};
+
+Result evaluate(ISentenceEncoder& encoder,
+                EmbeddingTable& embedding,
+                int dim,
+                int classes,
+                int epochs,
+                bool train_embedding,
+                const std::vector<Sample>& train,
+                const std::vector<Sample>& test)
+{
+    EnglishTokenizer tokenizer;
+    LinearClassifier classifier(dim, classes, 42);
+    SimpleTrainer trainer(tokenizer, encoder, classifier, dim, classes);
+    if (train_embedding)
+        trainer.enable_embedding_training(embedding);
+
+    for (int e = 0; e < epochs; ++e)
+        trainer.train_epoch(train, 0.2f * (1.0f - e / float(epochs)) + 0.01f);
+
+    std::vector<TokenBuffer> tokens(test.size());
+    for (size_t i = 0; i < test.size(); ++i)
+        tokenizer.tokenize(test[i].text, tokens[i]);
+
+    std::vector<float> sentence(dim), logits(classes);
+    int correct = 0;
+
+    BenchTimer timer;
+    for (size_t i = 0; i < test.size(); ++i)
+        encoder.encode(tokens[i], sentence.data());
+    double encode_us = timer.seconds() * 1e6 / test.size();
+
+    for (size_t i = 0; i < test.size(); ++i) {
+        encoder.encode(tokens[i], sentence.data());
+        classifier.forward(sentence.data(), logits.data());
+        int best = static_cast<int>(
+            std::max_element(logits.begin(), logits.end()) - logits.begin());
+        correct += best == test[i].label;
+    }
+
+    return {100.0 * correct / test.size(), encode_us};
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int train_samples = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int epochs = argc > 2 ? std::atoi(argv[2]) : 5;
+    int dim = argc > 3 ? std::atoi(argv[3]) : 64;
+    int heads = argc > 4 ? std::atoi(argv[4]) : 4;
+    int max_len = argc > 5 ? std::atoi(argv[5]) : 48;
+    bool train_embedding = argc > 6 ? std::atoi(argv[6]) != 0 : true;
+    int classes = 8;
+    int buckets = 200000;
+
+    auto noise = bench_vocabulary(5000, 1);
+    auto keywords = bench_vocabulary(classes * 4, 2);
+    for (auto& k : keywords)
+        k = "kw" + k;
+
+    auto train = keyword_corpus(train_samples, classes, max_len,
+                                noise, keywords, 3);
+    auto test = keyword_corpus(5000, classes, max_len, noise, keywords, 4);
+
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+
+    std::printf("attention vs mean: %d train / %zu test, %d epochs, dim %d, "
+                "%d heads, 4..%d words, embedding %s\n",
+                train_samples, test.size(), epochs, dim, heads, max_len,
+                train_embedding ? "trained" : "frozen");
+
+    EmbeddingTable mean_table(buckets, dim, 42);
+    WordEncoder mean_words(mean_table, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder mean(mean_words);
+    Result m = evaluate(mean, mean_table, dim, classes, epochs,
+                        train_embedding, train, test);
+
+    EmbeddingTable att_table(buckets, dim, 42);
+    WordEncoder att_words(att_table, ngram, &phonetic, buckets, 0.2f);
+    AttentionSentenceEncoder attention(att_words, heads);
+    Result a = evaluate(attention, att_table, dim, classes, epochs,
+                        train_embedding, train, test);
+
+    // Batched attention latency over the test set
+    EnglishTokenizer tokenizer;
+    const int batch = 64;
+    std::vector<TokenBuffer> tokens(test.size());
+    for (size_t i = 0; i < test.size(); ++i)
+        tokenizer.tokenize(test[i].text, tokens[i]);
+    std::vector<float> out(static_cast<size_t>(batch) * dim);
+
+    BenchTimer timer;
+    for (size_t i = 0; i + batch <= tokens.size(); i += batch)
+        attention.encode_batch(&tokens[i], batch, out.data());
+    double batched_us = timer.seconds() * 1e6 /
+                        (tokens.size() / batch * batch);
+
+    std::printf("%-22s %10s %14s %8s\n",
+                "encoder", "accuracy", "encode us/doc", "vs mean");
+    std::printf("%-22s %9.2f%% %14.2f %7.2fx\n",
+                "mean", m.accuracy, m.encode_us, 1.0);
+    std::printf("%-22s %9.2f%% %14.2f %7.2fx\n",
+                "attention", a.accuracy, a.encode_us,
+                a.encode_us / m.encode_us);
+    std::printf("%-22s %10s %14.2f %7.2fx\n",
+                "attention (batch 64)", "", batched_us,
+                batched_us / m.encode_us);
+
+    return 0;
+}
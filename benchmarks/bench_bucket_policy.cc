@@ -0,0 +1,173 @@
+// Hash x range-reduction policies for WordEncoder: bucket computation and
+// word encode throughput, and bucket collision statistics over the distinct n-grams of a synthetic
+// vocabulary. The bucket count is a power of two so every reduction applies.
+//
+//   bench_bucket_policy [vocab] [dim] [log2_buckets]
+
+#include "bench_common.h"
+#include "embedding/embedding_table.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+static volatile float g_sink;
+
+static const char* hash_name(HashPolicy h)
+{
+    switch (h) {
+        case HashPolicy::MURMUR3: return "murmur3";
+        case HashPolicy::WYHASH: return "wyhash";
+        default: return "fnv1a";
+    }
+}
+
+static const char* reduction_name(BucketReduction r)
+{
+    switch (r) {
+        case BucketReduction::MULTIPLY_SHIFT: return "mul-shift";
+        case BucketReduction::POW2_MASK: return "pow2-mask";
+        default: return "modulo";
+    }
+}
+
+struct CollisionStats {
+    size_t colliding;   // keys sharing a bucket with an earlier key
+    uint32_t max_load;
+};
+
+template <typename Hash, typename Reduce>
+CollisionStats collisions(const std::vector<std::string>& keys,
+                          const BucketRange& range)
+{
+    std::vector<uint32_t> load(range.count, 0);
+    CollisionStats stats{0, 0};
+    for (const auto& k : keys) {
+        uint32_t& l = load[Reduce::reduce(Hash::hash(k), range)];
+        if (l++ > 0)
+            ++stats.colliding;
+        stats.max_load = std::max(stats.max_load, l);
+    }
+    return stats;
+}
+
+template <typename Hash>
+CollisionStats collisions(const std::vector<std::string>& keys,
+                          const BucketRange& range,
+                          BucketReduction r)
+{
+    switch (r) {
+        case BucketReduction::MULTIPLY_SHIFT:
+            return collisions<Hash, MultiplyShiftReduce>(keys, range);
+        case BucketReduction::POW2_MASK:
+            return collisions<Hash, Pow2MaskReduce>(keys, range);
+        default:
+            return collisions<Hash, ModuloReduce>(keys, range);
+    }
+}
+
+static CollisionStats collisions(const std::vector<std::string>& keys,
+                                 const BucketRange& range,
+                                 HashPolicy h,
+                                 BucketReduction r)
+{
+    switch (h) {
+        case HashPolicy::MURMUR3:
+            return collisions<Murmur3Hash>(keys, range, r);
+        case HashPolicy::WYHASH:
+            return collisions<WyHash>(keys, range, r);
+        default:
+            return collisions<Fnv1aHash>(keys, range, r);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int vocab_size = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int dim = argc > 2 ? std::atoi(argv[2]) : 64;
+    int log2_buckets = argc > 3 ? std::atoi(argv[3]) : 21;
+    int buckets = 1 << log2_buckets;
+
+    auto vocab = bench_vocabulary(vocab_size, 17);
+    // Realistic n-gram overlap: shared stems with common suffixes
+    const char* suffixes[] = {"", "s", "ing", "ed", "er", "ly"};
+    std::vector<std::string> words;
+    for (size_t i = 0; i < vocab.size(); ++i)
+        words.push_back(vocab[i] + suffixes[i % 6]);
+
+    NGramGenerator ngram(3, 6);
+    std::unordered_set<std::string> unique;
+    for (const auto& w : words) {
+        std::string wrapped;
+        std::vector<std::string_view> grams;
+        ngram.generate(w, wrapped, grams);
+        for (auto g : grams)
+            unique.emplace(g);
+    }
+    std::vector<std::string> distinct(unique.begin(), unique.end());
+    std::sort(distinct.begin(), distinct.end());
+
+    double n = static_cast<double>(distinct.size());
+    double m = static_cast<double>(buckets);
+    double ideal = n - m * (1.0 - std::pow(1.0 - 1.0 / m, n));
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    PhoneticEncoder phonetic;
+
+    std::printf("bucket policies: %zu words, %zu distinct n-grams, 2^%d buckets,"
+                " dim %d\n", words.size(), distinct.size(), log2_buckets, dim);
+    std::printf("uniform hashing would leave %.0f colliding n-grams (%.2f%%)\n",
+                ideal, 100.0 * ideal / n);
+    std::printf("%-9s %-10s %14s %12s %11s %9s %9s\n", "hash", "reduce",
+                "bucket words/s", "encode w/s", "colliding", "vs ideal",
+                "max load");
+
+    std::vector<float> out(dim);
+    std::vector<int> scratch;
+
+    for (HashPolicy h : {HashPolicy::FNV1A, HashPolicy::MURMUR3,
+                         HashPolicy::WYHASH}) {
+        for (BucketReduction r : {BucketReduction::MODULO,
+                                  BucketReduction::MULTIPLY_SHIFT,
+                                  BucketReduction::POW2_MASK}) {
+            WordEncoder encoder(embedding, ngram, &phonetic, buckets, 0.2f,
+                                h, r);
+
+            CollisionStats stats = collisions(distinct, BucketRange(buckets),
+                                              h, r);
+
+            const int repeats = 10;
+            double total = words.size() * static_cast<double>(repeats);
+
+            BenchTimer timer;
+            for (int rep = 0; rep < repeats; ++rep)
+                for (const auto& w : words) {
+                    scratch.clear();
+                    g_sink = static_cast<float>(
+                        encoder.compute_buckets(w, scratch));
+                }
+            double bucket_rate = total / timer.seconds();
+
+            timer.reset();
+            for (int rep = 0; rep < repeats; ++rep)
+                for (const auto& w : words) {
+                    encoder.encode(w, out.data());
+                    g_sink = out[0];
+                }
+            double rate = total / timer.seconds();
+
+            std::printf("%-9s %-10s %14.0f %12.0f %11zu %8.3fx %9u\n",
+                        hash_name(h), reduction_name(r), bucket_rate, rate,
+                        stats.colliding, stats.colliding / ideal,
+                        stats.max_load);
+        }
+    }
+    return 0;
+}
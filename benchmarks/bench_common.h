@@ -0,0 +1,75 @@
+#pragma once
+
+// Shared helpers for the benchmark executables: a wall-clock timer and a
+// synthetic labelled corpus with a Zipf-like word distribution.
+
+#include "training/simple_trainer.h"
+#include "utils/rng.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+class BenchTimer {
+public:
+    BenchTimer() : start_(std::chrono::steady_clock::now()) {}
+
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+
+    double seconds() const {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+inline std::vector<std::string> bench_vocabulary(int size, uint64_t seed)
+{
+    RNG rng(seed);
+    std::vector<std::string> words;
+    words.reserve(size);
+
+    for (int i = 0; i < size; ++i) {
+        int len = 3 + static_cast<int>(rng.uniform(0.0f, 8.0f));
+        std::string w;
+        for (int j = 0; j < len; ++j)
+            w += static_cast<char>('a' + static_cast<int>(rng.uniform(0.0f, 25.99f)));
+        words.push_back(std::move(w));
+    }
+    return words;
+}
+
+// Each sample draws words with probability ~ 1/rank; the label is the
+// parity of the most frequent word index so the task is learnable.
+inline std::vector<Sample> bench_corpus(int num_samples,
+                                        int num_classes,
+                                        int words_per_sample,
+                                        uint64_t seed)
+{
+    auto vocab = bench_vocabulary(10000, seed);
+    RNG rng(seed + 1);
+
+    std::vector<Sample> data;
+    data.reserve(num_samples);
+
+    float log_v = std::log(static_cast<float>(vocab.size()));
+
+    for (int s = 0; s < num_samples; ++s) {
+        Sample sample;
+        int first = 0;
+        for (int w = 0; w < words_per_sample; ++w) {
+            int idx = static_cast<int>(std::exp(rng.uniform(0.0f, log_v))) - 1;
+            if (w == 0)
+                first = idx;
+            if (w > 0)
+                sample.text += ' ';
+            sample.text += vocab[idx];
+        }
+        sample.label = first % num_classes;
+        data.push_back(std::move(sample));
+    }
+    return data;
+}
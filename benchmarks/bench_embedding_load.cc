@@ -0,0 +1,68 @@
+// Cold-start cost of an EmbeddingTable: random initialisation versus
+// mapping a saved table (lazy, prewarmed, and with checksum verification).
+//
+//   bench_embedding_load [buckets] [dim] [path]
+
+#include "bench_common.h"
+#include "embedding/embedding_table.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static volatile float g_sink;
+
+static float touch_rows(const EmbeddingTable& table)
+{
+    // Reads one float per row so lazy mappings pay their page faults here.
+    float sum = 0.0f;
+    for (int b = 0; b < table.bucket_count(); ++b)
+        sum += table.row(b)[0];
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    int buckets = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int dim = argc > 2 ? std::atoi(argv[2]) : 256;
+    std::string path = argc > 3 ? argv[3] : "bench_embedding.bin";
+
+    BenchTimer timer;
+    EmbeddingTable built(buckets, dim, 42);
+    double init_s = timer.seconds();
+
+    built.save(path);
+
+    std::printf("embedding load: %d x %d (%.1f MB)\n", buckets, dim,
+                built.memory_bytes() / (1024.0 * 1024.0));
+    std::printf("%-28s %12s %12s\n", "mode", "load ms", "first pass ms");
+    std::printf("%-28s %12.2f %12s\n", "random init (constructor)",
+                init_s * 1e3, "-");
+
+    struct Mode {
+        const char* name;
+        EmbeddingLoadOptions options;
+    };
+    Mode modes[3];
+    modes[0].name = "mmap (lazy)";
+    modes[1].name = "mmap + prewarm";
+    modes[1].options.prewarm = true;
+    modes[2].name = "mmap + verify checksum";
+    modes[2].options.verify_checksum = true;
+
+    for (const Mode& mode : modes) {
+        timer.reset();
+        EmbeddingTable mapped(path, mode.options);
+        double load_s = timer.seconds();
+
+        timer.reset();
+        g_sink = touch_rows(mapped);
+        double touch_s = timer.seconds();
+
+        std::printf("%-28s %12.2f %12.2f\n", mode.name,
+                    load_s * 1e3, touch_s * 1e3);
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
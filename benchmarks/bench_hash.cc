@@ -0,0 +1,130 @@
+// N-gram hashing throughput (million n-grams/s) over the synthetic
+// vocabulary: scalar HashFunction::fnv1a and murmur3 on materialized
+// n-grams, the rolling NGramGenerator::for_each_hash, and the batched
+// fnv1a_ngrams kernel at each SIMD level.
+//
+//   bench_hash [words] [repeats] [min_n] [max_n]
+
+#include "bench_common.h"
+#include "hashing/batch_hash.h"
+#include "hashing/hash_function.h"
+#include "ngram/ngram_generator.h"
+#include "simd/kernels.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static volatile uint64_t g_sink;
+
+int main(int argc, char** argv)
+{
+    int num_words = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 200;
+    int min_n = argc > 3 ? std::atoi(argv[3]) : 3;
+    int max_n = argc > 4 ? std::atoi(argv[4]) : 6;
+
+    auto vocab = bench_vocabulary(num_words, 3);
+    NGramGenerator gen(min_n, max_n);
+
+    std::vector<std::string> wrapped(vocab.size());
+    std::vector<std::vector<std::string_view>> ngrams(vocab.size());
+    size_t total = 0;
+    for (size_t i = 0; i < vocab.size(); ++i) {
+        gen.generate(vocab[i], wrapped[i], ngrams[i]);
+        total += ngrams[i].size();
+    }
+
+    std::printf("n-gram hashing: %d words, %zu n-grams (n=%d..%d)\n",
+                num_words, total, min_n, max_n);
+    std::printf("%-26s %12s %8s\n", "method", "Mngrams/s", "speedup");
+
+    double base = 0.0;
+    auto report = [&](const char* name, double seconds) {
+        double rate = total * static_cast<double>(repeats) / seconds / 1e6;
+        if (base == 0.0)
+            base = rate;
+        std::printf("%-26s %12.1f %7.2fx\n", name, rate, rate / base);
+    };
+
+    BenchTimer timer;
+    for (int r = 0; r < repeats; ++r)
+        for (const auto& word : ngrams) {
+            uint64_t acc = 0;
+            for (auto g : word)
+                acc ^= HashFunction::fnv1a(g);
+            g_sink = acc;
+        }
+    report("fnv1a (per n-gram)", timer.seconds());
+
+    timer.reset();
+    for (int r = 0; r < repeats; ++r)
+        for (const auto& word : ngrams) {
+            uint64_t acc = 0;
+            for (auto g : word)
+                acc ^= HashFunction::murmur3(g);
+            g_sink = acc;
+        }
+    report("murmur3 (per n-gram)", timer.seconds());
+
+    timer.reset();
+    for (int r = 0; r < repeats; ++r)
+        for (const auto& word : vocab) {
+            uint64_t acc = 0;
+            gen.for_each_hash(word, [&](uint64_t h) { acc ^= h; });
+            g_sink = acc;
+        }
+    report("fnv1a rolling", timer.seconds());
+
+    std::vector<uint64_t> hashes(64 * (max_n - min_n + 1));
+    SimdLevel saved = simd_level();
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX512}) {
+        if (static_cast<int>(level) > static_cast<int>(simd_detect_level()))
+            continue;
+        simd_set_level(level);
+
+        timer.reset();
+        for (int r = 0; r < repeats; ++r)
+            for (const auto& w : wrapped) {
+                size_t n = fnv1a_ngrams(
+                    reinterpret_cast<const unsigned char*>(w.data()),
+                    w.size(), min_n, max_n, hashes.data());
+                g_sink = hashes[n - 1];
+            }
+
+        std::string name = std::string("fnv1a_ngrams (") +
+                           simd_level_name(level) + ")";
+        report(name.c_str(), timer.seconds());
+    }
+
+    // End to end: hashes reduced to buckets, as WordEncoder uses them
+    std::vector<int> buckets;
+    timer.reset();
+    for (int r = 0; r < repeats; ++r)
+        for (const auto& word : vocab) {
+            buckets.clear();
+            gen.for_each_hash(word, [&](uint64_t h) {
+                buckets.push_back(static_cast<int>(h % 2000000));
+            });
+            g_sink = buckets.size();
+        }
+    report("buckets (rolling)", timer.seconds());
+
+    for (SimdLevel level : {SimdLevel::SCALAR, simd_detect_level()}) {
+        simd_set_level(level);
+        timer.reset();
+        for (int r = 0; r < repeats; ++r)
+            for (const auto& word : vocab) {
+                buckets.clear();
+                gen.generate_buckets(word, 2000000, buckets);
+                g_sink = buckets.size();
+            }
+        std::string name = std::string("generate_buckets (") +
+                           simd_level_name(level) + ")";
+        report(name.c_str(), timer.seconds());
+    }
+    simd_set_level(saved);
+
+    return 0;
+}
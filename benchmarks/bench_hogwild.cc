@@ -0,0 +1,61 @@
+// Hogwild training throughput: samples/sec for 1..max_threads workers.
+//
+//   bench_hogwild [num_samples] [max_threads] [dim] [buckets]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+    int num_samples = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int max_threads = argc > 2 ? std::atoi(argv[2]) : 64;
+    int dim = argc > 3 ? std::atoi(argv[3]) : 256;
+    int buckets = argc > 4 ? std::atoi(argv[4]) : 200000;
+    int classes = 8;
+
+    auto data = bench_corpus(num_samples, classes, 16, 42);
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder(embedding, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder encoder(word_encoder);
+    EnglishTokenizer tokenizer;
+
+    std::printf("hogwild: %d samples, dim %d, %d buckets, %u hw threads\n",
+                num_samples, dim, buckets,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %14s %9s %11s %9s\n",
+                "threads", "samples/sec", "speedup", "efficiency", "loss");
+
+    double base = 0.0;
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        LinearClassifier classifier(dim, classes, 42);
+        SimpleTrainer trainer(tokenizer, encoder, classifier, dim, classes);
+        trainer.set_num_threads(threads);
+
+        BenchTimer timer;
+        float loss = trainer.train_epoch(data, 0.1f);
+        double rate = num_samples / timer.seconds();
+
+        if (threads == 1)
+            base = rate;
+
+        std::printf("%8d %14.0f %8.2fx %10.0f%% %9.4f\n",
+                    threads, rate, rate / base,
+                    100.0 * rate / base / threads, loss);
+    }
+
+    return 0;
+}
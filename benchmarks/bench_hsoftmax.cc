@@ -0,0 +1,152 @@
+// Full softmax vs negative sampling vs hierarchical softmax as the label
+// count grows: training throughput of per-sample SGD steps with each output
+// loss (negative sampling draws K negatives from unigram^0.75 and updates
+// K + 1 rows of the dense head), then top-1 latency (dense
+// forward + argmax vs HS greedy descent vs HS exact best-first search) and
+// how often greedy descent finds the exact top-1 once trained. Labels are
+// Zipf distributed and each input is its label's random prototype plus
+// noise, so the Huffman tree sees a realistic skew.
+//
+//   bench_hsoftmax [dim] [max_classes] [pool] [negatives]
+
+#include "bench_common.h"
+#include "classifier/hierarchical_softmax.h"
+#include "classifier/linear_classifier.h"
+#include "loss/negative_sampling.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+// Samples per second of f(i) over i in [0, n), repeated for ~min_seconds
+template <class F>
+double rate(int n, double min_seconds, F&& f)
+{
+    long count = 0;
+    BenchTimer timer;
+    do {
+        for (int i = 0; i < n; ++i)
+            f(i);
+        count += n;
+    } while (timer.seconds() < min_seconds);
+    return count / timer.seconds();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int dim = argc > 1 ? std::atoi(argv[1]) : 100;
+    int max_classes = argc > 2 ? std::atoi(argv[2]) : 50000;
+    int pool = argc > 3 ? std::atoi(argv[3]) : 4096;
+    int negatives = argc > 4 ? std::atoi(argv[4]) : 5;
+    double min_seconds = 0.5;
+    float lr = 0.1f;
+
+    std::printf("per-sample SGD and top-1 latency, dim %d, Zipf labels, "
+                "%d negatives\n", dim, negatives);
+    std::printf("%7s %6s %11s %11s %11s %8s %8s %10s %10s %10s %8s\n",
+                "classes", "depth", "softmax/s", "negative/s", "hsoftmax/s",
+                "neg x", "hs x", "dense us", "greedy us", "exact us",
+                "greedy=");
+
+    for (int classes : {16, 256, 4096, 16384, 50000}) {
+        if (classes > max_classes) break;
+
+        RNG rng(classes);
+
+        // Zipf(1) label sampler
+        std::vector<double> cdf(classes);
+        double total = 0.0;
+        for (int c = 0; c < classes; ++c)
+            cdf[c] = total += 1.0 / (c + 1);
+
+        std::vector<float> protos(static_cast<size_t>(classes) * dim);
+        for (auto& p : protos)
+            p = rng.uniform(-1.0f, 1.0f);
+
+        std::vector<int> labels(pool);
+        std::vector<float> X(static_cast<size_t>(pool) * dim);
+        std::vector<int64_t> counts(classes, 0);
+
+        for (int i = 0; i < pool; ++i) {
+            double u = rng.uniform(0.0f, 1.0f) * total;
+            int c = static_cast<int>(
+                std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+            c = std::min(c, classes - 1);
+
+            labels[i] = c;
+            ++counts[c];
+            for (int j = 0; j < dim; ++j)
+                X[static_cast<size_t>(i) * dim + j] =
+                    protos[static_cast<size_t>(c) * dim + j] +
+                    rng.uniform(-0.5f, 0.5f);
+        }
+
+        LinearClassifier dense(dim, classes, 42);
+        LinearClassifier sampled(dim, classes, 42);
+        HierarchicalSoftmax hs(dim, counts);
+
+        // Unseen labels still get negatives
+        std::vector<int64_t> smoothed = counts;
+        for (auto& count : smoothed)
+            ++count;
+        sampled.set_negative_sampler(
+            std::make_shared<NegativeSampler>(smoothed, negatives, 42));
+
+        double depth = 0.0;
+        for (int label : labels)
+            depth += hs.depth(label);
+        depth /= pool;
+
+        std::vector<float> logits(classes), dinput(dim);
+        auto x = [&](int i) { return &X[static_cast<size_t>(i) * dim]; };
+
+        double dense_rate = rate(pool, min_seconds, [&](int i) {
+            dense.train_sample(x(i), labels[i], dinput.data(), lr,
+                               logits.data());
+        });
+        double ns_rate = rate(pool, min_seconds, [&](int i) {
+            sampled.train_sample(x(i), labels[i], dinput.data(), lr,
+                                 logits.data());
+        });
+        double hs_rate = rate(pool, min_seconds, [&](int i) {
+            hs.train_sample(x(i), labels[i], dinput.data(), lr,
+                            logits.data());
+        });
+
+        volatile int sink = 0;
+        double dense_us = 1e6 / rate(pool, min_seconds, [&](int i) {
+            dense.forward(x(i), logits.data());
+            sink = sink + static_cast<int>(
+                std::max_element(logits.begin(), logits.end()) -
+                logits.begin());
+        });
+        double greedy_us = 1e6 / rate(pool, min_seconds, [&](int i) {
+            sink = sink + hs.predict_top1(x(i)).label;
+        });
+
+        Prediction best{};
+        double exact_us = 1e6 / rate(pool, min_seconds, [&](int i) {
+            hs.predict_topk(x(i), 1, &best);
+            sink = sink + best.label;
+        });
+
+        int agree = 0;
+        for (int i = 0; i < pool; ++i) {
+            hs.predict_topk(x(i), 1, &best);
+            agree += hs.predict_top1(x(i)).label == best.label;
+        }
+
+        std::printf("%7d %6.2f %11.0f %11.0f %11.0f %7.1fx %7.1fx %10.2f "
+                    "%10.2f %10.2f %7.1f%%\n",
+                    classes, depth, dense_rate, ns_rate, hs_rate,
+                    ns_rate / dense_rate, hs_rate / dense_rate,
+                    dense_us, greedy_us, exact_us, 100.0 * agree / pool);
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Dense vs low-rank classifier head as the label count grows: parameter
+// bytes and forward time per row, single-row forward() and forward_batch().
+// The low-rank head wins once rank * (C + d) < C * d; the measured
+// crossover also depends on how well each shape uses the GEMM tiles.
+//
+//   bench_lowrank [dim] [rank] [max_classes] [batch]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "classifier/lowrank_classifier.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct Timing {
+    double single_us;
+    double batch_us;   // per row
+};
+
+// Repeats each path for roughly min_seconds of work
+Timing time_head(const IClassifier& head,
+                 const std::vector<float>& X,
+                 int batch,
+                 double min_seconds)
+{
+    int dim = head.input_dim();
+    std::vector<float> logits(static_cast<size_t>(batch) * head.num_classes());
+
+    Timing t{};
+    volatile float sink = 0.0f;
+
+    long rows = 0;
+    BenchTimer timer;
+    do {
+        for (int i = 0; i < batch; ++i)
+            head.forward(&X[static_cast<size_t>(i) * dim], logits.data());
+        sink = sink + logits[0];
+        rows += batch;
+    } while (timer.seconds() < min_seconds);
+    t.single_us = timer.seconds() * 1e6 / rows;
+
+    rows = 0;
+    timer.reset();
+    do {
+        head.forward_batch(X.data(), batch, logits.data());
+        sink = sink + logits[0];
+        rows += batch;
+    } while (timer.seconds() < min_seconds);
+    t.batch_us = timer.seconds() * 1e6 / rows;
+
+    return t;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int dim = argc > 1 ? std::atoi(argv[1]) : 256;
+    int rank = argc > 2 ? std::atoi(argv[2]) : 32;
+    int max_classes = argc > 3 ? std::atoi(argv[3]) : 16384;
+    int batch = argc > 4 ? std::atoi(argv[4]) : 64;
+    double min_seconds = 0.2;
+
+    RNG rng(1);
+    std::vector<float> X(static_cast<size_t>(batch) * dim);
+    for (auto& x : X)
+        x = rng.uniform(-1.0f, 1.0f);
+
+    std::printf("dense vs low-rank head: dim %d, rank %d, batch %d "
+                "(flop crossover at C > %.1f)\n",
+                dim, rank, batch,
+                rank < dim ? double(rank) * dim / (dim - rank) : -1.0);
+    std::printf("%8s %10s %10s %11s %11s %9s %12s %12s %9s\n",
+                "classes", "dense MB", "lowrank MB",
+                "dense us", "lowrank us", "speedup",
+                "dense b us", "lowrank b us", "speedup");
+
+    for (int classes = 4; classes <= max_classes; classes *= 4) {
+        LinearClassifier dense(dim, classes, 42);
+        LowRankClassifier lowrank(dim, classes, rank, 42);
+
+        double dense_mb = (double(classes) * dim + classes) * 4 / 1e6;
+        double lowrank_mb =
+            (double(rank) * (classes + dim) + classes) * 4 / 1e6;
+
+        Timing d = time_head(dense, X, batch, min_seconds);
+        Timing l = time_head(lowrank, X, batch, min_seconds);
+
+        std::printf("%8d %10.3f %10.3f %11.3f %11.3f %8.2fx %12.3f %12.3f "
+                    "%8.2fx\n",
+                    classes, dense_mb, lowrank_mb,
+                    d.single_us, l.single_us, d.single_us / l.single_us,
+                    d.batch_us, l.batch_us, d.batch_us / l.batch_us);
+    }
+
+    return 0;
+}
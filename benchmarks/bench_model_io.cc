@@ -0,0 +1,55 @@
+// Save / load time of a full model file.
+//
+//   bench_model_io [buckets] [dim] [classes] [path]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "io/model_file.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    ModelConfig config;
+    config.bucket_count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    config.embedding_dim = argc > 2 ? std::atoi(argv[2]) : 256;
+    int classes = argc > 3 ? std::atoi(argv[3]) : 100;
+    std::string path = argc > 4 ? argv[4] : "bench_model.glad";
+
+    EmbeddingTable embedding(config.bucket_count, config.embedding_dim,
+                             config.seed);
+    LinearClassifier classifier(config.embedding_dim, classes, config.seed);
+
+    BenchTimer timer;
+    ModelFile::save(path, config, embedding, classifier);
+    double save_s = timer.seconds();
+
+    std::printf("model io: %d buckets x %d dim, %d classes (%.1f MB)\n",
+                config.bucket_count, config.embedding_dim, classes,
+                embedding.memory_bytes() / (1024.0 * 1024.0));
+    std::printf("%-32s %10.2f ms\n", "save", save_s * 1e3);
+
+    struct Mode {
+        const char* name;
+        ModelLoadOptions options;
+    };
+    Mode modes[3];
+    modes[0].name = "load (verify checksums)";
+    modes[1].name = "load (no verification)";
+    modes[1].options.verify_checksums = false;
+    modes[2].name = "load (no verification, prewarm)";
+    modes[2].options.verify_checksums = false;
+    modes[2].options.prewarm = true;
+
+    for (const Mode& mode : modes) {
+        timer.reset();
+        Model model = ModelFile::load(path, mode.options);
+        std::printf("%-32s %10.2f ms\n", mode.name, timer.seconds() * 1e3);
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
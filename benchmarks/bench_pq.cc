@@ -0,0 +1,104 @@
+// Compressed embedding storage: memory, reconstruction error and word
+// encoding throughput of FP32 versus FP16 and product-quantized (PQ8) rows.
+//
+//   bench_pq [buckets] [dim] [words]
+
+#include "bench_common.h"
+#include "embedding/embedding_table.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+static volatile float g_sink;
+
+// Words per second through WordEncoder::encode on table.
+static double encode_rate(const EmbeddingTable& table,
+                          const std::vector<std::string>& words)
+{
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder encoder(table, ngram, &phonetic, table.bucket_count(), 0.2f);
+
+    std::vector<float> out(table.dim());
+    BenchTimer timer;
+    for (const auto& w : words) {
+        encoder.encode(w, out.data());
+        g_sink = out[0];
+    }
+    return words.size() / timer.seconds();
+}
+
+// Mean squared reconstruction error relative to the mean squared value.
+static double relative_error(const EmbeddingTable& ref,
+                             const EmbeddingTable& table)
+{
+    std::vector<float> scratch(ref.dim());
+    double err = 0.0, norm = 0.0;
+    for (int b = 0; b < ref.bucket_count(); ++b) {
+        const float* r = table.row_f32(b, scratch.data());
+        for (int j = 0; j < ref.dim(); ++j) {
+            double d = r[j] - ref.row(b)[j];
+            err += d * d;
+            norm += static_cast<double>(ref.row(b)[j]) * ref.row(b)[j];
+        }
+    }
+    return err / norm;
+}
+
+int main(int argc, char** argv)
+{
+    int buckets = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int dim = argc > 2 ? std::atoi(argv[2]) : 256;
+    int num_words = argc > 3 ? std::atoi(argv[3]) : 200000;
+
+    auto vocab = bench_vocabulary(10000, 7);
+    std::vector<std::string> words;
+    for (int i = 0; i < num_words; ++i)
+        words.push_back(vocab[(i * 7919) % vocab.size()]);
+
+    EmbeddingTable f32(buckets, dim, 42);
+
+    std::printf("embedding compression: %d x %d, %d words\n",
+                buckets, dim, num_words);
+    std::printf("%-12s %10s %8s %10s %10s %12s\n", "storage", "MB", "ratio",
+                "build s", "rel mse", "words/s");
+
+    auto report = [&](const char* name, const EmbeddingTable& table,
+                      double build_s) {
+        std::printf("%-12s %10.2f %7.1fx %10.2f %10.4f %12.0f\n", name,
+                    table.memory_bytes() / (1024.0 * 1024.0),
+                    double(f32.memory_bytes()) / table.memory_bytes(),
+                    build_s, relative_error(f32, table),
+                    encode_rate(table, words));
+    };
+
+    encode_rate(f32, words);  // fault the freshly initialised pages in
+    report("f32", f32, 0.0);
+
+    BenchTimer timer;
+    EmbeddingTable f16(f32, EmbeddingDType::F16);
+    report("f16", f16, timer.seconds());
+
+    for (int dsub : {4, 8, 16}) {
+        if (dim % dsub != 0)
+            continue;
+
+        PQOptions options;
+        options.dsub = dsub;
+
+        timer.reset();
+        EmbeddingTable pq(f32, options);
+        double build_s = timer.seconds();
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "pq8 dsub=%d", dsub);
+        report(name, pq, build_s);
+    }
+
+    return 0;
+}
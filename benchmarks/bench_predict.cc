@@ -0,0 +1,77 @@
+// Offline batch inference: documents/sec of Predictor::encode_batch and
+// predict_batch for 1..max_threads threads on one shared model.
+//
+//   bench_predict [num_docs] [max_threads] [dim] [classes] [k]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/word_encoder.h"
+#include "inference/predictor.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+    int num_docs = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int max_threads = argc > 2 ? std::atoi(argv[2])
+                               : static_cast<int>(std::max(
+                                     1u, std::thread::hardware_concurrency()));
+    int dim = argc > 3 ? std::atoi(argv[3]) : 128;
+    int classes = argc > 4 ? std::atoi(argv[4]) : 256;
+    int k = argc > 5 ? std::atoi(argv[5]) : 5;
+    int buckets = 200000;
+
+    auto data = bench_corpus(num_docs, classes, 16, 42);
+    std::vector<std::string_view> docs;
+    for (const auto& s : data)
+        docs.push_back(s.text);
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder(embedding, ngram, &phonetic, buckets, 0.2f);
+    LinearClassifier classifier(dim, classes, 42);
+
+    std::vector<float> vectors(static_cast<size_t>(num_docs) * dim);
+    std::vector<Prediction> predictions(static_cast<size_t>(num_docs) * k);
+
+    std::printf("predict: %d docs, dim %d, %d classes, top-%d, "
+                "%u hw threads\n",
+                num_docs, dim, classes, k,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %14s %14s %9s\n",
+                "threads", "encode doc/s", "predict doc/s", "speedup");
+
+    double base = 0.0;
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        Predictor predictor(word_encoder, classifier, threads);
+
+        // Warm up the workers' scratch
+        predictor.predict_batch(docs.data(), std::min<size_t>(docs.size(), 256),
+                                k, predictions.data());
+
+        BenchTimer timer;
+        predictor.encode_batch(docs.data(), docs.size(), vectors.data());
+        double encode_rate = num_docs / timer.seconds();
+
+        timer.reset();
+        predictor.predict_batch(docs.data(), docs.size(), k,
+                                predictions.data());
+        double predict_rate = num_docs / timer.seconds();
+
+        if (threads == 1)
+            base = predict_rate;
+
+        std::printf("%8d %14.0f %14.0f %8.2fx\n",
+                    threads, encode_rate, predict_rate, predict_rate / base);
+    }
+
+    return 0;
+}
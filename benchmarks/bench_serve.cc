@@ -0,0 +1,66 @@
+// Micro-batching server under closed-loop load: `clients` threads each send
+// requests back to back through BatchServer::classify. Prints QPS, p50/p99
+// latency and mean batch size for several max_batch settings.
+//
+//   bench_serve [clients] [requests_per_client] [max_wait_us] [workers] [dim] [classes]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "serving/batch_server.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+    int clients = argc > 1 ? std::atoi(argv[1]) : 64;
+    int per_client = argc > 2 ? std::atoi(argv[2]) : 500;
+    int max_wait_us = argc > 3 ? std::atoi(argv[3]) : 200;
+    int workers = argc > 4 ? std::atoi(argv[4]) : 0;
+    int dim = argc > 5 ? std::atoi(argv[5]) : 128;
+    int classes = argc > 6 ? std::atoi(argv[6]) : 512;
+    int buckets = 200000;
+
+    auto data = bench_corpus(clients * per_client, classes, 16, 42);
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder(embedding, ngram, &phonetic, buckets, 0.2f);
+    LinearClassifier classifier(dim, classes, 42);
+
+    std::printf("serve: %d clients x %d requests, max wait %d us, dim %d, "
+                "%d classes, %u hw threads\n",
+                clients, per_client, max_wait_us, dim, classes,
+                std::thread::hardware_concurrency());
+    std::printf("%10s %10s %11s %11s %11s\n",
+                "max_batch", "QPS", "p50 (us)", "p99 (us)", "mean batch");
+
+    for (int max_batch : {1, 4, 16, 64, 256}) {
+        ServeOptions options;
+        options.max_batch = max_batch;
+        options.max_wait_us = max_wait_us;
+        options.workers = workers;
+        BatchServer server(word_encoder, classifier, options);
+
+        std::vector<std::thread> threads;
+        for (int c = 0; c < clients; ++c)
+            threads.emplace_back([&, c] {
+                for (int r = 0; r < per_client; ++r)
+                    server.classify(data[c * per_client + r].text);
+            });
+        for (auto& t : threads)
+            t.join();
+
+        ServeStats s = server.stats();
+        std::printf("%10d %10.0f %11.0f %11.0f %11.1f\n",
+                    max_batch, s.qps, s.p50_us, s.p99_us, s.mean_batch);
+    }
+
+    return 0;
+}
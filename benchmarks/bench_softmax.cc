@@ -0,0 +1,94 @@
+// Softmax cross-entropy over a batch of logit rows as the label count
+// grows: the scalar route (softmax() + cross_entropy() + the one-hot
+// subtract, three passes with std::exp) against the fused softmax_xent
+// kernel at each SIMD level, in place on the logits like the classifier
+// heads. Reports nanoseconds per logit and the speedup over scalar.
+//
+//   bench_softmax [rows]
+
+#include "bench_common.h"
+#include "loss/softmax.h"
+#include "simd/kernels.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Nanoseconds per logit of f() over rows x classes, repeated for
+// ~min_seconds; src is copied back into work before every call
+template <class F>
+double ns_per_logit(const std::vector<float>& src, std::vector<float>& work,
+                    double min_seconds, F&& f)
+{
+    long calls = 0;
+    double spent = 0.0;
+    do {
+        std::memcpy(work.data(), src.data(), src.size() * sizeof(float));
+        BenchTimer t;
+        f();
+        spent += t.seconds();
+        ++calls;
+    } while (spent < min_seconds);
+    return spent * 1e9 / (static_cast<double>(calls) * src.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int rows = argc > 1 ? std::atoi(argv[1]) : 32;
+    double min_seconds = 0.3;
+    SimdLevel best = simd_detect_level();
+
+    std::printf("softmax cross-entropy, %d rows: ns per logit\n", rows);
+    std::printf("%7s %10s", "classes", "3-pass");
+    for (int l = 0; l <= static_cast<int>(best); ++l)
+        std::printf(" %10s", simd_level_name(static_cast<SimdLevel>(l)));
+    std::printf(" %8s\n", "fused x");
+
+    for (int classes : {16, 256, 4096, 50000}) {
+        RNG rng(classes);
+        std::vector<float> logits(static_cast<size_t>(rows) * classes);
+        for (auto& l : logits)
+            l = rng.uniform(-8.0f, 8.0f);
+
+        std::vector<int> labels(rows);
+        for (auto& y : labels)
+            y = static_cast<int>(rng.uniform(0.0f, 1.0f) * (classes - 1));
+
+        std::vector<float> work(logits.size());
+        volatile float sink = 0.0f;
+
+        double scalar = ns_per_logit(logits, work, min_seconds, [&]() {
+            float loss = 0.0f;
+            for (int i = 0; i < rows; ++i) {
+                float* row = &work[static_cast<size_t>(i) * classes];
+                softmax(row, classes);
+                loss += cross_entropy(row, labels[i]);
+                row[labels[i]] -= 1.0f;
+            }
+            sink = sink + loss;
+        });
+
+        std::printf("%7d %10.3f", classes, scalar);
+
+        double fastest = scalar;
+        for (int l = 0; l <= static_cast<int>(best); ++l) {
+            simd_set_level(static_cast<SimdLevel>(l));
+            double fused = ns_per_logit(logits, work, min_seconds, [&]() {
+                sink = sink + softmax_xent(rows, classes, work.data(), classes,
+                                           labels.data(), work.data(),
+                                           classes);
+            });
+            fastest = fused < fastest ? fused : fastest;
+            std::printf(" %10.3f", fused);
+        }
+        simd_set_level(best);
+
+        std::printf(" %7.2fx\n", scalar / fastest);
+    }
+
+    return 0;
+}
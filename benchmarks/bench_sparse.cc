@@ -0,0 +1,144 @@
+// Sparse / hybrid heads vs gather-then-dense: classify latency per document
+// as texts get longer. Every path starts from tokens and hashes them; the
+// dense path then gathers dim-wide rows into a sentence vector and runs the
+// C x dim head, the sparse path adds one C-wide row per bucket, and the
+// hybrid path does both, reading its small dense embedding from the same
+// feature row.
+//
+//   bench_sparse [dim] [hybrid_dim] [classes] [buckets] [docs]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "classifier/sparse_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/sparse_features.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Mean us per document of f(doc) over all docs, repeated for ~min_seconds
+template <class F>
+double time_docs(const std::vector<TokenBuffer>& docs,
+                 double min_seconds,
+                 F&& f)
+{
+    long count = 0;
+    BenchTimer timer;
+    do {
+        for (const auto& doc : docs)
+            f(doc);
+        count += static_cast<long>(docs.size());
+    } while (timer.seconds() < min_seconds);
+    return timer.seconds() * 1e6 / count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int dim = argc > 1 ? std::atoi(argv[1]) : 256;
+    int hybrid_dim = argc > 2 ? std::atoi(argv[2]) : 16;
+    int classes = argc > 3 ? std::atoi(argv[3]) : 16;
+    int buckets = argc > 4 ? std::atoi(argv[4]) : 200000;
+    int num_docs = argc > 5 ? std::atoi(argv[5]) : 2000;
+    double min_seconds = 0.2;
+
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+
+    EmbeddingTable table(buckets, dim, 42);
+    WordEncoder words(table, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder mean(words);
+    LinearClassifier dense(dim, classes, 42);
+
+    EmbeddingTable small_table(buckets, hybrid_dim, 42);
+    WordEncoder small_words(small_table, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder small_mean(small_words);
+
+    // Random sparse weights so no row is special
+    RNG rng(7);
+    std::vector<float> S(static_cast<size_t>(buckets) * classes);
+    for (auto& s : S)
+        s = rng.uniform(-0.1f, 0.1f);
+    std::vector<float> bias(classes, 0.0f);
+
+    SparseClassifier sparse(0, buckets, classes, 42);
+    sparse.load_parameters(S.data(), nullptr, bias.data());
+    SparseClassifier hybrid(hybrid_dim, buckets, classes, 42);
+    hybrid.load_parameters(S.data(), hybrid.dense_weights(), bias.data());
+
+    auto vocab = bench_vocabulary(20000, 1);
+    EnglishTokenizer tokenizer;
+
+    std::printf("classify latency: dense dim %d vs sparse vs hybrid dim %d, "
+                "%d classes, %d buckets\n",
+                dim, hybrid_dim, classes, buckets);
+    std::printf("%6s %8s %12s %12s %12s %10s %10s\n",
+                "words", "nnz", "dense us", "sparse us", "hybrid us",
+                "sparse x", "hybrid x");
+
+    std::vector<float> sentence(dim), small(hybrid_dim), logits(classes);
+    SparseFeatures features;
+    volatile float sink = 0.0f;
+
+    for (int len : {1, 2, 4, 8, 16, 32, 64}) {
+        std::vector<TokenBuffer> docs(num_docs);
+        for (auto& doc : docs) {
+            std::string text;
+            for (int w = 0; w < len; ++w) {
+                if (w) text += ' ';
+                text += vocab[static_cast<size_t>(
+                    rng.uniform(0.0f, vocab.size() - 0.001f))];
+            }
+            tokenizer.tokenize(text, doc);
+        }
+
+        long nnz = 0;
+        for (const auto& doc : docs) {
+            features.clear();
+            mean.append_features(doc, features);
+            nnz += features.nnz();
+        }
+
+        double dense_us = time_docs(
+            docs, min_seconds, [&](const TokenBuffer& d) {
+            mean.encode(d, sentence.data());
+            dense.forward(sentence.data(), logits.data());
+            sink = sink + logits[0];
+        });
+
+        double sparse_us = time_docs(
+            docs, min_seconds, [&](const TokenBuffer& d) {
+            features.clear();
+            mean.append_features(d, features);
+            sparse.forward(nullptr, features.row_indices(0),
+                           features.row_values(0), features.row_size(0),
+                           logits.data());
+            sink = sink + logits[0];
+        });
+
+        double hybrid_us = time_docs(
+            docs, min_seconds, [&](const TokenBuffer& d) {
+            features.clear();
+            small_mean.append_features(d, features);
+            small_mean.encode_features(features, 0, small.data());
+            hybrid.forward(small.data(), features.row_indices(0),
+                           features.row_values(0), features.row_size(0),
+                           logits.data());
+            sink = sink + logits[0];
+        });
+
+        std::printf("%6d %8.1f %12.2f %12.2f %12.2f %9.2fx %9.2fx\n",
+                    len, double(nnz) / num_docs, dense_us, sparse_us,
+                    hybrid_us, dense_us / sparse_us, dense_us / hybrid_us);
+    }
+
+    return 0;
+}
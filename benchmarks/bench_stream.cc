@@ -0,0 +1,85 @@
+// Streaming training throughput: writes a synthetic fastText-format file and
+// trains on it through StreamingLoader with 1..max_readers reader threads,
+// printing the per-stage report (busy / wait time and the bottleneck).
+//
+//   bench_stream [num_samples] [max_readers] [trainer_threads] [dim] [buckets]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+#include "training/streaming_loader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+    int num_samples = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int max_readers = argc > 2 ? std::atoi(argv[2]) : 4;
+    int trainers = argc > 3 ? std::atoi(argv[3]) : 1;
+    int dim = argc > 4 ? std::atoi(argv[4]) : 64;
+    int buckets = argc > 5 ? std::atoi(argv[5]) : 200000;
+    int classes = 8;
+
+    std::string path = "bench_stream_corpus.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (const auto& s : bench_corpus(num_samples, classes, 16, 42))
+            out << "__label__" << s.label << ' ' << s.text << '\n';
+    }
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder(embedding, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder encoder(word_encoder);
+    EnglishTokenizer tokenizer;
+
+    auto labels = StreamingLoader::scan_labels(path);
+
+    std::printf("stream: %d samples, dim %d, %d buckets, %d trainer(s), "
+                "%u hw threads\n",
+                num_samples, dim, buckets, trainers,
+                std::thread::hardware_concurrency());
+
+    for (int readers = 1; readers <= max_readers; readers *= 2) {
+        LinearClassifier classifier(dim, classes, 42);
+        SimpleTrainer trainer(tokenizer, encoder, classifier, dim, classes);
+        trainer.set_num_threads(trainers);
+
+        StreamOptions options;
+        options.block_bytes = 256 << 10;
+        options.reader_threads = readers;
+        options.epochs = 2;
+
+        StreamingLoader loader(path, word_encoder, labels, options);
+        float loss = trainer.train_stream(loader, 0.1f);
+
+        std::printf("\n-- %d reader(s), loss %.4f\n%s\n",
+                    readers, loss, loader.report().summary().c_str());
+    }
+
+    // Baseline: tokenization and hashing inline on the training thread
+    {
+        auto data = bench_corpus(num_samples, classes, 16, 42);
+        LinearClassifier classifier(dim, classes, 42);
+        SimpleTrainer trainer(tokenizer, encoder, classifier, dim, classes);
+
+        BenchTimer timer;
+        for (int e = 0; e < 2; ++e)
+            trainer.train_epoch(data, 0.1f);
+
+        std::printf("\n-- in-memory train_epoch x2: %.0f samples/s\n",
+                    2.0 * num_samples / timer.seconds());
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Tokenizer throughput in GB/s of input text: EnglishTokenizer (vector and
+// TokenBuffer overloads) against SimdTokenizer at each SIMD level, on the
+// synthetic corpus with capitals, digits and punctuation mixed in.
+//
+//   bench_tokenizer [num_samples] [repeats]
+
+#include "bench_common.h"
+#include "simd/kernels.h"
+#include "tokenizer/english_tokenizer.h"
+#include "tokenizer/simd_tokenizer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static volatile size_t g_sink;
+
+int main(int argc, char** argv)
+{
+    int num_samples = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    auto data = bench_corpus(num_samples, 4, 16, 5);
+
+    RNG rng(9);
+    std::vector<std::string> texts;
+    size_t bytes = 0;
+    for (auto& s : data) {
+        for (char& c : s.text) {
+            float r = rng.uniform(0.0f, 1.0f);
+            if (r < 0.05f)
+                c = static_cast<char>(c - 'a' + 'A');
+            else if (r < 0.07f)
+                c = '0' + static_cast<char>(rng.uniform(0.0f, 9.99f));
+        }
+        s.text += rng.uniform(0.0f, 1.0f) < 0.5f ? "." : ", right?";
+        bytes += s.text.size();
+        texts.push_back(std::move(s.text));
+    }
+
+    auto report = [&](const char* name, double seconds, double base) {
+        double gbps = bytes * static_cast<double>(repeats) / seconds / 1e9;
+        std::printf("%-28s %8.3f GB/s %7.2fx\n", name, gbps,
+                    base > 0.0 ? base / seconds : 1.0);
+        return seconds;
+    };
+
+    std::printf("tokenizer: %d texts, %.1f MB, avg %.0f bytes/text\n",
+                num_samples, bytes / (1024.0 * 1024.0),
+                static_cast<double>(bytes) / texts.size());
+
+    EnglishTokenizer english;
+    SimdTokenizer simd;
+
+    std::vector<std::string> tokens;
+    BenchTimer timer;
+    for (int r = 0; r < repeats; ++r)
+        for (const auto& t : texts) {
+            english.tokenize(t, tokens);
+            g_sink = tokens.size();
+        }
+    double base = report("english (vector)", timer.seconds(), 0.0);
+
+    TokenBuffer buffer;
+    timer.reset();
+    for (int r = 0; r < repeats; ++r)
+        for (const auto& t : texts) {
+            english.tokenize(std::string_view(t), buffer);
+            g_sink = buffer.size();
+        }
+    report("english (TokenBuffer)", timer.seconds(), base);
+
+    SimdLevel saved = simd_level();
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2,
+                            SimdLevel::AVX512}) {
+        if (static_cast<int>(level) > static_cast<int>(simd_detect_level()))
+            continue;
+        simd_set_level(level);
+
+        timer.reset();
+        for (int r = 0; r < repeats; ++r)
+            for (const auto& t : texts) {
+                simd.tokenize(std::string_view(t), buffer);
+                g_sink = buffer.size();
+            }
+
+        std::string name = std::string("simd (") +
+                           simd_level_name(level) + ")";
+        report(name.c_str(), timer.seconds(), base);
+    }
+    simd_set_level(saved);
+
+    // One long document: block loop without per-text overhead
+    std::string document;
+    for (const auto& t : texts) {
+        document += t;
+        document += '\n';
+    }
+
+    std::printf("\nsingle %.1f MB document\n", document.size() / (1024.0 * 1024.0));
+    size_t doc_bytes = document.size();
+    auto report_doc = [&](const char* name, double seconds) {
+        std::printf("%-28s %8.3f GB/s\n", name,
+                    doc_bytes * static_cast<double>(repeats) / seconds / 1e9);
+    };
+
+    timer.reset();
+    for (int r = 0; r < repeats; ++r) {
+        english.tokenize(std::string_view(document), buffer);
+        g_sink = buffer.size();
+    }
+    report_doc("english (TokenBuffer)", timer.seconds());
+
+    timer.reset();
+    for (int r = 0; r < repeats; ++r) {
+        simd.tokenize(std::string_view(document), buffer);
+        g_sink = buffer.size();
+    }
+    std::string name = std::string("simd (") + simd_level_name(simd_level()) + ")";
+    report_doc(name.c_str(), timer.seconds());
+
+    return 0;
+}
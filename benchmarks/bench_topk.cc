@@ -0,0 +1,115 @@
+// Top-k prediction paths on the dense head as the label count grows, per
+// input: forward + in-place softmax + partial_sort over all classes (the
+// old route), select_topk over forward's logits, the fused
+// LinearClassifier::predict_topk, and the exp-free predict_label. Reports
+// mean and p99 latency of single calls.
+//
+//   bench_topk [dim] [k] [inputs]
+
+#include "bench_common.h"
+#include "classifier/linear_classifier.h"
+#include "classifier/topk.h"
+#include "loss/softmax.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+
+namespace {
+
+struct Latency {
+    double mean_us;
+    double p99_us;
+};
+
+// Times f(i) per call over the inputs, repeated for ~min_seconds
+template <class F>
+Latency measure(int inputs, double min_seconds, F&& f)
+{
+    std::vector<double> us;
+    BenchTimer total;
+    do {
+        for (int i = 0; i < inputs; ++i) {
+            BenchTimer t;
+            f(i);
+            us.push_back(t.seconds() * 1e6);
+        }
+    } while (total.seconds() < min_seconds);
+
+    double mean = std::accumulate(us.begin(), us.end(), 0.0) / us.size();
+    size_t p99 = us.size() * 99 / 100;
+    std::nth_element(us.begin(), us.begin() + p99, us.end());
+    return {mean, us[p99]};
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int dim = argc > 1 ? std::atoi(argv[1]) : 100;
+    int k = argc > 2 ? std::atoi(argv[2]) : 5;
+    int inputs = argc > 3 ? std::atoi(argv[3]) : 512;
+    double min_seconds = 0.3;
+
+    std::printf("top-%d latency per input, dim %d: mean / p99 us\n", k, dim);
+    std::printf("%7s %17s %17s %17s %17s %8s\n", "classes",
+                "softmax+sort", "select_topk", "fused topk", "argmax only",
+                "fused x");
+
+    for (int classes : {16, 256, 4096, 50000}) {
+        if (classes < k) continue;
+
+        LinearClassifier clf(dim, classes, 42);
+
+        RNG rng(classes);
+        std::vector<float> X(static_cast<size_t>(inputs) * dim);
+        for (auto& x : X)
+            x = rng.uniform(-1.0f, 1.0f);
+        auto x = [&](int i) { return &X[static_cast<size_t>(i) * dim]; };
+
+        std::vector<float> logits(classes);
+        std::vector<int> order(classes);
+        std::vector<Prediction> top(k);
+        volatile int sink = 0;
+
+        Latency full = measure(inputs, min_seconds, [&](int i) {
+            clf.forward(x(i), logits.data());
+            softmax(logits.data(), classes);
+            std::iota(order.begin(), order.end(), 0);
+            std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                              [&](int a, int b) {
+                                  return logits[a] > logits[b] ||
+                                         (logits[a] == logits[b] && a < b);
+                              });
+            for (int j = 0; j < k; ++j)
+                top[j] = {order[j], logits[order[j]]};
+            sink = sink + top[0].label;
+        });
+
+        Latency select = measure(inputs, min_seconds, [&](int i) {
+            clf.forward(x(i), logits.data());
+            select_topk(logits.data(), classes, k, top.data());
+            sink = sink + top[0].label;
+        });
+
+        Latency fused = measure(inputs, min_seconds, [&](int i) {
+            clf.predict_topk(x(i), k, top.data());
+            sink = sink + top[0].label;
+        });
+
+        Latency label = measure(inputs, min_seconds, [&](int i) {
+            sink = sink + clf.predict_label(x(i));
+        });
+
+        std::printf("%7d %8.2f / %6.2f %8.2f / %6.2f %8.2f / %6.2f "
+                    "%8.2f / %6.2f %7.2fx\n",
+                    classes, full.mean_us, full.p99_us,
+                    select.mean_us, select.p99_us,
+                    fused.mean_us, fused.p99_us,
+                    label.mean_us, label.p99_us,
+                    full.mean_us / fused.mean_us);
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Sentence encoding throughput with and without a WordVectorCache on the
+// Zipf-distributed synthetic corpus, for a few cache budgets, and with a
+// VocabIndex built from the corpus instead.
+//
+//   bench_word_cache [num_samples] [dim] [buckets]
+
+#include "bench_common.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/vocab_index.h"
+#include "encoder/word_encoder.h"
+#include "encoder/word_vector_cache.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+static volatile float g_sink;
+
+int main(int argc, char** argv)
+{
+    int num_samples = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int dim = argc > 2 ? std::atoi(argv[2]) : 256;
+    int buckets = argc > 3 ? std::atoi(argv[3]) : 200000;
+
+    auto data = bench_corpus(num_samples, 4, 12, 11);
+
+    EnglishTokenizer tokenizer;
+    std::vector<std::vector<std::string>> sentences;
+    sentences.reserve(data.size());
+    for (const auto& s : data)
+        sentences.push_back(tokenizer.tokenize(s.text));
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder words(embedding, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder encoder(words);
+
+    std::vector<float> out(dim);
+
+    auto run = [&]() {
+        BenchTimer timer;
+        for (const auto& tokens : sentences) {
+            encoder.encode(tokens, out.data());
+            g_sink = out[0];
+        }
+        return sentences.size() / timer.seconds();
+    };
+
+    run();  // warm the embedding pages
+
+    std::printf("word vector cache: %d sentences, dim %d\n", num_samples, dim);
+    std::printf("%-14s %10s %10s %14s %8s\n", "budget", "entries",
+                "hit rate", "sentences/s", "speedup");
+
+    double base = run();
+    std::printf("%-14s %10s %10s %14.0f %7.2fx\n", "none", "-", "-",
+                base, 1.0);
+
+    for (size_t mb : {1, 4, 16, 64}) {
+        WordVectorCache cache(dim, mb << 20);
+        words.set_cache(&cache);
+
+        run();  // fill
+        cache.reset_stats();
+        double rate = run();
+
+        WordCacheStats stats = cache.stats();
+        char name[32];
+        std::snprintf(name, sizeof(name), "%zu MB", mb);
+        std::printf("%-14s %10zu %9.1f%% %14.0f %7.2fx\n", name,
+                    stats.entries, 100.0 * stats.hit_rate(), rate,
+                    rate / base);
+
+        words.set_cache(nullptr);
+    }
+
+    std::vector<std::string> texts;
+    for (const auto& s : data)
+        texts.push_back(s.text);
+
+    BenchTimer timer;
+    VocabIndex index(words, VocabIndex::collect(tokenizer, texts));
+    double build_s = timer.seconds();
+
+    words.set_vocab_index(&index);
+    double rate = run();
+    std::printf("%-14s %10d %10s %14.0f %7.2fx   (%.1f MB, built in %.2f s)\n",
+                "vocab index", index.size(), "-", rate, rate / base,
+                index.memory_bytes() / (1024.0 * 1024.0), build_s);
+
+    return 0;
+}
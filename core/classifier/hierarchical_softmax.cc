@@ -0,0 +1,442 @@
+#include "hierarchical_softmax.h"
+#include "loss/softmax.h"
+#include "simd/kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Per-thread scratch shared by every head on the thread. Grows, never
+// shrinks, so steady-state calls do not allocate.
+struct Scratch {
+    std::vector<float> z;      // node scores, or Z = X W^T (n x nodes)
+    std::vector<float> dz;     // dL/dz, or dZ (n x nodes)
+    std::vector<float> nodes;  // per-node log p or subtree gradient sums
+    std::vector<float> t;      // dZ transposed for the batched update
+    std::vector<float> g;      // per path step gradients in train_batch
+};
+
+Scratch& scratch()
+{
+    thread_local Scratch s;
+    return s;
+}
+
+float* ensure_size(std::vector<float>& v, size_t n)
+{
+    if (v.size() < n)
+        v.resize(n);
+    return v.data();
+}
+
+// Open node of the top-k search; the heap's top has the largest log p,
+// then the smallest id
+struct Candidate {
+    float log_prob;
+    int node;
+};
+
+bool worse(const Candidate& a, const Candidate& b)
+{
+    return a.log_prob < b.log_prob ||
+           (a.log_prob == b.log_prob && a.node > b.node);
+}
+
+}  // namespace
+
+HierarchicalSoftmax::HierarchicalSoftmax(
+    int input_dim,
+    const std::vector<int64_t>& label_counts)
+    : input_dim_(input_dim),
+      num_classes_(static_cast<int>(label_counts.size()))
+{
+    if (input_dim <= 0)
+        throw std::invalid_argument("input_dim must be > 0");
+
+    if (label_counts.empty())
+        throw std::invalid_argument("hierarchical softmax needs labels");
+
+    for (int64_t count : label_counts)
+        if (count < 0)
+            throw std::invalid_argument("label counts must be >= 0");
+
+    int C = num_classes_;
+    int root = 2 * C - 2;
+
+    // Huffman: repeatedly merge the two least frequent subtrees. Ties go
+    // to the smaller id, so the tree depends only on the counts.
+    using Entry = std::pair<int64_t, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+    for (int c = 0; c < C; ++c)
+        queue.push({label_counts[c], c});
+
+    left_.resize(C - 1);
+    right_.resize(C - 1);
+    std::vector<int> parent(2 * C - 1, -1);
+    std::vector<uint8_t> code(2 * C - 1, 0);
+
+    for (int j = 0; j < C - 1; ++j) {
+        Entry a = queue.top();
+        queue.pop();
+        Entry b = queue.top();
+        queue.pop();
+
+        int id = C + j;
+        left_[j] = a.second;
+        right_[j] = b.second;
+        parent[a.second] = id;
+        parent[b.second] = id;
+        code[b.second] = 1;
+
+        queue.push({a.first + b.first, id});
+    }
+
+    // Root-first paths, stored back to back
+    path_offsets_.resize(C + 1);
+    path_offsets_[0] = 0;
+
+    for (int c = 0; c < C; ++c) {
+        size_t begin = path_nodes_.size();
+
+        for (int n = c; n != root; n = parent[n]) {
+            path_nodes_.push_back(parent[n] - C);
+            path_codes_.push_back(code[n]);
+        }
+
+        std::reverse(path_nodes_.begin() + begin, path_nodes_.end());
+        std::reverse(path_codes_.begin() + begin, path_codes_.end());
+
+        path_offsets_[c + 1] = static_cast<int>(path_nodes_.size());
+    }
+
+    weights_.assign(static_cast<size_t>(C - 1) * input_dim, 0.0f);
+}
+
+void HierarchicalSoftmax::load_parameters(const float* weights)
+{
+    std::memcpy(weights_.data(), weights, weights_.size() * sizeof(float));
+}
+
+void HierarchicalSoftmax::leaf_log_probs(
+    const float* z,
+    float* logits) const
+{
+    int C = num_classes_;
+    float* log_prob = ensure_size(scratch().nodes, 2 * C - 1);
+
+    // Parents have larger ids, so walking ids downwards is top-down
+    log_prob[2 * C - 2] = 0.0f;
+
+    for (int j = C - 2; j >= 0; --j) {
+        float lp = log_prob[C + j];
+        log_prob[left_[j]] = lp + log_sigmoid(-z[j]);
+        log_prob[right_[j]] = lp + log_sigmoid(z[j]);
+    }
+
+    std::memcpy(logits, log_prob, C * sizeof(float));
+}
+
+void HierarchicalSoftmax::node_gradients(
+    const float* z,
+    const float* dlogits,
+    float* dz) const
+{
+    int C = num_classes_;
+    float* sum = ensure_size(scratch().nodes, 2 * C - 1);
+
+    std::memcpy(sum, dlogits, C * sizeof(float));
+
+    // d log sigmoid(z) / dz = 1 - sigmoid(z) for the leaves on the right,
+    // d log sigmoid(-z) / dz = -sigmoid(z) for those on the left; sum[]
+    // collects dlogits per subtree bottom-up
+    for (int j = 0; j < C - 1; ++j) {
+        float l = sum[left_[j]];
+        float r = sum[right_[j]];
+        float s = sigmoid(z[j]);
+
+        sum[C + j] = l + r;
+        dz[j] = r * (1.0f - s) - l * s;
+    }
+}
+
+void HierarchicalSoftmax::forward(
+    const float* input,
+    float* logits) const
+{
+    int nodes = num_nodes();
+    float* z = ensure_size(scratch().z, nodes);
+
+    for (int j = 0; j < nodes; ++j)
+        z[j] = vec_dot(&weights_[static_cast<size_t>(j) * input_dim_],
+                       input, input_dim_);
+
+    leaf_log_probs(z, logits);
+}
+
+void HierarchicalSoftmax::backward_sgd(
+    const float* input,
+    const float* dlogits,
+    float* dinput,
+    float learning_rate)
+{
+    Scratch& s = scratch();
+    int nodes = num_nodes();
+    float* z = ensure_size(s.z, nodes);
+    float* dz = ensure_size(s.dz, nodes);
+
+    for (int j = 0; j < nodes; ++j)
+        z[j] = vec_dot(&weights_[static_cast<size_t>(j) * input_dim_],
+                       input, input_dim_);
+
+    node_gradients(z, dlogits, dz);
+
+    if (dinput)
+        std::memset(dinput, 0, input_dim_ * sizeof(float));
+
+    for (int j = 0; j < nodes; ++j) {
+        float* row = &weights_[static_cast<size_t>(j) * input_dim_];
+        float step = -(learning_rate * dz[j]);
+
+        if (dinput)
+            vec_axpy_update(dz[j], step, input, row, dinput, input_dim_);
+        else
+            vec_axpy(step, input, row, input_dim_);
+    }
+}
+
+void HierarchicalSoftmax::forward_batch(
+    const float* X,
+    int n,
+    float* logits) const
+{
+    if (n <= 0) return;
+
+    int nodes = num_nodes();
+    float* Z = ensure_size(scratch().z, static_cast<size_t>(n) * nodes);
+
+    if (nodes > 0)
+        gemm_nt(n, nodes, input_dim_,
+                X, input_dim_,
+                weights_.data(), input_dim_,
+                Z, nodes);
+
+    for (int i = 0; i < n; ++i)
+        leaf_log_probs(Z + static_cast<size_t>(i) * nodes,
+                       logits + static_cast<size_t>(i) * num_classes_);
+}
+
+void HierarchicalSoftmax::backward_batch(
+    const float* X,
+    int n,
+    const float* dlogits,
+    float* dX,
+    float learning_rate)
+{
+    if (n <= 0) return;
+
+    if (dX)
+        std::memset(dX, 0,
+                    static_cast<size_t>(n) * input_dim_ * sizeof(float));
+
+    int nodes = num_nodes();
+    if (nodes == 0) return;
+
+    Scratch& s = scratch();
+    size_t zn = static_cast<size_t>(n) * nodes;
+    float* Z = ensure_size(s.z, zn);
+    float* dZ = ensure_size(s.dz, zn);
+
+    gemm_nt(n, nodes, input_dim_,
+            X, input_dim_,
+            weights_.data(), input_dim_,
+            Z, nodes);
+
+    for (int i = 0; i < n; ++i)
+        node_gradients(Z + static_cast<size_t>(i) * nodes,
+                       dlogits + static_cast<size_t>(i) * num_classes_,
+                       dZ + static_cast<size_t>(i) * nodes);
+
+    // dX = dZ W before the step
+    if (dX)
+        gemm_nn_acc(n, input_dim_, nodes, 1.0f,
+                    dZ, nodes,
+                    weights_.data(), input_dim_,
+                    dX, input_dim_);
+
+    // W += step * dZ^T X
+    float* dZ_t = ensure_size(s.t, zn);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < nodes; ++j)
+            dZ_t[static_cast<size_t>(j) * n + i] =
+                dZ[static_cast<size_t>(i) * nodes + j];
+
+    gemm_nn_acc(nodes, input_dim_, n, -learning_rate / n,
+                dZ_t, n,
+                X, input_dim_,
+                weights_.data(), input_dim_);
+}
+
+float HierarchicalSoftmax::train_sample(
+    const float* input,
+    int label,
+    float* dinput,
+    float learning_rate,
+    float* /*logits*/)
+{
+    if (dinput)
+        std::memset(dinput, 0, input_dim_ * sizeof(float));
+
+    const int* nodes = path_nodes(label);
+    const uint8_t* codes = path_codes(label);
+    float loss = 0.0f;
+
+    // Path nodes are distinct, so dinput still sees pre-step weights
+    for (int p = 0; p < depth(label); ++p) {
+        float* row = &weights_[static_cast<size_t>(nodes[p]) * input_dim_];
+        float z = vec_dot(row, input, input_dim_);
+        float g = sigmoid(z) - codes[p];
+
+        loss -= log_sigmoid(codes[p] ? z : -z);
+
+        if (dinput)
+            vec_axpy_update(g, -(learning_rate * g), input, row, dinput,
+                            input_dim_);
+        else
+            vec_axpy(-(learning_rate * g), input, row, input_dim_);
+    }
+
+    return loss;
+}
+
+float HierarchicalSoftmax::train_batch(
+    const float* X,
+    int n,
+    const int* labels,
+    float* dX,
+    float learning_rate,
+    float* /*logits*/)
+{
+    if (n <= 0) return 0.0f;
+
+    size_t steps = 0;
+    for (int i = 0; i < n; ++i)
+        steps += depth(labels[i]);
+
+    float* g = ensure_size(scratch().g, steps);
+    float loss = 0.0f;
+
+    // Pass 1: every gradient and dX against the weights before the step
+    float* gi = g;
+    for (int i = 0; i < n; ++i) {
+        const float* x = X + static_cast<size_t>(i) * input_dim_;
+        float* dx = dX ? dX + static_cast<size_t>(i) * input_dim_ : nullptr;
+        const int* nodes = path_nodes(labels[i]);
+        const uint8_t* codes = path_codes(labels[i]);
+
+        if (dx)
+            std::memset(dx, 0, input_dim_ * sizeof(float));
+
+        for (int p = 0; p < depth(labels[i]); ++p) {
+            const float* row =
+                &weights_[static_cast<size_t>(nodes[p]) * input_dim_];
+            float z = vec_dot(row, x, input_dim_);
+
+            gi[p] = sigmoid(z) - codes[p];
+            loss -= log_sigmoid(codes[p] ? z : -z);
+
+            if (dx)
+                vec_axpy(gi[p], row, dx, input_dim_);
+        }
+
+        gi += depth(labels[i]);
+    }
+
+    // Pass 2: one mean-gradient step on the touched rows
+    float step = -learning_rate / n;
+
+    gi = g;
+    for (int i = 0; i < n; ++i) {
+        const float* x = X + static_cast<size_t>(i) * input_dim_;
+        const int* nodes = path_nodes(labels[i]);
+
+        for (int p = 0; p < depth(labels[i]); ++p)
+            vec_axpy(step * gi[p], x,
+                     &weights_[static_cast<size_t>(nodes[p]) * input_dim_],
+                     input_dim_);
+
+        gi += depth(labels[i]);
+    }
+
+    return loss;
+}
+
+Prediction HierarchicalSoftmax::predict_top1(const float* input) const
+{
+    int node = 2 * num_classes_ - 2;
+    float log_prob = 0.0f;
+
+    while (node >= num_classes_) {
+        int j = node - num_classes_;
+        float z = vec_dot(&weights_[static_cast<size_t>(j) * input_dim_],
+                          input, input_dim_);
+
+        if (z >= 0.0f) {
+            node = right_[j];
+            log_prob += log_sigmoid(z);
+        } else {
+            node = left_[j];
+            log_prob += log_sigmoid(-z);
+        }
+    }
+
+    return {node, std::exp(log_prob)};
+}
+
+void HierarchicalSoftmax::predict_topk(
+    const float* input,
+    int k,
+    Prediction* out) const
+{
+    if (k <= 0 || k > num_classes_)
+        throw std::invalid_argument("k must be in [1, num_classes]");
+
+    thread_local std::vector<Candidate> heap;
+    heap.clear();
+    heap.push_back({0.0f, 2 * num_classes_ - 2});
+
+    int found = 0;
+
+    while (found < k) {
+        std::pop_heap(heap.begin(), heap.end(), worse);
+        Candidate best = heap.back();
+        heap.pop_back();
+
+        if (best.node < num_classes_) {
+            out[found++] = {best.node, std::exp(best.log_prob)};
+            continue;
+        }
+
+        int j = best.node - num_classes_;
+        float z = vec_dot(&weights_[static_cast<size_t>(j) * input_dim_],
+                          input, input_dim_);
+
+        heap.push_back({best.log_prob + log_sigmoid(-z), left_[j]});
+        std::push_heap(heap.begin(), heap.end(), worse);
+        heap.push_back({best.log_prob + log_sigmoid(z), right_[j]});
+        std::push_heap(heap.begin(), heap.end(), worse);
+    }
+}
+
+int HierarchicalSoftmax::predict_label(const float* input) const
+{
+    Prediction best;
+    predict_topk(input, 1, &best);
+    return best.label;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "iclassifier.h"
+
+#include <cstdint>
+#include <vector>
+
+// Hierarchical softmax head for large label spaces. Labels are the leaves
+// of a Huffman tree built from their training frequencies, and each of the
+// C - 1 internal nodes holds one input_dim vector w_n. Going right at n has
+// probability sigmoid(w_n . x), so
+//
+//   log p(c | x) = sum over n on the path to c of log sigmoid(+-w_n . x)
+//
+// and the leaf probabilities always sum to one. Frequent labels sit near
+// the root, so the expected path length is about the label entropy in bits.
+//
+// train_sample / train_batch only touch the nodes on the label's path:
+// O(depth * input_dim) per sample instead of O(C * input_dim). forward
+// returns every leaf's log p (so softmax(forward) is the exact
+// distribution), and the generic backward_sgd / backward_batch take
+// gradients of those log-probs; both cost O(C * input_dim) like a dense
+// head and are there for interface completeness, not for training.
+//
+// There is no bias: a constant input feature plays that role if wanted.
+// Node vectors start at zero, as in fastText.
+class HierarchicalSoftmax : public IClassifier {
+public:
+    // label_counts[c] is the training frequency of label c; C is its size.
+    // Throws std::invalid_argument if input_dim <= 0, there are no labels,
+    // or a count is negative.
+    HierarchicalSoftmax(int input_dim, const std::vector<int64_t>& label_counts);
+
+    // logits[c] = log p(c | input)
+    void forward(const float* input, float* logits) const override;
+
+    void backward_sgd(const float* input,
+                      const float* dlogits,
+                      float* dinput,
+                      float learning_rate) override;
+
+    // Z = X W^T in one GEMM, then the per-row tree walks.
+    void forward_batch(const float* X, int n, float* logits) const override;
+
+    void backward_batch(const float* X,
+                        int n,
+                        const float* dlogits,
+                        float* dX,
+                        float learning_rate) override;
+
+    // Binary logistic loss at each node on the label's path; logits unused.
+    float train_sample(const float* input,
+                       int label,
+                       float* dinput,
+                       float learning_rate,
+                       float* logits) override;
+
+    float train_batch(const float* X,
+                      int n,
+                      const int* labels,
+                      float* dX,
+                      float learning_rate,
+                      float* logits) override;
+
+    // Greedy descent, taking the likelier child at every node: depth dot
+    // products, but not guaranteed to find the most probable label.
+    Prediction predict_top1(const float* input) const;
+
+    // Exact top k, best first, by best-first search over the tree. A
+    // child's log p is never above its parent's, so once a leaf is the best
+    // open node no unexpanded subtree can beat it. Expands only the nodes
+    // whose log p exceeds the k-th answer's. Throws std::invalid_argument
+    // unless 0 < k <= num_classes.
+    void predict_topk(const float* input,
+                      int k,
+                      Prediction* out) const override;
+
+    // Exact top-1 (predict_topk with k = 1)
+    int predict_label(const float* input) const override;
+
+    int input_dim() const noexcept override { return input_dim_; }
+    int num_classes() const noexcept override { return num_classes_; }
+    int num_nodes() const noexcept { return num_classes_ - 1; }
+
+    // Multiply-adds of a full forward(); training touches only depth(c)
+    // rows of input_dim.
+    size_t forward_flops() const noexcept override {
+        return static_cast<size_t>(num_nodes()) * input_dim_;
+    }
+
+    // Path of label c: internal node rows, root first, and the branch
+    // taken at each (1 = right).
+    int depth(int label) const noexcept {
+        return path_offsets_[label + 1] - path_offsets_[label];
+    }
+    const int* path_nodes(int label) const noexcept {
+        return &path_nodes_[path_offsets_[label]];
+    }
+    const uint8_t* path_codes(int label) const noexcept {
+        return &path_codes_[path_offsets_[label]];
+    }
+
+    // Row-major node vectors (num_nodes x input_dim)
+    const float* weights() const noexcept { return weights_.data(); }
+
+    // Overwrites all node vectors, e.g. when loading a saved model.
+    void load_parameters(const float* weights);
+
+private:
+    // logits[c] = log p(c) from the node scores z (num_nodes)
+    void leaf_log_probs(const float* z, float* logits) const;
+
+    // dL/dz for every node, given dL/dlogits over the leaf log-probs
+    void node_gradients(const float* z, const float* dlogits, float* dz) const;
+
+    int input_dim_;
+    int num_classes_;
+
+    // Node ids: leaves 0..C-1, internal nodes C..2C-2 with the root last;
+    // children always have smaller ids than their parent. Internal node
+    // C + j owns weight row j.
+    std::vector<int> left_;
+    std::vector<int> right_;
+
+    std::vector<int> path_offsets_;
+    std::vector<int> path_nodes_;
+    std::vector<uint8_t> path_codes_;
+
+    std::vector<float> weights_;
+};
@@ -0,0 +1,99 @@
+#include "iclassifier.h"
+#include "linear_classifier.h"
+#include "lowrank_classifier.h"
+#include "config/model_config.h"
+#include "simd/kernels.h"
+#include "topk.h"
+
+#include <stdexcept>
+#include <vector>
+
+float IClassifier::train_sample(
+    const float* input,
+    int label,
+    float* dinput,
+    float learning_rate,
+    float* logits)
+{
+    forward(input, logits);
+
+    // dlogits = probs - onehot, in place
+    float loss = softmax_xent(1, num_classes(), logits, 0, &label, logits, 0);
+
+    backward_sgd(input, logits, dinput, learning_rate);
+
+    return loss;
+}
+
+float IClassifier::train_batch(
+    const float* X,
+    int n,
+    const int* labels,
+    float* dX,
+    float learning_rate,
+    float* logits)
+{
+    int classes = num_classes();
+
+    forward_batch(X, n, logits);
+
+    float loss = softmax_xent(n, classes, logits, classes, labels,
+                              logits, classes);
+
+    backward_batch(X, n, logits, dX, learning_rate);
+
+    return loss;
+}
+
+namespace {
+
+float* logits_scratch(int n)
+{
+    thread_local std::vector<float> logits;
+    if (logits.size() < static_cast<size_t>(n))
+        logits.resize(n);
+    return logits.data();
+}
+
+}  // namespace
+
+void IClassifier::predict_topk(
+    const float* input,
+    int k,
+    Prediction* out) const
+{
+    int classes = num_classes();
+
+    if (k <= 0 || k > classes)
+        throw std::invalid_argument("k must be in [1, num_classes]");
+
+    float* logits = logits_scratch(classes);
+    forward(input, logits);
+    select_topk(logits, classes, k, out);
+}
+
+int IClassifier::predict_label(const float* input) const
+{
+    float* logits = logits_scratch(num_classes());
+    forward(input, logits);
+    return argmax(logits, num_classes());
+}
+
+std::unique_ptr<IClassifier> make_classifier(
+    const ModelConfig& config,
+    int num_classes)
+{
+    switch (config.projection_mode) {
+    case ProjectionMode::DENSE:
+        return std::make_unique<LinearClassifier>(
+            config.embedding_dim, num_classes, config.seed);
+    case ProjectionMode::LOWRANK:
+        return std::make_unique<LowRankClassifier>(
+            config.embedding_dim, num_classes, config.projection_rank,
+            config.seed);
+    default:
+        // SPARSE and HYBRID read bucket features: make_sparse_classifier
+        throw std::invalid_argument(
+            "projection_mode has no dense-input classifier head");
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "prediction.h"
+
+#include <cstddef>
+#include <memory>
+
+struct ModelConfig;
+
+// Classifier head: sentence vector (input_dim) -> logits (num_classes).
+// The const forward paths may run on many threads at once; the SGD steps
+// may run concurrently without locking (Hogwild), but not alongside a
+// batched step on the same head.
+class IClassifier {
+public:
+    virtual ~IClassifier() = default;
+
+    virtual void forward(const float* input, float* logits) const = 0;
+
+    // SGD step given dL/dlogits. dinput, when not null, receives dL/dinput
+    // computed with the weights from before the update.
+    virtual void backward_sgd(const float* input,
+                              const float* dlogits,
+                              float* dinput,
+                              float learning_rate) = 0;
+
+    // Batched variants over n row-major inputs (n x input_dim) and logits
+    // (n x num_classes). backward_batch applies one step with the mean
+    // gradient; dX is optional and uses the weights from before the step.
+    virtual void forward_batch(const float* X, int n, float* logits) const = 0;
+    virtual void backward_batch(const float* X,
+                                int n,
+                                const float* dlogits,
+                                float* dX,
+                                float learning_rate) = 0;
+
+    // One SGD step of the head's training loss on (input, label); returns
+    // the loss. logits is num_classes floats of scratch. The default is
+    // softmax cross-entropy through forward() and backward_sgd(); heads
+    // with a cheaper loss of their own (hierarchical softmax) override it.
+    virtual float train_sample(const float* input,
+                               int label,
+                               float* dinput,
+                               float learning_rate,
+                               float* logits);
+
+    // Batched train_sample with one mean-gradient step; logits is
+    // n x num_classes scratch. Returns the summed loss.
+    virtual float train_batch(const float* X,
+                              int n,
+                              const int* labels,
+                              float* dX,
+                              float learning_rate,
+                              float* logits);
+
+    // Top k classes of one input, best first (lower label on ties), with
+    // softmax probabilities. The default runs forward() into per-thread
+    // scratch and select_topk (topk.h): a k-entry heap plus one shifted
+    // exp-sum for the normalizer, no full softmax. Throws std::invalid_argument unless
+    // 0 < k <= num_classes.
+    virtual void predict_topk(const float* input, int k, Prediction* out) const;
+
+    // Most likely class without computing any probability, so no exp.
+    virtual int predict_label(const float* input) const;
+
+    virtual int input_dim() const noexcept = 0;
+    virtual int num_classes() const noexcept = 0;
+
+    // Multiply-adds of one forward(), excluding the bias
+    virtual size_t forward_flops() const noexcept = 0;
+};
+
+// DENSE or LOWRANK head for config, with input_dim = config.embedding_dim.
+// Throws std::invalid_argument for SPARSE and HYBRID, whose head takes
+// bucket features (make_sparse_classifier in sparse_classifier.h).
+std::unique_ptr<IClassifier> make_classifier(const ModelConfig& config,
+                                             int num_classes);
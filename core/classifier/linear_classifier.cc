@@ -1,7 +1,13 @@
 #include "linear_classifier.h"
 #include "utils/rng.h"
+#include "simd/kernels.h"
+#include "loss/negative_sampling.h"
+#include "loss/softmax.h"
+#include "topk.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <stdexcept>
 
 LinearClassifier::LinearClassifier(
     int input_dim,
@@ -23,6 +29,27 @@ LinearClassifier::LinearClassifier(
         b = 0.0f;
 }
 
+LinearClassifier::LinearClassifier(
+    int input_dim,
+    int num_classes,
+    const float* weights,
+    const float* bias)
+    : input_dim_(input_dim),
+      num_classes_(num_classes),
+      weights_(weights, weights + static_cast<size_t>(num_classes) * input_dim),
+      bias_(bias, bias + num_classes)
+{}
+
+void LinearClassifier::load_parameters(
+    const float* weights,
+    const float* bias)
+{
+    std::memcpy(weights_.data(), weights,
+                weights_.size() * sizeof(float));
+    std::memcpy(bias_.data(), bias,
+                bias_.size() * sizeof(float));
+}
+
 void LinearClassifier::forward(
     const float* input,
     float* logits) const
@@ -32,12 +59,8 @@ void LinearClassifier::forward(
         const float* row =
             &weights_[c * input_dim_];
 
-        float sum = bias_[c];
-
-        for (int j = 0; j < input_dim_; ++j)
-            sum += row[j] * input[j];
-
-        logits[c] = sum;
+        logits[c] = bias_[c] +
+                    vec_dot(row, input, input_dim_);
     }
 }
 
@@ -60,16 +83,280 @@ void LinearClassifier::backward_sgd(
         float* row =
             &weights_[c * input_dim_];
 
-        for (int j = 0; j < input_dim_; ++j) {
+        // SGD update; dinput reads the row before it changes
+        float step = -(learning_rate * grad_c);
+
+        if (dinput)
+            vec_axpy_update(grad_c, step, input,
+                            row, dinput, input_dim_);
+        else
+            vec_axpy(step, input, row, input_dim_);
+
+        bias_[c] -= learning_rate * grad_c;
+    }
+}
+
+void LinearClassifier::forward_batch(
+    const float* X,
+    int n,
+    float* logits) const
+{
+    gemm_nt(n, num_classes_, input_dim_,
+            X, input_dim_,
+            weights_.data(), input_dim_,
+            logits, num_classes_);
+
+    for (int i = 0; i < n; ++i) {
+        float* out = logits + i * num_classes_;
+        for (int c = 0; c < num_classes_; ++c)
+            out[c] += bias_[c];
+    }
+}
+
+void LinearClassifier::backward_batch(
+    const float* X,
+    int n,
+    const float* dlogits,
+    float* dX,
+    float learning_rate)
+{
+    if (n <= 0) return;
+
+    // dX = dlogits * W, before W changes
+    if (dX) {
+        std::memset(dX, 0,
+                    static_cast<size_t>(n) * input_dim_ * sizeof(float));
+        gemm_nn_acc(n, input_dim_, num_classes_, 1.0f,
+                    dlogits, num_classes_,
+                    weights_.data(), input_dim_,
+                    dX, input_dim_);
+    }
+
+    scratch_dlogits_t_.resize(static_cast<size_t>(num_classes_) * n);
+
+    for (int i = 0; i < n; ++i)
+        for (int c = 0; c < num_classes_; ++c)
+            scratch_dlogits_t_[c * n + i] = dlogits[i * num_classes_ + c];
+
+    float step = -learning_rate / n;
+
+    // W += step * dlogits^T * X
+    gemm_nn_acc(num_classes_, input_dim_, n, step,
+                scratch_dlogits_t_.data(), n,
+                X, input_dim_,
+                weights_.data(), input_dim_);
+
+    for (int c = 0; c < num_classes_; ++c) {
+        const float* g = &scratch_dlogits_t_[c * n];
+        float sum = 0.0f;
+        for (int i = 0; i < n; ++i)
+            sum += g[i];
+        bias_[c] += step * sum;
+    }
+}
+
+void LinearClassifier::predict_topk(
+    const float* input,
+    int k,
+    Prediction* out) const
+{
+    if (k <= 0 || k > num_classes_)
+        throw std::invalid_argument("k must be in [1, num_classes]");
+
+    TopKHeap heap(out, k);
+
+    // Logits in stack blocks of kBlock classes; sum = sum exp(z - max_val)
+    // over the blocks so far, rescaled when a block raises the max
+    constexpr int kBlock = 64;
+    float z[kBlock];
+    float max_val = -INFINITY;
+    float sum = 0.0f;
+
+    for (int c0 = 0; c0 < num_classes_; c0 += kBlock) {
 
-            if (dinput)
-                dinput[j] += row[j] * grad_c;
+        int len = std::min(kBlock, num_classes_ - c0);
 
-            // SGD update
-            row[j] -= learning_rate *
-                      grad_c * input[j];
+        for (int j = 0; j < len; ++j) {
+            int c = c0 + j;
+            z[j] = bias_[c] +
+                   vec_dot(&weights_[c * input_dim_], input, input_dim_);
+            heap.push(c, z[j]);
         }
 
+        float block_max = vec_max(z, len);
+        if (block_max > max_val) {
+            sum *= std::exp(max_val - block_max);
+            max_val = block_max;
+        }
+        sum += vec_exp_sum(z, max_val, nullptr, len);
+    }
+
+    heap.finish();
+
+    for (int j = 0; j < k; ++j)
+        out[j].probability = std::exp(out[j].probability - max_val) / sum;
+}
+
+int LinearClassifier::predict_label(const float* input) const
+{
+    int best = 0;
+    float best_z = -INFINITY;
+
+    for (int c = 0; c < num_classes_; ++c) {
+
+        float z = bias_[c] +
+                  vec_dot(&weights_[c * input_dim_], input, input_dim_);
+
+        if (z > best_z) {
+            best_z = z;
+            best = c;
+        }
+    }
+
+    return best;
+}
+
+void LinearClassifier::set_negative_sampler(
+    std::shared_ptr<const NegativeSampler> sampler)
+{
+    if (sampler && sampler->num_classes() != num_classes_)
+        throw std::invalid_argument(
+            "negative sampler class count does not match the classifier");
+
+    sampler_ = std::move(sampler);
+}
+
+namespace {
+
+// Per-thread rows and gradients of the sampled steps
+struct SampledScratch {
+    std::vector<int> rows;     // label, then its negatives, per sample
+    std::vector<float> g;      // sigmoid(z) - target per row
+};
+
+SampledScratch& sampled_scratch()
+{
+    thread_local SampledScratch s;
+    return s;
+}
+
+}  // namespace
+
+float LinearClassifier::train_sample(
+    const float* input,
+    int label,
+    float* dinput,
+    float learning_rate,
+    float* logits)
+{
+    if (!sampler_)
+        return IClassifier::train_sample(input, label, dinput,
+                                         learning_rate, logits);
+
+    int k = sampler_->negatives();
+
+    std::vector<int>& rows = sampled_scratch().rows;
+    rows.resize(k + 1);
+    rows[0] = label;
+    sampler_->sample(label, &rows[1]);
+
+    if (dinput) {
+        std::memset(dinput, 0,
+                    input_dim_ * sizeof(float));
+    }
+
+    float loss = 0.0f;
+
+    // -log sigmoid(z_label) - sum log sigmoid(-z_neg); as in word2vec, a
+    // row drawn twice is read again after its first update
+    for (int j = 0; j <= k; ++j) {
+
+        int c = rows[j];
+        float* row = &weights_[c * input_dim_];
+
+        float z = bias_[c] + vec_dot(row, input, input_dim_);
+        float grad_c = sigmoid(z) - (j == 0 ? 1.0f : 0.0f);
+
+        loss -= log_sigmoid(j == 0 ? z : -z);
+
+        float step = -(learning_rate * grad_c);
+
+        if (dinput)
+            vec_axpy_update(grad_c, step, input,
+                            row, dinput, input_dim_);
+        else
+            vec_axpy(step, input, row, input_dim_);
+
         bias_[c] -= learning_rate * grad_c;
     }
-}
\ No newline at end of file
+
+    return loss;
+}
+
+float LinearClassifier::train_batch(
+    const float* X,
+    int n,
+    const int* labels,
+    float* dX,
+    float learning_rate,
+    float* logits)
+{
+    if (!sampler_)
+        return IClassifier::train_batch(X, n, labels, dX,
+                                        learning_rate, logits);
+
+    if (n <= 0) return 0.0f;
+
+    int k1 = sampler_->negatives() + 1;
+
+    SampledScratch& s = sampled_scratch();
+    s.rows.resize(static_cast<size_t>(n) * k1);
+    s.g.resize(static_cast<size_t>(n) * k1);
+
+    float loss = 0.0f;
+
+    // Pass 1: draw, score and take dX against the weights before the step
+    for (int i = 0; i < n; ++i) {
+
+        const float* x = X + static_cast<size_t>(i) * input_dim_;
+        int* rows = &s.rows[static_cast<size_t>(i) * k1];
+        float* g = &s.g[static_cast<size_t>(i) * k1];
+
+        rows[0] = labels[i];
+        sampler_->sample(labels[i], rows + 1);
+
+        float* dx = dX ? dX + static_cast<size_t>(i) * input_dim_ : nullptr;
+        if (dx)
+            std::memset(dx, 0, input_dim_ * sizeof(float));
+
+        for (int j = 0; j < k1; ++j) {
+            const float* row = &weights_[rows[j] * input_dim_];
+            float z = bias_[rows[j]] + vec_dot(row, x, input_dim_);
+
+            g[j] = sigmoid(z) - (j == 0 ? 1.0f : 0.0f);
+            loss -= log_sigmoid(j == 0 ? z : -z);
+
+            if (dx)
+                vec_axpy(g[j], row, dx, input_dim_);
+        }
+    }
+
+    // Pass 2: one mean-gradient step on the touched rows
+    float step = -learning_rate / n;
+
+    for (int i = 0; i < n; ++i) {
+
+        const float* x = X + static_cast<size_t>(i) * input_dim_;
+
+        for (int j = 0; j < k1; ++j) {
+            size_t p = static_cast<size_t>(i) * k1 + j;
+            int c = s.rows[p];
+
+            vec_axpy(step * s.g[p], x, &weights_[c * input_dim_],
+                     input_dim_);
+            bias_[c] += step * s.g[p];
+        }
+    }
+
+    return loss;
+}
@@ -1,23 +1,82 @@
 #pragma once
 
+#include "iclassifier.h"
+
 #include <vector>
 #include <cstdint>
+#include <memory>
+
+class NegativeSampler;
 
-class LinearClassifier {
+// Dense head: logits = W x + b with W num_classes x input_dim.
+class LinearClassifier : public IClassifier {
     public:
         LinearClassifier(int input_dim, int num_classes, uint64_t seed);
 
+        // Copies the given num_classes x input_dim weights and num_classes
+        // biases, e.g. from a loaded model file; no random init.
+        LinearClassifier(int input_dim, int num_classes,
+                         const float* weights, const float* bias);
+
         
-        void forward(const float* input, float* logits) const;
+        void forward(const float* input, float* logits) const override;
+
+        void backward_sgd(const float* input,  const float* dlogits, float* dinput, float learning_rate) override;
+
+        // Batched variants over n row-major inputs (n x input_dim) and logits
+        // (n x num_classes). Each weights row is reused across the batch.
+        void forward_batch(const float* X, int n, float* logits) const override;
+
+        // Accumulates gradients over the batch and applies one SGD step with
+        // the mean gradient. dX (n x input_dim) is optional and computed with
+        // the weights from before the update.
+        void backward_batch(const float* X, int n, const float* dlogits, float* dX, float learning_rate) override;
+
+        // One pass over the rows: logits are computed in 64-class stack
+        // blocks that feed the k-entry heap and an online max-shifted
+        // exp-sum, so no num_classes-sized logits buffer is written.
+        void predict_topk(const float* input, int k, Prediction* out) const override;
+
+        // Running argmax over the rows; no exp, no buffer.
+        int predict_label(const float* input) const override;
 
-        void backward_sgd(const float* input,  const float* dlogits, float* dinput, float learning_rate);
+        // Softmax cross-entropy by default; with a negative sampler, the
+        // sampled binary-logistic loss over the label's row and
+        // sampler->negatives() drawn rows, so a step touches K + 1 rows
+        // instead of num_classes.
+        float train_sample(const float* input, int label, float* dinput, float learning_rate, float* logits) override;
 
-        int input_dim() const noexcept { return input_dim_; }
-        int num_classes() const noexcept { return num_classes_; }
+        float train_batch(const float* X, int n, const int* labels, float* dX, float learning_rate, float* logits) override;
+
+        // Switches train_sample / train_batch to negative sampling; nullptr
+        // restores the full softmax. forward() is unchanged, so the trained
+        // head still ranks all classes. Throws std::invalid_argument if the
+        // sampler's class count differs.
+        void set_negative_sampler(std::shared_ptr<const NegativeSampler> sampler);
+        const NegativeSampler* negative_sampler() const noexcept { return sampler_.get(); }
+
+        int input_dim() const noexcept override { return input_dim_; }
+        int num_classes() const noexcept override { return num_classes_; }
+
+        size_t forward_flops() const noexcept override {
+            return static_cast<size_t>(num_classes_) * input_dim_;
+        }
+
+        // Row-major num_classes x input_dim weights and num_classes biases
+        const float* weights() const noexcept { return weights_.data(); }
+        const float* bias() const noexcept { return bias_.data(); }
+
+        // Overwrites all parameters, e.g. when loading a saved model.
+        void load_parameters(const float* weights, const float* bias);
     private:
         int input_dim_;
         int num_classes_;
 
         std::vector<float> weights_;
         std::vector<float> bias_;
+
+        // dlogits transposed (num_classes x n) for the weight update GEMM
+        std::vector<float> scratch_dlogits_t_;
+
+        std::shared_ptr<const NegativeSampler> sampler_;
 };
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "lowrank_classifier.h"
+#include "utils/rng.h"
+#include "simd/kernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Per-thread scratch shared by every head on the thread. Grows, never
+// shrinks, so steady-state calls do not allocate.
+struct Scratch {
+    std::vector<float> h;      // V x, or H = X V^T (n x rank)
+    std::vector<float> dh;     // dL/dh, or dH (n x rank)
+    std::vector<float> t0;     // transposes for the batched updates
+    std::vector<float> t1;
+};
+
+Scratch& scratch()
+{
+    thread_local Scratch s;
+    return s;
+}
+
+float* ensure_size(std::vector<float>& v, size_t n)
+{
+    if (v.size() < n)
+        v.resize(n);
+    return v.data();
+}
+
+// out (cols x rows) = in (rows x cols) transposed
+void transpose(const float* in, int rows, int cols, float* out)
+{
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            out[static_cast<size_t>(j) * rows + i] =
+                in[static_cast<size_t>(i) * cols + j];
+}
+
+}  // namespace
+
+LowRankClassifier::LowRankClassifier(
+    int input_dim,
+    int num_classes,
+    int rank,
+    uint64_t seed)
+    : input_dim_(input_dim),
+      num_classes_(num_classes),
+      rank_(rank)
+{
+    if (input_dim <= 0 || num_classes <= 0 || rank <= 0)
+        throw std::invalid_argument(
+            "input_dim, num_classes and rank must be > 0");
+
+    u_.resize(static_cast<size_t>(num_classes) * rank);
+    v_.resize(static_cast<size_t>(rank) * input_dim);
+    bias_.assign(num_classes, 0.0f);
+
+    RNG rng(seed);
+
+    // Same fan-in scaling as the dense head, per factor
+    float v_bound = std::sqrt(1.0f / input_dim_);
+    float u_bound = std::sqrt(1.0f / rank_);
+
+    for (auto& w : v_)
+        w = rng.uniform(-v_bound, v_bound);
+    for (auto& w : u_)
+        w = rng.uniform(-u_bound, u_bound);
+}
+
+void LowRankClassifier::load_parameters(
+    const float* u,
+    const float* v,
+    const float* bias)
+{
+    std::memcpy(u_.data(), u, u_.size() * sizeof(float));
+    std::memcpy(v_.data(), v, v_.size() * sizeof(float));
+    std::memcpy(bias_.data(), bias, bias_.size() * sizeof(float));
+}
+
+void LowRankClassifier::forward(
+    const float* input,
+    float* logits) const
+{
+    float* h = ensure_size(scratch().h, rank_);
+
+    for (int j = 0; j < rank_; ++j)
+        h[j] = vec_dot(&v_[static_cast<size_t>(j) * input_dim_],
+                       input, input_dim_);
+
+    for (int c = 0; c < num_classes_; ++c)
+        logits[c] = bias_[c] +
+                    vec_dot(&u_[static_cast<size_t>(c) * rank_], h, rank_);
+}
+
+void LowRankClassifier::backward_sgd(
+    const float* input,
+    const float* dlogits,
+    float* dinput,
+    float learning_rate)
+{
+    Scratch& s = scratch();
+    float* h = ensure_size(s.h, rank_);
+    float* dh = ensure_size(s.dh, rank_);
+
+    for (int j = 0; j < rank_; ++j)
+        h[j] = vec_dot(&v_[static_cast<size_t>(j) * input_dim_],
+                       input, input_dim_);
+
+    // dh = U^T dlogits with U before its step, then U -= lr dlogits h^T
+    std::memset(dh, 0, rank_ * sizeof(float));
+
+    for (int c = 0; c < num_classes_; ++c) {
+        float grad_c = dlogits[c];
+        vec_axpy_update(grad_c, -(learning_rate * grad_c), h,
+                        &u_[static_cast<size_t>(c) * rank_], dh, rank_);
+        bias_[c] -= learning_rate * grad_c;
+    }
+
+    // dinput = V^T dh with V before its step, then V -= lr dh x^T
+    if (dinput)
+        std::memset(dinput, 0, input_dim_ * sizeof(float));
+
+    for (int j = 0; j < rank_; ++j) {
+        float* row = &v_[static_cast<size_t>(j) * input_dim_];
+        float step = -(learning_rate * dh[j]);
+
+        if (dinput)
+            vec_axpy_update(dh[j], step, input, row, dinput, input_dim_);
+        else
+            vec_axpy(step, input, row, input_dim_);
+    }
+}
+
+void LowRankClassifier::forward_batch(
+    const float* X,
+    int n,
+    float* logits) const
+{
+    if (n <= 0) return;
+
+    float* H = ensure_size(scratch().h, static_cast<size_t>(n) * rank_);
+
+    gemm_nt(n, rank_, input_dim_,
+            X, input_dim_,
+            v_.data(), input_dim_,
+            H, rank_);
+
+    gemm_nt(n, num_classes_, rank_,
+            H, rank_,
+            u_.data(), rank_,
+            logits, num_classes_);
+
+    for (int i = 0; i < n; ++i) {
+        float* out = logits + static_cast<size_t>(i) * num_classes_;
+        for (int c = 0; c < num_classes_; ++c)
+            out[c] += bias_[c];
+    }
+}
+
+void LowRankClassifier::backward_batch(
+    const float* X,
+    int n,
+    const float* dlogits,
+    float* dX,
+    float learning_rate)
+{
+    if (n <= 0) return;
+
+    Scratch& s = scratch();
+    size_t hn = static_cast<size_t>(n) * rank_;
+    float* H = ensure_size(s.h, hn);
+    float* dH = ensure_size(s.dh, hn);
+
+    gemm_nt(n, rank_, input_dim_,
+            X, input_dim_,
+            v_.data(), input_dim_,
+            H, rank_);
+
+    // dH = dlogits U and dX = dH V, both before the step
+    std::memset(dH, 0, hn * sizeof(float));
+    gemm_nn_acc(n, rank_, num_classes_, 1.0f,
+                dlogits, num_classes_,
+                u_.data(), rank_,
+                dH, rank_);
+
+    if (dX) {
+        std::memset(dX, 0,
+                    static_cast<size_t>(n) * input_dim_ * sizeof(float));
+        gemm_nn_acc(n, input_dim_, rank_, 1.0f,
+                    dH, rank_,
+                    v_.data(), input_dim_,
+                    dX, input_dim_);
+    }
+
+    float step = -learning_rate / n;
+
+    // U += step * dlogits^T H
+    float* dlogits_t = ensure_size(s.t0, static_cast<size_t>(num_classes_) * n);
+    transpose(dlogits, n, num_classes_, dlogits_t);
+    gemm_nn_acc(num_classes_, rank_, n, step,
+                dlogits_t, n,
+                H, rank_,
+                u_.data(), rank_);
+
+    // V += step * dH^T X
+    float* dH_t = ensure_size(s.t1, hn);
+    transpose(dH, n, rank_, dH_t);
+    gemm_nn_acc(rank_, input_dim_, n, step,
+                dH_t, n,
+                X, input_dim_,
+                v_.data(), input_dim_);
+
+    for (int c = 0; c < num_classes_; ++c) {
+        const float* g = &dlogits_t[static_cast<size_t>(c) * n];
+        float sum = 0.0f;
+        for (int i = 0; i < n; ++i)
+            sum += g[i];
+        bias_[c] += step * sum;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "iclassifier.h"
+
+#include <cstdint>
+#include <vector>
+
+// Factorized head for ProjectionMode::LOWRANK: logits = U (V x) + b with
+// V rank x input_dim and U num_classes x rank, i.e. W = U V of rank at most
+// rank. forward computes h = V x once and then U h, so a row costs
+// rank * (num_classes + input_dim) multiply-adds instead of
+// num_classes * input_dim, and the parameters shrink by the same ratio.
+// Worth it once rank < C d / (C + d); see bench_lowrank for the crossover.
+//
+// U and V are trained jointly by plain SGD. Scratch for h and its gradient
+// is per thread, so concurrent forward calls (and Hogwild steps) are safe.
+class LowRankClassifier : public IClassifier {
+public:
+    // Throws std::invalid_argument unless all sizes are positive.
+    LowRankClassifier(int input_dim, int num_classes, int rank, uint64_t seed);
+
+    void forward(const float* input, float* logits) const override;
+
+    void backward_sgd(const float* input,
+                      const float* dlogits,
+                      float* dinput,
+                      float learning_rate) override;
+
+    // Two GEMMs per batch: H = X V^T (n x rank), then H U^T.
+    void forward_batch(const float* X, int n, float* logits) const override;
+
+    void backward_batch(const float* X,
+                        int n,
+                        const float* dlogits,
+                        float* dX,
+                        float learning_rate) override;
+
+    int input_dim() const noexcept override { return input_dim_; }
+    int num_classes() const noexcept override { return num_classes_; }
+    int rank() const noexcept { return rank_; }
+
+    size_t forward_flops() const noexcept override {
+        return static_cast<size_t>(rank_) * (num_classes_ + input_dim_);
+    }
+
+    // Row-major U (num_classes x rank), V (rank x input_dim) and the
+    // num_classes biases
+    const float* u() const noexcept { return u_.data(); }
+    const float* v() const noexcept { return v_.data(); }
+    const float* bias() const noexcept { return bias_.data(); }
+
+    // Overwrites all parameters, e.g. when loading a saved model.
+    void load_parameters(const float* u, const float* v, const float* bias);
+
+private:
+    int input_dim_;
+    int num_classes_;
+    int rank_;
+
+    std::vector<float> u_;
+    std::vector<float> v_;
+    std::vector<float> bias_;
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+// One scored class: label index and its softmax probability.
+struct Prediction {
+    int label;
+    float probability;
+};
@@ -0,0 +1,204 @@
+#include "sparse_classifier.h"
+#include "config/model_config.h"
+#include "encoder/sparse_features.h"
+#include "utils/rng.h"
+#include "simd/kernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+SparseClassifier::SparseClassifier(
+    int dense_dim,
+    int num_features,
+    int num_classes,
+    uint64_t seed)
+    : dense_dim_(dense_dim),
+      num_features_(num_features),
+      num_classes_(num_classes)
+{
+    if (dense_dim < 0 || num_features <= 0 || num_classes <= 0)
+        throw std::invalid_argument(
+            "num_features and num_classes must be > 0, dense_dim >= 0");
+
+    sparse_.assign(static_cast<size_t>(num_features) * num_classes, 0.0f);
+    dense_.resize(static_cast<size_t>(num_classes) * dense_dim);
+    bias_.assign(num_classes, 0.0f);
+
+    if (dense_dim_ > 0) {
+        RNG rng(seed);
+        float bound = std::sqrt(1.0f / dense_dim_);
+        for (auto& w : dense_)
+            w = rng.uniform(-bound, bound);
+    }
+}
+
+void SparseClassifier::load_parameters(
+    const float* sparse_weights,
+    const float* dense_weights,
+    const float* bias)
+{
+    std::memcpy(sparse_.data(), sparse_weights,
+                sparse_.size() * sizeof(float));
+    if (dense_dim_ > 0)
+        std::memcpy(dense_.data(), dense_weights,
+                    dense_.size() * sizeof(float));
+    std::memcpy(bias_.data(), bias, bias_.size() * sizeof(float));
+}
+
+void SparseClassifier::forward(
+    const float* input,
+    const int* indices,
+    const float* values,
+    int nnz,
+    float* logits) const
+{
+    for (int c = 0; c < num_classes_; ++c)
+        logits[c] = bias_[c];
+
+    if (dense_dim_ > 0)
+        for (int c = 0; c < num_classes_; ++c)
+            logits[c] += vec_dot(&dense_[static_cast<size_t>(c) * dense_dim_],
+                                 input, dense_dim_);
+
+    int row_ptr[2] = {0, nnz};
+    spmm_csr_acc(1, num_classes_, row_ptr, indices, values,
+                 sparse_.data(), num_classes_, logits, num_classes_);
+}
+
+void SparseClassifier::backward_sgd(
+    const float* input,
+    const int* indices,
+    const float* values,
+    int nnz,
+    const float* dlogits,
+    float* dinput,
+    float learning_rate)
+{
+    if (dense_dim_ > 0) {
+        if (dinput)
+            std::memset(dinput, 0, dense_dim_ * sizeof(float));
+
+        for (int c = 0; c < num_classes_; ++c) {
+            float* row = &dense_[static_cast<size_t>(c) * dense_dim_];
+            float step = -(learning_rate * dlogits[c]);
+
+            if (dinput)
+                vec_axpy_update(dlogits[c], step, input, row, dinput,
+                                dense_dim_);
+            else
+                vec_axpy(step, input, row, dense_dim_);
+        }
+    }
+
+    for (int c = 0; c < num_classes_; ++c)
+        bias_[c] -= learning_rate * dlogits[c];
+
+    // S[indices[p]] -= lr * values[p] * dlogits
+    int row_ptr[2] = {0, nnz};
+    spmm_csr_t_acc(1, num_classes_, -learning_rate, row_ptr, indices, values,
+                   dlogits, num_classes_, sparse_.data(), num_classes_);
+}
+
+void SparseClassifier::forward_batch(
+    const float* X,
+    const SparseFeatures& features,
+    float* logits) const
+{
+    int n = features.rows();
+    if (n <= 0) return;
+
+    if (dense_dim_ > 0) {
+        gemm_nt(n, num_classes_, dense_dim_,
+                X, dense_dim_,
+                dense_.data(), dense_dim_,
+                logits, num_classes_);
+    } else {
+        std::memset(logits, 0,
+                    static_cast<size_t>(n) * num_classes_ * sizeof(float));
+    }
+
+    for (int i = 0; i < n; ++i) {
+        float* out = logits + static_cast<size_t>(i) * num_classes_;
+        for (int c = 0; c < num_classes_; ++c)
+            out[c] += bias_[c];
+    }
+
+    spmm_csr_acc(n, num_classes_,
+                 features.offsets.data(),
+                 features.indices.data(),
+                 features.values.data(),
+                 sparse_.data(), num_classes_,
+                 logits, num_classes_);
+}
+
+void SparseClassifier::backward_batch(
+    const float* X,
+    const SparseFeatures& features,
+    const float* dlogits,
+    float* dX,
+    float learning_rate)
+{
+    int n = features.rows();
+    if (n <= 0) return;
+
+    float step = -learning_rate / n;
+
+    scratch_dlogits_t_.resize(static_cast<size_t>(num_classes_) * n);
+    for (int i = 0; i < n; ++i)
+        for (int c = 0; c < num_classes_; ++c)
+            scratch_dlogits_t_[static_cast<size_t>(c) * n + i] =
+                dlogits[static_cast<size_t>(i) * num_classes_ + c];
+
+    if (dense_dim_ > 0) {
+        // dX = dlogits * W, before W changes
+        if (dX) {
+            std::memset(dX, 0,
+                        static_cast<size_t>(n) * dense_dim_ * sizeof(float));
+            gemm_nn_acc(n, dense_dim_, num_classes_, 1.0f,
+                        dlogits, num_classes_,
+                        dense_.data(), dense_dim_,
+                        dX, dense_dim_);
+        }
+
+        // W += step * dlogits^T * X
+        gemm_nn_acc(num_classes_, dense_dim_, n, step,
+                    scratch_dlogits_t_.data(), n,
+                    X, dense_dim_,
+                    dense_.data(), dense_dim_);
+    }
+
+    for (int c = 0; c < num_classes_; ++c) {
+        const float* g = &scratch_dlogits_t_[static_cast<size_t>(c) * n];
+        float sum = 0.0f;
+        for (int i = 0; i < n; ++i)
+            sum += g[i];
+        bias_[c] += step * sum;
+    }
+
+    // S += step * F^T * dlogits
+    spmm_csr_t_acc(n, num_classes_, step,
+                   features.offsets.data(),
+                   features.indices.data(),
+                   features.values.data(),
+                   dlogits, num_classes_,
+                   sparse_.data(), num_classes_);
+}
+
+std::unique_ptr<SparseClassifier> make_sparse_classifier(
+    const ModelConfig& config,
+    int num_classes)
+{
+    switch (config.projection_mode) {
+    case ProjectionMode::SPARSE:
+        return std::make_unique<SparseClassifier>(
+            0, config.bucket_count, num_classes, config.seed);
+    case ProjectionMode::HYBRID:
+        return std::make_unique<SparseClassifier>(
+            config.embedding_dim, config.bucket_count, num_classes,
+            config.seed);
+    default:
+        throw std::invalid_argument(
+            "projection_mode is not SPARSE or HYBRID");
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ModelConfig;
+struct SparseFeatures;
+
+// Head for ProjectionMode::SPARSE and HYBRID over hashed bucket features
+// (MeanSentenceEncoder::append_features) instead of the dense sentence
+// vector:
+//
+//     SPARSE  (dense_dim == 0):  logits = S^T f + b
+//     HYBRID  (dense_dim  > 0):  logits = S^T f + W x + b
+//
+// f is the sentence's bag of weighted bucket ids, S is num_features x
+// num_classes and stored feature-major, so every nonzero of f adds one
+// contiguous num_classes-wide row (spmm_csr_acc). A short text costs
+// nnz * C, where gather-then-dense costs nnz * dim for the row gathers plus
+// C * dim for the product. In HYBRID, x is a sentence vector from a small
+// dense embedding and W its num_classes x dense_dim weights.
+//
+// S starts at zero, so a hybrid head starts as its dense part.
+//
+// Memory: S is a dense float array, 4 * num_features * num_classes bytes
+// whether or not a bucket was ever seen, i.e. bucket_count / dim times a
+// dense head over the same classes. With the default 200000 buckets and
+// 100 classes that is 80 MB, against 100 KB for a 256-dim linear head.
+// ModelFile cannot store this head yet: saving a SPARSE or HYBRID config
+// throws.
+class SparseClassifier {
+public:
+    // Throws std::invalid_argument unless num_features, num_classes > 0
+    // and dense_dim >= 0.
+    SparseClassifier(int dense_dim,
+                     int num_features,
+                     int num_classes,
+                     uint64_t seed);
+
+    // One row: nnz bucket features, plus the dense input in HYBRID (input
+    // is not read when dense_dim == 0 and may be null).
+    void forward(const float* input,
+                 const int* indices,
+                 const float* values,
+                 int nnz,
+                 float* logits) const;
+
+    // SGD step given dL/dlogits. dinput, when not null, receives dL/dx
+    // computed with W from before the update. Touches only the nnz rows of
+    // S, so concurrent steps can run Hogwild.
+    void backward_sgd(const float* input,
+                      const int* indices,
+                      const float* values,
+                      int nnz,
+                      const float* dlogits,
+                      float* dinput,
+                      float learning_rate);
+
+    // Batched over features.rows() rows; X is rows x dense_dim (ignored
+    // when dense_dim == 0) and logits rows x num_classes.
+    void forward_batch(const float* X,
+                       const SparseFeatures& features,
+                       float* logits) const;
+
+    // One step with the mean gradient of the batch; dX is optional.
+    void backward_batch(const float* X,
+                        const SparseFeatures& features,
+                        const float* dlogits,
+                        float* dX,
+                        float learning_rate);
+
+    int dense_dim() const noexcept { return dense_dim_; }
+    int num_features() const noexcept { return num_features_; }
+    int num_classes() const noexcept { return num_classes_; }
+
+    // Row-major S (num_features x num_classes), W (num_classes x
+    // dense_dim, empty in SPARSE) and the num_classes biases
+    const float* sparse_weights() const noexcept { return sparse_.data(); }
+    const float* dense_weights() const noexcept { return dense_.data(); }
+    const float* bias() const noexcept { return bias_.data(); }
+
+    // Overwrites all parameters, e.g. when loading a saved model.
+    // dense_weights is not read in SPARSE.
+    void load_parameters(const float* sparse_weights,
+                         const float* dense_weights,
+                         const float* bias);
+
+private:
+    int dense_dim_;
+    int num_features_;
+    int num_classes_;
+
+    std::vector<float> sparse_;
+    std::vector<float> dense_;
+    std::vector<float> bias_;
+
+    // dlogits transposed (num_classes x n) for the dense update GEMM
+    std::vector<float> scratch_dlogits_t_;
+};
+
+// SPARSE or HYBRID head for config: num_features = bucket_count and, in
+// HYBRID, dense_dim = embedding_dim. Throws std::invalid_argument for the
+// other projection modes.
+std::unique_ptr<SparseClassifier>
+make_sparse_classifier(const ModelConfig& config, int num_classes);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "prediction.h"
+#include "simd/kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Running selection of the k best (label, score) pairs, kept in the
+// caller's k-entry array as a heap whose top is the worst entry kept, so a
+// score that cannot enter costs one compare. Higher score first, lower
+// label on ties. probability holds the raw score until the caller turns it
+// into one.
+class TopKHeap {
+public:
+    TopKHeap(Prediction* storage, int k) : items_(storage), k_(k) {}
+
+    void push(int label, float score) {
+        Prediction p{label, score};
+
+        if (size_ < k_) {
+            items_[size_++] = p;
+            std::push_heap(items_, items_ + size_, better);
+        } else if (better(p, items_[0])) {
+            std::pop_heap(items_, items_ + size_, better);
+            items_[size_ - 1] = p;
+            std::push_heap(items_, items_ + size_, better);
+        }
+    }
+
+    // Sorts the kept entries best first; the heap is spent afterwards.
+    void finish() { std::sort_heap(items_, items_ + size_, better); }
+
+    int size() const noexcept { return size_; }
+
+private:
+    static bool better(const Prediction& a, const Prediction& b) {
+        return a.probability > b.probability ||
+               (a.probability == b.probability && a.label < b.label);
+    }
+
+    Prediction* items_;
+    int k_;
+    int size_ = 0;
+};
+
+// Index of the largest logit, lowest on ties; no exp.
+inline int argmax(const float* logits, int n)
+{
+    int best = 0;
+    for (int i = 1; i < n; ++i)
+        if (logits[i] > logits[best])
+            best = i;
+    return best;
+}
+
+// Top k of n logits into out, best first, with their softmax
+// probabilities. Only the k winners are exponentiated for output; the
+// normalizer is the shifted log-sum-exp sum, and logits is left untouched.
+// Probabilities are exp(l - max) / sum rather than exp(l - lse): l - max
+// is exact, while lse would round at the scale of the largest logit.
+// k == 1 skips the heap: a running argmax and one exp-sum.
+inline void select_topk(const float* logits, int n, int k, Prediction* out)
+{
+    if (k == 1) {
+        int best = argmax(logits, n);
+        float sum = vec_exp_sum(logits, logits[best], nullptr, n);
+        out[0] = Prediction{best, 1.0f / sum};   // exp(0) / sum
+        return;
+    }
+
+    TopKHeap heap(out, k);
+    for (int c = 0; c < n; ++c)
+        heap.push(c, logits[c]);
+    heap.finish();
+
+    // out[0] holds the max
+    float max_val = out[0].probability;
+    float sum = vec_exp_sum(logits, max_val, nullptr, n);
+
+    for (int j = 0; j < k; ++j)
+        out[j].probability = std::exp(out[j].probability - max_val) / sum;
+}
@@ -5,6 +5,8 @@ bool ModelConfig::operator==(const ModelConfig& other) const {
            embedding_dim == other.embedding_dim &&
            ngram_min == other.ngram_min &&
            ngram_max == other.ngram_max &&
+           hash_policy == other.hash_policy &&
+           bucket_reduction == other.bucket_reduction &&
            phonetic_gamma == other.phonetic_gamma &&
            num_heads == other.num_heads &&
            use_projection == other.use_projection &&
@@ -14,7 +16,11 @@ bool ModelConfig::operator==(const ModelConfig& other) const {
            learning_rate_adam == other.learning_rate_adam &&
            learning_rate_sgd == other.learning_rate_sgd &&
            weight_decay == other.weight_decay &&
-           seed == other.seed;
+           projection_mode == other.projection_mode &&
+           projection_rank == other.projection_rank &&
+           precision_mode == other.precision_mode &&
+           seed == other.seed &&
+           pq_subvector_dim == other.pq_subvector_dim;
 }
 
 void ModelConfig::validate() const {
@@ -24,9 +30,30 @@ void ModelConfig::validate() const {
         throw std::invalid_argument("embedding_dim must be > 0");
     if(ngram_min<=0 || ngram_max < ngram_min)
         throw std::invalid_argument("Invalid ngram range");
+    if(hash_policy < HashPolicy::FNV1A || hash_policy > HashPolicy::WYHASH)
+        throw std::invalid_argument("unknown hash_policy");
+    if(bucket_reduction < BucketReduction::MODULO ||
+       bucket_reduction > BucketReduction::POW2_MASK)
+        throw std::invalid_argument("unknown bucket_reduction");
+    if(bucket_reduction == BucketReduction::POW2_MASK &&
+       (bucket_count & (bucket_count - 1)) != 0)
+        throw std::invalid_argument("POW2_MASK needs a power-of-two bucket_count");
+    if(projection_mode < ProjectionMode::DENSE ||
+       projection_mode > ProjectionMode::HYBRID)
+        throw std::invalid_argument("unknown projection_mode");
+    if(precision_mode < PrecisionMode::FP32 ||
+       precision_mode > PrecisionMode::PQ8)
+        throw std::invalid_argument("unknown precision_mode");
     if(num_heads<=0)
         throw std::invalid_argument("num_heads must be > 0");
+    if(batch_size<=0)
+        throw std::invalid_argument("batch_size must be > 0");
+    if(projection_rank<=0)
+        throw std::invalid_argument("projection_rank must be > 0");
     if(phonetic_gamma<0.0f)
         throw std::invalid_argument("phonetic_gamma must be >= 0");
+    if(precision_mode == PrecisionMode::PQ8 &&
+       (pq_subvector_dim <= 0 || embedding_dim % pq_subvector_dim != 0))
+        throw std::invalid_argument("pq_subvector_dim must divide embedding_dim");
     
 }
\ No newline at end of file
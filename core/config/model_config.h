@@ -12,7 +12,23 @@ enum class ProjectionMode {
 
 enum class PrecisionMode {
     FP32,
-    FP16
+    FP16,
+    BF16,
+    PQ8
+};
+
+// Hash applied to n-grams and phonetic codes (see hashing/bucket_policy.h).
+enum class HashPolicy {
+    FNV1A,
+    MURMUR3,
+    WYHASH
+};
+
+// Maps a 64-bit hash onto [0, bucket_count).
+enum class BucketReduction {
+    MODULO,            // hash % bucket_count
+    MULTIPLY_SHIFT,    // (hash * bucket_count) >> 64
+    POW2_MASK          // hash & (bucket_count - 1); power-of-two counts only
 };
 
 struct ModelConfig {
@@ -23,6 +39,10 @@ struct ModelConfig {
     int ngram_min = 3;
     int ngram_max = 6;
 
+    // bucket hashing; FNV1A + MODULO is the original scheme
+    HashPolicy hash_policy = HashPolicy::FNV1A;
+    BucketReduction bucket_reduction = BucketReduction::MODULO;
+
     // phonetic
     bool use_phonetic = true;
     float phonetic_gamma = 0.2f;
@@ -41,9 +61,13 @@ struct ModelConfig {
 
     // deterministic seeds
     ProjectionMode projection_mode = ProjectionMode::DENSE;
+    int projection_rank = 32;      // inner dim of the LOWRANK head
     PrecisionMode precision_mode = PrecisionMode::FP32;
     uint64_t seed = 42;
 
+    // product quantization (PrecisionMode::PQ8): floats per sub-vector
+    int pq_subvector_dim = 8;
+
     void validate() const;
     
     bool operator == (const ModelConfig& other) const;
@@ -1,8 +1,61 @@
 #include "embedding_table.h"
+#include "hashing/hash_function.h"
+#include "simd/kernels.h"
 #include "utils/aligned_alloc.h"
+#include "utils/mapped_file.h"
 #include "utils/rng.h"
 #include <cmath>
 #include <cassert>
+#include <climits>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const char kEmbeddingMagic[8] = {'G', 'L', 'A', 'D', 'E', 'M', 'B', '\0'};
+constexpr uint32_t kEmbeddingVersion = 1;
+constexpr uint64_t kDataAlignment = 4096;
+
+bool valid_dtype(uint32_t dtype)
+{
+    return dtype <= static_cast<uint32_t>(EmbeddingDType::PQ8);
+}
+
+}  // namespace
+
+size_t embedding_dtype_size(EmbeddingDType dtype) noexcept
+{
+    switch (dtype) {
+        case EmbeddingDType::F16:
+        case EmbeddingDType::BF16: return sizeof(uint16_t);
+        case EmbeddingDType::PQ8: return sizeof(uint8_t);
+        default: return sizeof(float);
+    }
+}
+
+const char* embedding_dtype_name(EmbeddingDType dtype) noexcept
+{
+    switch (dtype) {
+        case EmbeddingDType::F16: return "f16";
+        case EmbeddingDType::BF16: return "bf16";
+        case EmbeddingDType::PQ8: return "pq8";
+        default: return "f32";
+    }
+}
+
+EmbeddingDType embedding_dtype_for(PrecisionMode mode)
+{
+    switch (mode) {
+        case PrecisionMode::FP32: return EmbeddingDType::F32;
+        case PrecisionMode::FP16: return EmbeddingDType::F16;
+        case PrecisionMode::BF16: return EmbeddingDType::BF16;
+        case PrecisionMode::PQ8: return EmbeddingDType::PQ8;
+    }
+    throw std::invalid_argument("unknown precision mode");
+}
 
 EmbeddingTable::EmbeddingTable(
     int bucket_count,
@@ -10,13 +63,11 @@ EmbeddingTable::EmbeddingTable(
     uint64_t seed)
     : bucket_count_(bucket_count),
       dim_(dim),
+      dtype_(EmbeddingDType::F32),
       data_(nullptr)
 {
-    size_t total = static_cast<size_t>(bucket_count_) *
-                   dim_ * sizeof(float);
-
-    data_ = static_cast<float*>(
-        aligned_malloc(total, 32)
+    data_ = static_cast<unsigned char*>(
+        aligned_malloc(memory_bytes(), 32)
     );
 
     if (!data_)
@@ -33,23 +84,276 @@ EmbeddingTable::EmbeddingTable(
     }
 }
 
+EmbeddingTable::EmbeddingTable(
+    const std::string& path,
+    const EmbeddingLoadOptions& options)
+    : bucket_count_(0),
+      dim_(0),
+      dtype_(EmbeddingDType::F32),
+      data_(nullptr),
+      mapping_(std::make_shared<MappedFile>(path, options.prewarm))
+{
+    if (mapping_->size() < sizeof(EmbeddingFileHeader))
+        throw std::runtime_error("truncated embedding file '" + path + "'");
+
+    EmbeddingFileHeader header;
+    std::memcpy(&header, mapping_->data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kEmbeddingMagic, sizeof(kEmbeddingMagic)) != 0)
+        throw std::runtime_error("not an embedding file '" + path + "'");
+    if (header.version != kEmbeddingVersion)
+        throw std::runtime_error("unsupported embedding file version");
+    if (!valid_dtype(header.dtype))
+        throw std::runtime_error("unsupported embedding dtype");
+
+    dtype_ = static_cast<EmbeddingDType>(header.dtype);
+
+    // Sizes below come from an untrusted header: bound the counts to int
+    // first and check every product and sum for wraparound.
+    if (header.bucket_count == 0 || header.bucket_count > INT_MAX ||
+        header.dim == 0 || header.dim > INT_MAX)
+        throw std::runtime_error("corrupt embedding header '" + path + "'");
+
+    uint64_t codebook_bytes = 0;
+    uint64_t row_elements = header.dim;
+
+    if (dtype_ == EmbeddingDType::PQ8) {
+        if (header.pq_dsub == 0 || header.dim % header.pq_dsub != 0)
+            throw std::runtime_error("corrupt embedding header '" + path + "'");
+        codebook_bytes = header.dim * ProductQuantizer::KSUB * sizeof(float);
+        row_elements = header.dim / header.pq_dsub;
+    }
+
+    uint64_t expected = 0;
+    bool wrapped =
+        __builtin_mul_overflow(header.bucket_count, row_elements, &expected) ||
+        __builtin_mul_overflow(expected,
+                               uint64_t{embedding_dtype_size(dtype_)},
+                               &expected) ||
+        __builtin_add_overflow(expected, codebook_bytes, &expected);
+
+    if (wrapped ||
+        header.data_bytes != expected ||
+        header.data_offset % kDataAlignment != 0 ||
+        header.data_offset > mapping_->size() ||
+        header.data_bytes > mapping_->size() - header.data_offset)
+        throw std::runtime_error("corrupt embedding header '" + path + "'");
+
+    const unsigned char* rows = mapping_->data() + header.data_offset;
+
+    if (options.verify_checksum &&
+        HashFunction::checksum64(rows, header.data_bytes) != header.checksum)
+        throw std::runtime_error("embedding checksum mismatch '" + path + "'");
+
+    bucket_count_ = static_cast<int>(header.bucket_count);
+    dim_ = static_cast<int>(header.dim);
+
+    if (dtype_ == EmbeddingDType::PQ8) {
+        quantizer_ = std::make_shared<ProductQuantizer>(
+            dim_, static_cast<int>(header.pq_dsub),
+            reinterpret_cast<const float*>(rows));
+        rows += codebook_bytes;
+    }
+
+    // The mapping is PROT_READ; row() asserts nobody writes through it.
+    data_ = const_cast<unsigned char*>(rows);
+}
+
+EmbeddingTable::EmbeddingTable(
+    std::shared_ptr<MappedFile> mapping,
+    size_t offset,
+    int bucket_count,
+    int dim,
+    EmbeddingDType dtype)
+    : bucket_count_(bucket_count),
+      dim_(dim),
+      dtype_(dtype),
+      data_(nullptr),
+      mapping_(std::move(mapping))
+{
+    if (dtype_ == EmbeddingDType::PQ8)
+        throw std::invalid_argument("pq8 rows need a quantizer");
+
+    size_t bytes = static_cast<size_t>(bucket_count_) * row_bytes();
+
+    // Written so offset + bytes cannot wrap
+    if (!mapping_ || offset % 32 != 0 ||
+        offset > mapping_->size() || bytes > mapping_->size() - offset)
+        throw std::invalid_argument("embedding rows outside mapping");
+
+    data_ = const_cast<unsigned char*>(mapping_->data() + offset);
+}
+
+EmbeddingTable::EmbeddingTable(
+    std::shared_ptr<MappedFile> mapping,
+    size_t offset,
+    int bucket_count,
+    std::shared_ptr<const ProductQuantizer> quantizer)
+    : bucket_count_(bucket_count),
+      dim_(quantizer ? quantizer->dim() : 0),
+      dtype_(EmbeddingDType::PQ8),
+      data_(nullptr),
+      mapping_(std::move(mapping)),
+      quantizer_(std::move(quantizer))
+{
+    if (!quantizer_)
+        throw std::invalid_argument("pq8 rows need a quantizer");
+
+    size_t bytes = static_cast<size_t>(bucket_count_) * row_bytes();
+
+    if (!mapping_ ||
+        offset > mapping_->size() || bytes > mapping_->size() - offset)
+        throw std::invalid_argument("embedding rows outside mapping");
+
+    data_ = const_cast<unsigned char*>(mapping_->data() + offset);
+}
+
+EmbeddingTable::EmbeddingTable(
+    const EmbeddingTable& source,
+    EmbeddingDType dtype)
+    : bucket_count_(source.bucket_count_),
+      dim_(source.dim_),
+      dtype_(dtype),
+      data_(nullptr)
+{
+    if (dtype_ == EmbeddingDType::PQ8)
+        throw std::invalid_argument("pq8 tables are built from PQOptions");
+
+    data_ = static_cast<unsigned char*>(
+        aligned_malloc(memory_bytes(), 32)
+    );
+
+    if (!data_)
+        throw std::bad_alloc();
+
+    std::vector<float> widened(dim_);
+
+    for (int b = 0; b < bucket_count_; ++b) {
+        const float* src = source.row_f32(b, widened.data());
+        unsigned char* dst = data_ + static_cast<size_t>(b) * row_bytes();
+
+        switch (dtype_) {
+            case EmbeddingDType::F32:
+                std::memcpy(dst, src, row_bytes());
+                break;
+            case EmbeddingDType::F16:
+                vec_f32_to_f16(src, reinterpret_cast<uint16_t*>(dst), dim_);
+                break;
+            case EmbeddingDType::BF16:
+                vec_f32_to_bf16(src, reinterpret_cast<uint16_t*>(dst), dim_);
+                break;
+            case EmbeddingDType::PQ8:
+                break;
+        }
+    }
+}
+
+EmbeddingTable::EmbeddingTable(
+    const EmbeddingTable& source,
+    const PQOptions& options)
+    : bucket_count_(source.bucket_count_),
+      dim_(source.dim_),
+      dtype_(EmbeddingDType::PQ8),
+      data_(nullptr)
+{
+    auto quantizer = std::make_shared<ProductQuantizer>(dim_, options.dsub);
+
+    // The quantizer samples the rows; non-f32 sources are widened per row
+    quantizer->train(bucket_count_, [&](int b, float* scratch) {
+        return source.row_f32(b, scratch);
+    }, options);
+
+    data_ = static_cast<unsigned char*>(
+        aligned_malloc(static_cast<size_t>(bucket_count_) * quantizer->nsub(),
+                       32)
+    );
+
+    if (!data_)
+        throw std::bad_alloc();
+
+    // Encode in blocks so non-f32 sources only need a block of widened rows
+    constexpr int kBlock = 1024;
+    std::vector<float> block(static_cast<size_t>(kBlock) * dim_);
+
+    for (int b0 = 0; b0 < bucket_count_; b0 += kBlock) {
+        int m = std::min(kBlock, bucket_count_ - b0);
+        for (int i = 0; i < m; ++i) {
+            float* dst = &block[static_cast<size_t>(i) * dim_];
+            const float* src = source.row_f32(b0 + i, dst);
+            if (src != dst)
+                std::memcpy(dst, src, dim_ * sizeof(float));
+        }
+        quantizer->encode_batch(
+            block.data(), m,
+            data_ + static_cast<size_t>(b0) * quantizer->nsub());
+    }
+
+    quantizer_ = std::move(quantizer);
+}
+
+uint64_t EmbeddingTable::next_id() noexcept
+{
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
 EmbeddingTable::~EmbeddingTable() {
-    if (data_)
+    if (data_ && !mapping_)
         aligned_free(data_);
 }
 
 float* EmbeddingTable::row(int bucket) {
 #ifndef NDEBUG
     assert(bucket >= 0 && bucket < bucket_count_);
+    assert(dtype_ == EmbeddingDType::F32 && "row() needs an f32 table");
+    assert(!mapping_ && "mapped embedding tables are read-only");
 #endif
-    return data_ + static_cast<size_t>(bucket) * dim_;
+    return reinterpret_cast<float*>(data_) +
+           static_cast<size_t>(bucket) * dim_;
 }
 
 const float* EmbeddingTable::row(int bucket) const {
+#ifndef NDEBUG
+    assert(bucket >= 0 && bucket < bucket_count_);
+    assert(dtype_ == EmbeddingDType::F32 && "row() needs an f32 table");
+#endif
+    return reinterpret_cast<const float*>(data_) +
+           static_cast<size_t>(bucket) * dim_;
+}
+
+const void* EmbeddingTable::row_data(int bucket) const {
 #ifndef NDEBUG
     assert(bucket >= 0 && bucket < bucket_count_);
 #endif
-    return data_ + static_cast<size_t>(bucket) * dim_;
+    return data_ + static_cast<size_t>(bucket) * row_bytes();
+}
+
+const float* EmbeddingTable::row_f32(int bucket, float* scratch) const {
+    if (dtype_ == EmbeddingDType::F32)
+        return row(bucket);
+
+    std::fill(scratch, scratch + dim_, 0.0f);
+    accumulate_row(bucket, 1.0f, scratch);
+    return scratch;
+}
+
+void EmbeddingTable::accumulate_row(int bucket, float scale, float* out) const {
+    const void* r = row_data(bucket);
+
+    switch (dtype_) {
+        case EmbeddingDType::F32:
+            vec_axpy(scale, static_cast<const float*>(r), out, dim_);
+            break;
+        case EmbeddingDType::F16:
+            vec_axpy_f16(scale, static_cast<const uint16_t*>(r), out, dim_);
+            break;
+        case EmbeddingDType::BF16:
+            vec_axpy_bf16(scale, static_cast<const uint16_t*>(r), out, dim_);
+            break;
+        case EmbeddingDType::PQ8:
+            quantizer_->accumulate(static_cast<const uint8_t*>(r), scale, out);
+            break;
+    }
 }
 
 int EmbeddingTable::bucket_count() const noexcept {
@@ -60,7 +364,56 @@ int EmbeddingTable::dim() const noexcept {
     return dim_;
 }
 
+size_t EmbeddingTable::row_bytes() const noexcept {
+    if (dtype_ == EmbeddingDType::PQ8)
+        return quantizer_ ? static_cast<size_t>(quantizer_->nsub()) : 0;
+    return static_cast<size_t>(dim_) * embedding_dtype_size(dtype_);
+}
+
 size_t EmbeddingTable::memory_bytes() const noexcept {
-    return static_cast<size_t>(bucket_count_) *
-           dim_ * sizeof(float);
+    size_t bytes = static_cast<size_t>(bucket_count_) * row_bytes();
+    if (quantizer_)
+        bytes += quantizer_->centroid_bytes();
+    return bytes;
+}
+
+void EmbeddingTable::save(const std::string& path) const {
+    EmbeddingFileHeader header{};
+    std::memcpy(header.magic, kEmbeddingMagic, sizeof(kEmbeddingMagic));
+    header.version = kEmbeddingVersion;
+    header.dtype = static_cast<uint32_t>(dtype_);
+    header.bucket_count = static_cast<uint64_t>(bucket_count_);
+    header.dim = static_cast<uint64_t>(dim_);
+    header.data_offset = kDataAlignment;
+
+    // PQ8 stores the codebooks in front of the codes
+    std::vector<unsigned char> region;
+    const unsigned char* payload = data_;
+    size_t rows_bytes = static_cast<size_t>(bucket_count_) * row_bytes();
+
+    if (quantizer_) {
+        header.pq_dsub = static_cast<uint32_t>(quantizer_->dsub());
+        region.resize(quantizer_->centroid_bytes() + rows_bytes);
+        std::memcpy(region.data(), quantizer_->centroids(),
+                    quantizer_->centroid_bytes());
+        std::memcpy(region.data() + quantizer_->centroid_bytes(),
+                    data_, rows_bytes);
+        payload = region.data();
+    }
+
+    header.data_bytes = memory_bytes();
+    header.checksum = HashFunction::checksum64(payload, header.data_bytes);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot open '" + path + "' for writing");
+
+    std::vector<char> padding(kDataAlignment - sizeof(header), 0);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char*>(payload), header.data_bytes);
+
+    if (!out)
+        throw std::runtime_error("failed writing '" + path + "'");
 }
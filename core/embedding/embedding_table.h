@@ -1,7 +1,59 @@
 #pragma once
 
+#include "config/model_config.h"
+#include "embedding/product_quantizer.h"
+
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+
+class MappedFile;
+
+// Row storage type. F16 is IEEE binary16, BF16 is the upper half of a float;
+// both halve the resident size and are widened to float when read. PQ8 rows
+// are product-quantization codes, one byte per sub-vector.
+enum class EmbeddingDType : uint32_t {
+    F32 = 0,
+    F16 = 1,
+    BF16 = 2,
+    PQ8 = 3
+};
+
+// Bytes per stored element (per code for PQ8).
+size_t embedding_dtype_size(EmbeddingDType dtype) noexcept;
+
+const char* embedding_dtype_name(EmbeddingDType dtype) noexcept;
+
+// Storage type selected by ModelConfig::precision_mode.
+EmbeddingDType embedding_dtype_for(PrecisionMode mode);
+
+// On-disk layout written by EmbeddingTable::save():
+//   [EmbeddingFileHeader, 64 bytes][zero padding][rows, data_offset onwards]
+// data_offset is page aligned so mapped rows keep SIMD alignment. For PQ8 the
+// data region holds the codebooks (nsub x 256 x pq_dsub floats) followed by
+// the codes.
+struct EmbeddingFileHeader {
+    char magic[8];            // "GLADEMB\0"
+    uint32_t version;
+    uint32_t dtype;           // EmbeddingDType
+    uint64_t bucket_count;
+    uint64_t dim;
+    uint64_t data_offset;
+    uint64_t data_bytes;
+    uint64_t checksum;        // HashFunction::checksum64 over the data region
+    uint32_t pq_dsub;         // PQ8 only
+    uint32_t reserved;
+};
+
+static_assert(sizeof(EmbeddingFileHeader) == 64,
+              "EmbeddingFileHeader must stay 64 bytes");
+
+struct EmbeddingLoadOptions {
+    bool prewarm = false;          // fault all pages in at load time
+    bool verify_checksum = false;  // reads every page once
+};
 
 class EmbeddingTable {
 public:
@@ -9,20 +61,115 @@ public:
                    int dim,
                    uint64_t seed);
 
+    // Maps a file written by save() read-only and uses its rows in place.
+    // Processes mapping the same file share the physical pages. Throws
+    // std::runtime_error on I/O or format errors.
+    explicit EmbeddingTable(const std::string& path,
+                            const EmbeddingLoadOptions& options = {});
+
+    // Uses bucket_count x dim rows that already live inside mapping at byte
+    // offset (e.g. a section of a model file). offset must be 32-byte
+    // aligned.
+    EmbeddingTable(std::shared_ptr<MappedFile> mapping,
+                   size_t offset,
+                   int bucket_count,
+                   int dim,
+                   EmbeddingDType dtype = EmbeddingDType::F32);
+
+    // PQ8 rows whose codes live inside mapping at byte offset, decoded with
+    // quantizer.
+    EmbeddingTable(std::shared_ptr<MappedFile> mapping,
+                   size_t offset,
+                   int bucket_count,
+                   std::shared_ptr<const ProductQuantizer> quantizer);
+
+    // Owning copy of source converted to dtype (round to nearest even).
+    EmbeddingTable(const EmbeddingTable& source, EmbeddingDType dtype);
+
+    // Product-quantized copy of source: learns the codebooks on a sample of
+    // its rows, then encodes every row (PQ8).
+    EmbeddingTable(const EmbeddingTable& source, const PQOptions& options);
+
     ~EmbeddingTable();
 
+    EmbeddingTable(const EmbeddingTable&) = delete;
+    EmbeddingTable& operator=(const EmbeddingTable&) = delete;
+
     void initialize_uniform();
 
+    // Float rows; only valid for F32 tables. Writable rows are only
+    // available on tables that own their memory.
     float* row(int bucket);
     const float* row(int bucket) const;
 
+    // out += scale * row(bucket), widening 16-bit rows or decoding PQ codes
+    // on the fly.
+    void accumulate_row(int bucket, float scale, float* out) const;
+
     int bucket_count() const noexcept;
     int dim() const noexcept;
 
+    EmbeddingDType dtype() const noexcept { return dtype_; }
+
+    size_t row_bytes() const noexcept;
+
+    // Resident bytes: rows plus, for PQ8, the codebooks.
     size_t memory_bytes() const noexcept;
 
+    // Codebooks of a PQ8 table, nullptr otherwise.
+    const ProductQuantizer* quantizer() const noexcept { return quantizer_.get(); }
+
+    bool is_mapped() const noexcept { return mapping_ != nullptr; }
+
+    // Raw row storage (bucket_count x row_bytes()), e.g. for serialization.
+    const void* data() const noexcept { return data_; }
+    const void* row_data(int bucket) const;
+
+    // row(bucket) for F32 tables; otherwise the row widened into scratch
+    // (dim floats).
+    const float* row_f32(int bucket, float* scratch) const;
+
+    void save(const std::string& path) const;
+
+    // Bumped whenever rows change, so caches of derived vectors can tell
+    // they are stale. Code writing through row() directly must call
+    // bump_version() afterwards.
+    uint64_t version() const noexcept
+    {
+        return version_.load(std::memory_order_acquire);
+    }
+    void bump_version() noexcept
+    {
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Unique per table for the life of the process (never reused after
+    // destruction), so shared caches can tell tables apart.
+    uint64_t id() const noexcept { return id_; }
+
+    // Set while the rows are being trained. Every step bumps the version,
+    // so word vector caches skip such tables instead of churning.
+    bool trainable() const noexcept
+    {
+        return trainable_.load(std::memory_order_relaxed);
+    }
+    void set_trainable(bool trainable) noexcept
+    {
+        trainable_.store(trainable, std::memory_order_relaxed);
+    }
+
 private:
+    static uint64_t next_id() noexcept;
+
     int bucket_count_;
     int dim_;
-    float* data_;
+    EmbeddingDType dtype_;
+    unsigned char* data_;
+
+    std::shared_ptr<MappedFile> mapping_;
+    std::shared_ptr<const ProductQuantizer> quantizer_;
+
+    std::atomic<uint64_t> version_{0};
+    std::atomic<bool> trainable_{false};
+    uint64_t id_ = next_id();
 };
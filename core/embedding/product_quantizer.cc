@@ -0,0 +1,252 @@
+#include "product_quantizer.h"
+#include "simd/kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Sub-vectors scored per GEMM call while assigning.
+constexpr int kAssignBlock = 256;
+
+}  // namespace
+
+ProductQuantizer::ProductQuantizer(int dim, int dsub)
+    : dim_(dim),
+      dsub_(dsub),
+      nsub_(0)
+{
+    if (dim <= 0 || dsub <= 0 || dim % dsub != 0)
+        throw std::invalid_argument("dsub must divide the embedding dim");
+
+    nsub_ = dim_ / dsub_;
+    centroids_.assign(static_cast<size_t>(nsub_) * KSUB * dsub_, 0.0f);
+}
+
+ProductQuantizer::ProductQuantizer(int dim, int dsub, const float* centroids)
+    : ProductQuantizer(dim, dsub)
+{
+    std::memcpy(centroids_.data(), centroids, centroid_bytes());
+}
+
+void ProductQuantizer::assign(
+    int s,
+    const float* points,
+    int ld,
+    int n,
+    int* out) const
+{
+    const float* c = centroids_.data() + static_cast<size_t>(s) * KSUB * dsub_;
+
+    float norms[KSUB];
+    for (int k = 0; k < KSUB; ++k)
+        norms[k] = vec_dot(c + k * dsub_, c + k * dsub_, dsub_);
+
+    // argmin_k |x - c_k|^2 = argmin_k |c_k|^2 - 2 x.c_k
+    std::vector<float> scores(static_cast<size_t>(kAssignBlock) * KSUB);
+
+    for (int i0 = 0; i0 < n; i0 += kAssignBlock) {
+        int m = std::min(kAssignBlock, n - i0);
+        gemm_nt(m, KSUB, dsub_,
+                points + static_cast<size_t>(i0) * ld, ld,
+                c, dsub_,
+                scores.data(), KSUB);
+
+        for (int i = 0; i < m; ++i) {
+            const float* row = &scores[static_cast<size_t>(i) * KSUB];
+            int best = 0;
+            float best_dist = std::numeric_limits<float>::max();
+            for (int k = 0; k < KSUB; ++k) {
+                float d = norms[k] - 2.0f * row[k];
+                if (d < best_dist) {
+                    best_dist = d;
+                    best = k;
+                }
+            }
+            out[i0 + i] = best;
+        }
+    }
+}
+
+void ProductQuantizer::train_subspace(
+    int s,
+    const float* points,
+    int ld,
+    int n,
+    const PQOptions& options)
+{
+    float* c = centroids_.data() + static_cast<size_t>(s) * KSUB * dsub_;
+
+    // k-means++ seeding: each new centroid is a sample point drawn with
+    // probability proportional to its squared distance to the nearest
+    // centroid so far. Once every point is covered (n < 256) the draws
+    // repeat points; the empty cluster split below separates the copies.
+    std::mt19937_64 rng(options.seed + static_cast<uint64_t>(s));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    auto point = [&](int i) { return points + static_cast<size_t>(i) * ld; };
+    auto dist2 = [&](const float* a, const float* b) {
+        float d = 0.0f;
+        for (int j = 0; j < dsub_; ++j)
+            d += (a[j] - b[j]) * (a[j] - b[j]);
+        return d;
+    };
+
+    std::memcpy(c, point(static_cast<int>(rng() % n)), dsub_ * sizeof(float));
+
+    std::vector<float> nearest(n);
+    for (int i = 0; i < n; ++i)
+        nearest[i] = dist2(point(i), c);
+
+    for (int k = 1; k < KSUB; ++k) {
+        double total = 0.0;
+        for (float d : nearest)
+            total += d;
+
+        int pick = static_cast<int>(rng() % n);
+        if (total > 0.0) {
+            double target = unit(rng) * total;
+            for (int i = 0; i < n; ++i) {
+                target -= nearest[i];
+                if (target <= 0.0) {
+                    pick = i;
+                    break;
+                }
+            }
+        }
+
+        float* ck = c + k * dsub_;
+        std::memcpy(ck, point(pick), dsub_ * sizeof(float));
+        for (int i = 0; i < n; ++i)
+            nearest[i] = std::min(nearest[i], dist2(point(i), ck));
+    }
+
+    std::vector<int> assignment(n);
+    std::vector<float> sums(static_cast<size_t>(KSUB) * dsub_);
+    std::vector<int> counts(KSUB);
+
+    const float eps = 1.0f / 1024.0f;
+
+    for (int it = 0; it < options.iterations; ++it) {
+        assign(s, points, ld, n, assignment.data());
+
+        std::fill(sums.begin(), sums.end(), 0.0f);
+        std::fill(counts.begin(), counts.end(), 0);
+
+        for (int i = 0; i < n; ++i) {
+            int k = assignment[i];
+            vec_axpy(1.0f, points + static_cast<size_t>(i) * ld,
+                     &sums[static_cast<size_t>(k) * dsub_], dsub_);
+            ++counts[k];
+        }
+
+        for (int k = 0; k < KSUB; ++k) {
+            if (counts[k] == 0)
+                continue;
+            float* ck = c + k * dsub_;
+            std::memcpy(ck, &sums[static_cast<size_t>(k) * dsub_],
+                        dsub_ * sizeof(float));
+            vec_scale(1.0f / counts[k], ck, dsub_);
+        }
+
+        // Split the largest cluster into every empty one
+        for (int k = 0; k < KSUB; ++k) {
+            if (counts[k] != 0)
+                continue;
+
+            int largest = static_cast<int>(
+                std::max_element(counts.begin(), counts.end()) -
+                counts.begin());
+
+            float* ck = c + k * dsub_;
+            float* cl = c + largest * dsub_;
+            for (int j = 0; j < dsub_; ++j) {
+                float sign = (j % 2 == 0) ? 1.0f : -1.0f;
+                ck[j] = cl[j] * (1.0f + sign * eps);
+                cl[j] = cl[j] * (1.0f - sign * eps);
+            }
+
+            counts[k] = counts[largest] / 2;
+            counts[largest] -= counts[k];
+        }
+    }
+}
+
+void ProductQuantizer::train(
+    const float* data,
+    int n,
+    const PQOptions& options)
+{
+    train(n, [&](int i, float*) {
+        return data + static_cast<size_t>(i) * dim_;
+    }, options);
+}
+
+void ProductQuantizer::train(
+    int n,
+    const RowReader& row,
+    const PQOptions& options)
+{
+    if (n <= 0)
+        throw std::invalid_argument("no vectors to train the quantizer on");
+    if (options.iterations < 0 || options.max_training_rows <= 0)
+        throw std::invalid_argument("invalid PQ training options");
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    if (n > options.max_training_rows) {
+        std::mt19937_64 rng(options.seed);
+        std::shuffle(order.begin(), order.end(), rng);
+        n = options.max_training_rows;
+    }
+
+    std::vector<float> sample(static_cast<size_t>(n) * dim_);
+    for (int i = 0; i < n; ++i) {
+        float* dst = &sample[static_cast<size_t>(i) * dim_];
+        const float* src = row(order[i], dst);
+        if (src != dst)
+            std::memcpy(dst, src, dim_ * sizeof(float));
+    }
+
+    for (int s = 0; s < nsub_; ++s)
+        train_subspace(s, sample.data() + s * dsub_, dim_, n, options);
+}
+
+void ProductQuantizer::encode_batch(
+    const float* data,
+    int n,
+    uint8_t* codes) const
+{
+    std::vector<int> assignment(n);
+
+    for (int s = 0; s < nsub_; ++s) {
+        assign(s, data + s * dsub_, dim_, n, assignment.data());
+        for (int i = 0; i < n; ++i)
+            codes[static_cast<size_t>(i) * nsub_ + s] =
+                static_cast<uint8_t>(assignment[i]);
+    }
+}
+
+void ProductQuantizer::encode(const float* x, uint8_t* code) const
+{
+    encode_batch(x, 1, code);
+}
+
+void ProductQuantizer::decode(const uint8_t* code, float* x) const
+{
+    std::fill(x, x + dim_, 0.0f);
+    accumulate(code, 1.0f, x);
+}
+
+void ProductQuantizer::accumulate(
+    const uint8_t* code,
+    float scale,
+    float* out) const
+{
+    vec_pq_axpy(scale, centroids_.data(), code, nsub_, dsub_, out);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct PQOptions {
+    int dsub = 8;                    // floats per sub-vector
+    int iterations = 10;             // k-means (Lloyd) iterations
+    int max_training_rows = 16384;   // rows sampled to fit the codebooks
+    uint64_t seed = 42;
+};
+
+// Product quantizer in the style of fastText's .ftz models: each dim-sized
+// vector is cut into dim / dsub sub-vectors and every sub-vector is replaced
+// by the index of its nearest centroid in a 256-entry codebook learnt for
+// that sub-space. A row then costs dim / dsub bytes.
+//
+// Codebook layout: nsub x 256 x dsub floats.
+class ProductQuantizer {
+public:
+    static constexpr int KSUB = 256;
+
+    // Zero codebooks; throws std::invalid_argument unless dsub divides dim.
+    ProductQuantizer(int dim, int dsub);
+
+    // Copies nsub x 256 x dsub trained centroids.
+    ProductQuantizer(int dim, int dsub, const float* centroids);
+
+    // Fits the codebooks with k-means on n row-major vectors.
+    void train(const float* data, int n, const PQOptions& options);
+
+    // Same, for n rows read through row(i, scratch), which returns row i
+    // either in its own storage or written to the dim-float scratch. Only
+    // the sampled rows are read: when n > max_training_rows, the first
+    // max_training_rows of a shuffle seeded with options.seed.
+    using RowReader = std::function<const float*(int, float*)>;
+    void train(int n, const RowReader& row, const PQOptions& options);
+
+    void encode(const float* x, uint8_t* code) const;
+
+    // Encodes n row-major vectors into n x nsub codes.
+    void encode_batch(const float* data, int n, uint8_t* codes) const;
+
+    void decode(const uint8_t* code, float* x) const;
+
+    // out += scale * decode(code)
+    void accumulate(const uint8_t* code, float scale, float* out) const;
+
+    int dim() const noexcept { return dim_; }
+    int dsub() const noexcept { return dsub_; }
+    int nsub() const noexcept { return nsub_; }
+
+    const float* centroids() const noexcept { return centroids_.data(); }
+    size_t centroid_bytes() const noexcept
+    {
+        return centroids_.size() * sizeof(float);
+    }
+
+private:
+    // Nearest centroid of sub-space s for n sub-vectors at points + i * ld.
+    void assign(int s, const float* points, int ld, int n, int* out) const;
+
+    void train_subspace(int s,
+                        const float* points,
+                        int ld,
+                        int n,
+                        const PQOptions& options);
+
+    int dim_;
+    int dsub_;
+    int nsub_;
+
+    std::vector<float> centroids_;
+};
@@ -0,0 +1,397 @@
+#include "attention_sentence_encoder.h"
+#include "word_encoder.h"
+#include "config/model_config.h"
+#include "embedding/embedding_table.h"
+#include "simd/kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Grows v to at least n elements; never shrinks, so reuse does not allocate.
+void ensure_size(std::vector<float>& v, size_t n)
+{
+    if (v.size() < n)
+        v.resize(n);
+}
+
+// One attention head over T tokens whose head slices start at
+// words + t * ld: scores, softmax and the weighted sum in a single routine,
+// with the dot products and accumulation done by the SIMD kernels. Leaves
+// the attention weights in weights[0..T).
+void attend_head(const float* words,
+                 int T,
+                 int ld,
+                 const float* query,
+                 int head_dim,
+                 float scale,
+                 float* weights,
+                 float* out)
+{
+    float max_score = -std::numeric_limits<float>::infinity();
+
+    for (int t = 0; t < T; ++t) {
+        weights[t] = vec_dot(query, words + t * ld, head_dim) * scale;
+        max_score = std::max(max_score, weights[t]);
+    }
+
+    float sum = 0.0f;
+    for (int t = 0; t < T; ++t) {
+        weights[t] = std::exp(weights[t] - max_score);
+        sum += weights[t];
+    }
+
+    float inv = 1.0f / sum;
+
+    std::memset(out, 0, head_dim * sizeof(float));
+    for (int t = 0; t < T; ++t) {
+        weights[t] *= inv;
+        vec_axpy(weights[t], words + t * ld, out, head_dim);
+    }
+}
+
+}  // namespace
+
+AttentionSentenceEncoder::AttentionSentenceEncoder(
+    const WordEncoder& word_encoder,
+    int num_heads,
+    bool use_projection,
+    bool use_residual)
+    : word_encoder_(word_encoder),
+      dim_(word_encoder.dim()),
+      num_heads_(num_heads),
+      head_dim_(0),
+      use_projection_(use_projection),
+      use_residual_(use_residual),
+      score_scale_(0.0f),
+      weights_(std::make_shared<Weights>())
+{
+    if (num_heads <= 0 || dim_ % num_heads != 0)
+        throw std::invalid_argument(
+            "num_heads must be positive and divide the embedding dim");
+
+    head_dim_ = dim_ / num_heads;
+    score_scale_ = 1.0f / std::sqrt(static_cast<float>(head_dim_));
+
+    weights_->queries.assign(dim_, 0.0f);
+
+    if (use_projection_) {
+        weights_->projection.assign(static_cast<size_t>(dim_) * dim_, 0.0f);
+
+        // Without the residual the projection must carry the signal itself
+        if (!use_residual_)
+            for (int i = 0; i < dim_; ++i)
+                weights_->projection[static_cast<size_t>(i) * dim_ + i] = 1.0f;
+    }
+
+    scratch_pooled_.resize(dim_);
+    scratch_mean_.resize(dim_);
+    scratch_dpooled_.resize(dim_);
+    scratch_dquery_.resize(head_dim_);
+}
+
+AttentionSentenceEncoder::AttentionSentenceEncoder(
+    const AttentionSentenceEncoder& other,
+    const WordEncoder& word_encoder)
+    : word_encoder_(word_encoder),
+      dim_(other.dim_),
+      num_heads_(other.num_heads_),
+      head_dim_(other.head_dim_),
+      use_projection_(other.use_projection_),
+      use_residual_(other.use_residual_),
+      score_scale_(other.score_scale_),
+      weights_(other.weights_)
+{
+    if (word_encoder.dim() != dim_)
+        throw std::invalid_argument("word encoder dim does not match");
+
+    scratch_pooled_.resize(dim_);
+    scratch_mean_.resize(dim_);
+    scratch_dpooled_.resize(dim_);
+    scratch_dquery_.resize(head_dim_);
+}
+
+std::unique_ptr<ISentenceEncoder> AttentionSentenceEncoder::clone(
+    const WordEncoder& word_encoder) const
+{
+    return std::unique_ptr<ISentenceEncoder>(
+        new AttentionSentenceEncoder(*this, word_encoder));
+}
+
+void AttentionSentenceEncoder::load_parameters(
+    const float* queries,
+    const float* projection)
+{
+    std::copy(queries, queries + dim_, weights_->queries.begin());
+
+    if (use_projection_) {
+        std::copy(projection, projection + weights_->projection.size(),
+                  weights_->projection.begin());
+    }
+}
+
+template <class Tokens>
+int AttentionSentenceEncoder::load_words(const Tokens& tokens) const
+{
+    int T = static_cast<int>(tokens.size());
+    ensure_size(scratch_words_, static_cast<size_t>(T) * dim_);
+
+    float* row = scratch_words_.data();
+    for (const auto& token : tokens) {
+        word_encoder_.encode(token, row);
+        row += dim_;
+    }
+
+    return T;
+}
+
+void AttentionSentenceEncoder::pool(int T, float* pooled, float* mean) const
+{
+    if (T == 0) {
+        std::memset(pooled, 0, dim_ * sizeof(float));
+        if (mean)
+            std::memset(mean, 0, dim_ * sizeof(float));
+        return;
+    }
+
+    ensure_size(scratch_attention_, static_cast<size_t>(T) * num_heads_);
+
+    const float* words = scratch_words_.data();
+    const float* queries = weights_->queries.data();
+
+    for (int h = 0; h < num_heads_; ++h)
+        attend_head(words + h * head_dim_, T, dim_,
+                    queries + h * head_dim_, head_dim_, score_scale_,
+                    &scratch_attention_[static_cast<size_t>(h) * T],
+                    pooled + h * head_dim_);
+
+    if (mean) {
+        std::memset(mean, 0, dim_ * sizeof(float));
+        for (int t = 0; t < T; ++t)
+            vec_axpy(1.0f, words + static_cast<size_t>(t) * dim_, mean, dim_);
+        vec_scale(1.0f / T, mean, dim_);
+    }
+}
+
+void AttentionSentenceEncoder::finish(
+    const float* pooled,
+    const float* mean,
+    float* out) const
+{
+    if (use_projection_) {
+        const float* W = weights_->projection.data();
+        for (int j = 0; j < dim_; ++j)
+            out[j] = vec_dot(W + static_cast<size_t>(j) * dim_, pooled, dim_);
+    } else {
+        std::memcpy(out, pooled, dim_ * sizeof(float));
+    }
+
+    if (use_residual_)
+        vec_axpy(1.0f, mean, out, dim_);
+}
+
+template <class Tokens>
+void AttentionSentenceEncoder::encode_tokens(
+    const Tokens& tokens,
+    float* out) const
+{
+    int T = load_words(tokens);
+
+    float* mean = use_residual_ ? scratch_mean_.data() : nullptr;
+    pool(T, scratch_pooled_.data(), mean);
+    finish(scratch_pooled_.data(), mean, out);
+}
+
+void AttentionSentenceEncoder::encode(
+    const std::vector<std::string>& tokens,
+    float* out) const
+{
+    encode_tokens(tokens, out);
+}
+
+void AttentionSentenceEncoder::encode(
+    const TokenBuffer& tokens,
+    float* out) const
+{
+    encode_tokens(tokens, out);
+}
+
+void AttentionSentenceEncoder::encode(
+    const HashedSentence& tokens,
+    float* out) const
+{
+    encode_tokens(tokens, out);
+}
+
+void AttentionSentenceEncoder::encode_batch(
+    const TokenBuffer* sentences,
+    int n,
+    float* out) const
+{
+    if (!use_projection_) {
+        for (int i = 0; i < n; ++i)
+            encode_tokens(sentences[i], out + static_cast<size_t>(i) * dim_);
+        return;
+    }
+
+    // Pool every sentence first (pooled rows, then projected rows), so
+    // each projection row is streamed once per four sentences by gemm_nt
+    size_t rows = static_cast<size_t>(n) * dim_;
+    ensure_size(scratch_batch_, 2 * rows);
+    float* pooled = scratch_batch_.data();
+    float* projected = pooled + rows;
+
+    for (int i = 0; i < n; ++i) {
+        int T = load_words(sentences[i]);
+        pool(T, pooled + static_cast<size_t>(i) * dim_,
+             use_residual_ ? out + static_cast<size_t>(i) * dim_ : nullptr);
+    }
+
+    gemm_nt(n, dim_, dim_,
+            pooled, dim_,
+            weights_->projection.data(), dim_,
+            use_residual_ ? projected : out, dim_);
+
+    if (use_residual_)
+        vec_axpy(1.0f, projected, out, n * dim_);
+}
+
+template <class Tokens>
+void AttentionSentenceEncoder::backward_tokens(
+    const Tokens& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    Weights& w = *weights_;
+
+    int T = load_words(tokens);
+    float* pooled = scratch_pooled_.data();
+    pool(T, pooled, nullptr);
+
+    // Projection: dpooled = W^T dout (old W), then W -= lr dout pooled^T
+    float* dpooled = scratch_dpooled_.data();
+
+    if (use_projection_) {
+        std::memset(dpooled, 0, dim_ * sizeof(float));
+        for (int j = 0; j < dim_; ++j) {
+            vec_axpy_update(dout[j], -learning_rate * dout[j], pooled,
+                            &w.projection[static_cast<size_t>(j) * dim_],
+                            dpooled, dim_);
+        }
+    } else {
+        std::memcpy(dpooled, dout, dim_ * sizeof(float));
+    }
+
+    if (T == 0)
+        return;
+
+    ensure_size(scratch_dwords_, static_cast<size_t>(T) * dim_);
+    float* dwords = scratch_dwords_.data();
+    const float* words = scratch_words_.data();
+
+    // The residual mean spreads dout evenly over the tokens
+    for (int t = 0; t < T; ++t) {
+        float* dx = dwords + static_cast<size_t>(t) * dim_;
+        if (use_residual_) {
+            std::memcpy(dx, dout, dim_ * sizeof(float));
+            vec_scale(1.0f / T, dx, dim_);
+        } else {
+            std::memset(dx, 0, dim_ * sizeof(float));
+        }
+    }
+
+    // Per head, with a = softmax(s) and o = sum_t a_t x_t:
+    //   ds_t = a_t (do . x_t - do . o)
+    //   dx_t += a_t do + ds_t scale q,   dq = sum_t ds_t scale x_t
+    float* dq = scratch_dquery_.data();
+
+    for (int h = 0; h < num_heads_; ++h) {
+        const float* a = &scratch_attention_[static_cast<size_t>(h) * T];
+        const float* dp = dpooled + h * head_dim_;
+        float* q = &w.queries[h * head_dim_];
+
+        float dp_dot_o = vec_dot(dp, pooled + h * head_dim_, head_dim_);
+
+        std::memset(dq, 0, head_dim_ * sizeof(float));
+
+        for (int t = 0; t < T; ++t) {
+            size_t offset = static_cast<size_t>(t) * dim_ + h * head_dim_;
+            const float* x = words + offset;
+            float* dx = dwords + offset;
+
+            float ds = a[t] * (vec_dot(dp, x, head_dim_) - dp_dot_o) *
+                       score_scale_;
+
+            vec_axpy(a[t], dp, dx, head_dim_);
+            vec_axpy(ds, q, dx, head_dim_);
+            vec_axpy(ds, x, dq, head_dim_);
+        }
+
+        vec_axpy(-learning_rate, dq, q, head_dim_);
+    }
+
+    if (!embedding)
+        return;
+
+    // Each token's gradient goes to the rows its word vector read
+    int t = 0;
+    for (const auto& token : tokens) {
+        const float* dx = dwords + static_cast<size_t>(t++) * dim_;
+
+        scratch_grads_.clear();
+        word_encoder_.accumulate_bucket_weights(token, 1.0f, scratch_grads_);
+
+        for (const BucketWeight& g : scratch_grads_)
+            vec_axpy(-learning_rate * g.weight, dx,
+                     embedding->row(g.bucket), dim_);
+    }
+
+    embedding->bump_version();
+}
+
+void AttentionSentenceEncoder::backward(
+    const std::vector<std::string>& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    backward_tokens(tokens, dout, learning_rate, embedding);
+}
+
+void AttentionSentenceEncoder::backward(
+    const TokenBuffer& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    backward_tokens(tokens, dout, learning_rate, embedding);
+}
+
+void AttentionSentenceEncoder::backward(
+    const HashedSentence& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    backward_tokens(tokens, dout, learning_rate, embedding);
+}
+
+std::unique_ptr<AttentionSentenceEncoder> make_sentence_encoder(
+    const ModelConfig& config,
+    const WordEncoder& word_encoder)
+{
+    config.validate();
+
+    if (word_encoder.dim() != config.embedding_dim)
+        throw std::invalid_argument(
+            "word encoder dim does not match config.embedding_dim");
+
+    return std::make_unique<AttentionSentenceEncoder>(
+        word_encoder, config.num_heads, config.use_projection,
+        config.use_residual);
+}
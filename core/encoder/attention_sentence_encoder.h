@@ -0,0 +1,146 @@
+#pragma once
+
+#include "isentence_encoder.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class WordEncoder;
+class EmbeddingTable;
+struct BucketWeight;
+struct ModelConfig;
+
+// Multi-head attention pooling over word vectors.
+//
+// The dim-sized word vectors x_t are cut into num_heads slices of
+// head_dim = dim / num_heads. Head h has a learned query q_h and pools its
+// slice with
+//
+//     a_t = softmax_t(q_h . x_t[h] / sqrt(head_dim)),   o[h] = sum_t a_t x_t[h]
+//
+// in one fused pass per head (scores, softmax and weighted sum over a token
+// matrix kept in scratch). The sentence vector is
+//
+//     y = (use_projection ? W o : o) + (use_residual ? mean_t x_t : 0)
+//
+// Queries start at zero, i.e. uniform attention, and W at zero with the
+// residual or at the identity without it, so an untrained encoder equals
+// MeanSentenceEncoder and training only has to learn what to weight. There
+// is no projection bias: the classifier has one, and training both at
+// once diverges at the trainer's learning rates.
+//
+// Weights live in a block shared by clone()s; scratch grows to the longest
+// sentence seen and is reused, so steady-state encoding does not allocate.
+class AttentionSentenceEncoder : public ISentenceEncoder {
+public:
+    // Throws std::invalid_argument unless num_heads > 0 divides the dim.
+    explicit AttentionSentenceEncoder(const WordEncoder& word_encoder,
+                                      int num_heads = 4,
+                                      bool use_projection = true,
+                                      bool use_residual = true);
+
+    void encode(const std::vector<std::string>& tokens,
+                float* out) const override;
+    void encode(const TokenBuffer& tokens, float* out) const override;
+    void encode(const HashedSentence& tokens, float* out) const override;
+
+    // Encodes n sentences into out (n x dim). Pooling runs per sentence;
+    // the projection is one GEMM over the whole batch.
+    void encode_batch(const TokenBuffer* sentences,
+                      int n,
+                      float* out) const;
+
+    // Trains the queries and projection, and the embedding rows when
+    // embedding is not null. Re-runs the forward pass for tokens.
+    void backward(const std::vector<std::string>& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable* embedding) const override;
+    void backward(const TokenBuffer& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable* embedding) const override;
+    void backward(const HashedSentence& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable* embedding) const override;
+
+    bool trainable() const override { return true; }
+
+    int dim() const override { return dim_; }
+    int num_heads() const { return num_heads_; }
+    int head_dim() const { return head_dim_; }
+    bool use_projection() const { return use_projection_; }
+    bool use_residual() const { return use_residual_; }
+
+    const WordEncoder& word_encoder() const override { return word_encoder_; }
+
+    std::unique_ptr<ISentenceEncoder>
+    clone(const WordEncoder& word_encoder) const override;
+
+    // num_heads x head_dim queries (= dim floats) and the row-major
+    // dim x dim projection.
+    const float* queries() const { return weights_->queries.data(); }
+    const float* projection() const { return weights_->projection.data(); }
+
+    // Overwrites the weights, e.g. when loading a saved model. projection
+    // is ignored without use_projection.
+    void load_parameters(const float* queries, const float* projection);
+
+private:
+    struct Weights {
+        std::vector<float> queries;
+        std::vector<float> projection;
+    };
+
+    // Word vectors of tokens into scratch_words_ (T x dim); returns T.
+    template <class Tokens>
+    int load_words(const Tokens& tokens) const;
+
+    // Attention pooling of the T loaded words: fills scratch_attention_
+    // (T x num_heads), pooled (dim) and, with the residual, mean (dim).
+    void pool(int T, float* pooled, float* mean) const;
+
+    // y from pooled and mean, without the projection GEMM when batched.
+    void finish(const float* pooled, const float* mean, float* out) const;
+
+    template <class Tokens>
+    void encode_tokens(const Tokens& tokens, float* out) const;
+
+    template <class Tokens>
+    void backward_tokens(const Tokens& tokens,
+                         const float* dout,
+                         float learning_rate,
+                         EmbeddingTable* embedding) const;
+
+    AttentionSentenceEncoder(const AttentionSentenceEncoder& other,
+                             const WordEncoder& word_encoder);
+
+    const WordEncoder& word_encoder_;
+    int dim_;
+    int num_heads_;
+    int head_dim_;
+    bool use_projection_;
+    bool use_residual_;
+    float score_scale_;
+
+    std::shared_ptr<Weights> weights_;
+
+    mutable std::vector<float> scratch_words_;
+    mutable std::vector<float> scratch_attention_;
+    mutable std::vector<float> scratch_pooled_;
+    mutable std::vector<float> scratch_mean_;
+    mutable std::vector<float> scratch_dpooled_;
+    mutable std::vector<float> scratch_dwords_;
+    mutable std::vector<float> scratch_dquery_;
+    mutable std::vector<float> scratch_batch_;
+    mutable std::vector<BucketWeight> scratch_grads_;
+};
+
+// Encoder with config's num_heads, use_projection and use_residual and
+// freshly initialized weights. Throws std::invalid_argument if config is
+// invalid or word_encoder's dim is not config.embedding_dim.
+std::unique_ptr<AttentionSentenceEncoder>
+make_sentence_encoder(const ModelConfig& config,
+                      const WordEncoder& word_encoder);
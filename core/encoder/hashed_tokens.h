@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Buckets of one token as WordEncoder::compute_buckets() produced them, for
+// inputs that were tokenized and hashed ahead of time (streaming training).
+struct HashedToken {
+    const int* buckets;
+    int count;
+    int phonetic_bucket;   // -1 when there is none
+};
+
+// The tokens of one sentence as slices of a shared bucket array: token i
+// owns buckets[offsets[i], offsets[i + 1]) and phonetic[i]. Iterates like a
+// token container, so the sentence encoders accept it in place of strings.
+class HashedSentence {
+public:
+    HashedSentence(const uint32_t* offsets,
+                   const int* buckets,
+                   const int* phonetic,
+                   size_t size)
+        : offsets_(offsets), buckets_(buckets), phonetic_(phonetic),
+          size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    HashedToken operator[](size_t i) const
+    {
+        return {buckets_ + offsets_[i],
+                static_cast<int>(offsets_[i + 1] - offsets_[i]),
+                phonetic_[i]};
+    }
+
+    class iterator {
+    public:
+        iterator(const HashedSentence* s, size_t i) : s_(s), i_(i) {}
+        HashedToken operator*() const { return (*s_)[i_]; }
+        iterator& operator++() { ++i_; return *this; }
+        bool operator!=(const iterator& o) const { return i_ != o.i_; }
+
+    private:
+        const HashedSentence* s_;
+        size_t i_;
+    };
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size_); }
+
+private:
+    const uint32_t* offsets_;
+    const int* buckets_;
+    const int* phonetic_;
+    size_t size_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "hashed_tokens.h"
+#include "tokenizer/token_buffer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class EmbeddingTable;
+class WordEncoder;
+
+// Sentence vector from the word vectors of its tokens. Encoders keep
+// mutable scratch, so one instance serves one thread at a time; clone()
+// makes per-thread copies.
+class ISentenceEncoder {
+public:
+    virtual ~ISentenceEncoder() = default;
+
+    virtual void encode(const std::vector<std::string>& tokens,
+                        float* out) const = 0;
+    virtual void encode(const TokenBuffer& tokens, float* out) const = 0;
+    virtual void encode(const HashedSentence& tokens, float* out) const = 0;
+
+    // SGD step given the gradient of the loss w.r.t. the sentence vector:
+    // trains the encoder's own weights, if any, and the embedding rows the
+    // tokens read when embedding is not null.
+    virtual void backward(const std::vector<std::string>& tokens,
+                          const float* dout,
+                          float learning_rate,
+                          EmbeddingTable* embedding) const = 0;
+    virtual void backward(const TokenBuffer& tokens,
+                          const float* dout,
+                          float learning_rate,
+                          EmbeddingTable* embedding) const = 0;
+    virtual void backward(const HashedSentence& tokens,
+                          const float* dout,
+                          float learning_rate,
+                          EmbeddingTable* embedding) const = 0;
+
+    // True if backward() has weights of its own to train, so it is worth
+    // calling even when the embedding is frozen.
+    virtual bool trainable() const { return false; }
+
+    virtual int dim() const = 0;
+
+    virtual const WordEncoder& word_encoder() const = 0;
+
+    // Copy with private scratch that reads word vectors through
+    // word_encoder. Trainable weights stay shared with this encoder, so
+    // clones on worker threads train one model (Hogwild).
+    virtual std::unique_ptr<ISentenceEncoder>
+    clone(const WordEncoder& word_encoder) const = 0;
+};
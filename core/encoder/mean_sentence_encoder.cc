@@ -1,5 +1,9 @@
 #include "mean_sentence_encoder.h"
+#include "sparse_features.h"
 #include "word_encoder.h"
+#include "embedding/embedding_table.h"
+#include "simd/kernels.h"
+#include <algorithm>
 #include <cstring>
 
 MeanSentenceEncoder::MeanSentenceEncoder(
@@ -10,9 +14,10 @@ MeanSentenceEncoder::MeanSentenceEncoder(
     scratch_word_.resize(dim_);
 }
 
-void MeanSentenceEncoder::encode(
-    const std::vector<std::string>& tokens, 
-    float* out) const 
+template <class Tokens>
+void MeanSentenceEncoder::encode_tokens(
+    const Tokens& tokens,
+    float* out) const
 {
     std::memset(out, 0, dim_ * sizeof(float));
 
@@ -22,14 +27,186 @@ void MeanSentenceEncoder::encode(
     for (const auto& token : tokens) {
         word_encoder_.encode(token, scratch_word_.data());
 
-        for (int j = 0; j < dim_; ++j) {
-            out[j] += scratch_word_[j];
-        }
+        vec_axpy(1.0f, scratch_word_.data(), out, dim_);
     }
 
     // Average
+    vec_scale(1.0f / tokens.size(), out, dim_);
+}
+
+void MeanSentenceEncoder::encode(
+    const std::vector<std::string>& tokens, 
+    float* out) const 
+{
+    encode_tokens(tokens, out);
+}
+
+void MeanSentenceEncoder::encode(
+    const TokenBuffer& tokens,
+    float* out) const
+{
+    encode_tokens(tokens, out);
+}
+
+void MeanSentenceEncoder::encode(
+    const HashedSentence& tokens,
+    float* out) const
+{
+    encode_tokens(tokens, out);
+}
+
+template <class Tokens>
+void MeanSentenceEncoder::features_tokens(
+    const Tokens& tokens,
+    SparseFeatures& out) const
+{
+    if (!tokens.empty()) {
+        scratch_grads_.clear();
+
+        float inv = 1.0f / tokens.size();
+        for (const auto& token : tokens)
+            word_encoder_.accumulate_bucket_weights(token, inv,
+                                                    scratch_grads_);
+
+        for (const BucketWeight& g : scratch_grads_)
+            out.add(g.bucket, g.weight);
+    }
+
+    out.end_row();
+}
+
+void MeanSentenceEncoder::append_features(
+    const std::vector<std::string>& tokens,
+    SparseFeatures& out) const
+{
+    features_tokens(tokens, out);
+}
+
+void MeanSentenceEncoder::append_features(
+    const TokenBuffer& tokens,
+    SparseFeatures& out) const
+{
+    features_tokens(tokens, out);
+}
+
+void MeanSentenceEncoder::append_features(
+    const HashedSentence& tokens,
+    SparseFeatures& out) const
+{
+    features_tokens(tokens, out);
+}
+
+void MeanSentenceEncoder::encode_features(
+    const SparseFeatures& features,
+    int i,
+    float* out) const
+{
+    std::memset(out, 0, dim_ * sizeof(float));
+
+    const EmbeddingTable& table = word_encoder_.embedding();
+    const int* indices = features.row_indices(i);
+    const float* values = features.row_values(i);
+
+    for (int p = 0; p < features.row_size(i); ++p)
+        table.accumulate_row(indices[p], values[p], out);
+}
+
+template <class Tokens>
+void MeanSentenceEncoder::backward_tokens(
+    const Tokens& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable& embedding) const
+{
+    if (tokens.empty()) return;
+
+    scratch_grads_.clear();
+
     float inv = 1.0f / tokens.size();
-    for (int j = 0; j < dim_; ++j) {
-        out[j] *= inv;
+    for (const auto& token : tokens)
+        word_encoder_.accumulate_bucket_weights(token, inv, scratch_grads_);
+
+    // Merge repeated buckets so every row is written once
+    std::sort(scratch_grads_.begin(), scratch_grads_.end(),
+              [](const BucketWeight& a, const BucketWeight& b) {
+                  return a.bucket < b.bucket;
+              });
+
+    size_t i = 0;
+    while (i < scratch_grads_.size()) {
+        int bucket = scratch_grads_[i].bucket;
+        float weight = 0.0f;
+
+        for (; i < scratch_grads_.size() &&
+               scratch_grads_[i].bucket == bucket; ++i)
+            weight += scratch_grads_[i].weight;
+
+        vec_axpy(-learning_rate * weight, dout,
+                 embedding.row(bucket), dim_);
     }
-}
\ No newline at end of file
+
+    embedding.bump_version();
+}
+
+void MeanSentenceEncoder::backward(
+    const std::vector<std::string>& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable& embedding) const
+{
+    backward_tokens(tokens, dout, learning_rate, embedding);
+}
+
+void MeanSentenceEncoder::backward(
+    const TokenBuffer& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable& embedding) const
+{
+    backward_tokens(tokens, dout, learning_rate, embedding);
+}
+
+void MeanSentenceEncoder::backward(
+    const HashedSentence& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable& embedding) const
+{
+    backward_tokens(tokens, dout, learning_rate, embedding);
+}
+
+void MeanSentenceEncoder::backward(
+    const std::vector<std::string>& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    if (embedding)
+        backward_tokens(tokens, dout, learning_rate, *embedding);
+}
+
+void MeanSentenceEncoder::backward(
+    const TokenBuffer& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    if (embedding)
+        backward_tokens(tokens, dout, learning_rate, *embedding);
+}
+
+void MeanSentenceEncoder::backward(
+    const HashedSentence& tokens,
+    const float* dout,
+    float learning_rate,
+    EmbeddingTable* embedding) const
+{
+    if (embedding)
+        backward_tokens(tokens, dout, learning_rate, *embedding);
+}
+
+std::unique_ptr<ISentenceEncoder> MeanSentenceEncoder::clone(
+    const WordEncoder& word_encoder) const
+{
+    return std::make_unique<MeanSentenceEncoder>(word_encoder);
+}
@@ -1,21 +1,103 @@
 #pragma once
 
+#include "isentence_encoder.h"
+
 #include <string>
 #include <vector>
 
 class WordEncoder;
+class EmbeddingTable;
+struct BucketWeight;
+struct SparseFeatures;
 
-class MeanSentenceEncoder {
+class MeanSentenceEncoder : public ISentenceEncoder {
 public:
     explicit MeanSentenceEncoder(const WordEncoder& word_encoder);
 
-    void encode(const std::vector<std::string>& tokens, float* out) const;
-    
-    int dim() const { return dim_; }
+    void encode(const std::vector<std::string>& tokens,
+                float* out) const override;
+
+    // Allocation-free path for tokens viewed from a TokenBuffer.
+    void encode(const TokenBuffer& tokens, float* out) const override;
+
+    // Tokens hashed ahead of time (no tokenizer or n-gram work).
+    void encode(const HashedSentence& tokens, float* out) const override;
+
+    // Appends one row holding the embedding rows the sentence vector reads
+    // and their weights, i.e. encode(tokens) = sum_p values[p] *
+    // row(indices[p]), without reading the table. Input of the sparse and
+    // hybrid classifier heads.
+    void append_features(const std::vector<std::string>& tokens,
+                         SparseFeatures& out) const;
+    void append_features(const TokenBuffer& tokens, SparseFeatures& out) const;
+    void append_features(const HashedSentence& tokens,
+                         SparseFeatures& out) const;
+
+    // encode() of the tokens features row i was appended from, read
+    // straight from the feature row without hashing the tokens again.
+    void encode_features(const SparseFeatures& features,
+                         int i,
+                         float* out) const;
+
+    // Sparse SGD step for the embedding rows tokens read, given the gradient
+    // of the loss w.r.t. the sentence vector. Each touched row is updated
+    // once; the cost is proportional to the number of n-grams, not to the
+    // table size. embedding must be the table the word encoder reads.
+    void backward(const std::vector<std::string>& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable& embedding) const;
+
+    void backward(const TokenBuffer& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable& embedding) const;
+
+    void backward(const HashedSentence& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable& embedding) const;
+
+    // ISentenceEncoder: no weights of its own, so a null embedding is a
+    // no-op.
+    void backward(const std::vector<std::string>& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable* embedding) const override;
+
+    void backward(const TokenBuffer& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable* embedding) const override;
+
+    void backward(const HashedSentence& tokens,
+                  const float* dout,
+                  float learning_rate,
+                  EmbeddingTable* embedding) const override;
+
+    int dim() const override { return dim_; }
+
+    const WordEncoder& word_encoder() const override { return word_encoder_; }
+
+    std::unique_ptr<ISentenceEncoder>
+    clone(const WordEncoder& word_encoder) const override;
 
 private:
+    template <class Tokens>
+    void encode_tokens(const Tokens& tokens, float* out) const;
+
+    template <class Tokens>
+    void features_tokens(const Tokens& tokens, SparseFeatures& out) const;
+
+    template <class Tokens>
+    void backward_tokens(const Tokens& tokens,
+                         const float* dout,
+                         float learning_rate,
+                         EmbeddingTable& embedding) const;
+
     const WordEncoder& word_encoder_;
     int dim_;
 
     mutable std::vector<float> scratch_word_;
-};
\ No newline at end of file
+    mutable std::vector<BucketWeight> scratch_grads_;
+};
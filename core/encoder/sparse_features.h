@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+// Rows of weighted bucket ids in CSR form, the input of the sparse and
+// hybrid classifier heads: row i holds indices / values
+// [offsets[i], offsets[i + 1]). A bucket may repeat within a row; its
+// values add. clear() keeps the capacity, so a reused batch does not
+// allocate once warmed up.
+struct SparseFeatures {
+    std::vector<int> offsets = {0};
+    std::vector<int> indices;
+    std::vector<float> values;
+
+    int rows() const { return static_cast<int>(offsets.size()) - 1; }
+    int nnz() const { return static_cast<int>(indices.size()); }
+
+    // Entries of row i
+    int row_size(int i) const { return offsets[i + 1] - offsets[i]; }
+    const int* row_indices(int i) const { return indices.data() + offsets[i]; }
+    const float* row_values(int i) const { return values.data() + offsets[i]; }
+
+    void clear()
+    {
+        offsets.assign(1, 0);
+        indices.clear();
+        values.clear();
+    }
+
+    // Appends to the open row; end_row() closes it.
+    void add(int index, float value)
+    {
+        indices.push_back(index);
+        values.push_back(value);
+    }
+
+    void end_row() { offsets.push_back(static_cast<int>(indices.size())); }
+};
@@ -0,0 +1,310 @@
+#include "vocab_index.h"
+#include "word_encoder.h"
+#include "hashing/hash_function.h"
+#include "tokenizer/itokenizer.h"
+#include "utils/mapped_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+const char kVocabMagic[8] = {'G', 'L', 'A', 'D', 'V', 'O', 'C', '\0'};
+constexpr uint32_t kVocabVersion = 1;
+constexpr uint64_t kArrayAlignment = 64;
+
+uint64_t align_up(uint64_t x)
+{
+    return (x + kArrayAlignment - 1) & ~(kArrayAlignment - 1);
+}
+
+// Byte offsets of every array inside the image.
+struct VocabLayout {
+    uint64_t slots;
+    uint64_t token_offsets;
+    uint64_t token_chars;
+    uint64_t bucket_offsets;
+    uint64_t bucket_ids;
+    uint64_t phonetic;
+    uint64_t end;
+};
+
+VocabLayout layout_for(const VocabFileHeader& h)
+{
+    VocabLayout l;
+    l.slots = align_up(sizeof(VocabFileHeader));
+    l.token_offsets = align_up(l.slots + uint64_t(h.table_slots) * sizeof(VocabSlot));
+    l.token_chars = align_up(l.token_offsets + (h.token_count + 1) * sizeof(uint64_t));
+    l.bucket_offsets = align_up(l.token_chars + h.token_bytes);
+    l.bucket_ids = align_up(l.bucket_offsets + (h.token_count + 1) * sizeof(uint32_t));
+    l.phonetic = align_up(l.bucket_ids + h.bucket_entries * sizeof(int32_t));
+    l.end = align_up(l.phonetic + h.token_count * sizeof(int32_t));
+    return l;
+}
+
+uint32_t table_slots_for(size_t tokens)
+{
+    // Load factor <= 1/2 keeps linear probe sequences short
+    uint32_t slots = 16;
+    while (slots < 2 * tokens)
+        slots <<= 1;
+    return slots;
+}
+
+}  // namespace
+
+uint64_t VocabIndex::fingerprint(const WordEncoder& encoder)
+{
+    // The buckets of a few fixed probes change with the bucket count, the
+    // n-gram range and the phonetic settings.
+    static const char* const kProbes[] = {
+        "a", "the", "glad", "encoder", "xylophone", "robert", "rupert"
+    };
+
+    std::vector<int> values;
+    for (const char* probe : kProbes) {
+        int phonetic = encoder.compute_buckets(probe, values);
+        values.push_back(phonetic);
+    }
+    return HashFunction::checksum64(values.data(), values.size() * sizeof(int));
+}
+
+VocabIndex::VocabIndex(
+    const WordEncoder& encoder,
+    const std::vector<std::string>& vocabulary)
+{
+    std::unordered_map<std::string_view, int> ids;
+    std::vector<std::string_view> tokens;
+    for (const auto& t : vocabulary) {
+        if (ids.emplace(t, static_cast<int>(tokens.size())).second)
+            tokens.push_back(t);
+    }
+
+    std::vector<uint64_t> token_offsets = {0};
+    std::vector<uint32_t> bucket_offsets = {0};
+    std::vector<int32_t> bucket_ids;
+    std::vector<int32_t> phonetic;
+    std::vector<int> scratch;
+
+    for (std::string_view t : tokens) {
+        token_offsets.push_back(token_offsets.back() + t.size());
+
+        scratch.clear();
+        phonetic.push_back(encoder.compute_buckets(t, scratch));
+        bucket_ids.insert(bucket_ids.end(), scratch.begin(), scratch.end());
+        bucket_offsets.push_back(static_cast<uint32_t>(bucket_ids.size()));
+    }
+
+    header_ = VocabFileHeader{};
+    std::memcpy(header_.magic, kVocabMagic, sizeof(kVocabMagic));
+    header_.version = kVocabVersion;
+    header_.table_slots = table_slots_for(tokens.size());
+    header_.token_count = tokens.size();
+    header_.bucket_entries = bucket_ids.size();
+    header_.token_bytes = token_offsets.back();
+    header_.fingerprint = fingerprint(encoder);
+    header_.bucket_count = static_cast<uint32_t>(
+        encoder.bucket_count());
+
+    VocabLayout l = layout_for(header_);
+    storage_.assign(l.end / sizeof(uint64_t), 0);
+    unsigned char* image = reinterpret_cast<unsigned char*>(storage_.data());
+
+    auto put = [&](uint64_t offset, const void* data, size_t bytes) {
+        if (bytes)
+            std::memcpy(image + offset, data, bytes);
+    };
+
+    put(l.token_offsets, token_offsets.data(),
+        token_offsets.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < tokens.size(); ++i)
+        put(l.token_chars + token_offsets[i], tokens[i].data(), tokens[i].size());
+    put(l.bucket_offsets, bucket_offsets.data(),
+        bucket_offsets.size() * sizeof(uint32_t));
+    put(l.bucket_ids, bucket_ids.data(), bucket_ids.size() * sizeof(int32_t));
+    put(l.phonetic, phonetic.data(), phonetic.size() * sizeof(int32_t));
+
+    VocabSlot* slots = reinterpret_cast<VocabSlot*>(image + l.slots);
+    uint32_t mask = header_.table_slots - 1;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        uint64_t hash = HashFunction::fnv1a(tokens[i]);
+        uint32_t s = static_cast<uint32_t>(hash) & mask;
+        while (slots[s].id != 0)
+            s = (s + 1) & mask;
+        slots[s].hash = hash;
+        slots[s].id = static_cast<uint32_t>(i + 1);
+    }
+
+    header_.checksum = HashFunction::checksum64(
+        image + sizeof(VocabFileHeader), l.end - sizeof(VocabFileHeader));
+    std::memcpy(image, &header_, sizeof(header_));
+
+    bind(image, l.end);
+}
+
+VocabIndex::VocabIndex(
+    const std::string& path,
+    bool prewarm,
+    bool verify_checksum)
+    : mapping_(std::make_shared<MappedFile>(path, prewarm))
+{
+    if (mapping_->size() < sizeof(VocabFileHeader))
+        throw std::runtime_error("truncated vocabulary file '" + path + "'");
+
+    VocabFileHeader header;
+    std::memcpy(&header, mapping_->data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kVocabMagic, sizeof(kVocabMagic)) != 0)
+        throw std::runtime_error("not a vocabulary file '" + path + "'");
+    if (header.version != kVocabVersion)
+        throw std::runtime_error("unsupported vocabulary file version");
+
+    // Bound the untrusted sizes by the file before layout_for adds them up;
+    // token_count < table_slots keeps it below 2^32.
+    uint64_t size = mapping_->size();
+
+    if (header.table_slots == 0 ||
+        (header.table_slots & (header.table_slots - 1)) != 0 ||
+        header.token_count >= header.table_slots ||
+        header.token_bytes > size ||
+        header.bucket_entries > UINT32_MAX ||
+        header.bucket_count == 0 || header.bucket_count > INT32_MAX ||
+        layout_for(header).end > size)
+        throw std::runtime_error("corrupt vocabulary header '" + path + "'");
+
+    uint64_t end = layout_for(header).end;
+
+    if (verify_checksum &&
+        HashFunction::checksum64(mapping_->data() + sizeof(VocabFileHeader),
+                                 end - sizeof(VocabFileHeader)) !=
+            header.checksum)
+        throw std::runtime_error("vocabulary checksum mismatch '" + path + "'");
+
+    bind(mapping_->data(), end);
+    validate(path);
+}
+
+VocabIndex::~VocabIndex() = default;
+
+void VocabIndex::bind(const unsigned char* image, size_t size)
+{
+    std::memcpy(&header_, image, sizeof(header_));
+    VocabLayout l = layout_for(header_);
+
+    image_ = image;
+    image_size_ = size;
+
+    slots_ = reinterpret_cast<const VocabSlot*>(image + l.slots);
+    token_offsets_ = reinterpret_cast<const uint64_t*>(image + l.token_offsets);
+    token_chars_ = reinterpret_cast<const char*>(image + l.token_chars);
+    bucket_offsets_ = reinterpret_cast<const uint32_t*>(image + l.bucket_offsets);
+    bucket_ids_ = reinterpret_cast<const int32_t*>(image + l.bucket_ids);
+    phonetic_ = reinterpret_cast<const int32_t*>(image + l.phonetic);
+}
+
+void VocabIndex::validate(const std::string& path) const
+{
+    uint64_t tokens = header_.token_count;
+    auto corrupt = [&]() {
+        return std::runtime_error("corrupt vocabulary arrays '" + path + "'");
+    };
+
+    if (token_offsets_[0] != 0 ||
+        token_offsets_[tokens] != header_.token_bytes ||
+        bucket_offsets_[0] != 0 ||
+        bucket_offsets_[tokens] != header_.bucket_entries)
+        throw corrupt();
+
+    int32_t buckets = static_cast<int32_t>(header_.bucket_count);
+
+    for (uint64_t t = 0; t < tokens; ++t) {
+        if (token_offsets_[t] > token_offsets_[t + 1] ||
+            bucket_offsets_[t] > bucket_offsets_[t + 1] ||
+            phonetic_[t] < -1 || phonetic_[t] >= buckets)
+            throw corrupt();
+    }
+
+    for (uint64_t e = 0; e < header_.bucket_entries; ++e)
+        if (bucket_ids_[e] < 0 || bucket_ids_[e] >= buckets)
+            throw corrupt();
+
+    // find() stops at the first empty slot, so one must exist
+    bool has_empty = false;
+    for (uint32_t s = 0; s < header_.table_slots; ++s) {
+        if (slots_[s].id > tokens)
+            throw corrupt();
+        has_empty |= slots_[s].id == 0;
+    }
+    if (!has_empty)
+        throw corrupt();
+}
+
+int VocabIndex::find(std::string_view token) const noexcept
+{
+    uint64_t hash = HashFunction::fnv1a(token);
+    uint32_t mask = header_.table_slots - 1;
+
+    for (uint32_t s = static_cast<uint32_t>(hash) & mask;;
+         s = (s + 1) & mask) {
+        const VocabSlot& slot = slots_[s];
+        if (slot.id == 0)
+            return -1;
+        int id = static_cast<int>(slot.id - 1);
+        if (slot.hash == hash && this->token(id) == token)
+            return id;
+    }
+}
+
+void VocabIndex::save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot open '" + path + "' for writing");
+
+    out.write(reinterpret_cast<const char*>(image_),
+              static_cast<std::streamsize>(image_size_));
+
+    if (!out)
+        throw std::runtime_error("failed writing '" + path + "'");
+}
+
+std::vector<std::string> VocabIndex::collect(
+    const ITokenizer& tokenizer,
+    const std::vector<std::string>& texts,
+    int min_count,
+    size_t max_tokens)
+{
+    std::unordered_map<std::string, int> counts;
+    std::vector<std::string> tokens;
+
+    for (const auto& text : texts) {
+        tokens.clear();
+        tokenizer.tokenize(text, tokens);
+        for (auto& t : tokens)
+            ++counts[t];
+    }
+
+    std::vector<std::pair<std::string, int>> sorted;
+    for (auto& kv : counts)
+        if (kv.second >= min_count)
+            sorted.emplace_back(kv.first, kv.second);
+
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) {
+                  return a.second != b.second ? a.second > b.second
+                                              : a.first < b.first;
+              });
+
+    if (max_tokens > 0 && sorted.size() > max_tokens)
+        sorted.resize(max_tokens);
+
+    std::vector<std::string> out;
+    out.reserve(sorted.size());
+    for (auto& kv : sorted)
+        out.push_back(std::move(kv.first));
+    return out;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ITokenizer;
+class MappedFile;
+class WordEncoder;
+
+// On-disk layout written by VocabIndex::save(), all arrays 64-byte aligned
+// in this order after the header:
+//   slots          table_slots x VocabSlot (open addressing, linear probe)
+//   token_offsets  (token_count + 1) x uint64
+//   token_chars    token_bytes
+//   bucket_offsets (token_count + 1) x uint32   (CSR row pointers)
+//   bucket_ids     bucket_entries x int32
+//   phonetic       token_count x int32          (-1: none)
+// The in-memory index uses the same image, so save() is a single write and
+// a mapped file is used in place.
+struct VocabFileHeader {
+    char magic[8];            // "GLADVOC\0"
+    uint32_t version;
+    uint32_t table_slots;     // power of two
+    uint64_t token_count;
+    uint64_t bucket_entries;
+    uint64_t token_bytes;
+    uint64_t fingerprint;     // of the WordEncoder configuration
+    uint64_t checksum;        // HashFunction::checksum64 over the arrays
+    uint32_t bucket_count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(VocabFileHeader) == 64,
+              "VocabFileHeader must stay 64 bytes");
+
+struct VocabSlot {
+    uint64_t hash;            // HashFunction::fnv1a of the token
+    uint32_t id;              // token id + 1, 0 marks an empty slot
+    uint32_t pad;
+};
+
+// Precomputed token -> (n-gram buckets, phonetic bucket) lists for a known
+// vocabulary. WordEncoder::set_vocab_index() makes in-vocabulary tokens skip
+// n-gram generation, hashing and the phonetic encoder entirely.
+class VocabIndex {
+public:
+    // Computes the buckets of every distinct token with encoder.
+    VocabIndex(const WordEncoder& encoder,
+               const std::vector<std::string>& vocabulary);
+
+    // Maps a file written by save() read-only. The offset arrays, bucket
+    // ids and probe table are always range-checked (one pass over the
+    // arrays), so a stale or corrupt file cannot cause out-of-bounds reads;
+    // verify_checksum additionally hashes every byte. Throws
+    // std::runtime_error on I/O or format errors.
+    explicit VocabIndex(const std::string& path,
+                        bool prewarm = false,
+                        bool verify_checksum = false);
+
+    ~VocabIndex();
+
+    VocabIndex(const VocabIndex&) = delete;
+    VocabIndex& operator=(const VocabIndex&) = delete;
+
+    // Token id, or -1 when token is not in the vocabulary.
+    int find(std::string_view token) const noexcept;
+
+    const int32_t* buckets(int id) const noexcept
+    {
+        return bucket_ids_ + bucket_offsets_[id];
+    }
+    int bucket_count(int id) const noexcept
+    {
+        return static_cast<int>(bucket_offsets_[id + 1] - bucket_offsets_[id]);
+    }
+    int phonetic_bucket(int id) const noexcept { return phonetic_[id]; }
+
+    std::string_view token(int id) const noexcept
+    {
+        return std::string_view(token_chars_ + token_offsets_[id],
+                                token_offsets_[id + 1] - token_offsets_[id]);
+    }
+
+    int size() const noexcept { return static_cast<int>(header_.token_count); }
+
+    // Identifies the encoder settings the buckets were computed with.
+    uint64_t fingerprint() const noexcept { return header_.fingerprint; }
+    static uint64_t fingerprint(const WordEncoder& encoder);
+
+    size_t memory_bytes() const noexcept { return image_size_; }
+    bool is_mapped() const noexcept { return mapping_ != nullptr; }
+
+    void save(const std::string& path) const;
+
+    // Distinct tokens of texts seen at least min_count times, most frequent
+    // first (ties by token); max_tokens = 0 keeps all of them.
+    static std::vector<std::string> collect(const ITokenizer& tokenizer,
+                                            const std::vector<std::string>& texts,
+                                            int min_count = 1,
+                                            size_t max_tokens = 0);
+
+private:
+    // Points the array views into a complete image.
+    void bind(const unsigned char* image, size_t size);
+
+    // Throws std::runtime_error unless the bound arrays are consistent:
+    // monotone offsets ending at token_bytes / bucket_entries, bucket ids
+    // below bucket_count and a probe table that terminates.
+    void validate(const std::string& path) const;
+
+    VocabFileHeader header_;
+
+    const VocabSlot* slots_ = nullptr;
+    const uint64_t* token_offsets_ = nullptr;
+    const char* token_chars_ = nullptr;
+    const uint32_t* bucket_offsets_ = nullptr;
+    const int32_t* bucket_ids_ = nullptr;
+    const int32_t* phonetic_ = nullptr;
+
+    const unsigned char* image_ = nullptr;
+    size_t image_size_ = 0;
+
+    std::vector<uint64_t> storage_;           // owned image (8-byte aligned)
+    std::shared_ptr<MappedFile> mapping_;
+};
@@ -1,82 +1,233 @@
 #include "word_encoder.h"
-#include "hashing/hash_function.h"
 #include "ngram/ngram_generator.h"
 #include "phonetic/phonetic_encoder.h"
 #include "embedding/embedding_table.h"
+#include "hashing/hash_function.h"
+#include "simd/kernels.h"
+#include "vocab_index.h"
+#include "word_vector_cache.h"
 #include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Bucket routines with the hash and reduction inlined into the n-gram loop.
+template <typename Hash, typename Reduce>
+struct BucketHasher {
+    static void ngrams(const NGramGenerator& ngram,
+                       std::string_view token,
+                       const BucketRange& range,
+                       std::vector<int>& out)
+    {
+        if constexpr (Hash::ROLLING) {
+            ngram.hash_buckets(token, [&range](uint64_t hash) {
+                return Reduce::reduce(hash, range);
+            }, out);
+        } else {
+            ngram.for_each_ngram(token, [&](std::string_view g) {
+                out.push_back(static_cast<int>(
+                    Reduce::reduce(Hash::hash(g), range)));
+            });
+        }
+    }
+
+    static int key(std::string_view key, const BucketRange& range)
+    {
+        return static_cast<int>(Reduce::reduce(Hash::hash(key), range));
+    }
+};
+
+template <typename Hash>
+WordEncoder::BucketFunctions select_reduction(BucketReduction reduction)
+{
+    switch (reduction) {
+        case BucketReduction::MULTIPLY_SHIFT:
+            return {BucketHasher<Hash, MultiplyShiftReduce>::ngrams,
+                    BucketHasher<Hash, MultiplyShiftReduce>::key};
+        case BucketReduction::POW2_MASK:
+            return {BucketHasher<Hash, Pow2MaskReduce>::ngrams,
+                    BucketHasher<Hash, Pow2MaskReduce>::key};
+        case BucketReduction::MODULO:
+            break;
+    }
+    return {BucketHasher<Hash, ModuloReduce>::ngrams,
+            BucketHasher<Hash, ModuloReduce>::key};
+}
+
+WordEncoder::BucketFunctions select_buckets(HashPolicy hash,
+                                            BucketReduction reduction)
+{
+    switch (hash) {
+        case HashPolicy::MURMUR3:
+            return select_reduction<Murmur3Hash>(reduction);
+        case HashPolicy::WYHASH:
+            return select_reduction<WyHash>(reduction);
+        case HashPolicy::FNV1A:
+            break;
+    }
+    return select_reduction<Fnv1aHash>(reduction);
+}
+
+}  // namespace
 
 WordEncoder::WordEncoder(
     const EmbeddingTable& embedding,
     const NGramGenerator& ngram,
     const PhoneticEncoder* phonetic,
     int bucket_count,
-    float phonetic_gamma)
+    float phonetic_gamma,
+    HashPolicy hash,
+    BucketReduction reduction)
     : embedding_(embedding),
       ngram_(ngram),
       phonetic_(phonetic),
       bucket_count_(bucket_count),
-      gamma_(phonetic_gamma)
+      gamma_(phonetic_gamma),
+      hash_policy_(hash),
+      reduction_(reduction),
+      range_(static_cast<uint64_t>(bucket_count > 0 ? bucket_count : 1)),
+      buckets_(select_buckets(hash, reduction))
 {
-    scratch_ngrams_.reserve(32);
-    scratch_wrapped_.reserve(64);
+    if (reduction == BucketReduction::POW2_MASK &&
+        (bucket_count & (bucket_count - 1)) != 0)
+        throw std::invalid_argument(
+            "POW2_MASK needs a power-of-two bucket_count");
+
     scratch_phonetic_.reserve(8);
+    scratch_buckets_.reserve(32);
+}
+
+void WordEncoder::set_cache(WordVectorCache* cache) {
+    if (cache && cache->dim() != embedding_.dim())
+        throw std::invalid_argument("cache dim does not match embedding dim");
+
+    if (cache) {
+        // Table, bucket mapping (as in VocabIndex) and phonetic weight
+        uint64_t owner[3] = {embedding_.id(), VocabIndex::fingerprint(*this),
+                             0};
+        std::memcpy(&owner[2], &gamma_, sizeof(gamma_));
+        cache_owner_ = HashFunction::checksum64(owner, sizeof(owner));
+    }
+    cache_ = cache;
+}
+
+void WordEncoder::set_vocab_index(const VocabIndex* index) {
+    if (index && index->fingerprint() != VocabIndex::fingerprint(*this))
+        throw std::invalid_argument(
+            "vocabulary index was built with different encoder settings");
+    vocab_ = index;
 }
 
 int WordEncoder::dim() const {
     return embedding_.dim();
 }
 
-void WordEncoder::encode(
-    const std::string& token,
-    float* out) const
+int WordEncoder::compute_buckets(
+    std::string_view token,
+    std::vector<int>& ngram_buckets) const
 {
-    int dim = embedding_.dim();
+    buckets_.ngrams(ngram_, token, range_, ngram_buckets);
 
-    std::memset(out, 0, dim * sizeof(float));
+    if (phonetic_ && gamma_ > 0.0f) {
+        phonetic_->encode(token, scratch_phonetic_);
 
-    scratch_ngrams_.clear();
-    scratch_wrapped_.clear();
+        if (!scratch_phonetic_.empty())
+            return buckets_.key(scratch_phonetic_, range_);
+    }
 
-    ngram_.generate(token,
-                    scratch_wrapped_,
-                    scratch_ngrams_);
+    return -1;
+}
 
-    int count = 0;
+int WordEncoder::resolve_buckets(
+    std::string_view token,
+    const int*& buckets,
+    int& count) const
+{
+    if (vocab_) {
+        int id = vocab_->find(token);
+        if (id >= 0) {
+            buckets = vocab_->buckets(id);
+            count = vocab_->bucket_count(id);
+            return vocab_->phonetic_bucket(id);
+        }
+    }
 
-    for (auto& g : scratch_ngrams_) {
-        uint64_t hash = HashFunction::fnv1a(g);
-        int bucket = hash % bucket_count_;
+    scratch_buckets_.clear();
+    int phonetic_bucket = compute_buckets(token, scratch_buckets_);
 
-        const float* row = embedding_.row(bucket);
+    buckets = scratch_buckets_.data();
+    count = static_cast<int>(scratch_buckets_.size());
+    return phonetic_bucket;
+}
 
-        for (int j = 0; j < dim; ++j)
-            out[j] += row[j];
+void WordEncoder::encode_buckets(
+    const int* ngram_buckets,
+    int count,
+    int phonetic_bucket,
+    float* out) const
+{
+    int dim = embedding_.dim();
 
-        count++;
-    }
+    std::memset(out, 0, dim * sizeof(float));
+
+    for (int i = 0; i < count; ++i)
+        embedding_.accumulate_row(ngram_buckets[i], 1.0f, out);
 
-    if (count > 0) {
-        float inv = 1.0f / count;
-        for (int j = 0; j < dim; ++j)
-            out[j] *= inv;
+    if (count > 0)
+        vec_scale(1.0f / count, out, dim);
+
+    if (phonetic_bucket >= 0)
+        embedding_.accumulate_row(phonetic_bucket, gamma_, out);
+}
+
+void WordEncoder::encode(
+    std::string_view token,
+    float* out) const
+{
+    // Read the version first: a vector computed while rows change is
+    // tagged with the older version and never served afterwards.
+    // Rows under training change every step: caching would only churn.
+    WordVectorCache* cache = embedding_.trainable() ? nullptr : cache_;
+
+    uint64_t version = 0;
+    if (cache) {
+        version = embedding_.version();
+        if (cache->lookup(cache_owner_, token, version, out))
+            return;
     }
 
-    if (phonetic_ && gamma_ > 0.0f) {
-        scratch_phonetic_.clear();
-        scratch_phonetic_ =
-            phonetic_->encode(token);
+    const int* buckets;
+    int count;
+    int phonetic_bucket = resolve_buckets(token, buckets, count);
 
-        if (!scratch_phonetic_.empty()) {
-            uint64_t hash =
-                HashFunction::fnv1a(scratch_phonetic_);
+    encode_buckets(buckets, count, phonetic_bucket, out);
 
-            int bucket = hash % bucket_count_;
+    if (cache)
+        cache->insert(cache_owner_, token, version, out);
+}
 
-            const float* row =
-                embedding_.row(bucket);
+void WordEncoder::accumulate_bucket_weights(
+    std::string_view token,
+    float scale,
+    std::vector<BucketWeight>& out) const
+{
+    HashedToken hashed;
+    hashed.phonetic_bucket = resolve_buckets(token, hashed.buckets,
+                                             hashed.count);
+    accumulate_bucket_weights(hashed, scale, out);
+}
 
-            for (int j = 0; j < dim; ++j)
-                out[j] += gamma_ * row[j];
-        }
+void WordEncoder::accumulate_bucket_weights(
+    const HashedToken& token,
+    float scale,
+    std::vector<BucketWeight>& out) const
+{
+    if (token.count > 0) {
+        float w = scale / token.count;
+        for (int i = 0; i < token.count; ++i)
+            out.push_back({token.buckets[i], w});
     }
+
+    if (token.phonetic_bucket >= 0)
+        out.push_back({token.phonetic_bucket, scale * gamma_});
 }
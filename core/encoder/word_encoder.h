@@ -1,27 +1,106 @@
 #pragma once
 
+#include "config/model_config.h"
+#include "hashing/bucket_policy.h"
+#include "hashed_tokens.h"
+
 #include <string>
+#include <string_view>
 #include <vector>
 
 class EmbeddingTable;
 class NGramGenerator;
 class PhoneticEncoder;
+class VocabIndex;
+class WordVectorCache;
+
+// Gradient weight of one embedding row: d(output) / d(row) = weight * I.
+struct BucketWeight {
+    int bucket;
+    float weight;
+};
 
 class WordEncoder {
 public:
+    // hash and reduction select the bucket scheme recorded in ModelConfig;
+    // throws std::invalid_argument for POW2_MASK with a bucket_count that
+    // is not a power of two.
     WordEncoder(const EmbeddingTable& embedding,
                 const NGramGenerator& ngram,
                 const PhoneticEncoder* phonetic,
                 int bucket_count,
-                float phonetic_gamma);
+                float phonetic_gamma,
+                HashPolicy hash = HashPolicy::FNV1A,
+                BucketReduction reduction = BucketReduction::MODULO);
+
+    void encode(std::string_view token, float* out) const;
+
+    // Same vector from buckets computed ahead of time.
+    void encode(const HashedToken& token, float* out) const {
+        encode_buckets(token.buckets, token.count, token.phonetic_bucket, out);
+    }
+
+    // Appends the n-gram buckets of token to ngram_buckets and returns the
+    // phonetic bucket, or -1 when the phonetic term is disabled or empty.
+    int compute_buckets(std::string_view token,
+                        std::vector<int>& ngram_buckets) const;
+
+    // Word vector from precomputed buckets:
+    //   mean(rows[ngram_buckets]) + gamma * rows[phonetic_bucket]
+    void encode_buckets(const int* ngram_buckets,
+                        int count,
+                        int phonetic_bucket,
+                        float* out) const;
+
+    // Appends the rows token reads and their weights, scaled by scale, so a
+    // caller can push an output gradient back into just those rows.
+    void accumulate_bucket_weights(std::string_view token,
+                                   float scale,
+                                   std::vector<BucketWeight>& out) const;
+
+    void accumulate_bucket_weights(const HashedToken& token,
+                                   float scale,
+                                   std::vector<BucketWeight>& out) const;
+
+    // Optional shared cache consulted by encode(); not owned, nullptr
+    // disables it. Entries are keyed by the table's id and this encoder's
+    // settings, so only encoders producing identical vectors share them,
+    // and tagged with the embedding version, so row updates invalidate
+    // them. While the table is trainable() the cache is bypassed. Throws
+    // std::invalid_argument on a dim mismatch.
+    void set_cache(WordVectorCache* cache);
+    WordVectorCache* cache() const { return cache_; }
+
+    // Optional precomputed buckets for known tokens (not owned, nullptr
+    // disables). In-vocabulary tokens skip n-gram generation, hashing and
+    // the phonetic encoder. Throws std::invalid_argument if the index was
+    // built with different encoder settings.
+    void set_vocab_index(const VocabIndex* index);
+    const VocabIndex* vocab_index() const { return vocab_; }
 
-    void encode(const std::string& token, float* out) const;
-    
     // Accessors
     const EmbeddingTable& embedding() const { return embedding_; }
     int dim() const;
+    int bucket_count() const { return bucket_count_; }
+    HashPolicy hash_policy() const { return hash_policy_; }
+    BucketReduction bucket_reduction() const { return reduction_; }
+
+    // One BucketHasher<Hash, Reduce> instantiation, picked at construction.
+    struct BucketFunctions {
+        void (*ngrams)(const NGramGenerator& ngram,
+                       std::string_view token,
+                       const BucketRange& range,
+                       std::vector<int>& out);
+        int (*key)(std::string_view key, const BucketRange& range);
+    };
 
 private:
+    // Buckets of token from the vocabulary index when it knows the token,
+    // otherwise computed into scratch_buckets_. Returns the phonetic bucket.
+    int resolve_buckets(std::string_view token,
+                        const int*& buckets,
+                        int& count) const;
+
     const EmbeddingTable& embedding_;
     const NGramGenerator& ngram_;
     const PhoneticEncoder* phonetic_;
@@ -29,8 +108,16 @@ private:
     int bucket_count_;
     float gamma_;
 
+    HashPolicy hash_policy_;
+    BucketReduction reduction_;
+    BucketRange range_;
+    BucketFunctions buckets_;
+
+    WordVectorCache* cache_ = nullptr;
+    uint64_t cache_owner_ = 0;
+    const VocabIndex* vocab_ = nullptr;
+
     // Scratch buffers
-    mutable std::vector<std::string_view> scratch_ngrams_;
-    mutable std::string scratch_wrapped_;
     mutable std::string scratch_phonetic_;
+    mutable std::vector<int> scratch_buckets_;
 };
@@ -0,0 +1,209 @@
+#include "word_vector_cache.h"
+#include "hashing/hash_function.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct CacheKey {
+    uint64_t owner;
+    std::string_view token;
+
+    bool operator==(const CacheKey& other) const
+    {
+        return owner == other.owner && token == other.token;
+    }
+};
+
+struct CacheKeyHash {
+    size_t operator()(const CacheKey& key) const
+    {
+        return static_cast<size_t>(HashFunction::fnv1a(key.token) ^
+                                   (key.owner * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+}  // namespace
+
+struct alignas(64) WordVectorCache::Shard {
+    std::mutex mutex;
+
+    // Keys view the slot strings, so lookups by string_view do not copy.
+    std::unordered_map<CacheKey, int, CacheKeyHash> index;
+    std::vector<std::string> keys;
+    std::vector<uint64_t> owners;
+    std::vector<uint64_t> versions;
+    std::vector<uint8_t> referenced;
+    std::vector<float> vectors;        // capacity x dim
+
+    int capacity = 0;
+    int used = 0;
+    int hand = 0;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+};
+
+size_t WordVectorCache::entry_bytes(int dim) noexcept
+{
+    // vector + slot key + owner + index node (key, value, hash, link,
+    // bucket)
+    return static_cast<size_t>(dim) * sizeof(float) +
+           sizeof(std::string) + sizeof(uint64_t) + 56 +
+           sizeof(uint64_t) + sizeof(uint8_t);
+}
+
+WordVectorCache::WordVectorCache(
+    int dim,
+    size_t memory_budget_bytes,
+    int num_shards)
+    : dim_(dim),
+      num_shards_(num_shards)
+{
+    if (dim <= 0 || num_shards <= 0)
+        throw std::invalid_argument("cache dim and shard count must be > 0");
+
+    size_t entries = memory_budget_bytes / entry_bytes(dim);
+    size_t per_shard = entries / static_cast<size_t>(num_shards);
+
+    if (per_shard == 0)
+        throw std::invalid_argument("cache budget below one entry per shard");
+
+    shards_.reset(new Shard[num_shards]);
+
+    for (int s = 0; s < num_shards; ++s) {
+        Shard& shard = shards_[s];
+        shard.capacity = static_cast<int>(per_shard);
+        shard.index.reserve(per_shard);
+        shard.keys.resize(per_shard);
+        shard.owners.resize(per_shard);
+        shard.versions.resize(per_shard);
+        shard.referenced.resize(per_shard);
+        shard.vectors.resize(per_shard * dim);
+    }
+}
+
+WordVectorCache::~WordVectorCache() = default;
+
+WordVectorCache::Shard& WordVectorCache::shard_for(
+    uint64_t owner,
+    std::string_view token)
+{
+    // High bits: the low ones also pick the unordered_map bucket
+    uint64_t h = CacheKeyHash{}(CacheKey{owner, token});
+    return shards_[(h >> 32) % static_cast<uint64_t>(num_shards_)];
+}
+
+bool WordVectorCache::lookup(
+    uint64_t owner,
+    std::string_view token,
+    uint64_t version,
+    float* out)
+{
+    Shard& shard = shard_for(owner, token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(CacheKey{owner, token});
+    if (it == shard.index.end() || shard.versions[it->second] != version) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    int slot = it->second;
+    shard.referenced[slot] = 1;
+    std::memcpy(out, &shard.vectors[static_cast<size_t>(slot) * dim_],
+                dim_ * sizeof(float));
+
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void WordVectorCache::insert(
+    uint64_t owner,
+    std::string_view token,
+    uint64_t version,
+    const float* vec)
+{
+    Shard& shard = shard_for(owner, token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    int slot;
+    auto it = shard.index.find(CacheKey{owner, token});
+
+    if (it != shard.index.end()) {
+        // Stale version (or a racing insert): refresh in place
+        slot = it->second;
+    } else {
+        if (shard.used < shard.capacity) {
+            slot = shard.used++;
+        } else {
+            // CLOCK: clear reference bits until an unreferenced slot
+            while (shard.referenced[shard.hand]) {
+                shard.referenced[shard.hand] = 0;
+                shard.hand = (shard.hand + 1) % shard.capacity;
+            }
+            slot = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.capacity;
+
+            shard.index.erase(CacheKey{shard.owners[slot], shard.keys[slot]});
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shard.keys[slot].assign(token.data(), token.size());
+        shard.owners[slot] = owner;
+        shard.index.emplace(CacheKey{owner, shard.keys[slot]}, slot);
+        shard.referenced[slot] = 0;
+    }
+
+    shard.versions[slot] = version;
+    std::memcpy(&shard.vectors[static_cast<size_t>(slot) * dim_], vec,
+                dim_ * sizeof(float));
+}
+
+void WordVectorCache::clear()
+{
+    for (int s = 0; s < num_shards_; ++s) {
+        Shard& shard = shards_[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        std::fill(shard.referenced.begin(), shard.referenced.end(), 0);
+        shard.used = 0;
+        shard.hand = 0;
+    }
+}
+
+WordCacheStats WordVectorCache::stats() const
+{
+    WordCacheStats out;
+    for (int s = 0; s < num_shards_; ++s) {
+        Shard& shard = shards_[s];
+        out.hits += shard.hits.load(std::memory_order_relaxed);
+        out.misses += shard.misses.load(std::memory_order_relaxed);
+        out.evictions += shard.evictions.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        out.entries += static_cast<size_t>(shard.used);
+        out.capacity += static_cast<size_t>(shard.capacity);
+    }
+    return out;
+}
+
+void WordVectorCache::reset_stats()
+{
+    for (int s = 0; s < num_shards_; ++s) {
+        shards_[s].hits.store(0, std::memory_order_relaxed);
+        shards_[s].misses.store(0, std::memory_order_relaxed);
+        shards_[s].evictions.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t WordVectorCache::capacity() const noexcept
+{
+    return static_cast<size_t>(shards_[0].capacity) * num_shards_;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct WordCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t capacity = 0;
+
+    double hit_rate() const
+    {
+        uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / total : 0.0;
+    }
+};
+
+// Bounded token -> word vector cache for WordEncoder.
+//
+// Tokens are spread over independently locked shards by hash; each shard is
+// a fixed array of slots with CLOCK (second chance) eviction. Capacity is
+// derived from a memory budget using entry_bytes(), an estimate that covers
+// the vector, the key and the index node.
+//
+// Keys are (owner, token): owner identifies what produced the vector (for
+// WordEncoder, its table and encoder settings), so encoders over different
+// tables can share one cache without colliding. Entries are also tagged
+// with the EmbeddingTable version they were computed from; a lookup with a
+// different version is a miss, so updating the embedding rows invalidates
+// the cache without a sweep.
+class WordVectorCache {
+public:
+    // Throws std::invalid_argument when the budget cannot hold one entry per
+    // shard.
+    WordVectorCache(int dim,
+                    size_t memory_budget_bytes,
+                    int num_shards = 16);
+
+    ~WordVectorCache();
+
+    WordVectorCache(const WordVectorCache&) = delete;
+    WordVectorCache& operator=(const WordVectorCache&) = delete;
+
+    // Copies the cached vector into out (dim floats) and returns true on a
+    // hit for this owner and version.
+    bool lookup(uint64_t owner,
+                std::string_view token,
+                uint64_t version,
+                float* out);
+
+    void insert(uint64_t owner,
+                std::string_view token,
+                uint64_t version,
+                const float* vec);
+
+    void clear();
+
+    WordCacheStats stats() const;
+    void reset_stats();
+
+    int dim() const noexcept { return dim_; }
+    size_t capacity() const noexcept;
+
+    static size_t entry_bytes(int dim) noexcept;
+
+private:
+    struct Shard;
+
+    Shard& shard_for(uint64_t owner, std::string_view token);
+
+    int dim_;
+    int num_shards_;
+    std::unique_ptr<Shard[]> shards_;
+};
@@ -0,0 +1,175 @@
+#include "batch_hash.h"
+#include "hash_function.h"
+#include "simd/kernels.h"
+#include "simd/target.h"
+
+namespace {
+
+constexpr int kLanes = 8;
+
+// Windows longer than this are hashed by the scalar path.
+constexpr int kMaxSimdN = 32;
+
+size_t ngrams_scalar(const unsigned char* data,
+                     size_t length,
+                     int min_n,
+                     int max_n,
+                     uint64_t* out)
+{
+    size_t count = 0;
+    for (size_t s = 0; s < length; ++s) {
+        uint64_t hash = HashFunction::FNV_OFFSET;
+        size_t end = s + static_cast<size_t>(max_n);
+        if (end > length)
+            end = length;
+
+        for (size_t j = s; j < end; ++j) {
+            hash = HashFunction::fnv1a_step(hash, data[j]);
+            if (j + 1 - s >= static_cast<size_t>(min_n))
+                out[count++] = hash;
+        }
+    }
+    return count;
+}
+
+#ifdef GLAD_SIMD_X86
+
+// ----------------------------------------------------------------------------
+// AVX-512BW: one 8-lane chain per block with masked byte loads (no padding).
+// The span step vectors (lane = start, vector = n) are written to the stack,
+// gathered back in (s, n) order and compressed past the end of the text.
+// ----------------------------------------------------------------------------
+
+constexpr int kMaxSimdSpan = 8;
+
+// For every span and output vector r, lane e holds window i = 8 r + e of the
+// block in (s, n) order: start k = i / span, length index j = i % span. It is
+// read from steps[j][k] and needs k + j more bytes after min_n - 1.
+struct TransposeTable {
+    alignas(64) int64_t source[kMaxSimdSpan + 1][kMaxSimdSpan][kLanes];
+    alignas(64) int64_t last_byte[kMaxSimdSpan + 1][kMaxSimdSpan][kLanes];
+};
+
+const TransposeTable& transpose_table()
+{
+    static const TransposeTable table = [] {
+        TransposeTable t{};
+        for (int span = 1; span <= kMaxSimdSpan; ++span)
+            for (int r = 0; r < span; ++r)
+                for (int e = 0; e < kLanes; ++e) {
+                    int i = r * kLanes + e;
+                    int k = i / span, j = i % span;
+                    t.source[span][r][e] = j * kLanes + k;
+                    t.last_byte[span][r][e] = k + j;
+                }
+        return t;
+    }();
+    return table;
+}
+
+GLAD_TARGET_AVX512BW
+inline __m512i fnv_mul_avx512(__m512i h)
+{
+    const __m512i low_prime = _mm512_set1_epi64(0x1b3);
+    __m512i lo = _mm512_mul_epu32(h, low_prime);
+    __m512i hi = _mm512_mul_epu32(_mm512_srli_epi64(h, 32), low_prime);
+    return _mm512_add_epi64(
+        _mm512_add_epi64(lo, _mm512_slli_epi64(hi, 32)),
+        _mm512_slli_epi64(h, 40));
+}
+
+GLAD_TARGET_AVX512BW
+size_t ngrams_avx512(const unsigned char* data,
+                     size_t length,
+                     int min_n,
+                     int max_n,
+                     uint64_t* out)
+{
+    const TransposeTable& table = transpose_table();
+    const int span = max_n - min_n + 1;
+    // Starts past this have no window of min_n bytes.
+    const size_t starts = length >= static_cast<size_t>(min_n)
+                              ? length - min_n + 1 : 0;
+    size_t count = 0;
+
+    for (size_t s0 = 0; s0 < starts; s0 += kLanes) {
+        alignas(64) uint64_t steps[kMaxSimdSpan][kLanes];
+        __m512i h = _mm512_set1_epi64(
+            static_cast<long long>(HashFunction::FNV_OFFSET));
+
+        for (int t = 0; t < max_n; ++t) {
+            size_t avail = length - s0 > static_cast<size_t>(t)
+                               ? length - s0 - t : 0;
+            __mmask16 live = avail >= kLanes ? __mmask16(0xFF)
+                                             : __mmask16((1u << avail) - 1);
+
+            __m128i bytes = _mm_maskz_loadu_epi8(live, data + s0 + t);
+            h = fnv_mul_avx512(
+                _mm512_xor_si512(h, _mm512_cvtepu8_epi64(bytes)));
+            if (t + 1 >= min_n)
+                _mm512_store_si512(steps[t + 1 - min_n], h);
+        }
+
+        // Window (k, j) exists iff k + j <= length - s0 - min_n.
+        __m512i limit = _mm512_set1_epi64(
+            static_cast<long long>(length - s0) - min_n);
+
+        for (int r = 0; r < span; ++r) {
+            __m512i v = _mm512_i64gather_epi64(
+                _mm512_load_si512(table.source[span][r]), steps, 8);
+
+            __mmask8 valid = _mm512_cmple_epi64_mask(
+                _mm512_load_si512(table.last_byte[span][r]), limit);
+            if (valid == 0xFF) {
+                _mm512_storeu_si512(out + count, v);
+                count += kLanes;
+            } else {
+                int n = __builtin_popcount(valid);
+                _mm512_mask_storeu_epi64(out + count, __mmask8((1u << n) - 1),
+                                         _mm512_maskz_compress_epi64(valid, v));
+                count += static_cast<size_t>(n);
+            }
+        }
+    }
+    return count;
+}
+
+#endif  // GLAD_SIMD_X86
+
+}  // namespace
+
+size_t ngram_window_count(size_t length, int min_n, int max_n)
+{
+    size_t count = 0;
+    for (int n = min_n; n <= max_n; ++n)
+        if (static_cast<size_t>(n) <= length)
+            count += length - n + 1;
+    return count;
+}
+
+size_t fnv1a_ngrams(const unsigned char* data,
+                    size_t length,
+                    int min_n,
+                    int max_n,
+                    uint64_t* out)
+{
+    if (min_n < 1)
+        min_n = 1;
+    if (max_n < min_n)
+        return 0;
+
+#ifdef GLAD_SIMD_X86
+    if (max_n <= kMaxSimdN) {
+        switch (simd_level()) {
+            case SimdLevel::AVX512:
+                if (simd_has_avx512bw() && max_n - min_n < kMaxSimdSpan)
+                    return ngrams_avx512(data, length, min_n, max_n, out);
+                break;
+            case SimdLevel::AVX2:
+            case SimdLevel::SCALAR:
+                break;
+        }
+    }
+#endif
+    return ngrams_scalar(data, length, min_n, max_n, out);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Number of windows fnv1a_ngrams() produces for a text of length bytes.
+size_t ngram_window_count(size_t length, int min_n, int max_n);
+
+// FNV-1a of every window data[s, s + n) with min_n <= n <= max_n and
+// s + n <= length, written to out in (s, n) order, i.e. the order
+// NGramGenerator::generate() lists n-grams of an already wrapped word.
+// Returns the count (see ngram_window_count()).
+//
+// On AVX-512BW, eight start positions share a vector: at step t every lane
+// folds in byte s + t, so the bytes for all lanes come from one masked load,
+// and the 64-bit multiply by the FNV prime (2^40 + 0x1b3) is a shift plus two
+// 32 x 32 -> 64-bit multiplies. Otherwise a scalar loop keeps one
+// independent chain per start. Results equal HashFunction::fnv1a bit for bit
+// at every simd_level().
+size_t fnv1a_ngrams(const unsigned char* data,
+                    size_t length,
+                    int min_n,
+                    int max_n,
+                    uint64_t* out);
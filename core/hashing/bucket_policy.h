@@ -0,0 +1,84 @@
+#pragma once
+
+#include "hash_function.h"
+
+#include <cstdint>
+#include <string_view>
+
+// Compile-time hash and range-reduction policies for mapping n-grams to
+// embedding buckets. WordEncoder instantiates its bucket routine once per
+// (hash, reduction) pair, so the per-n-gram calls below inline completely;
+// the pair itself is picked at runtime from ModelConfig.
+
+// ---------------------------------------------------------------------------
+// Hash policies: static uint64_t hash(std::string_view). ROLLING policies
+// can also be extended byte by byte (NGramGenerator::hash_buckets).
+// ---------------------------------------------------------------------------
+
+struct Fnv1aHash {
+    static constexpr bool ROLLING = true;
+    static uint64_t hash(std::string_view key) {
+        return HashFunction::fnv1a(key);
+    }
+};
+
+struct Murmur3Hash {
+    static constexpr bool ROLLING = false;
+    static uint64_t hash(std::string_view key) {
+        return HashFunction::murmur3(key);
+    }
+};
+
+struct WyHash {
+    static constexpr bool ROLLING = false;
+    static uint64_t hash(std::string_view key) {
+        return HashFunction::wyhash(key);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Reduction policies: static uint64_t reduce(uint64_t hash, const
+// BucketRange&), result in [0, range.count).
+// ---------------------------------------------------------------------------
+
+// Bucket count plus constants precomputed once per encoder.
+struct BucketRange {
+    explicit BucketRange(uint64_t bucket_count)
+        : count(bucket_count),
+          // ceil(2^128 / count); wraps to 0 for count == 1, which still
+          // reduces everything to 0
+          fastmod_magic(~static_cast<__uint128_t>(0) / bucket_count + 1) {}
+
+    uint64_t count;
+    __uint128_t fastmod_magic;
+};
+
+// hash % count without a division: Lemire's "faster remainder by direct
+// computation" with a 128-bit reciprocal is exact for every 64-bit hash, so
+// buckets match the original scheme bit for bit.
+struct ModuloReduce {
+    static uint64_t reduce(uint64_t hash, const BucketRange& range) {
+        __uint128_t low = range.fastmod_magic * hash;
+        __uint128_t bottom =
+            (static_cast<__uint128_t>(static_cast<uint64_t>(low)) *
+             range.count) >> 64;
+        __uint128_t top = (low >> 64) * range.count;
+        return static_cast<uint64_t>((bottom + top) >> 64);
+    }
+};
+
+// Lemire's multiply-shift range reduction: one multiply, uses the high bits
+// of the hash.
+struct MultiplyShiftReduce {
+    static uint64_t reduce(uint64_t hash, const BucketRange& range) {
+        return static_cast<uint64_t>(
+            (static_cast<__uint128_t>(hash) * range.count) >> 64);
+    }
+};
+
+// Low bits only; count must be a power of two.
+struct Pow2MaskReduce {
+    static uint64_t reduce(uint64_t hash, const BucketRange& range) {
+        return hash & (range.count - 1);
+    }
+};
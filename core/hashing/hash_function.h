@@ -1,20 +1,25 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string_view>
 
 class HashFunction {
 public:
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    // One FNV-1a round; lets callers extend a hash byte by byte.
+    static uint64_t fnv1a_step(uint64_t hash, unsigned char c) {
+        return (hash ^ static_cast<uint64_t>(c)) * FNV_PRIME;
+    }
+
     // FNV-1a hash algorithm
     static uint64_t fnv1a(std::string_view str) {
-        constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
-        constexpr uint64_t FNV_PRIME = 1099511628211ULL;
-        
         uint64_t hash = FNV_OFFSET;
-        for (char c : str) {
-            hash ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
-            hash *= FNV_PRIME;
-        }
+        for (char c : str)
+            hash = fnv1a_step(hash, static_cast<unsigned char>(c));
         return hash;
     }
     
@@ -55,4 +60,113 @@ public:
         
         return h;
     }
+
+    // wyhash-style hash: keys up to 16 bytes are read as two overlapping
+    // words and finished with one 64 x 64 -> 128-bit multiply-fold, which
+    // suits short n-grams better than byte-at-a-time FNV.
+    static uint64_t wyhash(std::string_view str, uint64_t seed = 0) {
+        constexpr uint64_t P0 = 0xa0761d6478bd642fULL;
+        constexpr uint64_t P1 = 0xe7037ed1a0b428dbULL;
+        constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ULL;
+        constexpr uint64_t P3 = 0x589965cc75374cc3ULL;
+
+        auto mix = [](uint64_t a, uint64_t b) {
+            __uint128_t r = static_cast<__uint128_t>(a) * b;
+            return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+        };
+        auto read8 = [](const unsigned char* p) {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            return v;
+        };
+        auto read4 = [](const unsigned char* p) {
+            uint32_t v;
+            std::memcpy(&v, p, 4);
+            return static_cast<uint64_t>(v);
+        };
+
+        const unsigned char* p =
+            reinterpret_cast<const unsigned char*>(str.data());
+        const size_t len = str.size();
+        seed ^= mix(seed ^ P0, P1);
+
+        uint64_t a = 0, b = 0;
+        if (len <= 16) {
+            if (len >= 4) {
+                size_t mid = (len >> 3) << 2;
+                a = (read4(p) << 32) | read4(p + mid);
+                b = (read4(p + len - 4) << 32) | read4(p + len - 4 - mid);
+            } else if (len > 0) {
+                a = (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) |
+                    p[len - 1];
+            }
+        } else {
+            size_t i = len;
+            if (i > 48) {
+                uint64_t s1 = seed, s2 = seed;
+                do {
+                    seed = mix(read8(p) ^ P1, read8(p + 8) ^ seed);
+                    s1 = mix(read8(p + 16) ^ P2, read8(p + 24) ^ s1);
+                    s2 = mix(read8(p + 32) ^ P3, read8(p + 40) ^ s2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= s1 ^ s2;
+            }
+            while (i > 16) {
+                seed = mix(read8(p) ^ P1, read8(p + 8) ^ seed);
+                p += 16;
+                i -= 16;
+            }
+            a = read8(p + i - 16);
+            b = read8(p + i - 8);
+        }
+
+        __uint128_t r = static_cast<__uint128_t>(a ^ P1) * (b ^ seed);
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+        return mix(a ^ P0 ^ len, b ^ P1);
+    }
+
+    // 64-bit checksum for large binary blobs (model tensors). Four
+    // independent multiply-rotate lanes over 8-byte words keep it close to
+    // memory bandwidth; not a cryptographic hash.
+    static uint64_t checksum64(const void* data, size_t size) {
+        constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        uint64_t lanes[4] = {P1, P2, P1 ^ P2, P1 + P2};
+
+        auto round = [](uint64_t h, uint64_t w) {
+            h ^= w * P2;
+            h = (h << 31) | (h >> 33);
+            return h * P1;
+        };
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int l = 0; l < 4; ++l) {
+                uint64_t w;
+                std::memcpy(&w, p + i + 8 * l, 8);
+                lanes[l] = round(lanes[l], w);
+            }
+        }
+        for (; i + 8 <= size; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            lanes[0] = round(lanes[0], w);
+        }
+        for (; i < size; ++i)
+            lanes[1] = round(lanes[1], p[i]);
+
+        uint64_t h = static_cast<uint64_t>(size);
+        for (uint64_t lane : lanes)
+            h = round(h, lane);
+
+        h ^= h >> 33;
+        h *= P2;
+        h ^= h >> 29;
+        return h;
+    }
 };
@@ -0,0 +1,164 @@
+#include "inference/predictor.h"
+#include "classifier/iclassifier.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "classifier/topk.h"
+#include "tokenizer/simd_tokenizer.h"
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+struct Predictor::Context {
+    Context(const WordEncoder& shared, int dim, int num_classes)
+        : word_encoder(shared),
+          encoder(word_encoder),
+          inputs(CHUNK * dim),
+          logits(CHUNK * num_classes)
+    {}
+
+    WordEncoder word_encoder;
+    MeanSentenceEncoder encoder;
+    SimdTokenizer tokenizer;
+    TokenBuffer tokens;
+
+    std::vector<float> inputs;
+    std::vector<float> logits;
+};
+
+Predictor::Predictor(
+    const WordEncoder& word_encoder,
+    const IClassifier& classifier,
+    int threads)
+    : classifier_(classifier),
+      dim_(classifier.input_dim()),
+      num_classes_(classifier.num_classes())
+{
+    if (threads < 0)
+        throw std::invalid_argument("threads must be >= 0");
+    if (word_encoder.dim() != dim_)
+        throw std::invalid_argument(
+            "embedding dim does not match the classifier input");
+
+    if (threads == 0)
+        threads = static_cast<int>(
+            std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 0; i < threads; ++i)
+        contexts_.push_back(
+            std::make_unique<Context>(word_encoder, dim_, num_classes_));
+
+    pool_ = std::make_unique<ThreadPool>(threads);
+}
+
+Predictor::~Predictor() = default;
+
+int Predictor::num_threads() const noexcept
+{
+    return pool_->size();
+}
+
+template <class F>
+void Predictor::for_each_chunk(size_t n, F&& f) const
+{
+    size_t chunks = (n + CHUNK - 1) / CHUNK;
+    if (chunks == 0)
+        return;
+
+    int tasks = static_cast<int>(
+        std::min<size_t>(chunks, contexts_.size()));
+
+    // Per-call completion, so concurrent calls do not wait on each other
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    int remaining = tasks;
+    std::exception_ptr error;
+
+    for (int t = 0; t < tasks; ++t)
+        pool_->submit([&](int worker) {
+            try {
+                Context& ctx = *contexts_[worker];
+                for (size_t c; (c = next.fetch_add(1)) < chunks;)
+                    f(ctx, c * CHUNK, std::min(n, (c + 1) * CHUNK));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                next.store(chunks);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0)
+                done.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return remaining == 0; });
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void Predictor::encode_batch(
+    const std::string_view* docs,
+    size_t n,
+    float* out) const
+{
+    for_each_chunk(n, [&](Context& ctx, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ctx.tokenizer.tokenize(docs[i], ctx.tokens);
+            ctx.encoder.encode(ctx.tokens, out + i * dim_);
+        }
+    });
+}
+
+void Predictor::predict_batch(
+    const std::string_view* docs,
+    size_t n,
+    int k,
+    Prediction* out) const
+{
+    if (k <= 0 || k > num_classes_)
+        throw std::invalid_argument("k must be in [1, num_classes]");
+
+    for_each_chunk(n, [&](Context& ctx, size_t begin, size_t end) {
+        int rows = static_cast<int>(end - begin);
+
+        for (int r = 0; r < rows; ++r) {
+            ctx.tokenizer.tokenize(docs[begin + r], ctx.tokens);
+            ctx.encoder.encode(ctx.tokens, &ctx.inputs[r * dim_]);
+        }
+
+        classifier_.forward_batch(ctx.inputs.data(), rows, ctx.logits.data());
+
+        // k-entry heap per row plus the shifted exp-sum; no full softmax
+        for (int r = 0; r < rows; ++r)
+            select_topk(&ctx.logits[r * num_classes_], num_classes_, k,
+                        out + (begin + r) * k);
+    });
+}
+
+std::vector<float> Predictor::encode_batch(
+    const std::vector<std::string>& docs) const
+{
+    std::vector<std::string_view> views(docs.begin(), docs.end());
+    std::vector<float> out(docs.size() * dim_);
+    encode_batch(views.data(), views.size(), out.data());
+    return out;
+}
+
+std::vector<Prediction> Predictor::predict_batch(
+    const std::vector<std::string>& docs,
+    int k) const
+{
+    std::vector<std::string_view> views(docs.begin(), docs.end());
+    std::vector<Prediction> out(docs.size() * std::max(k, 0));
+    predict_batch(views.data(), views.size(), k, out.data());
+    return out;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "classifier/prediction.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class IClassifier;
+class ThreadPool;
+class WordEncoder;
+
+// Offline batch inference over a shared read-only model. Documents are cut
+// into fixed chunks that the pool's workers claim dynamically; every worker
+// has a private context (WordEncoder copy, tokenizer, chunk buffers), so the
+// only shared state is the embedding table and classifier weights.
+//
+// Results are identical for any thread count: a document's chunk, and hence
+// its batched forward pass, depends only on its index. Concurrent calls on
+// one Predictor are safe.
+class Predictor {
+public:
+    static constexpr size_t CHUNK = 64;   // documents per work item
+
+    // threads = 0 uses the hardware concurrency. Throws
+    // std::invalid_argument if the encoder and classifier dims differ.
+    Predictor(const WordEncoder& word_encoder,
+              const IClassifier& classifier,
+              int threads = 0);
+
+    ~Predictor();
+
+    Predictor(const Predictor&) = delete;
+    Predictor& operator=(const Predictor&) = delete;
+
+    // Sentence vectors of n documents into out (n x dim, row-major).
+    void encode_batch(const std::string_view* docs, size_t n, float* out) const;
+
+    // Top k classes of n documents, best first, into out (n x k).
+    // Throws std::invalid_argument unless 0 < k <= num_classes.
+    void predict_batch(const std::string_view* docs,
+                       size_t n,
+                       int k,
+                       Prediction* out) const;
+
+    std::vector<float> encode_batch(const std::vector<std::string>& docs) const;
+
+    std::vector<Prediction> predict_batch(const std::vector<std::string>& docs,
+                                          int k = 1) const;
+
+    int dim() const noexcept { return dim_; }
+    int num_classes() const noexcept { return num_classes_; }
+    int num_threads() const noexcept;
+
+private:
+    struct Context;
+
+    // Runs f(context, begin, end) over [0, n) in CHUNK-sized pieces on the
+    // pool and waits; rethrows the first failure.
+    template <class F>
+    void for_each_chunk(size_t n, F&& f) const;
+
+    const IClassifier& classifier_;
+    int dim_;
+    int num_classes_;
+
+    std::vector<std::unique_ptr<Context>> contexts_;
+    std::unique_ptr<ThreadPool> pool_;
+};
@@ -0,0 +1,474 @@
+#include "model_file.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/attention_sentence_encoder.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "hashing/hash_function.h"
+#include "utils/mapped_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const char kModelMagic[8] = {'G', 'L', 'A', 'D', 'M', 'D', 'L', '\0'};
+constexpr uint64_t kSectionAlignment = 64;
+
+// Fixed-width image of ModelConfig. New fields are only ever appended;
+// readers take the prefix they know and keep defaults for the rest.
+struct ConfigRecord {
+    int32_t bucket_count;
+    int32_t embedding_dim;
+    int32_t ngram_min;
+    int32_t ngram_max;
+    uint8_t use_phonetic;
+    uint8_t use_projection;
+    uint8_t use_residual;
+    uint8_t pad0;
+    float phonetic_gamma;
+    int32_t num_heads;
+    int32_t epochs;
+    int32_t batch_size;
+    float learning_rate_adam;
+    float learning_rate_sgd;
+    float weight_decay;
+    uint32_t projection_mode;
+    uint32_t precision_mode;
+    uint64_t seed;
+    int32_t pq_subvector_dim;
+    int32_t projection_rank;    // 0 in files written before it existed
+    uint32_t hash_policy;
+    uint32_t bucket_reduction;
+};
+
+ConfigRecord to_record(const ModelConfig& c)
+{
+    ConfigRecord r{};
+    r.bucket_count = c.bucket_count;
+    r.embedding_dim = c.embedding_dim;
+    r.ngram_min = c.ngram_min;
+    r.ngram_max = c.ngram_max;
+    r.use_phonetic = c.use_phonetic;
+    r.use_projection = c.use_projection;
+    r.use_residual = c.use_residual;
+    r.phonetic_gamma = c.phonetic_gamma;
+    r.num_heads = c.num_heads;
+    r.epochs = c.epochs;
+    r.batch_size = c.batch_size;
+    r.learning_rate_adam = c.learning_rate_adam;
+    r.learning_rate_sgd = c.learning_rate_sgd;
+    r.weight_decay = c.weight_decay;
+    r.projection_mode = static_cast<uint32_t>(c.projection_mode);
+    r.precision_mode = static_cast<uint32_t>(c.precision_mode);
+    r.seed = c.seed;
+    r.pq_subvector_dim = c.pq_subvector_dim;
+    r.projection_rank = c.projection_rank;
+    r.hash_policy = static_cast<uint32_t>(c.hash_policy);
+    r.bucket_reduction = static_cast<uint32_t>(c.bucket_reduction);
+    return r;
+}
+
+ModelConfig from_record(const ConfigRecord& r)
+{
+    ModelConfig c;
+    c.bucket_count = r.bucket_count;
+    c.embedding_dim = r.embedding_dim;
+    c.ngram_min = r.ngram_min;
+    c.ngram_max = r.ngram_max;
+    c.use_phonetic = r.use_phonetic != 0;
+    c.use_projection = r.use_projection != 0;
+    c.use_residual = r.use_residual != 0;
+    c.phonetic_gamma = r.phonetic_gamma;
+    c.num_heads = r.num_heads;
+    c.epochs = r.epochs;
+    c.batch_size = r.batch_size;
+    c.learning_rate_adam = r.learning_rate_adam;
+    c.learning_rate_sgd = r.learning_rate_sgd;
+    c.weight_decay = r.weight_decay;
+    c.projection_mode = static_cast<ProjectionMode>(r.projection_mode);
+    c.precision_mode = static_cast<PrecisionMode>(r.precision_mode);
+    c.seed = r.seed;
+    c.pq_subvector_dim = r.pq_subvector_dim;
+    if (r.projection_rank > 0)
+        c.projection_rank = r.projection_rank;
+    c.hash_policy = static_cast<HashPolicy>(r.hash_policy);
+    c.bucket_reduction = static_cast<BucketReduction>(r.bucket_reduction);
+    return c;
+}
+
+struct PendingSection {
+    ModelSectionType type;
+    SectionDType dtype;
+    const void* data;
+    uint64_t bytes;
+    uint64_t rows;
+    uint64_t cols;
+};
+
+SectionDType section_dtype(EmbeddingDType dtype)
+{
+    switch (dtype) {
+        case EmbeddingDType::F16: return SectionDType::F16;
+        case EmbeddingDType::BF16: return SectionDType::BF16;
+        case EmbeddingDType::PQ8: return SectionDType::U8;
+        default: return SectionDType::F32;
+    }
+}
+
+uint64_t align_up(uint64_t x)
+{
+    return (x + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+void write_sections(const std::string& path,
+                    const std::vector<PendingSection>& sections)
+{
+    // Lay everything out first so the file is written strictly in order.
+    std::vector<ModelSectionEntry> table(sections.size());
+
+    uint64_t offset = align_up(sizeof(ModelFileHeader) +
+                               sections.size() * sizeof(ModelSectionEntry));
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const PendingSection& s = sections[i];
+        ModelSectionEntry& e = table[i];
+        e = ModelSectionEntry{};
+        e.type = static_cast<uint32_t>(s.type);
+        e.dtype = static_cast<uint32_t>(s.dtype);
+        e.offset = offset;
+        e.bytes = s.bytes;
+        e.rows = s.rows;
+        e.cols = s.cols;
+        e.checksum = HashFunction::checksum64(s.data, s.bytes);
+        offset = align_up(offset + s.bytes);
+    }
+
+    ModelFileHeader header{};
+    std::memcpy(header.magic, kModelMagic, sizeof(kModelMagic));
+    header.version = ModelFile::VERSION;
+    header.section_count = static_cast<uint32_t>(sections.size());
+    header.file_size = offset;
+    header.table_checksum = HashFunction::checksum64(
+        table.data(), table.size() * sizeof(ModelSectionEntry));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot open '" + path + "' for writing");
+
+    const char zeros[kSectionAlignment] = {};
+    uint64_t written = 0;
+
+    auto put = [&](const void* data, uint64_t bytes) {
+        out.write(static_cast<const char*>(data),
+                  static_cast<std::streamsize>(bytes));
+        written += bytes;
+    };
+    auto pad_to = [&](uint64_t target) {
+        put(zeros, target - written);
+    };
+
+    put(&header, sizeof(header));
+    put(table.data(), table.size() * sizeof(ModelSectionEntry));
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        pad_to(table[i].offset);
+        put(sections[i].data, sections[i].bytes);
+    }
+    pad_to(header.file_size);
+
+    if (!out)
+        throw std::runtime_error("failed writing '" + path + "'");
+}
+
+// Validated view of a mapped model file.
+class SectionReader {
+public:
+    SectionReader(std::shared_ptr<MappedFile> file, bool verify)
+        : file_(std::move(file)),
+          verify_(verify)
+    {
+        const std::string& path = file_->path();
+
+        if (file_->size() < sizeof(ModelFileHeader))
+            throw std::runtime_error("truncated model file '" + path + "'");
+
+        std::memcpy(&header_, file_->data(), sizeof(header_));
+
+        if (std::memcmp(header_.magic, kModelMagic, sizeof(kModelMagic)) != 0)
+            throw std::runtime_error("not a model file '" + path + "'");
+        if (header_.version == 0 || header_.version > ModelFile::VERSION)
+            throw std::runtime_error("unsupported model file version " +
+                                     std::to_string(header_.version));
+
+        // section_count is 32 bits, so this product cannot wrap
+        uint64_t table_bytes =
+            uint64_t(header_.section_count) * sizeof(ModelSectionEntry);
+
+        if (header_.file_size > file_->size() ||
+            table_bytes > file_->size() - sizeof(ModelFileHeader))
+            throw std::runtime_error("truncated model file '" + path + "'");
+
+        const unsigned char* table = file_->data() + sizeof(ModelFileHeader);
+
+        if (HashFunction::checksum64(table, table_bytes) !=
+            header_.table_checksum)
+            throw std::runtime_error("corrupt section table '" + path + "'");
+
+        table_.resize(header_.section_count);
+        std::memcpy(table_.data(), table, table_bytes);
+
+        for (const auto& e : table_) {
+            if (e.offset % kSectionAlignment != 0 ||
+                e.offset > header_.file_size ||
+                e.bytes > header_.file_size - e.offset)
+                throw std::runtime_error("section outside file '" + path + "'");
+        }
+    }
+
+    const ModelSectionEntry* find(ModelSectionType type) const
+    {
+        for (const auto& e : table_)
+            if (e.type == static_cast<uint32_t>(type))
+                return &e;
+        return nullptr;
+    }
+
+    const ModelSectionEntry& require(ModelSectionType type) const
+    {
+        const ModelSectionEntry* e = find(type);
+        if (!e)
+            throw std::runtime_error(
+                "model file misses section " +
+                std::to_string(static_cast<uint32_t>(type)));
+        return *e;
+    }
+
+    // Returns the payload after checking its checksum (when enabled).
+    const unsigned char* payload(const ModelSectionEntry& e) const
+    {
+        const unsigned char* p = file_->data() + e.offset;
+        if (verify_ && HashFunction::checksum64(p, e.bytes) != e.checksum)
+            throw std::runtime_error(
+                "checksum mismatch in section " + std::to_string(e.type));
+        return p;
+    }
+
+    const unsigned char* tensor(const ModelSectionEntry& e,
+                                SectionDType dtype,
+                                uint64_t element_size,
+                                uint64_t rows,
+                                uint64_t cols) const
+    {
+        uint64_t bytes = 0;
+        bool wrapped = __builtin_mul_overflow(rows, cols, &bytes) ||
+                       __builtin_mul_overflow(bytes, element_size, &bytes);
+
+        if (wrapped || e.dtype != static_cast<uint32_t>(dtype) ||
+            e.rows != rows || e.cols != cols || e.bytes != bytes)
+            throw std::runtime_error(
+                "unexpected shape in section " + std::to_string(e.type));
+        return payload(e);
+    }
+
+    const unsigned char* f32_tensor(const ModelSectionEntry& e,
+                                    uint64_t rows,
+                                    uint64_t cols) const
+    {
+        return tensor(e, SectionDType::F32, sizeof(float), rows, cols);
+    }
+
+    const std::shared_ptr<MappedFile>& file() const { return file_; }
+
+private:
+    std::shared_ptr<MappedFile> file_;
+    bool verify_;
+    ModelFileHeader header_;
+    std::vector<ModelSectionEntry> table_;
+};
+
+}  // namespace
+
+void ModelFile::save(
+    const std::string& path,
+    const ModelConfig& config,
+    const EmbeddingTable& embedding,
+    const LinearClassifier& classifier,
+    const AttentionSentenceEncoder* encoder)
+{
+    config.validate();
+
+    // Only the dense head has sections; a LOWRANK config saved with a dense
+    // classifier would load as a model it does not describe.
+    if (config.projection_mode != ProjectionMode::DENSE)
+        throw std::invalid_argument(
+            "model files only hold DENSE classifier heads");
+
+    if (embedding.bucket_count() != config.bucket_count ||
+        embedding.dim() != config.embedding_dim)
+        throw std::invalid_argument("embedding shape does not match config");
+
+    if (embedding.dtype() != embedding_dtype_for(config.precision_mode))
+        throw std::invalid_argument(
+            "embedding dtype does not match config.precision_mode");
+
+    const ProductQuantizer* pq = embedding.quantizer();
+    if (pq && pq->dsub() != config.pq_subvector_dim)
+        throw std::invalid_argument(
+            "quantizer dsub does not match config.pq_subvector_dim");
+
+    if (classifier.input_dim() != config.embedding_dim)
+        throw std::invalid_argument("classifier input_dim does not match config");
+
+    if (encoder && (encoder->dim() != config.embedding_dim ||
+                    encoder->num_heads() != config.num_heads ||
+                    encoder->use_projection() != config.use_projection ||
+                    encoder->use_residual() != config.use_residual))
+        throw std::invalid_argument("sentence encoder does not match config");
+
+    ConfigRecord record = to_record(config);
+
+    uint64_t buckets = static_cast<uint64_t>(embedding.bucket_count());
+    uint64_t dim = static_cast<uint64_t>(embedding.dim());
+    uint64_t classes = static_cast<uint64_t>(classifier.num_classes());
+    uint64_t row_bytes = embedding.row_bytes();
+    uint64_t row_elements = row_bytes / embedding_dtype_size(embedding.dtype());
+
+    std::vector<PendingSection> sections = {
+        {ModelSectionType::CONFIG, SectionDType::RAW,
+         &record, sizeof(record), 1, sizeof(record)},
+        {ModelSectionType::EMBEDDING, section_dtype(embedding.dtype()),
+         embedding.data(), buckets * row_bytes, buckets, row_elements},
+        {ModelSectionType::CLASSIFIER_WEIGHTS, SectionDType::F32,
+         classifier.weights(), classes * dim * sizeof(float), classes, dim},
+        {ModelSectionType::CLASSIFIER_BIAS, SectionDType::F32,
+         classifier.bias(), classes * sizeof(float), 1, classes},
+    };
+
+    if (pq)
+        sections.push_back(
+            {ModelSectionType::EMBEDDING_CODEBOOK, SectionDType::F32,
+             pq->centroids(), pq->centroid_bytes(),
+             static_cast<uint64_t>(pq->nsub()) * ProductQuantizer::KSUB,
+             static_cast<uint64_t>(pq->dsub())});
+
+    if (encoder) {
+        sections.push_back(
+            {ModelSectionType::ENCODER_QUERIES, SectionDType::F32,
+             encoder->queries(), dim * sizeof(float), 1, dim});
+        if (encoder->use_projection())
+            sections.push_back(
+                {ModelSectionType::ENCODER_PROJECTION, SectionDType::F32,
+                 encoder->projection(), dim * dim * sizeof(float), dim, dim});
+    }
+
+    write_sections(path, sections);
+}
+
+Model ModelFile::load(
+    const std::string& path,
+    const ModelLoadOptions& options)
+{
+    SectionReader reader(
+        std::make_shared<MappedFile>(path, options.prewarm),
+        options.verify_checksums);
+
+    Model model;
+
+    const ModelSectionEntry& cfg = reader.require(ModelSectionType::CONFIG);
+    ConfigRecord record = to_record(ModelConfig{});
+    std::memcpy(&record, reader.payload(cfg),
+                cfg.bytes < sizeof(record) ? cfg.bytes : sizeof(record));
+    model.config = from_record(record);
+
+    // A config that does not validate came from a damaged file
+    try {
+        model.config.validate();
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(
+            "corrupt model file '" + path + "': " + e.what());
+    }
+
+    if (model.config.projection_mode != ProjectionMode::DENSE)
+        throw std::runtime_error(
+            "unsupported projection_mode in model file '" + path + "'");
+
+    uint64_t buckets = static_cast<uint64_t>(model.config.bucket_count);
+    uint64_t dim = static_cast<uint64_t>(model.config.embedding_dim);
+
+    const ModelSectionEntry& emb = reader.require(ModelSectionType::EMBEDDING);
+    EmbeddingDType emb_dtype = embedding_dtype_for(model.config.precision_mode);
+
+    if (emb_dtype == EmbeddingDType::PQ8) {
+        uint64_t dsub = static_cast<uint64_t>(model.config.pq_subvector_dim);
+        uint64_t nsub = dim / dsub;
+
+        const ModelSectionEntry& cb =
+            reader.require(ModelSectionType::EMBEDDING_CODEBOOK);
+        const float* centroids = reinterpret_cast<const float*>(
+            reader.f32_tensor(cb, nsub * ProductQuantizer::KSUB, dsub));
+
+        reader.tensor(emb, SectionDType::U8, 1, buckets, nsub);
+        model.embedding = std::make_unique<EmbeddingTable>(
+            reader.file(), emb.offset, model.config.bucket_count,
+            std::make_shared<const ProductQuantizer>(
+                model.config.embedding_dim, model.config.pq_subvector_dim,
+                centroids));
+    } else {
+        reader.tensor(emb, section_dtype(emb_dtype),
+                      embedding_dtype_size(emb_dtype), buckets, dim);
+        model.embedding = std::make_unique<EmbeddingTable>(
+            reader.file(), emb.offset,
+            model.config.bucket_count, model.config.embedding_dim, emb_dtype);
+    }
+
+    const ModelSectionEntry& w =
+        reader.require(ModelSectionType::CLASSIFIER_WEIGHTS);
+    const ModelSectionEntry& b =
+        reader.require(ModelSectionType::CLASSIFIER_BIAS);
+    uint64_t classes = w.rows;
+
+    if (classes == 0 || classes > INT32_MAX)
+        throw std::runtime_error("invalid class count in model file");
+
+    const float* weights = reinterpret_cast<const float*>(
+        reader.f32_tensor(w, classes, dim));
+    const float* bias = reinterpret_cast<const float*>(
+        reader.f32_tensor(b, 1, classes));
+
+    model.classifier = std::make_unique<LinearClassifier>(
+        model.config.embedding_dim, static_cast<int>(classes), weights, bias);
+
+    // Copied out: the encoder owns its weights, and they are small
+    if (const ModelSectionEntry* q =
+            reader.find(ModelSectionType::ENCODER_QUERIES)) {
+        const float* queries = reinterpret_cast<const float*>(
+            reader.f32_tensor(*q, 1, dim));
+        model.encoder_queries.assign(queries, queries + dim);
+
+        if (model.config.use_projection) {
+            const ModelSectionEntry& p =
+                reader.require(ModelSectionType::ENCODER_PROJECTION);
+            const float* projection = reinterpret_cast<const float*>(
+                reader.f32_tensor(p, dim, dim));
+            model.encoder_projection.assign(projection,
+                                            projection + dim * dim);
+        }
+    }
+
+    return model;
+}
+
+std::unique_ptr<ISentenceEncoder> Model::sentence_encoder(
+    const WordEncoder& word_encoder) const
+{
+    if (!has_attention_encoder())
+        return std::make_unique<MeanSentenceEncoder>(word_encoder);
+
+    auto encoder = make_sentence_encoder(config, word_encoder);
+    encoder->load_parameters(encoder_queries.data(),
+                             encoder_projection.data());
+    return encoder;
+}
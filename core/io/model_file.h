@@ -0,0 +1,112 @@
+#pragma once
+
+#include "config/model_config.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class AttentionSentenceEncoder;
+class EmbeddingTable;
+class ISentenceEncoder;
+class LinearClassifier;
+class MappedFile;
+class WordEncoder;
+
+// Binary model file, version 1. Little-endian; all offsets from file start.
+//
+//   ModelFileHeader                      64 bytes
+//   ModelSectionEntry[section_count]     64 bytes each
+//   section payloads                     each 64-byte aligned, zero padded
+//
+// Tensor sections are raw row-major arrays, so a reader can mmap or pread
+// them and use them without per-element parsing. Every section carries its
+// own checksum (HashFunction::checksum64); the header checksums the section
+// table. Unknown section types are skipped by older readers.
+
+enum class ModelSectionType : uint32_t {
+    CONFIG = 1,
+    EMBEDDING = 2,
+    CLASSIFIER_WEIGHTS = 3,
+    CLASSIFIER_BIAS = 4,
+    EMBEDDING_CODEBOOK = 5,   // PQ8 embeddings: nsub x 256 x dsub floats
+    ENCODER_QUERIES = 6,      // attention encoder: 1 x dim floats
+    ENCODER_PROJECTION = 7    // attention encoder: dim x dim, row-major
+};
+
+enum class SectionDType : uint32_t {
+    RAW = 0,
+    F32 = 1,
+    F16 = 2,
+    BF16 = 3,
+    U8 = 4
+};
+
+struct ModelFileHeader {
+    char magic[8];            // "GLADMDL\0"
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t file_size;
+    uint64_t table_checksum;  // over the section table
+    uint64_t reserved[4];
+};
+
+struct ModelSectionEntry {
+    uint32_t type;            // ModelSectionType
+    uint32_t dtype;           // SectionDType
+    uint64_t offset;
+    uint64_t bytes;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t checksum;
+    uint64_t reserved[2];
+};
+
+static_assert(sizeof(ModelFileHeader) == 64, "header must be 64 bytes");
+static_assert(sizeof(ModelSectionEntry) == 64, "entry must be 64 bytes");
+
+struct ModelLoadOptions {
+    bool prewarm = false;           // fault tensor pages in at load time
+    bool verify_checksums = true;   // reads every section once
+};
+
+struct Model {
+    ModelConfig config;
+    std::unique_ptr<EmbeddingTable> embedding;   // views the file mapping
+    std::unique_ptr<LinearClassifier> classifier;
+
+    // Attention encoder weights, empty for mean-pooling models. The
+    // projection is also empty without config.use_projection.
+    std::vector<float> encoder_queries;
+    std::vector<float> encoder_projection;
+
+    bool has_attention_encoder() const { return !encoder_queries.empty(); }
+
+    // The sentence encoder the model was saved with over word_encoder:
+    // attention pooling with the saved weights, or mean pooling.
+    std::unique_ptr<ISentenceEncoder>
+    sentence_encoder(const WordEncoder& word_encoder) const;
+};
+
+class ModelFile {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // Writes the whole model front to back in one sequential pass, with
+    // the attention encoder's weights when encoder is not null. Throws
+    // std::runtime_error on I/O errors and std::invalid_argument if the
+    // parts do not agree with config. Only DENSE heads can be saved so far:
+    // other projection modes throw std::invalid_argument.
+    static void save(const std::string& path,
+                     const ModelConfig& config,
+                     const EmbeddingTable& embedding,
+                     const LinearClassifier& classifier,
+                     const AttentionSentenceEncoder* encoder = nullptr);
+
+    // Maps the file; the embedding rows are used in place. Throws
+    // std::runtime_error on format or checksum errors, including a stored
+    // config that does not validate.
+    static Model load(const std::string& path,
+                      const ModelLoadOptions& options = {});
+};
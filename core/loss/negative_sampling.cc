@@ -0,0 +1,140 @@
+#include "negative_sampling.h"
+
+#include <cmath>
+#include <stdexcept>
+
+AliasTable::AliasTable(const std::vector<double>& weights)
+{
+    if (weights.empty())
+        throw std::invalid_argument("alias table needs weights");
+
+    double total = 0.0;
+    for (double w : weights) {
+        if (w < 0.0)
+            throw std::invalid_argument("alias weights must be >= 0");
+        total += w;
+    }
+
+    if (total <= 0.0)
+        throw std::invalid_argument("alias weights sum to zero");
+
+    int n = static_cast<int>(weights.size());
+    prob_.resize(n);
+    alias_.resize(n);
+
+    // Vose: scale to mean 1, then pair each under-full bucket with an
+    // over-full one that donates the rest of its mass
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * n / total;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+
+        prob_[s] = static_cast<float>(scaled[s]);
+        alias_[s] = l;
+
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // Leftovers are full up to rounding
+    for (int i : small) {
+        prob_[i] = 1.0f;
+        alias_[i] = i;
+    }
+    for (int i : large) {
+        prob_[i] = 1.0f;
+        alias_[i] = i;
+    }
+}
+
+double AliasTable::probability(int i) const
+{
+    int n = size();
+    double p = prob_[i];
+
+    for (int j = 0; j < n; ++j)
+        if (alias_[j] == i && j != i)
+            p += 1.0 - prob_[j];
+
+    return p / n;
+}
+
+namespace {
+
+std::vector<double> powered(const std::vector<int64_t>& counts, double power)
+{
+    std::vector<double> weights(counts.size());
+    int nonzero = 0;
+
+    for (size_t c = 0; c < counts.size(); ++c) {
+        if (counts[c] < 0)
+            throw std::invalid_argument("label counts must be >= 0");
+        weights[c] = std::pow(static_cast<double>(counts[c]), power);
+        nonzero += counts[c] > 0;
+    }
+
+    if (nonzero < 2)
+        throw std::invalid_argument(
+            "negative sampling needs two labels with non-zero counts");
+
+    return weights;
+}
+
+std::atomic<uint64_t> next_sampler_id{1};
+
+}  // namespace
+
+NegativeSampler::NegativeSampler(
+    const std::vector<int64_t>& label_counts,
+    int negatives,
+    uint64_t seed,
+    double power)
+    : table_(powered(label_counts, power)),
+      negatives_(negatives),
+      seed_(seed),
+      id_(next_sampler_id.fetch_add(1))
+{
+    if (negatives <= 0)
+        throw std::invalid_argument("negatives must be > 0");
+}
+
+FastRNG& NegativeSampler::thread_rng() const
+{
+    struct Local {
+        uint64_t owner = 0;
+        FastRNG rng{0};
+    };
+    thread_local Local local;
+
+    // A thread switching samplers starts a fresh stream of the new one
+    if (local.owner != id_) {
+        local.owner = id_;
+        local.rng = FastRNG(seed_ + 0x9E3779B97F4A7C15ull * streams_++);
+    }
+
+    return local.rng;
+}
+
+void NegativeSampler::sample(int label, int* out) const
+{
+    FastRNG& rng = thread_rng();
+
+    for (int k = 0; k < negatives_; ++k) {
+        int c;
+        do {
+            c = table_.sample(rng);
+        } while (c == label);
+        out[k] = c;
+    }
+}
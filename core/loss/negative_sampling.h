@@ -0,0 +1,63 @@
+#pragma once
+
+#include "utils/rng.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Walker / Vose alias table: O(n) to build, then O(1) per draw (one bucket
+// pick and one biased coin) for any discrete distribution.
+class AliasTable {
+public:
+    // weights need not be normalized. Throws std::invalid_argument if there
+    // are none, one is negative, or they sum to zero.
+    explicit AliasTable(const std::vector<double>& weights);
+
+    int sample(FastRNG& rng) const {
+        uint32_t i = rng.below(static_cast<uint32_t>(prob_.size()));
+        return rng.uniform() < prob_[i] ? static_cast<int>(i) : alias_[i];
+    }
+
+    int size() const noexcept { return static_cast<int>(prob_.size()); }
+
+    // Normalized probability of outcome i, recovered from the table
+    double probability(int i) const;
+
+private:
+    std::vector<float> prob_;   // keep bucket i with this probability
+    std::vector<int> alias_;    // otherwise return alias_[i]
+};
+
+// Negatives for the sampled binary-logistic loss: labels drawn from
+// count^power (word2vec / fastText use 0.75, which flattens the unigram
+// distribution towards rare labels), never the true label.
+//
+// Each calling thread gets its own FastRNG stream, seeded from seed and the
+// order in which threads first draw from this sampler, so single-threaded
+// training is reproducible and Hogwild workers need no locking.
+class NegativeSampler {
+public:
+    // Throws std::invalid_argument if negatives <= 0, a count is negative,
+    // or fewer than two labels have a non-zero count (no negative exists).
+    NegativeSampler(const std::vector<int64_t>& label_counts,
+                    int negatives,
+                    uint64_t seed,
+                    double power = 0.75);
+
+    // Draws negatives() labels != label into out, redrawing hits on label.
+    void sample(int label, int* out) const;
+
+    int negatives() const noexcept { return negatives_; }
+    int num_classes() const noexcept { return table_.size(); }
+    double probability(int label) const { return table_.probability(label); }
+
+private:
+    FastRNG& thread_rng() const;
+
+    AliasTable table_;
+    int negatives_;
+    uint64_t seed_;
+    uint64_t id_;                           // unique per sampler
+    mutable std::atomic<uint64_t> streams_{0};
+};
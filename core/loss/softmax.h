@@ -30,4 +30,16 @@ inline float cross_entropy(
     const float eps = 1e-9f;
     float p = std::max(probs[true_class], eps);
     return -std::log(p);
-}
\ No newline at end of file
+}
+
+inline float sigmoid(float z)
+{
+    return 1.0f / (1.0f + std::exp(-z));
+}
+
+// log sigmoid(t) without overflow for large |t|
+inline float log_sigmoid(float t)
+{
+    return t >= 0.0f ? -std::log1p(std::exp(-t))
+                     : t - std::log1p(std::exp(t));
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "hashing/batch_hash.h"
+#include "hashing/hash_function.h"
+
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -9,7 +13,7 @@ public:
     NGramGenerator(int min_n, int max_n)
         : min_n_(min_n), max_n_(max_n) {}
     
-    void generate(const std::string& word,
+    void generate(std::string_view word,
                   std::string& wrapped,
                   std::vector<std::string_view>& ngrams) const {
         // Wrap word with boundary markers
@@ -29,10 +33,111 @@ public:
         }
     }
     
+    // Calls f(hash) with HashFunction::fnv1a of every n-gram generate()
+    // would produce, in the same order, without building them: each start
+    // position is hashed once and the FNV state is extended for n = min_n ..
+    // max_n. The '<' and '>' markers are virtual bytes around word.
+    template <typename F>
+    void for_each_hash(std::string_view word, F&& f) const {
+        const size_t length = word.size() + 2;
+
+        auto byte_at = [&](size_t j) -> unsigned char {
+            if (j == 0)
+                return '<';
+            if (j == length - 1)
+                return '>';
+            return static_cast<unsigned char>(word[j - 1]);
+        };
+
+        for (size_t i = 0; i < length; ++i) {
+            uint64_t hash = HashFunction::FNV_OFFSET;
+            size_t end = i + static_cast<size_t>(max_n_);
+            if (end > length)
+                end = length;
+
+            for (size_t j = i; j < end; ++j) {
+                hash = HashFunction::fnv1a_step(hash, byte_at(j));
+                if (j + 1 - i >= static_cast<size_t>(min_n_))
+                    f(hash);
+            }
+        }
+    }
+
+    // Appends to_bucket(fnv1a(g)) for every n-gram g of word. Words that fit
+    // the stack buffers are wrapped once and hashed with the SIMD batch
+    // kernel; longer ones take the rolling path above.
+    template <typename ToBucket>
+    void hash_buckets(std::string_view word,
+                      ToBucket&& to_bucket,
+                      std::vector<int>& buckets) const {
+        const size_t length = word.size() + 2;
+
+        if (length > MAX_BATCHED || max_n_ - min_n_ >= 8) {
+            for_each_hash(word, [&](uint64_t hash) {
+                buckets.push_back(static_cast<int>(to_bucket(hash)));
+            });
+            return;
+        }
+
+        unsigned char wrapped[MAX_BATCHED];
+        wrap(word, wrapped);
+
+        uint64_t hashes[MAX_BATCHED * 8];
+        size_t count = fnv1a_ngrams(wrapped, length, min_n_, max_n_, hashes);
+
+        size_t first = buckets.size();
+        buckets.resize(first + count);
+        for (size_t i = 0; i < count; ++i)
+            buckets[first + i] = static_cast<int>(to_bucket(hashes[i]));
+    }
+
+    // Appends the bucket (fnv1a % bucket_count) of every n-gram of word.
+    void generate_buckets(std::string_view word,
+                          uint64_t bucket_count,
+                          std::vector<int>& buckets) const {
+        hash_buckets(word,
+                     [bucket_count](uint64_t hash) { return hash % bucket_count; },
+                     buckets);
+    }
+
+    // Calls f(ngram) for every n-gram in generate() order, for hashes that
+    // need the bytes contiguous. Short words are wrapped on the stack.
+    template <typename F>
+    void for_each_ngram(std::string_view word, F&& f) const {
+        const size_t length = word.size() + 2;
+
+        unsigned char stack[MAX_BATCHED];
+        std::string heap;
+        const char* wrapped;
+        if (length <= MAX_BATCHED) {
+            wrap(word, stack);
+            wrapped = reinterpret_cast<const char*>(stack);
+        } else {
+            heap.reserve(length);
+            heap += '<';
+            heap += word;
+            heap += '>';
+            wrapped = heap.data();
+        }
+
+        for (size_t i = 0; i < length; ++i)
+            for (int n = min_n_; n <= max_n_ && i + n <= length; ++n)
+                f(std::string_view(wrapped + i, n));
+    }
+
     int min_n() const { return min_n_; }
     int max_n() const { return max_n_; }
     
 private:
+    static constexpr size_t MAX_BATCHED = 64;
+
+    static void wrap(std::string_view word, unsigned char* out) {
+        out[0] = '<';
+        for (size_t i = 0; i < word.size(); ++i)
+            out[i + 1] = static_cast<unsigned char>(word[i]);
+        out[word.size() + 1] = '>';
+    }
+
     int min_n_;
     int max_n_;
 };
@@ -1,15 +1,24 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cctype>
 
 class PhoneticEncoder {
 public:
     // Simplified Soundex-like encoding
     std::string encode(const std::string& word) const {
-        if (word.empty()) return "";
-        
         std::string result;
+        encode(word, result);
+        return result;
+    }
+
+    // Writes the code into result, reusing its storage (codes are at most
+    // 8 characters, so this never allocates once result has grown).
+    void encode(std::string_view word, std::string& result) const {
+        result.clear();
+        if (word.empty()) return;
+        
         result.reserve(8);
         
         // Keep first letter
@@ -29,8 +38,6 @@ public:
                 prev_code = code;
             }
         }
-        
-        return result;
     }
     
 private:
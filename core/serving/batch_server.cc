@@ -0,0 +1,267 @@
+#include "serving/batch_server.h"
+#include "classifier/iclassifier.h"
+#include "classifier/topk.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "tokenizer/simd_tokenizer.h"
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+double percentile(std::vector<float>& values, double q)
+{
+    if (values.empty())
+        return 0.0;
+
+    size_t k = std::min(values.size() - 1,
+                        static_cast<size_t>(q * values.size()));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+}  // namespace
+
+std::string ServeStats::summary() const
+{
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "%llu requests in %llu batches (mean %.1f), "
+                  "%.0f QPS, latency p50 %.0f us, p99 %.0f us, max %.0f us",
+                  static_cast<unsigned long long>(requests),
+                  static_cast<unsigned long long>(batches),
+                  mean_batch, qps, p50_us, p99_us, max_us);
+    return buf;
+}
+
+struct BatchServer::Context {
+    explicit Context(const WordEncoder& shared)
+        : word_encoder(shared),
+          encoder(word_encoder)
+    {}
+
+    WordEncoder word_encoder;
+    MeanSentenceEncoder encoder;
+    SimdTokenizer tokenizer;
+    TokenBuffer tokens;
+
+    std::vector<float> inputs;
+    std::vector<float> logits;
+};
+
+BatchServer::BatchServer(
+    const WordEncoder& word_encoder,
+    const IClassifier& classifier,
+    const ServeOptions& options)
+    : classifier_(classifier),
+      options_(options),
+      dim_(classifier.input_dim()),
+      num_classes_(classifier.num_classes())
+{
+    if (options_.max_batch <= 0)
+        throw std::invalid_argument("max_batch must be > 0");
+    if (options_.max_wait_us < 0)
+        throw std::invalid_argument("max_wait_us must be >= 0");
+    if (options_.workers < 0)
+        throw std::invalid_argument("workers must be >= 0");
+    if (options_.latency_window == 0)
+        throw std::invalid_argument("latency_window must be > 0");
+    if (word_encoder.dim() != dim_)
+        throw std::invalid_argument(
+            "embedding dim does not match the classifier input");
+
+    if (options_.workers == 0)
+        options_.workers = static_cast<int>(
+            std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 0; i < options_.workers; ++i) {
+        contexts_.push_back(std::make_unique<Context>(word_encoder));
+        contexts_.back()->inputs.resize(
+            static_cast<size_t>(options_.max_batch) * dim_);
+        contexts_.back()->logits.resize(
+            static_cast<size_t>(options_.max_batch) * num_classes_);
+    }
+
+    idle_workers_ = options_.workers;
+    latencies_us_.reserve(options_.latency_window);
+
+    pool_ = std::make_unique<ThreadPool>(options_.workers);
+    scheduler_ = std::thread([this] { schedule_loop(); });
+}
+
+BatchServer::~BatchServer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    changed_.notify_all();
+
+    scheduler_.join();
+    pool_.reset();
+}
+
+std::future<Prediction> BatchServer::submit(std::string text)
+{
+    Request request;
+    request.text = std::move(text);
+    request.arrived = Clock::now();
+
+    std::future<Prediction> result = request.result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_)
+            throw std::runtime_error("BatchServer is shutting down");
+        pending_.push_back(std::move(request));
+    }
+    changed_.notify_all();
+
+    return result;
+}
+
+Prediction BatchServer::classify(std::string_view text)
+{
+    return submit(std::string(text)).get();
+}
+
+void BatchServer::schedule_loop()
+{
+    const size_t max_batch = options_.max_batch;
+    const auto max_wait = std::chrono::microseconds(options_.max_wait_us);
+
+    for (;;) {
+        auto batch = std::make_shared<std::vector<Request>>();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            changed_.wait(lock, [&] {
+                return (!pending_.empty() && idle_workers_ > 0) ||
+                       (stop_ && pending_.empty());
+            });
+
+            if (pending_.empty())
+                return;   // stopping and drained
+
+            // Fill up to max_batch, but never hold the oldest request past
+            // its deadline. Shutdown flushes immediately.
+            auto deadline = pending_.front().arrived + max_wait;
+            changed_.wait_until(lock, deadline, [&] {
+                return stop_ || pending_.size() >= max_batch;
+            });
+
+            size_t n = std::min(max_batch, pending_.size());
+            batch->reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                batch->push_back(std::move(pending_.front()));
+                pending_.pop_front();
+            }
+
+            --idle_workers_;
+        }
+
+        pool_->submit([this, batch](int worker) {
+            run_batch(worker, *batch);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++idle_workers_;
+            }
+            changed_.notify_all();
+        });
+    }
+}
+
+void BatchServer::run_batch(int worker, std::vector<Request>& batch)
+{
+    Context& ctx = *contexts_[worker];
+    int n = static_cast<int>(batch.size());
+
+    try {
+        for (int i = 0; i < n; ++i) {
+            ctx.tokenizer.tokenize(batch[i].text, ctx.tokens);
+            ctx.encoder.encode(ctx.tokens, &ctx.inputs[i * dim_]);
+        }
+
+        classifier_.forward_batch(ctx.inputs.data(), n, ctx.logits.data());
+
+    } catch (...) {
+        for (auto& r : batch)
+            r.result.set_exception(std::current_exception());
+        return;
+    }
+
+    // Record before completing, so a caller that has its result also sees
+    // it counted in stats()
+    record(batch, Clock::now());
+
+    for (int i = 0; i < n; ++i) {
+        Prediction best;
+        select_topk(&ctx.logits[i * num_classes_], num_classes_, 1, &best);
+        batch[i].result.set_value(best);
+    }
+}
+
+void BatchServer::record(const std::vector<Request>& batch,
+                         Clock::time_point done)
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+
+    for (const auto& r : batch) {
+        if (completed_ == 0 || r.arrived < first_arrival_)
+            first_arrival_ = r.arrived;
+
+        float us = std::chrono::duration<float, std::micro>(
+            done - r.arrived).count();
+
+        if (latencies_us_.size() < options_.latency_window)
+            latencies_us_.push_back(us);
+        else
+            latencies_us_[latency_next_] = us;
+        latency_next_ = (latency_next_ + 1) % options_.latency_window;
+
+        ++completed_;
+    }
+
+    last_done_ = std::max(last_done_, done);
+    ++batches_;
+}
+
+ServeStats BatchServer::stats() const
+{
+    std::vector<float> latencies;
+    ServeStats s;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        latencies = latencies_us_;
+        s.requests = completed_;
+        s.batches = batches_;
+
+        double seconds = std::chrono::duration<double>(
+            last_done_ - first_arrival_).count();
+        if (completed_ > 0 && seconds > 0.0)
+            s.qps = completed_ / seconds;
+    }
+
+    if (s.batches > 0)
+        s.mean_batch = static_cast<double>(s.requests) / s.batches;
+
+    s.p50_us = percentile(latencies, 0.50);
+    s.p99_us = percentile(latencies, 0.99);
+    if (!latencies.empty())
+        s.max_us = *std::max_element(latencies.begin(), latencies.end());
+
+    return s;
+}
+
+void BatchServer::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    latencies_us_.clear();
+    latency_next_ = 0;
+    completed_ = 0;
+    batches_ = 0;
+    first_arrival_ = Clock::time_point();
+    last_done_ = Clock::time_point();
+}
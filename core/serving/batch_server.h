@@ -0,0 +1,113 @@
+#pragma once
+
+#include "classifier/prediction.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class IClassifier;
+class ThreadPool;
+class WordEncoder;
+
+struct ServeOptions {
+    int max_batch = 32;        // requests per micro-batch
+    int max_wait_us = 200;     // oldest request waits at most this long
+    int workers = 0;           // batch workers; 0 = hardware concurrency
+    size_t latency_window = 1 << 16;   // recent latencies kept for p50/p99
+};
+
+struct ServeStats {
+    uint64_t requests = 0;       // completed
+    uint64_t batches = 0;
+    double mean_batch = 0.0;
+    double p50_us = 0.0;         // arrival -> result, over the recent window
+    double p99_us = 0.0;
+    double max_us = 0.0;
+    double qps = 0.0;            // completed / (last completion - first arrival)
+
+    std::string summary() const;
+};
+
+// Micro-batching front end for MeanSentenceEncoder + a classifier head.
+//
+// Callers on any thread submit single texts. A scheduler thread collects
+// them and dispatches a batch once max_batch requests are pending or the
+// oldest has waited max_wait_us, whichever comes first, but only when a
+// worker is free: while every worker is busy, requests keep accumulating,
+// so batches grow with load. A worker tokenizes and encodes the batch into
+// one input matrix and runs the head's forward_batch on it.
+//
+// The embedding and classifier are shared read-only; every worker owns a
+// copy of the WordEncoder and its own scratch.
+class BatchServer {
+public:
+    // Throws std::invalid_argument on bad options or mismatched dims.
+    BatchServer(const WordEncoder& word_encoder,
+                const IClassifier& classifier,
+                const ServeOptions& options = ServeOptions());
+
+    // Finishes pending requests, then stops.
+    ~BatchServer();
+
+    BatchServer(const BatchServer&) = delete;
+    BatchServer& operator=(const BatchServer&) = delete;
+
+    // Thread-safe. The future carries the top class and its probability.
+    std::future<Prediction> submit(std::string text);
+
+    // submit(text).get()
+    Prediction classify(std::string_view text);
+
+    ServeStats stats() const;
+    void reset_stats();
+
+    const ServeOptions& options() const noexcept { return options_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        std::string text;
+        std::promise<Prediction> result;
+        Clock::time_point arrived;
+    };
+
+    struct Context;
+
+    void schedule_loop();
+    void run_batch(int worker, std::vector<Request>& batch);
+    void record(const std::vector<Request>& batch, Clock::time_point done);
+
+    const IClassifier& classifier_;
+    ServeOptions options_;
+    int dim_;
+    int num_classes_;
+
+    std::vector<std::unique_ptr<Context>> contexts_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<Request> pending_;
+    int idle_workers_ = 0;
+    bool stop_ = false;
+
+    mutable std::mutex stats_mutex_;
+    std::vector<float> latencies_us_;   // ring of the last latency_window
+    size_t latency_next_ = 0;
+    uint64_t completed_ = 0;
+    uint64_t batches_ = 0;
+    Clock::time_point first_arrival_;
+    Clock::time_point last_done_;
+
+    std::unique_ptr<ThreadPool> pool_;
+    std::thread scheduler_;
+};
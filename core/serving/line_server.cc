@@ -0,0 +1,315 @@
+#include "serving/line_server.h"
+#include "serving/batch_server.h"
+#include "utils/logger.h"
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::runtime_error io_error(const std::string& what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Sockets are written with MSG_NOSIGNAL, so a client that hangs up
+// surfaces as EPIPE instead of a process-wide SIGPIPE; other fds (pipes)
+// fall back to write().
+void write_all(int fd, const char* data, size_t size)
+{
+    bool socket = true;
+
+    while (size > 0) {
+        ssize_t n = socket ? ::send(fd, data, size, MSG_NOSIGNAL)
+                           : ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (socket && errno == ENOTSOCK) {
+                socket = false;
+                continue;
+            }
+            throw io_error("write failed");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+// Responses of one connection, completed in any order, written in order.
+class ResponseQueue {
+public:
+    explicit ResponseQueue(size_t capacity) : capacity_(capacity) {}
+
+    // Blocks while capacity requests are outstanding.
+    void push(std::future<Prediction> f)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_.wait(lock, [&] { return queue_.size() < capacity_; });
+        queue_.push_back(std::move(f));
+        ready_.notify_one();
+    }
+
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+        ready_.notify_one();
+    }
+
+    // False once finished and drained.
+    bool pop(std::future<Prediction>& f)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [&] { return finished_ || !queue_.empty(); });
+        return take(f);
+    }
+
+    // Pops the oldest response only if its result is already there.
+    bool try_pop_ready(std::future<Prediction>& f)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty() ||
+            queue_.front().wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready)
+            return false;
+        return take(f);
+    }
+
+private:
+    bool take(std::future<Prediction>& f)
+    {
+        if (queue_.empty())
+            return false;
+
+        f = std::move(queue_.front());
+        queue_.pop_front();
+        space_.notify_one();
+        return true;
+    }
+
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+    std::deque<std::future<Prediction>> queue_;
+    bool finished_ = false;
+};
+
+void append_error(std::string& out, const char* message)
+{
+    out += "error\t";
+    for (const char* c = message; *c; ++c)
+        out += (*c == '\n' || *c == '\r' || *c == '\t') ? ' ' : *c;
+    out += '\n';
+}
+
+// Accept failures such as EMFILE leave the listener readable, so poll
+// would report it again at once: sleep before retrying.
+constexpr auto kAcceptBackoff = std::chrono::milliseconds(50);
+
+}  // namespace
+
+size_t serve_fd(BatchServer& server,
+                int in_fd,
+                int out_fd,
+                size_t max_in_flight)
+{
+    ResponseQueue responses(max_in_flight > 0 ? max_in_flight : 1);
+    std::exception_ptr write_error;
+
+    // Writes each run of already completed responses with one write()
+    std::thread writer([&] {
+        std::string out;
+        std::future<Prediction> f;
+        char line[64];
+
+        // A failed request gets an error line; the rest keep flowing
+        auto append = [&] {
+            try {
+                Prediction p = f.get();
+                int len = std::snprintf(line, sizeof(line), "%d\t%.6f\n",
+                                        p.label, p.probability);
+                out.append(line, static_cast<size_t>(len));
+            } catch (const std::exception& e) {
+                append_error(out, e.what());
+            } catch (...) {
+                append_error(out, "unknown error");
+            }
+        };
+
+        while (responses.pop(f)) {
+            append();
+            while (responses.try_pop_ready(f))
+                append();
+
+            if (!write_error) {
+                try {
+                    write_all(out_fd, out.data(), out.size());
+                } catch (...) {
+                    write_error = std::current_exception();
+                }
+            }
+            out.clear();
+        }
+    });
+
+    size_t requests = 0;
+    std::string pending;
+    std::vector<char> buf(1 << 16);
+    std::exception_ptr read_error;
+
+    try {
+        for (;;) {
+            ssize_t n = ::read(in_fd, buf.data(), buf.size());
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw io_error("read failed");
+            }
+            if (n == 0)
+                break;
+
+            pending.append(buf.data(), static_cast<size_t>(n));
+
+            size_t start = 0;
+            for (size_t eol; (eol = pending.find('\n', start)) !=
+                             std::string::npos; start = eol + 1) {
+                size_t len = eol - start;
+                if (len > 0 && pending[eol - 1] == '\r')
+                    --len;
+                responses.push(server.submit(pending.substr(start, len)));
+                ++requests;
+            }
+            pending.erase(0, start);
+        }
+
+        // Last line without a newline
+        if (!pending.empty()) {
+            if (pending.back() == '\r')
+                pending.pop_back();
+            responses.push(server.submit(pending));
+            ++requests;
+        }
+    } catch (...) {
+        read_error = std::current_exception();
+    }
+
+    responses.finish();
+    writer.join();
+
+    if (read_error)
+        std::rethrow_exception(read_error);
+    if (write_error)
+        std::rethrow_exception(write_error);
+
+    return requests;
+}
+
+void serve_unix_socket(BatchServer& server,
+                       const std::string& path,
+                       const std::atomic<bool>& stop)
+{
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("socket path too long: " + path);
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+        throw io_error("cannot create socket");
+
+    ::unlink(path.c_str());
+
+    if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr),
+               sizeof(addr)) != 0 ||
+        ::listen(listen_fd, 64) != 0) {
+        auto error = io_error("cannot listen on '" + path + "'");
+        ::close(listen_fd);
+        throw error;
+    }
+
+    struct Connection {
+        int fd;
+        std::atomic<bool> done{false};
+        std::thread thread;
+    };
+    std::list<Connection> connections;
+
+    auto reap = [&](bool all) {
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (all || it->done.load()) {
+                it->thread.join();
+                ::close(it->fd);
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    };
+
+    bool accept_failing = false;
+
+    while (!stop.load()) {
+        reap(false);
+
+        pollfd pfd{listen_fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 100) <= 0)
+            continue;
+
+        int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            int error = errno;
+            if (error == EINTR || error == EAGAIN || error == ECONNABORTED)
+                continue;
+
+            // Out of descriptors or memory: log once per streak, back off
+            if (!accept_failing)
+                Logger::log(LogLevel::WARNING,
+                            std::string("accept failed on '") + path +
+                            "': " + std::strerror(error));
+            accept_failing = true;
+            std::this_thread::sleep_for(kAcceptBackoff);
+            continue;
+        }
+        accept_failing = false;
+
+        Connection& c = connections.emplace_back();
+        c.fd = fd;
+        c.thread = std::thread([&server, &c] {
+            try {
+                serve_fd(server, c.fd, c.fd);
+            } catch (const std::exception&) {
+                // A client that goes away mid-response only ends its
+                // own connection: socket writes never raise SIGPIPE
+            }
+            c.done.store(true);
+        });
+    }
+
+    // Unblock readers so every connection drains its responses and exits
+    for (auto& c : connections)
+        ::shutdown(c.fd, SHUT_RD);
+    reap(true);
+
+    ::close(listen_fd);
+    ::unlink(path.c_str());
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+class BatchServer;
+
+// Line protocol over a byte stream: each request is one line of text
+// ('\r\n' accepted), each response one line "<label>\t<probability>" in
+// request order, or "error\t<message>" if the request's batch failed. A
+// connection pipelines its requests into the BatchServer, so one client can
+// fill batches on its own.
+
+// Serves until in_fd reaches end of file; returns the number of requests.
+// At most max_in_flight requests are outstanding per connection.
+// Throws std::runtime_error on read / write errors. A socket out_fd is
+// written with MSG_NOSIGNAL; for a pipe whose reader may exit first, the
+// caller must ignore SIGPIPE (as gladtotext_serve does) or the process is
+// killed.
+size_t serve_fd(BatchServer& server,
+                int in_fd,
+                int out_fd,
+                size_t max_in_flight = 1024);
+
+// Listens on a Unix domain socket at path (replacing a stale socket file)
+// and serves every connection on its own thread until stop becomes true.
+// Clients that disconnect early only end their own connection. Persistent
+// accept() failures (e.g. out of descriptors) are logged and retried after
+// a short back-off.
+// Throws std::runtime_error if the socket cannot be set up.
+void serve_unix_socket(BatchServer& server,
+                       const std::string& path,
+                       const std::atomic<bool>& stop);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Software conversions between float and the 16-bit storage formats used by
+// half-precision embedding tables. float -> 16 bit rounds to nearest even;
+// 16 bit -> float is exact. The SIMD kernels produce identical bits, with
+// one exception: vec_f32_to_bf16 on CPUs with AVX-512 BF16 flushes float
+// denormals to zero, where these functions round them.
+
+inline uint32_t float_bits(float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+inline float bits_float(uint32_t u)
+{
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// IEEE 754 binary16
+inline float half_to_float(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+
+    if (exp == 0x1f)                      // inf / nan
+        return bits_float(sign | 0x7f800000 | (mant << 13));
+
+    if (exp == 0) {
+        if (mant == 0)
+            return bits_float(sign);
+        // subnormal: value = mant * 2^-24
+        float v = static_cast<float>(mant) * (1.0f / 16777216.0f);
+        return sign ? -v : v;
+    }
+
+    return bits_float(sign | ((exp + 112) << 23) | (mant << 13));
+}
+
+inline uint16_t float_to_half(float f)
+{
+    uint32_t u = float_bits(f);
+    uint16_t sign = static_cast<uint16_t>((u >> 16) & 0x8000);
+    uint32_t abs = u & 0x7fffffff;
+
+    if (abs >= 0x7f800000)                // inf / nan
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+
+    if (abs >= 0x477ff000)                // rounds to >= 65520: overflow
+        return sign | 0x7c00;
+
+    if (abs < 0x38800000) {               // below the smallest normal half
+        // Scale into the subnormal range; the float add rounds to nearest
+        // even at bit 2^-24 for us.
+        float v = bits_float(abs) + 0.5f;
+        return sign | static_cast<uint16_t>(float_bits(v) - 0x3f000000);
+    }
+
+    uint32_t mant_odd = (abs >> 13) & 1;
+    abs += 0xc8000fff + mant_odd;         // rebias exponent and round
+    return sign | static_cast<uint16_t>(abs >> 13);
+}
+
+// bfloat16: the upper half of a float
+inline float bf16_to_float(uint16_t b)
+{
+    return bits_float(static_cast<uint32_t>(b) << 16);
+}
+
+inline uint16_t float_to_bf16(float f)
+{
+    uint32_t u = float_bits(f);
+
+    if ((u & 0x7fffffff) > 0x7f800000)    // quiet nan
+        return static_cast<uint16_t>((u >> 16) | 0x40);
+
+    u += 0x7fff + ((u >> 16) & 1);
+    return static_cast<uint16_t>(u >> 16);
+}
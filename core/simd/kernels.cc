@@ -0,0 +1,1482 @@
+#include "kernels.h"
+#include "half.h"
+#include "target.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+// NOTE: this file is compiled with -ffp-contract=off (see CMakeLists.txt) so
+// that "a * b + c" written with separate mul/add is never fused behind our
+// back. Deterministic mode relies on that.
+
+namespace {
+
+constexpr int kLanes = 16;
+
+struct KernelTable {
+    float (*dot)(const float*, const float*, int);
+    void (*axpy)(float, const float*, float*, int);
+    void (*scale)(float, float*, int);
+    void (*axpy_update)(float, float, const float*, float*, float*, int);
+
+    // 4x4 block of gemm_nt
+    void (*dot_tile)(const float*, int, const float*, int, int, float*, int);
+
+    // 4 x acc_nr block of gemm_nn_acc
+    void (*acc_tile)(float, const float*, int, const float*, int, int,
+                     float*, int);
+    int acc_nr;
+
+    void (*axpy_f16)(float, const uint16_t*, float*, int);
+    void (*axpy_bf16)(float, const uint16_t*, float*, int);
+    void (*f32_to_f16)(const float*, uint16_t*, int);
+
+    void (*pq_axpy)(float, const float*, const uint8_t*, int, int, float*);
+
+    float (*max)(const float*, int);
+    float (*exp_sum)(const float*, float, float*, int);
+};
+
+constexpr int kTileM = 4;
+constexpr int kTileN = 4;
+
+// Fixed pairwise reduction of the 16 lane partial sums. Shared by every level
+// in deterministic mode.
+inline float reduce_lanes(float* acc)
+{
+    for (int s = kLanes / 2; s > 0; s /= 2)
+        for (int l = 0; l < s; ++l)
+            acc[l] += acc[l + s];
+    return acc[0];
+}
+
+// Adds the n % 16 tail elements into their lanes and reduces.
+inline float finish_lanes(float* acc,
+                          const float* a,
+                          const float* b,
+                          int start,
+                          int n)
+{
+    for (int i = start; i < n; ++i)
+        acc[i - start] += a[i] * b[i];
+    return reduce_lanes(acc);
+}
+
+// ---------------------------------------------------------------------------
+// Scalar
+// ---------------------------------------------------------------------------
+
+float dot_scalar(const float* a, const float* b, int n)
+{
+    float acc[kLanes] = {0};
+    int n16 = n & ~(kLanes - 1);
+
+    for (int i = 0; i < n16; i += kLanes)
+        for (int l = 0; l < kLanes; ++l)
+            acc[l] += a[i + l] * b[i + l];
+
+    return finish_lanes(acc, a, b, n16, n);
+}
+
+void axpy_scalar(float alpha, const float* x, float* y, int n)
+{
+    for (int i = 0; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+void scale_scalar(float alpha, float* x, int n)
+{
+    for (int i = 0; i < n; ++i)
+        x[i] *= alpha;
+}
+
+void axpy_update_scalar(float grad,
+                        float step,
+                        const float* input,
+                        float* row,
+                        float* dinput,
+                        int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dinput[i] += grad * row[i];
+        row[i] += step * input[i];
+    }
+}
+
+void dot_tile_scalar(const float* A, int lda,
+                     const float* B, int ldb,
+                     int k, float* C, int ldc)
+{
+    for (int i = 0; i < kTileM; ++i)
+        for (int j = 0; j < kTileN; ++j)
+            C[i * ldc + j] = dot_scalar(A + i * lda, B + j * ldb, k);
+}
+
+// Reference for one block of gemm_nn_acc. SIMD tiles reproduce this exact
+// operation order: accumulate over p, then C += alpha * acc.
+void acc_block_scalar(int mr, int nr, float alpha,
+                      const float* A, int lda,
+                      const float* B, int ldb,
+                      int k, float* C, int ldc)
+{
+    for (int i = 0; i < mr; ++i) {
+        for (int j = 0; j < nr; ++j) {
+            float acc = 0.0f;
+            for (int p = 0; p < k; ++p)
+                acc += A[i * lda + p] * B[p * ldb + j];
+            C[i * ldc + j] += alpha * acc;
+        }
+    }
+}
+
+constexpr int kScalarAccN = 16;
+
+void acc_tile_scalar(float alpha,
+                     const float* A, int lda,
+                     const float* B, int ldb,
+                     int k, float* C, int ldc)
+{
+    acc_block_scalar(kTileM, kScalarAccN, alpha, A, lda, B, ldb, k, C, ldc);
+}
+
+void axpy_f16_scalar(float alpha, const uint16_t* x, float* y, int n)
+{
+    for (int i = 0; i < n; ++i)
+        y[i] += alpha * half_to_float(x[i]);
+}
+
+void axpy_bf16_scalar(float alpha, const uint16_t* x, float* y, int n)
+{
+    for (int i = 0; i < n; ++i)
+        y[i] += alpha * bf16_to_float(x[i]);
+}
+
+void f32_to_f16_scalar(const float* x, uint16_t* y, int n)
+{
+    for (int i = 0; i < n; ++i)
+        y[i] = float_to_half(x[i]);
+}
+
+void f32_to_bf16_scalar(const float* x, uint16_t* y, int n)
+{
+    for (int i = 0; i < n; ++i)
+        y[i] = float_to_bf16(x[i]);
+}
+
+constexpr int kPQCentroids = 256;
+
+inline const float* pq_centroid(const float* codebook,
+                                const uint8_t* codes,
+                                int s,
+                                int dsub)
+{
+    return codebook + (static_cast<size_t>(s) * kPQCentroids + codes[s]) * dsub;
+}
+
+void pq_axpy_scalar(float alpha, const float* codebook, const uint8_t* codes,
+                    int nsub, int dsub, float* y)
+{
+    for (int s = 0; s < nsub; ++s) {
+        const float* c = pq_centroid(codebook, codes, s, dsub);
+        float* out = y + s * dsub;
+        for (int j = 0; j < dsub; ++j)
+            out[j] += alpha * c[j];
+    }
+}
+
+float max_scalar(const float* x, int n)
+{
+    float m = x[0];
+    for (int i = 1; i < n; ++i)
+        m = x[i] > m ? x[i] : m;
+    return m;
+}
+
+// The exact version: std::exp, summed in index order. Deterministic mode
+// uses it at every level.
+float exp_sum_scalar(const float* x, float shift, float* out, int n)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        float e = std::exp(x[i] - shift);
+        if (out)
+            out[i] = e;
+        sum += e;
+    }
+    return sum;
+}
+
+// Range reduction and polynomial of the fast exp (Cephes expf):
+// x = k ln2 + r with |r| <= ln2 / 2, ln2 split in two so k ln2 is exact,
+// exp(r) = 1 + r + r^2 P(r) with P of degree 5, then 2^k through the
+// exponent bits. Below kExpLo the result would be subnormal and is
+// flushed to 0.
+constexpr float kExpLo = -87.33654f;
+constexpr float kExpHi = 88.0f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+
+#ifdef GLAD_SIMD_X86
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA
+// ---------------------------------------------------------------------------
+
+GLAD_TARGET_AVX2
+float dot_avx2_strict(const float* a, const float* b, int n)
+{
+    __m256 lo = _mm256_setzero_ps();
+    __m256 hi = _mm256_setzero_ps();
+    int n16 = n & ~(kLanes - 1);
+
+    for (int i = 0; i < n16; i += kLanes) {
+        lo = _mm256_add_ps(lo, _mm256_mul_ps(_mm256_loadu_ps(a + i),
+                                             _mm256_loadu_ps(b + i)));
+        hi = _mm256_add_ps(hi, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8),
+                                             _mm256_loadu_ps(b + i + 8)));
+    }
+
+    alignas(32) float acc[kLanes];
+    _mm256_store_ps(acc, lo);
+    _mm256_store_ps(acc + 8, hi);
+    return finish_lanes(acc, a, b, n16, n);
+}
+
+GLAD_TARGET_AVX2
+inline float hsum_avx2(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v),
+                          _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+GLAD_TARGET_AVX2
+float dot_avx2_fast(const float* a, const float* b, int n)
+{
+    __m256 s0 = _mm256_setzero_ps();
+    __m256 s1 = _mm256_setzero_ps();
+    __m256 s2 = _mm256_setzero_ps();
+    __m256 s3 = _mm256_setzero_ps();
+    int i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i),
+                             _mm256_loadu_ps(b + i), s0);
+        s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                             _mm256_loadu_ps(b + i + 8), s1);
+        s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16),
+                             _mm256_loadu_ps(b + i + 16), s2);
+        s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24),
+                             _mm256_loadu_ps(b + i + 24), s3);
+    }
+    for (; i + 8 <= n; i += 8)
+        s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i),
+                             _mm256_loadu_ps(b + i), s0);
+
+    float sum = hsum_avx2(_mm256_add_ps(_mm256_add_ps(s0, s1),
+                                        _mm256_add_ps(s2, s3)));
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+GLAD_TARGET_AVX2
+void axpy_avx2_strict(float alpha, const float* x, float* y, int n)
+{
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i,
+            _mm256_add_ps(_mm256_loadu_ps(y + i),
+                          _mm256_mul_ps(va, _mm256_loadu_ps(x + i))));
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+GLAD_TARGET_AVX2
+void axpy_avx2_fast(float alpha, const float* x, float* y, int n)
+{
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i,
+            _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i),
+                            _mm256_loadu_ps(y + i)));
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+GLAD_TARGET_AVX2
+void scale_avx2(float alpha, float* x, int n)
+{
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(va, _mm256_loadu_ps(x + i)));
+    for (; i < n; ++i)
+        x[i] *= alpha;
+}
+
+GLAD_TARGET_AVX2
+void axpy_update_avx2_strict(float grad,
+                             float step,
+                             const float* input,
+                             float* row,
+                             float* dinput,
+                             int n)
+{
+    __m256 vg = _mm256_set1_ps(grad);
+    __m256 vs = _mm256_set1_ps(step);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_loadu_ps(row + i);
+        _mm256_storeu_ps(dinput + i,
+            _mm256_add_ps(_mm256_loadu_ps(dinput + i),
+                          _mm256_mul_ps(vg, r)));
+        _mm256_storeu_ps(row + i,
+            _mm256_add_ps(r, _mm256_mul_ps(vs, _mm256_loadu_ps(input + i))));
+    }
+    for (; i < n; ++i) {
+        dinput[i] += grad * row[i];
+        row[i] += step * input[i];
+    }
+}
+
+GLAD_TARGET_AVX2
+void axpy_update_avx2_fast(float grad,
+                           float step,
+                           const float* input,
+                           float* row,
+                           float* dinput,
+                           int n)
+{
+    __m256 vg = _mm256_set1_ps(grad);
+    __m256 vs = _mm256_set1_ps(step);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_loadu_ps(row + i);
+        _mm256_storeu_ps(dinput + i,
+            _mm256_fmadd_ps(vg, r, _mm256_loadu_ps(dinput + i)));
+        _mm256_storeu_ps(row + i,
+            _mm256_fmadd_ps(vs, _mm256_loadu_ps(input + i), r));
+    }
+    for (; i < n; ++i) {
+        dinput[i] += grad * row[i];
+        row[i] += step * input[i];
+    }
+}
+
+// The strict tile works on 2x2 sub-blocks: with two 8-wide accumulators per
+// output (the 16-lane layout) a full 4x4 block would not fit in 16 ymm.
+GLAD_TARGET_AVX2
+void dot_tile_avx2_strict(const float* A, int lda,
+                          const float* B, int ldb,
+                          int k, float* C, int ldc)
+{
+    int k16 = k & ~(kLanes - 1);
+
+    for (int i0 = 0; i0 < kTileM; i0 += 2) {
+        for (int j0 = 0; j0 < kTileN; j0 += 2) {
+            __m256 lo[2][2], hi[2][2];
+            for (int i = 0; i < 2; ++i)
+                for (int j = 0; j < 2; ++j) {
+                    lo[i][j] = _mm256_setzero_ps();
+                    hi[i][j] = _mm256_setzero_ps();
+                }
+
+            for (int p = 0; p < k16; p += kLanes) {
+                __m256 alo[2], ahi[2];
+                for (int i = 0; i < 2; ++i) {
+                    alo[i] = _mm256_loadu_ps(A + (i0 + i) * lda + p);
+                    ahi[i] = _mm256_loadu_ps(A + (i0 + i) * lda + p + 8);
+                }
+                for (int j = 0; j < 2; ++j) {
+                    __m256 blo = _mm256_loadu_ps(B + (j0 + j) * ldb + p);
+                    __m256 bhi = _mm256_loadu_ps(B + (j0 + j) * ldb + p + 8);
+                    for (int i = 0; i < 2; ++i) {
+                        lo[i][j] = _mm256_add_ps(lo[i][j],
+                                                 _mm256_mul_ps(alo[i], blo));
+                        hi[i][j] = _mm256_add_ps(hi[i][j],
+                                                 _mm256_mul_ps(ahi[i], bhi));
+                    }
+                }
+            }
+
+            for (int i = 0; i < 2; ++i) {
+                for (int j = 0; j < 2; ++j) {
+                    alignas(32) float acc[kLanes];
+                    _mm256_store_ps(acc, lo[i][j]);
+                    _mm256_store_ps(acc + 8, hi[i][j]);
+                    C[(i0 + i) * ldc + j0 + j] =
+                        finish_lanes(acc, A + (i0 + i) * lda,
+                                     B + (j0 + j) * ldb, k16, k);
+                }
+            }
+        }
+    }
+}
+
+GLAD_TARGET_AVX2
+void dot_tile_avx2_fast(const float* A, int lda,
+                        const float* B, int ldb,
+                        int k, float* C, int ldc)
+{
+    int k8 = k & ~7;
+
+    for (int i0 = 0; i0 < kTileM; i0 += 2) {
+        __m256 acc[2][kTileN];
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < kTileN; ++j)
+                acc[i][j] = _mm256_setzero_ps();
+
+        for (int p = 0; p < k8; p += 8) {
+            __m256 a0 = _mm256_loadu_ps(A + i0 * lda + p);
+            __m256 a1 = _mm256_loadu_ps(A + (i0 + 1) * lda + p);
+            for (int j = 0; j < kTileN; ++j) {
+                __m256 b = _mm256_loadu_ps(B + j * ldb + p);
+                acc[0][j] = _mm256_fmadd_ps(a0, b, acc[0][j]);
+                acc[1][j] = _mm256_fmadd_ps(a1, b, acc[1][j]);
+            }
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            const float* a = A + (i0 + i) * lda;
+            for (int j = 0; j < kTileN; ++j) {
+                const float* b = B + j * ldb;
+                float sum = hsum_avx2(acc[i][j]);
+                for (int p = k8; p < k; ++p)
+                    sum += a[p] * b[p];
+                C[(i0 + i) * ldc + j] = sum;
+            }
+        }
+    }
+}
+
+constexpr int kAvx2AccN = 16;
+
+template <bool Fused>
+GLAD_TARGET_AVX2
+void acc_tile_avx2(float alpha,
+                   const float* A, int lda,
+                   const float* B, int ldb,
+                   int k, float* C, int ldc)
+{
+    __m256 acc[kTileM][2];
+    for (int i = 0; i < kTileM; ++i) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+
+    for (int p = 0; p < k; ++p) {
+        __m256 b0 = _mm256_loadu_ps(B + p * ldb);
+        __m256 b1 = _mm256_loadu_ps(B + p * ldb + 8);
+        for (int i = 0; i < kTileM; ++i) {
+            __m256 a = _mm256_set1_ps(A[i * lda + p]);
+            if (Fused) {
+                acc[i][0] = _mm256_fmadd_ps(a, b0, acc[i][0]);
+                acc[i][1] = _mm256_fmadd_ps(a, b1, acc[i][1]);
+            } else {
+                acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_mul_ps(a, b0));
+                acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_mul_ps(a, b1));
+            }
+        }
+    }
+
+    __m256 va = _mm256_set1_ps(alpha);
+    for (int i = 0; i < kTileM; ++i) {
+        for (int h = 0; h < 2; ++h) {
+            float* c = C + i * ldc + h * 8;
+            __m256 cv = _mm256_loadu_ps(c);
+            if (Fused)
+                cv = _mm256_fmadd_ps(va, acc[i][h], cv);
+            else
+                cv = _mm256_add_ps(cv, _mm256_mul_ps(va, acc[i][h]));
+            _mm256_storeu_ps(c, cv);
+        }
+    }
+}
+
+GLAD_TARGET_AVX2
+inline __m256 load_bf16_avx2(const uint16_t* x)
+{
+    __m256i w = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(w, 16));
+}
+
+GLAD_TARGET_AVX2
+inline __m256 load_f16_avx2(const uint16_t* x)
+{
+    return _mm256_cvtph_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+}
+
+template <bool Fused, bool BF16>
+GLAD_TARGET_AVX2
+void axpy_half_avx2(float alpha, const uint16_t* x, float* y, int n)
+{
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 xv = BF16 ? load_bf16_avx2(x + i) : load_f16_avx2(x + i);
+        __m256 yv = _mm256_loadu_ps(y + i);
+        if (Fused)
+            yv = _mm256_fmadd_ps(va, xv, yv);
+        else
+            yv = _mm256_add_ps(yv, _mm256_mul_ps(va, xv));
+        _mm256_storeu_ps(y + i, yv);
+    }
+    for (; i < n; ++i)
+        y[i] += alpha * (BF16 ? bf16_to_float(x[i]) : half_to_float(x[i]));
+}
+
+GLAD_TARGET_AVX2
+void f32_to_f16_avx2(const float* x, uint16_t* y, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(x + i),
+                                         _MM_FROUND_TO_NEAREST_INT));
+    for (; i < n; ++i)
+        y[i] = float_to_half(x[i]);
+}
+
+// One centroid gather per sub-vector: dsub 4 uses SSE registers, multiples
+// of 8 full AVX registers.
+template <bool Fused>
+GLAD_TARGET_AVX2
+void pq_axpy_avx2(float alpha, const float* codebook, const uint8_t* codes,
+                  int nsub, int dsub, float* y)
+{
+    if (dsub == 4) {
+        __m128 va = _mm_set1_ps(alpha);
+        for (int s = 0; s < nsub; ++s) {
+            __m128 c = _mm_loadu_ps(pq_centroid(codebook, codes, s, 4));
+            __m128 yv = _mm_loadu_ps(y + s * 4);
+            if (Fused)
+                yv = _mm_fmadd_ps(va, c, yv);
+            else
+                yv = _mm_add_ps(yv, _mm_mul_ps(va, c));
+            _mm_storeu_ps(y + s * 4, yv);
+        }
+        return;
+    }
+
+    if (dsub % 8 != 0) {
+        pq_axpy_scalar(alpha, codebook, codes, nsub, dsub, y);
+        return;
+    }
+
+    __m256 va = _mm256_set1_ps(alpha);
+    for (int s = 0; s < nsub; ++s) {
+        const float* c = pq_centroid(codebook, codes, s, dsub);
+        float* out = y + s * dsub;
+        for (int j = 0; j < dsub; j += 8) {
+            __m256 cv = _mm256_loadu_ps(c + j);
+            __m256 yv = _mm256_loadu_ps(out + j);
+            if (Fused)
+                yv = _mm256_fmadd_ps(va, cv, yv);
+            else
+                yv = _mm256_add_ps(yv, _mm256_mul_ps(va, cv));
+            _mm256_storeu_ps(out + j, yv);
+        }
+    }
+}
+
+GLAD_TARGET_AVX2
+float max_avx2(const float* x, int n)
+{
+    __m256 m = _mm256_set1_ps(-INFINITY);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        m = _mm256_max_ps(m, _mm256_loadu_ps(x + i));
+
+    __m128 h = _mm_max_ps(_mm256_castps256_ps128(m),
+                          _mm256_extractf128_ps(m, 1));
+    h = _mm_max_ps(h, _mm_movehl_ps(h, h));
+    h = _mm_max_ss(h, _mm_movehdup_ps(h));
+
+    float r = _mm_cvtss_f32(h);
+    for (; i < n; ++i)
+        r = x[i] > r ? x[i] : r;
+    return r;
+}
+
+// Fast exp, see kExpLo
+GLAD_TARGET_AVX2
+inline __m256 exp_avx2(__m256 x)
+{
+    __m256 under = _mm256_cmp_ps(x, _mm256_set1_ps(kExpLo), _CMP_LT_OQ);
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(kExpLo)),
+                      _mm256_set1_ps(kExpHi));
+
+    __m256 k = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kLog2e)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(k, _mm256_set1_ps(kLn2Hi), x);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(kLn2Lo), r);
+
+    __m256 p = _mm256_set1_ps(kExpP0);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP5));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r),
+                        _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+    __m256i e = _mm256_slli_epi32(
+        _mm256_add_epi32(_mm256_cvtps_epi32(k), _mm256_set1_epi32(127)), 23);
+    p = _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+
+    return _mm256_andnot_ps(under, p);
+}
+
+GLAD_TARGET_AVX2
+float exp_sum_avx2(const float* x, float shift, float* out, int n)
+{
+    __m256 vs = _mm256_set1_ps(shift);
+    __m256 s0 = _mm256_setzero_ps();
+    __m256 s1 = _mm256_setzero_ps();
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256 e0 = exp_avx2(_mm256_sub_ps(_mm256_loadu_ps(x + i), vs));
+        __m256 e1 = exp_avx2(_mm256_sub_ps(_mm256_loadu_ps(x + i + 8), vs));
+        if (out) {
+            _mm256_storeu_ps(out + i, e0);
+            _mm256_storeu_ps(out + i + 8, e1);
+        }
+        s0 = _mm256_add_ps(s0, e0);
+        s1 = _mm256_add_ps(s1, e1);
+    }
+
+    // Tail lanes read as -inf, so they add exp(-inf) = 0
+    for (; i < n; i += 8) {
+        __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - i), lane);
+        __m256 v = _mm256_blendv_ps(_mm256_set1_ps(-INFINITY),
+                                    _mm256_maskload_ps(x + i, mask),
+                                    _mm256_castsi256_ps(mask));
+        __m256 e = exp_avx2(_mm256_sub_ps(v, vs));
+        if (out)
+            _mm256_maskstore_ps(out + i, mask, e);
+        s0 = _mm256_add_ps(s0, e);
+    }
+
+    return hsum_avx2(_mm256_add_ps(s0, s1));
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512
+// ---------------------------------------------------------------------------
+
+GLAD_TARGET_AVX512
+float dot_avx512_strict(const float* a, const float* b, int n)
+{
+    __m512 s = _mm512_setzero_ps();
+    int n16 = n & ~(kLanes - 1);
+
+    for (int i = 0; i < n16; i += kLanes)
+        s = _mm512_add_ps(s, _mm512_mul_ps(_mm512_loadu_ps(a + i),
+                                           _mm512_loadu_ps(b + i)));
+
+    alignas(64) float acc[kLanes];
+    _mm512_store_ps(acc, s);
+    return finish_lanes(acc, a, b, n16, n);
+}
+
+GLAD_TARGET_AVX512
+float dot_avx512_fast(const float* a, const float* b, int n)
+{
+    __m512 s0 = _mm512_setzero_ps();
+    __m512 s1 = _mm512_setzero_ps();
+    __m512 s2 = _mm512_setzero_ps();
+    __m512 s3 = _mm512_setzero_ps();
+    int i = 0;
+
+    for (; i + 64 <= n; i += 64) {
+        s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i),
+                             _mm512_loadu_ps(b + i), s0);
+        s1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16),
+                             _mm512_loadu_ps(b + i + 16), s1);
+        s2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32),
+                             _mm512_loadu_ps(b + i + 32), s2);
+        s3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48),
+                             _mm512_loadu_ps(b + i + 48), s3);
+    }
+    for (; i + 16 <= n; i += 16)
+        s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i),
+                             _mm512_loadu_ps(b + i), s0);
+    if (i < n) {
+        __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1);
+        s1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i),
+                             _mm512_maskz_loadu_ps(m, b + i), s1);
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1),
+                                              _mm512_add_ps(s2, s3)));
+}
+
+GLAD_TARGET_AVX512
+void axpy_avx512_strict(float alpha, const float* x, float* y, int n)
+{
+    __m512 va = _mm512_set1_ps(alpha);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(y + i,
+            _mm512_add_ps(_mm512_loadu_ps(y + i),
+                          _mm512_mul_ps(va, _mm512_loadu_ps(x + i))));
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+GLAD_TARGET_AVX512
+void axpy_avx512_fast(float alpha, const float* x, float* y, int n)
+{
+    __m512 va = _mm512_set1_ps(alpha);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(y + i,
+            _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),
+                            _mm512_loadu_ps(y + i)));
+    if (i < n) {
+        __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(y + i, m,
+            _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x + i),
+                            _mm512_maskz_loadu_ps(m, y + i)));
+    }
+}
+
+GLAD_TARGET_AVX512
+void scale_avx512(float alpha, float* x, int n)
+{
+    __m512 va = _mm512_set1_ps(alpha);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(x + i, _mm512_mul_ps(va, _mm512_loadu_ps(x + i)));
+    for (; i < n; ++i)
+        x[i] *= alpha;
+}
+
+GLAD_TARGET_AVX512
+void axpy_update_avx512_strict(float grad,
+                               float step,
+                               const float* input,
+                               float* row,
+                               float* dinput,
+                               int n)
+{
+    __m512 vg = _mm512_set1_ps(grad);
+    __m512 vs = _mm512_set1_ps(step);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 r = _mm512_loadu_ps(row + i);
+        _mm512_storeu_ps(dinput + i,
+            _mm512_add_ps(_mm512_loadu_ps(dinput + i),
+                          _mm512_mul_ps(vg, r)));
+        _mm512_storeu_ps(row + i,
+            _mm512_add_ps(r, _mm512_mul_ps(vs, _mm512_loadu_ps(input + i))));
+    }
+    for (; i < n; ++i) {
+        dinput[i] += grad * row[i];
+        row[i] += step * input[i];
+    }
+}
+
+GLAD_TARGET_AVX512
+void axpy_update_avx512_fast(float grad,
+                             float step,
+                             const float* input,
+                             float* row,
+                             float* dinput,
+                             int n)
+{
+    __m512 vg = _mm512_set1_ps(grad);
+    __m512 vs = _mm512_set1_ps(step);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 r = _mm512_loadu_ps(row + i);
+        _mm512_storeu_ps(dinput + i,
+            _mm512_fmadd_ps(vg, r, _mm512_loadu_ps(dinput + i)));
+        _mm512_storeu_ps(row + i,
+            _mm512_fmadd_ps(vs, _mm512_loadu_ps(input + i), r));
+    }
+    for (; i < n; ++i) {
+        dinput[i] += grad * row[i];
+        row[i] += step * input[i];
+    }
+}
+
+template <bool Fused>
+GLAD_TARGET_AVX512
+void dot_tile_avx512(const float* A, int lda,
+                     const float* B, int ldb,
+                     int k, float* C, int ldc)
+{
+    __m512 acc[kTileM][kTileN];
+    for (int i = 0; i < kTileM; ++i)
+        for (int j = 0; j < kTileN; ++j)
+            acc[i][j] = _mm512_setzero_ps();
+
+    int k16 = k & ~(kLanes - 1);
+
+    for (int p = 0; p < k16; p += kLanes) {
+        __m512 a[kTileM];
+        for (int i = 0; i < kTileM; ++i)
+            a[i] = _mm512_loadu_ps(A + i * lda + p);
+        for (int j = 0; j < kTileN; ++j) {
+            __m512 b = _mm512_loadu_ps(B + j * ldb + p);
+            for (int i = 0; i < kTileM; ++i) {
+                if (Fused)
+                    acc[i][j] = _mm512_fmadd_ps(a[i], b, acc[i][j]);
+                else
+                    acc[i][j] = _mm512_add_ps(acc[i][j],
+                                              _mm512_mul_ps(a[i], b));
+            }
+        }
+    }
+
+    if (Fused) {
+        if (k16 < k) {
+            __mmask16 m = static_cast<__mmask16>((1u << (k - k16)) - 1);
+            for (int j = 0; j < kTileN; ++j) {
+                __m512 b = _mm512_maskz_loadu_ps(m, B + j * ldb + k16);
+                for (int i = 0; i < kTileM; ++i)
+                    acc[i][j] = _mm512_fmadd_ps(
+                        _mm512_maskz_loadu_ps(m, A + i * lda + k16),
+                        b, acc[i][j]);
+            }
+        }
+        for (int i = 0; i < kTileM; ++i)
+            for (int j = 0; j < kTileN; ++j)
+                C[i * ldc + j] = _mm512_reduce_add_ps(acc[i][j]);
+        return;
+    }
+
+    for (int i = 0; i < kTileM; ++i) {
+        for (int j = 0; j < kTileN; ++j) {
+            alignas(64) float lanes[kLanes];
+            _mm512_store_ps(lanes, acc[i][j]);
+            C[i * ldc + j] = finish_lanes(lanes, A + i * lda,
+                                          B + j * ldb, k16, k);
+        }
+    }
+}
+
+constexpr int kAvx512AccN = 32;
+
+template <bool Fused>
+GLAD_TARGET_AVX512
+void acc_tile_avx512(float alpha,
+                     const float* A, int lda,
+                     const float* B, int ldb,
+                     int k, float* C, int ldc)
+{
+    __m512 acc[kTileM][2];
+    for (int i = 0; i < kTileM; ++i) {
+        acc[i][0] = _mm512_setzero_ps();
+        acc[i][1] = _mm512_setzero_ps();
+    }
+
+    for (int p = 0; p < k; ++p) {
+        __m512 b0 = _mm512_loadu_ps(B + p * ldb);
+        __m512 b1 = _mm512_loadu_ps(B + p * ldb + 16);
+        for (int i = 0; i < kTileM; ++i) {
+            __m512 a = _mm512_set1_ps(A[i * lda + p]);
+            if (Fused) {
+                acc[i][0] = _mm512_fmadd_ps(a, b0, acc[i][0]);
+                acc[i][1] = _mm512_fmadd_ps(a, b1, acc[i][1]);
+            } else {
+                acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_mul_ps(a, b0));
+                acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_mul_ps(a, b1));
+            }
+        }
+    }
+
+    __m512 va = _mm512_set1_ps(alpha);
+    for (int i = 0; i < kTileM; ++i) {
+        for (int h = 0; h < 2; ++h) {
+            float* c = C + i * ldc + h * 16;
+            __m512 cv = _mm512_loadu_ps(c);
+            if (Fused)
+                cv = _mm512_fmadd_ps(va, acc[i][h], cv);
+            else
+                cv = _mm512_add_ps(cv, _mm512_mul_ps(va, acc[i][h]));
+            _mm512_storeu_ps(c, cv);
+        }
+    }
+}
+
+template <bool Fused, bool BF16>
+GLAD_TARGET_AVX512
+void axpy_half_avx512(float alpha, const uint16_t* x, float* y, int n)
+{
+    __m512 va = _mm512_set1_ps(alpha);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i raw = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(x + i));
+        __m512 xv = BF16
+            ? _mm512_castsi512_ps(
+                  _mm512_slli_epi32(_mm512_cvtepu16_epi32(raw), 16))
+            : _mm512_cvtph_ps(raw);
+        __m512 yv = _mm512_loadu_ps(y + i);
+        if (Fused)
+            yv = _mm512_fmadd_ps(va, xv, yv);
+        else
+            yv = _mm512_add_ps(yv, _mm512_mul_ps(va, xv));
+        _mm512_storeu_ps(y + i, yv);
+    }
+    for (; i < n; ++i)
+        y[i] += alpha * (BF16 ? bf16_to_float(x[i]) : half_to_float(x[i]));
+}
+
+GLAD_TARGET_AVX512
+void f32_to_f16_avx512(const float* x, uint16_t* y, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + i),
+                            _mm512_cvtps_ph(_mm512_loadu_ps(x + i),
+                                            _MM_FROUND_TO_NEAREST_INT));
+    for (; i < n; ++i)
+        y[i] = float_to_half(x[i]);
+}
+
+// dsub 8 packs two centroids per register; multiples of 16 use full
+// registers; anything else goes through the AVX2 version.
+template <bool Fused>
+GLAD_TARGET_AVX512
+void pq_axpy_avx512(float alpha, const float* codebook, const uint8_t* codes,
+                    int nsub, int dsub, float* y)
+{
+    __m512 va = _mm512_set1_ps(alpha);
+
+    auto step = [&](__m512 cv, float* out) GLAD_TARGET_AVX512 {
+        __m512 yv = _mm512_loadu_ps(out);
+        if (Fused)
+            yv = _mm512_fmadd_ps(va, cv, yv);
+        else
+            yv = _mm512_add_ps(yv, _mm512_mul_ps(va, cv));
+        _mm512_storeu_ps(out, yv);
+    };
+
+    if (dsub == 8) {
+        int s = 0;
+        for (; s + 2 <= nsub; s += 2) {
+            __m512 cv = _mm512_insertf32x8(
+                _mm512_castps256_ps512(
+                    _mm256_loadu_ps(pq_centroid(codebook, codes, s, 8))),
+                _mm256_loadu_ps(pq_centroid(codebook, codes, s + 1, 8)), 1);
+            step(cv, y + s * 8);
+        }
+        if (s < nsub)
+            pq_axpy_avx2<Fused>(alpha, codebook + s * kPQCentroids * 8,
+                                codes + s, 1, 8, y + s * 8);
+        return;
+    }
+
+    if (dsub % 16 != 0) {
+        pq_axpy_avx2<Fused>(alpha, codebook, codes, nsub, dsub, y);
+        return;
+    }
+
+    for (int s = 0; s < nsub; ++s) {
+        const float* c = pq_centroid(codebook, codes, s, dsub);
+        for (int j = 0; j < dsub; j += 16)
+            step(_mm512_loadu_ps(c + j), y + s * dsub + j);
+    }
+}
+
+GLAD_TARGET_AVX512
+float max_avx512(const float* x, int n)
+{
+    __m512 m = _mm512_set1_ps(-INFINITY);
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        m = _mm512_max_ps(m, _mm512_loadu_ps(x + i));
+    if (i < n) {
+        __mmask16 k = static_cast<__mmask16>((1u << (n - i)) - 1);
+        m = _mm512_mask_max_ps(m, k, m, _mm512_maskz_loadu_ps(k, x + i));
+    }
+    return _mm512_reduce_max_ps(m);
+}
+
+// Fast exp, see kExpLo
+GLAD_TARGET_AVX512
+inline __m512 exp_avx512(__m512 x)
+{
+    __mmask16 under = _mm512_cmp_ps_mask(x, _mm512_set1_ps(kExpLo),
+                                         _CMP_LT_OQ);
+    x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(kExpLo)),
+                      _mm512_set1_ps(kExpHi));
+
+    __m512 k = _mm512_roundscale_ps(
+        _mm512_mul_ps(x, _mm512_set1_ps(kLog2e)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(k, _mm512_set1_ps(kLn2Hi), x);
+    r = _mm512_fnmadd_ps(k, _mm512_set1_ps(kLn2Lo), r);
+
+    __m512 p = _mm512_set1_ps(kExpP0);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP1));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP2));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP3));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP4));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP5));
+    p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r),
+                        _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+
+    __m512i e = _mm512_slli_epi32(
+        _mm512_add_epi32(_mm512_cvtps_epi32(k), _mm512_set1_epi32(127)), 23);
+    p = _mm512_mul_ps(p, _mm512_castsi512_ps(e));
+
+    return _mm512_maskz_mov_ps(static_cast<__mmask16>(~under), p);
+}
+
+GLAD_TARGET_AVX512
+float exp_sum_avx512(const float* x, float shift, float* out, int n)
+{
+    __m512 vs = _mm512_set1_ps(shift);
+    __m512 s0 = _mm512_setzero_ps();
+    __m512 s1 = _mm512_setzero_ps();
+    int i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m512 e0 = exp_avx512(_mm512_sub_ps(_mm512_loadu_ps(x + i), vs));
+        __m512 e1 = exp_avx512(_mm512_sub_ps(_mm512_loadu_ps(x + i + 16),
+                                             vs));
+        if (out) {
+            _mm512_storeu_ps(out + i, e0);
+            _mm512_storeu_ps(out + i + 16, e1);
+        }
+        s0 = _mm512_add_ps(s0, e0);
+        s1 = _mm512_add_ps(s1, e1);
+    }
+
+    for (; i < n; i += 16) {
+        int left = n - i < 16 ? n - i : 16;
+        __mmask16 k = static_cast<__mmask16>((1u << left) - 1);
+        __m512 e = exp_avx512(_mm512_sub_ps(_mm512_maskz_loadu_ps(k, x + i),
+                                            vs));
+        e = _mm512_maskz_mov_ps(k, e);
+        if (out)
+            _mm512_mask_storeu_ps(out + i, k, e);
+        s0 = _mm512_add_ps(s0, e);
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(s0, s1));
+}
+
+GLAD_TARGET_AVX512BF16
+void f32_to_bf16_avx512bf16(const float* x, uint16_t* y, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256bh b = _mm512_cvtneps_pbh(_mm512_loadu_ps(x + i));
+        std::memcpy(y + i, &b, sizeof(b));
+    }
+    for (; i < n; ++i)
+        y[i] = float_to_bf16(x[i]);
+}
+
+#endif  // GLAD_SIMD_X86
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+const KernelTable kScalarTable = {
+    dot_scalar, axpy_scalar, scale_scalar, axpy_update_scalar,
+    dot_tile_scalar, acc_tile_scalar, kScalarAccN,
+    axpy_f16_scalar, axpy_bf16_scalar, f32_to_f16_scalar,
+    pq_axpy_scalar,
+    max_scalar, exp_sum_scalar
+};
+
+#ifdef GLAD_SIMD_X86
+const KernelTable kAvx2StrictTable = {
+    dot_avx2_strict, axpy_avx2_strict, scale_avx2, axpy_update_avx2_strict,
+    dot_tile_avx2_strict, acc_tile_avx2<false>, kAvx2AccN,
+    axpy_half_avx2<false, false>, axpy_half_avx2<false, true>,
+    f32_to_f16_avx2, pq_axpy_avx2<false>,
+    max_avx2, exp_sum_scalar
+};
+const KernelTable kAvx2FastTable = {
+    dot_avx2_fast, axpy_avx2_fast, scale_avx2, axpy_update_avx2_fast,
+    dot_tile_avx2_fast, acc_tile_avx2<true>, kAvx2AccN,
+    axpy_half_avx2<true, false>, axpy_half_avx2<true, true>,
+    f32_to_f16_avx2, pq_axpy_avx2<true>,
+    max_avx2, exp_sum_avx2
+};
+const KernelTable kAvx512StrictTable = {
+    dot_avx512_strict, axpy_avx512_strict, scale_avx512,
+    axpy_update_avx512_strict,
+    dot_tile_avx512<false>, acc_tile_avx512<false>, kAvx512AccN,
+    axpy_half_avx512<false, false>, axpy_half_avx512<false, true>,
+    f32_to_f16_avx512, pq_axpy_avx512<false>,
+    max_avx512, exp_sum_scalar
+};
+const KernelTable kAvx512FastTable = {
+    dot_avx512_fast, axpy_avx512_fast, scale_avx512,
+    axpy_update_avx512_fast,
+    dot_tile_avx512<true>, acc_tile_avx512<true>, kAvx512AccN,
+    axpy_half_avx512<true, false>, axpy_half_avx512<true, true>,
+    f32_to_f16_avx512, pq_axpy_avx512<true>,
+    max_avx512, exp_sum_avx512
+};
+#endif
+
+std::atomic<int> g_level{-1};
+std::atomic<bool> g_deterministic{false};
+std::atomic<const KernelTable*> g_table{nullptr};
+
+const KernelTable* select_table(SimdLevel level, bool deterministic)
+{
+#ifdef GLAD_SIMD_X86
+    switch (level) {
+        case SimdLevel::AVX512:
+            return deterministic ? &kAvx512StrictTable : &kAvx512FastTable;
+        case SimdLevel::AVX2:
+            return deterministic ? &kAvx2StrictTable : &kAvx2FastTable;
+        case SimdLevel::SCALAR:
+            break;
+    }
+#else
+    (void)level;
+    (void)deterministic;
+#endif
+    return &kScalarTable;
+}
+
+void refresh_table()
+{
+    g_table.store(select_table(simd_level(), g_deterministic.load()),
+                  std::memory_order_release);
+}
+
+inline const KernelTable& table()
+{
+    const KernelTable* t = g_table.load(std::memory_order_acquire);
+    if (!t) {
+        refresh_table();
+        t = g_table.load(std::memory_order_acquire);
+    }
+    return *t;
+}
+
+}  // namespace
+
+SimdLevel simd_detect_level()
+{
+#ifdef GLAD_SIMD_X86
+    static const SimdLevel detected = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512dq"))
+            return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") &&
+            __builtin_cpu_supports("fma") &&
+            __builtin_cpu_supports("f16c"))
+            return SimdLevel::AVX2;
+        return SimdLevel::SCALAR;
+    }();
+    return detected;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+bool simd_has_avx512bw()
+{
+#ifdef GLAD_SIMD_X86
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512bw") != 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+SimdLevel simd_level()
+{
+    int level = g_level.load();
+    if (level < 0)
+        return simd_detect_level();
+    return static_cast<SimdLevel>(level);
+}
+
+void simd_set_level(SimdLevel level)
+{
+    if (static_cast<int>(level) > static_cast<int>(simd_detect_level()))
+        level = simd_detect_level();
+    g_level.store(static_cast<int>(level));
+    refresh_table();
+}
+
+bool simd_deterministic()
+{
+    return g_deterministic.load();
+}
+
+void simd_set_deterministic(bool enabled)
+{
+    g_deterministic.store(enabled);
+    refresh_table();
+}
+
+const char* simd_level_name(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::AVX512:
+            return "avx512";
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SCALAR:
+            break;
+    }
+    return "scalar";
+}
+
+float vec_dot(const float* a, const float* b, int n)
+{
+    return table().dot(a, b, n);
+}
+
+void vec_axpy(float alpha, const float* x, float* y, int n)
+{
+    table().axpy(alpha, x, y, n);
+}
+
+void vec_scale(float alpha, float* x, int n)
+{
+    table().scale(alpha, x, n);
+}
+
+void vec_axpy_update(float grad,
+                     float step,
+                     const float* input,
+                     float* row,
+                     float* dinput,
+                     int n)
+{
+    table().axpy_update(grad, step, input, row, dinput, n);
+}
+
+void gemm_nt(int m, int n, int k,
+             const float* A, int lda,
+             const float* B, int ldb,
+             float* C, int ldc)
+{
+    // B rows per block: 64 rows of a 256-d matrix is 64 KB, which stays in
+    // L2 while every A row streams past it.
+    constexpr int kBlockN = 64;
+
+    const KernelTable& t = table();
+
+    for (int j0 = 0; j0 < n; j0 += kBlockN) {
+        int j_end = j0 + kBlockN < n ? j0 + kBlockN : n;
+
+        for (int i0 = 0; i0 < m; i0 += kTileM) {
+            for (int j = j0; j < j_end; j += kTileN) {
+                if (i0 + kTileM <= m && j + kTileN <= j_end) {
+                    t.dot_tile(A + i0 * lda, lda, B + j * ldb, ldb,
+                               k, C + i0 * ldc + j, ldc);
+                    continue;
+                }
+                for (int i = i0; i < m && i < i0 + kTileM; ++i)
+                    for (int jj = j; jj < j_end && jj < j + kTileN; ++jj)
+                        C[i * ldc + jj] =
+                            t.dot(A + i * lda, B + jj * ldb, k);
+            }
+        }
+    }
+}
+
+void gemm_nn_acc(int m, int n, int k,
+                 float alpha,
+                 const float* A, int lda,
+                 const float* B, int ldb,
+                 float* C, int ldc)
+{
+    // k is blocked so a kBlockK x acc_nr panel of B stays in L1 while it is
+    // reused across all rows of A.
+    constexpr int kBlockK = 256;
+
+    const KernelTable& t = table();
+    const int nr = t.acc_nr;
+
+    for (int p0 = 0; p0 < k; p0 += kBlockK) {
+        int kb = p0 + kBlockK < k ? kBlockK : k - p0;
+
+        for (int j0 = 0; j0 < n; j0 += nr) {
+            int nb = j0 + nr < n ? nr : n - j0;
+
+            for (int i0 = 0; i0 < m; i0 += kTileM) {
+                int mb = i0 + kTileM < m ? kTileM : m - i0;
+
+                const float* a = A + i0 * lda + p0;
+                const float* b = B + p0 * ldb + j0;
+                float* c = C + i0 * ldc + j0;
+
+                if (mb == kTileM && nb == nr)
+                    t.acc_tile(alpha, a, lda, b, ldb, kb, c, ldc);
+                else
+                    acc_block_scalar(mb, nb, alpha, a, lda, b, ldb,
+                                     kb, c, ldc);
+            }
+        }
+    }
+}
+
+void spmm_csr_acc(int m, int n,
+                  const int* row_ptr,
+                  const int* indices,
+                  const float* values,
+                  const float* B, int ldb,
+                  float* C, int ldc)
+{
+    const KernelTable& t = table();
+
+    for (int i = 0; i < m; ++i) {
+        float* c = C + static_cast<size_t>(i) * ldc;
+
+        int end = row_ptr[i + 1];
+        for (int p = row_ptr[i]; p < end; ++p) {
+            // Hashed features hit random rows of B; start the next load now
+            if (p + 1 < end)
+                __builtin_prefetch(
+                    B + static_cast<size_t>(indices[p + 1]) * ldb);
+            t.axpy(values[p], B + static_cast<size_t>(indices[p]) * ldb,
+                   c, n);
+        }
+    }
+}
+
+void spmm_csr_t_acc(int m, int n,
+                    float alpha,
+                    const int* row_ptr,
+                    const int* indices,
+                    const float* values,
+                    const float* A, int lda,
+                    float* C, int ldc)
+{
+    const KernelTable& t = table();
+
+    for (int i = 0; i < m; ++i) {
+        const float* a = A + static_cast<size_t>(i) * lda;
+        for (int p = row_ptr[i]; p < row_ptr[i + 1]; ++p)
+            t.axpy(alpha * values[p], a,
+                   C + static_cast<size_t>(indices[p]) * ldc, n);
+    }
+}
+
+void vec_axpy_f16(float alpha, const uint16_t* x, float* y, int n)
+{
+    table().axpy_f16(alpha, x, y, n);
+}
+
+void vec_axpy_bf16(float alpha, const uint16_t* x, float* y, int n)
+{
+    table().axpy_bf16(alpha, x, y, n);
+}
+
+void vec_f32_to_f16(const float* x, uint16_t* y, int n)
+{
+    table().f32_to_f16(x, y, n);
+}
+
+void vec_f32_to_bf16(const float* x, uint16_t* y, int n)
+{
+#ifdef GLAD_SIMD_X86
+    static const bool has_bf16 = __builtin_cpu_supports("avx512bf16");
+    if (has_bf16 && simd_level() == SimdLevel::AVX512) {
+        f32_to_bf16_avx512bf16(x, y, n);
+        return;
+    }
+#endif
+    f32_to_bf16_scalar(x, y, n);
+}
+
+void vec_pq_axpy(float alpha,
+                 const float* codebook,
+                 const uint8_t* codes,
+                 int nsub,
+                 int dsub,
+                 float* y)
+{
+    table().pq_axpy(alpha, codebook, codes, nsub, dsub, y);
+}
+
+float vec_max(const float* x, int n)
+{
+    return table().max(x, n);
+}
+
+float vec_exp_sum(const float* x, float shift, float* out, int n)
+{
+    return table().exp_sum(x, shift, out, n);
+}
+
+void vec_softmax(float* x, int n)
+{
+    const KernelTable& t = table();
+
+    float max_val = t.max(x, n);
+    float sum = t.exp_sum(x, max_val, x, n);
+    t.scale(1.0f / sum, x, n);
+}
+
+void vec_log_softmax(float* x, int n)
+{
+    const KernelTable& t = table();
+
+    float max_val = t.max(x, n);
+    float log_sum = std::log(t.exp_sum(x, max_val, nullptr, n));
+
+    // (x - max) is exact; subtracting max + log_sum in one go would round
+    // at the scale of max
+    for (int i = 0; i < n; ++i)
+        x[i] = (x[i] - max_val) - log_sum;
+}
+
+float softmax_xent(int m, int n,
+                   const float* logits, int ldl,
+                   const int* labels,
+                   float* dlogits, int ldd)
+{
+    const KernelTable& t = table();
+    float loss = 0.0f;
+
+    for (int i = 0; i < m; ++i) {
+        const float* l = logits + static_cast<size_t>(i) * ldl;
+        float* d = dlogits + static_cast<size_t>(i) * ldd;
+        int label = labels[i];
+
+        // Pass 1: max. Read the label's logit before d may overwrite it.
+        float max_val = t.max(l, n);
+        float target = l[label] - max_val;
+
+        // Pass 2: d = exp(l - max) and its sum, then normalize in place
+        float sum = t.exp_sum(l, max_val, d, n);
+        t.scale(1.0f / sum, d, n);
+        d[label] -= 1.0f;
+
+        // -log softmax[label] = log sum - (l[label] - max)
+        loss += std::log(sum) - target;
+    }
+
+    return loss;
+}
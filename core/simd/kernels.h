@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+
+// Small dense-vector kernel library used on the encode / classify hot paths.
+//
+// Every kernel has a scalar, an AVX2+FMA and an AVX-512 implementation. The
+// widest one the CPU supports is picked at first use via CPUID; tests and
+// benchmarks can force a lower level with simd_set_level().
+//
+// In deterministic mode the kernels avoid FMA contraction and reduce dot
+// products over a fixed 16-lane layout, so all levels produce bitwise
+// identical results. The default (fast) mode uses FMA and wider unrolling.
+
+enum class SimdLevel {
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+// Best level supported by this CPU (and compiled in).
+SimdLevel simd_detect_level();
+
+SimdLevel simd_level();
+
+// Clamped to simd_detect_level().
+void simd_set_level(SimdLevel level);
+
+bool simd_deterministic();
+void simd_set_deterministic(bool enabled);
+
+const char* simd_level_name(SimdLevel level);
+
+// AVX-512 byte / word instructions (AVX-512BW). SimdLevel::AVX512 only
+// implies F and DQ, so byte-oriented code (tokenizer, n-gram hashing)
+// checks this as well. The CPU is queried once.
+bool simd_has_avx512bw();
+
+// sum_i a[i] * b[i]
+float vec_dot(const float* a, const float* b, int n);
+
+// y += alpha * x
+void vec_axpy(float alpha, const float* x, float* y, int n);
+
+// x *= alpha
+void vec_scale(float alpha, float* x, int n);
+
+// Fused backward step for one weight row, reading row before updating it:
+//   dinput += grad * row
+//   row    += step * input
+void vec_axpy_update(float grad,
+                     float step,
+                     const float* input,
+                     float* row,
+                     float* dinput,
+                     int n);
+
+// y += alpha * x for 16-bit storage: IEEE binary16 (F16C / AVX-512 convert)
+// and bfloat16 (widened by a shift). The conversion is exact, so these obey
+// the same deterministic-mode rules as vec_axpy.
+void vec_axpy_f16(float alpha, const uint16_t* x, float* y, int n);
+void vec_axpy_bf16(float alpha, const uint16_t* x, float* y, int n);
+
+// float -> 16-bit storage, round to nearest even. f32 -> bf16 uses AVX-512
+// BF16 when present; that instruction flushes denormals to zero.
+void vec_f32_to_f16(const float* x, uint16_t* y, int n);
+void vec_f32_to_bf16(const float* x, uint16_t* y, int n);
+
+// Product-quantized axpy: y[s * dsub + j] += alpha * centroid(s)[j] for each
+// of the nsub sub-vectors, where centroid(s) is codebook row
+// (s * 256 + codes[s]) and the codebook is nsub x 256 x dsub floats.
+void vec_pq_axpy(float alpha,
+                 const float* codebook,
+                 const uint8_t* codes,
+                 int nsub,
+                 int dsub,
+                 float* y);
+
+// Row-major GEMM with the second operand transposed:
+//   C[i * ldc + j] = dot(A[i * lda ...], B[j * ldb ...])   (i < m, j < n)
+// Blocked over B rows and register-tiled 4x4 so each B row is loaded once per
+// four A rows. In deterministic mode every element equals vec_dot() bitwise.
+void gemm_nt(int m, int n, int k,
+             const float* A, int lda,
+             const float* B, int ldb,
+             float* C, int ldc);
+
+// Row-major accumulating GEMM:
+//   C[i * ldc + j] += alpha * sum_p A[i * lda + p] * B[p * ldb + j]
+void gemm_nn_acc(int m, int n, int k,
+                 float alpha,
+                 const float* A, int lda,
+                 const float* B, int ldb,
+                 float* C, int ldc);
+
+// max_i x[i], n > 0
+float vec_max(const float* x, int n);
+
+// sum_i exp(x[i] - shift), also written to out[i] unless out is null (out
+// may be x). shift is normally vec_max(x), so every term is <= 1.
+//
+// The fast AVX2 / AVX-512 levels evaluate exp with a polynomial after
+// range reduction (Cephes expf): max relative error 1.2e-7 (1 ulp) against
+// exp on [-87.3, 88], measured on a dense sweep; terms below exp(-87.3),
+// where the result would be subnormal, are flushed to 0. The scalar level
+// and deterministic mode use std::exp at every level, so results stay
+// bitwise identical across levels there.
+float vec_exp_sum(const float* x, float shift, float* out, int n);
+
+// In-place softmax and log-softmax of one row, via vec_max / vec_exp_sum.
+void vec_softmax(float* x, int n);
+void vec_log_softmax(float* x, int n);
+
+// Fused softmax cross-entropy over m rows of n logits (row stride ldl):
+// for row i with label y = labels[i],
+//   dlogits[i * ldd + j] = softmax(row)[j] - (j == y)
+// and the return value is the summed loss -log softmax(row)[y]. Per row:
+// one max pass, one exp pass that writes dlogits and sums, and an in-cache
+// scale. The loss is log(sum) - (l[y] - max), not the log of a rounded
+// probability, so it stays accurate (and unclamped) when softmax[y]
+// underflows. dlogits may alias logits (ldd == ldl).
+float softmax_xent(int m, int n,
+                   const float* logits, int ldl,
+                   const int* labels,
+                   float* dlogits, int ldd);
+
+// Accumulating CSR sparse times dense, for bag-of-features inputs. Sparse
+// row i holds indices / values [row_ptr[i], row_ptr[i + 1]); for i < m,
+// j < n
+//   C[i * ldc + j] += sum_p values[p] * B[indices[p] * ldb + j]
+// Each nonzero is one vec_axpy of a B row, with the next row prefetched, so
+// a row costs nnz * n instead of k * n.
+void spmm_csr_acc(int m, int n,
+                  const int* row_ptr,
+                  const int* indices,
+                  const float* values,
+                  const float* B, int ldb,
+                  float* C, int ldc);
+
+// Transposed accumulate, the weight gradient of spmm_csr_acc: for every
+// nonzero p of row i,
+//   C[indices[p] * ldc + j] += alpha * values[p] * A[i * lda + j]   (j < n)
+void spmm_csr_t_acc(int m, int n,
+                    float alpha,
+                    const int* row_ptr,
+                    const int* indices,
+                    const float* values,
+                    const float* A, int lda,
+                    float* C, int ldc);
@@ -0,0 +1,23 @@
+#pragma once
+
+// Compiler target attributes for the x86 SIMD code paths, shared by every
+// translation unit with intrinsics. Include from .cc files only; the
+// functions marked with these must only run after simd_level() (and, for
+// byte/word ops, simd_has_avx512bw()) says the CPU has the extensions.
+//
+//   GLAD_TARGET_AVX2        SimdLevel::AVX2
+//   GLAD_TARGET_AVX512      SimdLevel::AVX512
+//   GLAD_TARGET_AVX512BW    SimdLevel::AVX512 + simd_has_avx512bw()
+//   GLAD_TARGET_AVX512BF16  AVX-512 BF16 conversion instructions
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define GLAD_SIMD_X86 1
+#include <immintrin.h>
+#define GLAD_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#define GLAD_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#define GLAD_TARGET_AVX512BW \
+    __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl")))
+#define GLAD_TARGET_AVX512BF16 \
+    __attribute__((target("avx512f,avx512bw,avx512bf16")))
+#endif
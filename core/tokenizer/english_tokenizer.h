@@ -26,6 +26,28 @@ public:
         }
     }
     
+    // Same tokens as above, lowercased into out's arena.
+    void tokenize(std::string_view text, TokenBuffer& out) const override {
+        out.reset(text.size());
+
+        char* start = out.cursor();
+        size_t length = 0;
+
+        for (char c : text) {
+            if (std::isalnum(static_cast<unsigned char>(c))) {
+                start[length++] = static_cast<char>(
+                    std::tolower(static_cast<unsigned char>(c)));
+            } else if (length > 0) {
+                out.commit(length);
+                start = out.cursor();
+                length = 0;
+            }
+        }
+
+        if (length > 0)
+            out.commit(length);
+    }
+
     // Convenience method that returns tokens
     std::vector<std::string> tokenize(const std::string& text) const {
         std::vector<std::string> tokens;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "token_buffer.h"
+
 #include <string>
+#include <string_view>
 #include <vector>
 
 class ITokenizer {
@@ -9,4 +12,19 @@ public:
     
     virtual void tokenize(const std::string& text,
                          std::vector<std::string>& tokens) const = 0;
+
+    // Zero-copy variant writing views into a reusable buffer. The default
+    // goes through the vector overload; tokenizers on hot paths override it.
+    virtual void tokenize(std::string_view text, TokenBuffer& out) const {
+        std::vector<std::string> tokens;
+        tokenize(std::string(text), tokens);
+
+        size_t bytes = 0;
+        for (const auto& t : tokens)
+            bytes += t.size();
+
+        out.reset(bytes);
+        for (const auto& t : tokens)
+            out.push(t);
+    }
 };
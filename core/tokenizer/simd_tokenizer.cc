@@ -0,0 +1,239 @@
+#include "simd_tokenizer.h"
+#include "simd/kernels.h"
+#include "simd/target.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kBlock = 64;
+
+// Reference classification of n <= 64 bytes: copies them to dst, lowercasing
+// alnum bytes, and returns the alnum bitmask (bit i for src[i]).
+uint64_t classify_scalar(const char* src, char* dst, size_t n)
+{
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        if (std::isalnum(c)) {
+            dst[i] = static_cast<char>(std::tolower(c));
+            mask |= uint64_t(1) << i;
+        } else {
+            dst[i] = src[i];
+        }
+    }
+    return mask;
+}
+
+// Turns the per-block alnum masks into tokens. The whole text has been
+// copied to the arena, so a token is committed in place and the separators
+// before it are skipped.
+class RunEmitter {
+public:
+    explicit RunEmitter(TokenBuffer& out) : out_(out) {}
+
+    // mask covers text bytes [base, base + width), width <= 64.
+    void block(uint64_t mask, size_t base, size_t width)
+    {
+        uint64_t valid = width == kBlock ? ~uint64_t(0)
+                                         : (uint64_t(1) << width) - 1;
+        mask &= valid;
+
+        // Blocks inside a long token or a long gap
+        if (in_token_ ? mask == valid : mask == 0)
+            return;
+
+        uint64_t gaps = ~mask & valid;
+        size_t pos = 0;
+
+        while (pos < width) {
+            uint64_t rest = (in_token_ ? gaps : mask) >> pos;
+            if (!rest)
+                return;
+            pos += static_cast<size_t>(__builtin_ctzll(rest));
+
+            if (in_token_) {
+                emit(base + pos);
+            } else {
+                start_ = base + pos;
+                in_token_ = true;
+            }
+        }
+    }
+
+    void finish(size_t end)
+    {
+        if (in_token_)
+            emit(end);
+    }
+
+private:
+    void emit(size_t end)
+    {
+        out_.skip(start_ - consumed_);
+        out_.commit(end - start_);
+        consumed_ = end;
+        in_token_ = false;
+    }
+
+    TokenBuffer& out_;
+    size_t consumed_ = 0;
+    size_t start_ = 0;
+    bool in_token_ = false;
+};
+
+void scan_scalar(const char* src, char* dst, size_t n, RunEmitter& runs)
+{
+    for (size_t i = 0; i < n; i += kBlock) {
+        size_t width = n - i < kBlock ? n - i : kBlock;
+        runs.block(classify_scalar(src + i, dst + i, width), i, width);
+    }
+}
+
+#ifdef GLAD_SIMD_X86
+
+// ----------------------------------------------------------------------------
+// AVX2: two 32-byte halves per 64-bit mask
+// ----------------------------------------------------------------------------
+
+// Returns false (leaving dst untouched) if the 32 bytes are not all ASCII.
+GLAD_TARGET_AVX2
+inline bool classify_avx2(const char* src, char* dst, uint32_t& mask)
+{
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    if (_mm256_movemask_epi8(v))
+        return false;
+
+    // With the high bit clear, signed compares are range checks. OR-ing 0x20
+    // folds 'A'..'Z' onto 'a'..'z' and maps no other byte into that range.
+    __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i letter = _mm256_and_si256(
+        _mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded));
+    __m256i digit = _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+
+    __m256i lowered = _mm256_blendv_epi8(v, folded, letter);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), lowered);
+
+    mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_or_si256(letter, digit)));
+    return true;
+}
+
+GLAD_TARGET_AVX2
+inline uint64_t classify_block_avx2(const char* src, char* dst)
+{
+    uint32_t lo, hi;
+    if (classify_avx2(src, dst, lo) && classify_avx2(src + 32, dst + 32, hi))
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+    return classify_scalar(src, dst, kBlock);
+}
+
+GLAD_TARGET_AVX2
+void scan_avx2(const char* src, char* dst, size_t n, RunEmitter& runs)
+{
+    size_t i = 0;
+    for (; i + kBlock <= n; i += kBlock)
+        runs.block(classify_block_avx2(src + i, dst + i), i, kBlock);
+
+    if (i < n) {
+        // Zero padding is a separator; bits past the text are masked off.
+        alignas(32) char in[kBlock] = {};
+        alignas(32) char lowered[kBlock];
+        std::memcpy(in, src + i, n - i);
+        uint64_t mask = classify_block_avx2(in, lowered);
+        std::memcpy(dst + i, lowered, n - i);
+        runs.block(mask, i, n - i);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// AVX-512BW: one 64-byte block per step, masked load for the tail
+// ----------------------------------------------------------------------------
+
+GLAD_TARGET_AVX512BW
+inline uint64_t classify_block_avx512(const char* src,
+                                      char* dst,
+                                      __mmask64 live)
+{
+    __m512i v = _mm512_maskz_loadu_epi8(live, src);
+    if (_mm512_movepi8_mask(v)) {
+        size_t width = static_cast<size_t>(__builtin_popcountll(live));
+        return classify_scalar(src, dst, width);
+    }
+
+    __m512i folded = _mm512_or_si512(v, _mm512_set1_epi8(0x20));
+    __mmask64 letter = _mm512_cmple_epu8_mask(
+        _mm512_sub_epi8(folded, _mm512_set1_epi8('a')),
+        _mm512_set1_epi8('z' - 'a'));
+    __mmask64 digit = _mm512_cmple_epu8_mask(
+        _mm512_sub_epi8(v, _mm512_set1_epi8('0')),
+        _mm512_set1_epi8('9' - '0'));
+
+    __m512i lowered = _mm512_mask_blend_epi8(letter, v, folded);
+    _mm512_mask_storeu_epi8(dst, live, lowered);
+
+    return letter | digit;
+}
+
+GLAD_TARGET_AVX512BW
+void scan_avx512(const char* src, char* dst, size_t n, RunEmitter& runs)
+{
+    size_t i = 0;
+    for (; i + kBlock <= n; i += kBlock)
+        runs.block(classify_block_avx512(src + i, dst + i, ~__mmask64(0)),
+                   i, kBlock);
+
+    if (i < n) {
+        __mmask64 live = (__mmask64(1) << (n - i)) - 1;
+        runs.block(classify_block_avx512(src + i, dst + i, live), i, n - i);
+    }
+}
+
+#endif  // GLAD_SIMD_X86
+
+using ScanFn = void (*)(const char*, char*, size_t, RunEmitter&);
+
+ScanFn select_scan()
+{
+#ifdef GLAD_SIMD_X86
+    switch (simd_level()) {
+        case SimdLevel::AVX512:
+            if (simd_has_avx512bw())
+                return scan_avx512;
+            return scan_avx2;
+        case SimdLevel::AVX2:
+            return scan_avx2;
+        case SimdLevel::SCALAR:
+            break;
+    }
+#endif
+    return scan_scalar;
+}
+
+}  // namespace
+
+void SimdTokenizer::tokenize(std::string_view text, TokenBuffer& out) const
+{
+    out.reset(text.size());
+
+    RunEmitter runs(out);
+    select_scan()(text.data(), out.cursor(), text.size(), runs);
+    runs.finish(text.size());
+}
+
+void SimdTokenizer::tokenize(const std::string& text,
+                             std::vector<std::string>& tokens) const
+{
+    TokenBuffer buffer;
+    tokenize(std::string_view(text), buffer);
+
+    tokens.clear();
+    tokens.reserve(buffer.size());
+    for (std::string_view t : buffer)
+        tokens.emplace_back(t);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "itokenizer.h"
+
+// Drop-in replacement for EnglishTokenizer that classifies 32 (AVX2) or 64
+// (AVX-512BW) bytes per step. Each block is lowercased in registers and
+// copied whole into the token arena while a compare yields an alnum bitmask;
+// tokens are the runs of set bits, found with count-trailing-zeros.
+//
+// Blocks holding a byte >= 0x80 fall back to std::isalnum / std::tolower so
+// the output matches EnglishTokenizer exactly, whatever the C locale says
+// about those bytes. The SIMD level follows simd_level().
+class SimdTokenizer : public ITokenizer {
+public:
+    void tokenize(const std::string& text,
+                  std::vector<std::string>& tokens) const override;
+
+    void tokenize(std::string_view text, TokenBuffer& out) const override;
+
+    std::vector<std::string> tokenize(const std::string& text) const {
+        std::vector<std::string> tokens;
+        tokenize(text, tokens);
+        return tokens;
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Reusable tokenizer output: tokens are string_views into an arena owned by
+// the buffer. A tokenizer reserves the arena once per text (normalized
+// tokens never outgrow their source text), so the views stay valid until the
+// next clear() and a warmed-up buffer tokenizes without heap allocations.
+class TokenBuffer {
+public:
+    TokenBuffer() = default;
+
+    TokenBuffer(const TokenBuffer&) = delete;
+    TokenBuffer& operator=(const TokenBuffer&) = delete;
+    TokenBuffer(TokenBuffer&&) noexcept = default;
+    TokenBuffer& operator=(TokenBuffer&&) noexcept = default;
+
+    // Drops the tokens and makes room for bytes of token text. Invalidates
+    // all views.
+    void reset(size_t bytes)
+    {
+        tokens_.clear();
+        used_ = 0;
+        if (bytes > capacity_) {
+            size_t grown = capacity_ * 2 > bytes ? capacity_ * 2 : bytes;
+            arena_.reset(new char[grown]);
+            capacity_ = grown;
+        }
+    }
+
+    void clear() { reset(0); }
+
+    // Next free arena byte; the caller writes at most the reserved bytes.
+    char* cursor() noexcept { return arena_.get() + used_; }
+
+    // Commits the length bytes just written at cursor() as one token.
+    void commit(size_t length)
+    {
+        tokens_.emplace_back(arena_.get() + used_, length);
+        used_ += length;
+    }
+
+    // Steps over length bytes written at cursor() that belong to no token,
+    // for tokenizers that copy whole spans and only view the tokens in them.
+    void skip(size_t length) noexcept { used_ += length; }
+
+    // Copies token into the arena (reset() must have reserved room).
+    void push(std::string_view token)
+    {
+        for (size_t i = 0; i < token.size(); ++i)
+            cursor()[i] = token[i];
+        commit(token.size());
+    }
+
+    size_t size() const noexcept { return tokens_.size(); }
+    bool empty() const noexcept { return tokens_.empty(); }
+
+    std::string_view operator[](size_t i) const noexcept { return tokens_[i]; }
+
+    const std::vector<std::string_view>& tokens() const noexcept
+    {
+        return tokens_;
+    }
+
+    auto begin() const noexcept { return tokens_.begin(); }
+    auto end() const noexcept { return tokens_.end(); }
+
+private:
+    std::unique_ptr<char[]> arena_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+
+    std::vector<std::string_view> tokens_;
+};
@@ -1,13 +1,80 @@
 #include "training/simple_trainer.h"
-#include "loss/softmax.h"
+#include "config/model_config.h"
 #include "tokenizer/english_tokenizer.h"
 #include "encoder/mean_sentence_encoder.h"
-#include "classifier/linear_classifier.h"
+#include "encoder/vocab_index.h"
+#include "encoder/word_encoder.h"
+#include "classifier/iclassifier.h"
+#include "embedding/embedding_table.h"
+#include "training/streaming_loader.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// One per-sample SGD step on already tokenized input. All mutable scratch
+// is passed in, so concurrent calls only share the classifier, encoder and
+// embedding weights (Hogwild). embedding is null when the rows are frozen.
+template <class Tokens>
+float sgd_update(
+    const Tokens& tokens,
+    int label,
+    const ISentenceEncoder& encoder,
+    IClassifier& classifier,
+    EmbeddingTable* embedding,
+    float learning_rate,
+    float* sentence,
+    float* logits,
+    float* dsentence)
+{
+    encoder.encode(tokens, sentence);
+
+    // The sentence gradient is only needed if something below the head
+    // learns
+    bool backprop = embedding || encoder.trainable();
+
+    float loss = classifier.train_sample(
+        sentence,
+        label,
+        backprop ? dsentence : nullptr,
+        learning_rate,
+        logits);
+
+    if (backprop)
+        encoder.backward(tokens, dsentence,
+                         learning_rate, embedding);
+
+    return loss;
+}
+
+float sgd_step(
+    const EnglishTokenizer& tokenizer,
+    TokenBuffer& tokens,
+    const ISentenceEncoder& encoder,
+    IClassifier& classifier,
+    EmbeddingTable* embedding,
+    const Sample& sample,
+    float learning_rate,
+    float* sentence,
+    float* logits,
+    float* dsentence)
+{
+    tokenizer.tokenize(sample.text, tokens);
+
+    return sgd_update(tokens, sample.label, encoder, classifier, embedding,
+                      learning_rate, sentence, logits, dsentence);
+}
+
+}  // namespace
 
 SimpleTrainer::SimpleTrainer(
     EnglishTokenizer& tokenizer,
-    MeanSentenceEncoder& encoder,
-    LinearClassifier& classifier,
+    ISentenceEncoder& encoder,
+    IClassifier& classifier,
     int input_dim,
     int num_classes)
     : tokenizer_(tokenizer),
@@ -17,47 +84,288 @@ SimpleTrainer::SimpleTrainer(
       num_classes_(num_classes),
       sentence_(input_dim),
       logits_(num_classes),
-      dlogits_(num_classes)
+      dsentence_(input_dim)
 {}
 
+SimpleTrainer::SimpleTrainer(
+    EnglishTokenizer& tokenizer,
+    ISentenceEncoder& encoder,
+    IClassifier& classifier,
+    const ModelConfig& config,
+    int num_classes)
+    : SimpleTrainer(tokenizer, encoder, classifier,
+                    config.embedding_dim, num_classes)
+{
+    config.validate();
+    set_batch_size(config.batch_size);
+}
+
 float SimpleTrainer::train_epoch(
     const std::vector<Sample>& data,
     float learning_rate)
 {
+    if (num_threads_ > 1 && data.size() > 1)
+        return train_epoch_hogwild(data, learning_rate);
+
+    if (batch_size_ > 1)
+        return train_epoch_batched(data, learning_rate);
+
     float total_loss = 0.0f;
 
-    for (const auto& sample : data) {
+    for (const auto& sample : data)
+        total_loss += sgd_step(tokenizer_, tokens_, encoder_, classifier_,
+                               embedding_, sample, learning_rate,
+                               sentence_.data(),
+                               logits_.data(),
+                               dsentence_.data());
+
+    return total_loss / data.size();
+}
+
+void SimpleTrainer::set_batch_size(int batch_size)
+{
+    if (batch_size <= 0)
+        throw std::invalid_argument("batch_size must be > 0");
+
+    batch_size_ = batch_size;
+}
+
+float SimpleTrainer::train_epoch_batched(
+    const std::vector<Sample>& data,
+    float learning_rate)
+{
+    batch_inputs_.resize(static_cast<size_t>(batch_size_) * dim_);
+    batch_logits_.resize(static_cast<size_t>(batch_size_) * num_classes_);
+    batch_tokens_.resize(batch_size_);
+    batch_labels_.resize(batch_size_);
+
+    bool backprop = embedding_ || encoder_.trainable();
+
+    if (backprop)
+        batch_dinputs_.resize(static_cast<size_t>(batch_size_) * dim_);
+
+    float total_loss = 0.0f;
+
+    for (size_t start = 0; start < data.size(); start += batch_size_) {
+
+        int n = static_cast<int>(
+            std::min<size_t>(batch_size_, data.size() - start));
+
+        for (int i = 0; i < n; ++i) {
+            tokenizer_.tokenize(data[start + i].text,
+                                batch_tokens_[i]);
+
+            encoder_.encode(batch_tokens_[i],
+                            &batch_inputs_[i * dim_]);
+        }
+
+        for (int i = 0; i < n; ++i)
+            batch_labels_[i] = data[start + i].label;
+
+        total_loss += classifier_.train_batch(
+            batch_inputs_.data(), n,
+            batch_labels_.data(),
+            backprop ? batch_dinputs_.data() : nullptr,
+            learning_rate,
+            batch_logits_.data());
+
+        // The head steps with the batch-mean gradient; match it here
+        if (backprop) {
+            for (int i = 0; i < n; ++i)
+                encoder_.backward(batch_tokens_[i],
+                                  &batch_dinputs_[i * dim_],
+                                  learning_rate / n,
+                                  embedding_);
+        }
+    }
+
+    return total_loss / data.size();
+}
+
+void SimpleTrainer::set_num_threads(int num_threads)
+{
+    if (num_threads <= 0)
+        throw std::invalid_argument("num_threads must be > 0");
+
+    num_threads_ = num_threads;
+}
+
+float SimpleTrainer::train_epoch_hogwild(
+    const std::vector<Sample>& data,
+    float learning_rate)
+{
+    int threads = static_cast<int>(
+        std::min<size_t>(num_threads_, data.size()));
+
+    std::vector<float> losses(threads, 0.0f);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
 
-        auto tokens =
-            tokenizer_.tokenize(sample.text);
+    const WordEncoder& shared_word_encoder = encoder_.word_encoder();
 
-        encoder_.encode(tokens,
-                        sentence_.data());
+    // The first worker failure, rethrown after the join like the serial
+    // path would throw it; the other workers stop at their next sample.
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
 
-        classifier_.forward(sentence_.data(),
-                            logits_.data());
+    for (int t = 0; t < threads; ++t) {
 
-        softmax(logits_.data(),
-                num_classes_);
+        size_t begin = data.size() * t / threads;
+        size_t end = data.size() * (t + 1) / threads;
 
-        float loss =
-            cross_entropy(logits_.data(),
-                          sample.label);
+        workers.emplace_back([&, t, begin, end] {
+            try {
+                // Private tokenizer, encoder scratch and activations; the
+                // classifier, encoder weights and embedding rows are
+                // updated without locks.
+                EnglishTokenizer tokenizer;
+                TokenBuffer tokens;
+                WordEncoder word_encoder(shared_word_encoder);
+                auto encoder = encoder_.clone(word_encoder);
 
-        total_loss += loss;
+                std::vector<float> sentence(dim_);
+                std::vector<float> logits(num_classes_);
+                std::vector<float> dsentence(dim_);
 
-        // dlogits = probs
-        for (int i = 0; i < num_classes_; ++i)
-            dlogits_[i] = logits_[i];
+                float loss = 0.0f;
 
-        dlogits_[sample.label] -= 1.0f;
+                for (size_t i = begin; i < end && !failed.load(); ++i)
+                    loss += sgd_step(tokenizer, tokens, *encoder,
+                                     classifier_, embedding_, data[i],
+                                     learning_rate,
+                                     sentence.data(),
+                                     logits.data(),
+                                     dsentence.data());
 
-        classifier_.backward_sgd(
-            sentence_.data(),
-            dlogits_.data(),
-            nullptr,
-            learning_rate);
+                losses[t] = loss;
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+                failed.store(true);
+            }
+        });
     }
 
+    for (auto& w : workers)
+        w.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    float total_loss = 0.0f;
+    for (float l : losses)
+        total_loss += l;
+
     return total_loss / data.size();
+}
+
+float SimpleTrainer::train_stream(
+    StreamingLoader& loader,
+    float learning_rate)
+{
+    if (loader.num_labels() > num_classes_)
+        throw std::invalid_argument(
+            "stream has more labels than the classifier has classes");
+
+    const WordEncoder& shared_word_encoder = encoder_.word_encoder();
+
+    // The blocks carry bucket ids, so the loader must hash exactly like
+    // the encoder being trained
+    if (loader.encoder().bucket_count() != shared_word_encoder.bucket_count() ||
+        VocabIndex::fingerprint(loader.encoder()) !=
+            VocabIndex::fingerprint(shared_word_encoder))
+        throw std::invalid_argument(
+            "stream is hashed with different encoder settings");
+
+    int threads = num_threads_;
+
+    std::vector<double> losses(threads, 0.0);
+    std::vector<size_t> counts(threads, 0);
+
+    auto work = [&](int t) {
+        // Same private state as the Hogwild epoch; tokenization and
+        // hashing already happened on the loader's reader threads.
+        WordEncoder word_encoder(shared_word_encoder);
+        auto encoder = encoder_.clone(word_encoder);
+
+        std::vector<float> sentence(dim_);
+        std::vector<float> logits(num_classes_);
+        std::vector<float> dsentence(dim_);
+
+        double loss = 0.0;
+        size_t count = 0;
+
+        while (FeatureBlock* block = loader.next()) {
+            for (uint32_t i : block->order)
+                loss += sgd_update(block->sentence(i), block->labels[i],
+                                   *encoder, classifier_, embedding_,
+                                   learning_rate,
+                                   sentence.data(),
+                                   logits.data(),
+                                   dsentence.data());
+
+            count += block->size();
+            loader.release(block);
+        }
+
+        losses[t] = loss;
+        counts[t] = count;
+    };
+
+    if (threads == 1) {
+        work(0);
+    } else {
+        // A reader failure rethrown by next(), or a training error, is
+        // kept and rethrown after the join, as in the single-thread case
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                try {
+                    work(t);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            });
+        for (auto& w : workers)
+            w.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    double total_loss = 0.0;
+    size_t total = 0;
+    for (int t = 0; t < threads; ++t) {
+        total_loss += losses[t];
+        total += counts[t];
+    }
+
+    return total ? static_cast<float>(total_loss / total) : 0.0f;
+}
+
+void SimpleTrainer::enable_embedding_training(
+    EmbeddingTable& embedding)
+{
+    if (&embedding != &encoder_.word_encoder().embedding())
+        throw std::invalid_argument(
+            "embedding must be the table the encoder reads");
+
+    if (embedding.is_mapped())
+        throw std::invalid_argument(
+            "memory-mapped embedding tables are read-only");
+
+    if (embedding.dtype() != EmbeddingDType::F32)
+        throw std::invalid_argument(
+            "embedding training needs f32 rows");
+
+    embedding_ = &embedding;
+    embedding.set_trainable(true);
 }
\ No newline at end of file
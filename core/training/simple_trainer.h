@@ -1,5 +1,7 @@
 #pragma once
 
+#include "tokenizer/token_buffer.h"
+
 #include <vector>
 #include <string>
 
@@ -9,29 +11,89 @@ struct Sample {
 };
 
 class EnglishTokenizer;
-class MeanSentenceEncoder;
-class LinearClassifier;
+class ISentenceEncoder;
+class IClassifier;
+class EmbeddingTable;
+class StreamingLoader;
+struct ModelConfig;
 
 class SimpleTrainer {
 public:
+    // encoder may be any sentence encoder; its own weights, if it has
+    // any, are trained along with the classifier.
     SimpleTrainer(EnglishTokenizer& tokenizer,
-                  MeanSentenceEncoder& encoder,
-                  LinearClassifier& classifier,
+                  ISentenceEncoder& encoder,
+                  IClassifier& classifier,
                   int input_dim,
                   int num_classes);
 
+    // input_dim is config.embedding_dim and the batch size starts at
+    // config.batch_size. Throws std::invalid_argument if the config does
+    // not validate.
+    SimpleTrainer(EnglishTokenizer& tokenizer,
+                  ISentenceEncoder& encoder,
+                  IClassifier& classifier,
+                  const ModelConfig& config,
+                  int num_classes);
+
     float train_epoch(const std::vector<Sample>& data,
                       float learning_rate);
 
+    // Trains on every block the loader yields (all of its epochs) with
+    // num_threads workers pulling blocks concurrently; per-sample SGD,
+    // Hogwild when num_threads > 1. Returns the mean loss. Throws
+    // std::invalid_argument unless the loader hashes with this trainer's
+    // WordEncoder settings; a reader failure is rethrown to the caller.
+    float train_stream(StreamingLoader& loader, float learning_rate);
+
+    // Number of samples whose gradients are averaged before each weight
+    // update; the ModelConfig constructor takes it from
+    // ModelConfig::batch_size. 1 means per-sample SGD.
+    void set_batch_size(int batch_size);
+    int batch_size() const { return batch_size_; }
+
+    // Hogwild mode: with more than one thread, train_epoch splits the data
+    // into contiguous shards and each worker applies per-sample SGD to the
+    // shared weights without locking. Results are not bitwise reproducible
+    // and batch_size is ignored in this mode.
+    void set_num_threads(int num_threads);
+    int num_threads() const { return num_threads_; }
+
+    // Also train the embedding rows: the sentence gradient is sent back
+    // through the encoders into the n-gram and phonetic buckets each sample
+    // touched. embedding must be the (owned, f32) table the encoder reads.
+    // Marks it trainable(), which turns word vector caching off for it
+    // until set_trainable(false).
+    void enable_embedding_training(EmbeddingTable& embedding);
+
 private:
+    float train_epoch_batched(const std::vector<Sample>& data,
+                              float learning_rate);
+
+    float train_epoch_hogwild(const std::vector<Sample>& data,
+                              float learning_rate);
+
     EnglishTokenizer& tokenizer_;
-    MeanSentenceEncoder& encoder_;
-    LinearClassifier& classifier_;
+    ISentenceEncoder& encoder_;
+    IClassifier& classifier_;
 
     int dim_;
     int num_classes_;
 
     std::vector<float> sentence_;
     std::vector<float> logits_;
-    std::vector<float> dlogits_;
+    std::vector<float> dsentence_;
+
+    // Reused across samples so tokenization does not allocate
+    TokenBuffer tokens_;
+
+    EmbeddingTable* embedding_ = nullptr;
+
+    int batch_size_ = 1;
+    int num_threads_ = 1;
+    std::vector<float> batch_inputs_;
+    std::vector<float> batch_logits_;
+    std::vector<float> batch_dinputs_;
+    std::vector<int> batch_labels_;
+    std::vector<TokenBuffer> batch_tokens_;
 };
\ No newline at end of file
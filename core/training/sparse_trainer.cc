@@ -0,0 +1,92 @@
+#include "training/sparse_trainer.h"
+#include "classifier/sparse_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "simd/kernels.h"
+#include "tokenizer/english_tokenizer.h"
+
+#include <stdexcept>
+
+SparseTrainer::SparseTrainer(
+    EnglishTokenizer& tokenizer,
+    const MeanSentenceEncoder& encoder,
+    SparseClassifier& classifier)
+    : tokenizer_(tokenizer),
+      encoder_(encoder),
+      classifier_(classifier),
+      sentence_(classifier.dense_dim()),
+      logits_(classifier.num_classes()),
+      dsentence_(classifier.dense_dim())
+{
+    if (classifier.dense_dim() > 0 && classifier.dense_dim() != encoder.dim())
+        throw std::invalid_argument(
+            "hybrid dense_dim does not match the encoder dim");
+
+    if (encoder.word_encoder().bucket_count() != classifier.num_features())
+        throw std::invalid_argument(
+            "classifier num_features must equal the bucket count");
+}
+
+float SparseTrainer::train_epoch(
+    const std::vector<Sample>& data,
+    float learning_rate)
+{
+    int num_classes = classifier_.num_classes();
+    bool dense = classifier_.dense_dim() > 0;
+    float total_loss = 0.0f;
+
+    for (const auto& sample : data) {
+        tokenizer_.tokenize(sample.text, tokens_);
+
+        features_.clear();
+        encoder_.append_features(tokens_, features_);
+
+        if (dense)
+            encoder_.encode_features(features_, 0, sentence_.data());
+
+        classifier_.forward(sentence_.data(),
+                            features_.row_indices(0),
+                            features_.row_values(0),
+                            features_.row_size(0),
+                            logits_.data());
+
+        // dlogits = probs - onehot, in place
+        total_loss += softmax_xent(1, num_classes, logits_.data(), 0,
+                                   &sample.label, logits_.data(), 0);
+
+        bool backprop = dense && embedding_;
+
+        classifier_.backward_sgd(sentence_.data(),
+                                 features_.row_indices(0),
+                                 features_.row_values(0),
+                                 features_.row_size(0),
+                                 logits_.data(),
+                                 backprop ? dsentence_.data() : nullptr,
+                                 learning_rate);
+
+        if (backprop)
+            encoder_.backward(tokens_, dsentence_.data(), learning_rate,
+                              *embedding_);
+    }
+
+    return total_loss / data.size();
+}
+
+void SparseTrainer::enable_embedding_training(EmbeddingTable& embedding)
+{
+    if (classifier_.dense_dim() == 0)
+        throw std::invalid_argument(
+            "a SPARSE head has no embedding to train");
+
+    if (&embedding != &encoder_.word_encoder().embedding())
+        throw std::invalid_argument(
+            "embedding must be the table the encoder reads");
+
+    if (embedding.is_mapped() || embedding.dtype() != EmbeddingDType::F32)
+        throw std::invalid_argument(
+            "embedding training needs an owned f32 table");
+
+    embedding_ = &embedding;
+    embedding.set_trainable(true);
+}
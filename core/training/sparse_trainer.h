@@ -0,0 +1,47 @@
+#pragma once
+
+#include "encoder/sparse_features.h"
+#include "training/simple_trainer.h"
+#include "tokenizer/token_buffer.h"
+
+#include <vector>
+
+class EmbeddingTable;
+class EnglishTokenizer;
+class MeanSentenceEncoder;
+class SparseClassifier;
+
+// Per-sample SGD for the SPARSE / HYBRID head. encoder supplies each
+// sample's bucket features and, for a hybrid head, the dense sentence
+// vector (its embedding dim must equal the head's dense_dim). In SPARSE the
+// embedding table is never read, so the encoder may sit on any table with
+// the right bucket hashing.
+class SparseTrainer {
+public:
+    // Throws std::invalid_argument if a hybrid head's dense_dim differs
+    // from the encoder dim.
+    SparseTrainer(EnglishTokenizer& tokenizer,
+                  const MeanSentenceEncoder& encoder,
+                  SparseClassifier& classifier);
+
+    float train_epoch(const std::vector<Sample>& data, float learning_rate);
+
+    // HYBRID only: also train the dense part's embedding rows. Marks the
+    // table trainable(), as SimpleTrainer does.
+    void enable_embedding_training(EmbeddingTable& embedding);
+
+private:
+    EnglishTokenizer& tokenizer_;
+    const MeanSentenceEncoder& encoder_;
+    SparseClassifier& classifier_;
+
+    std::vector<float> sentence_;
+    std::vector<float> logits_;
+    std::vector<float> dsentence_;
+
+    // Reused across samples so nothing allocates once warmed up
+    TokenBuffer tokens_;
+    SparseFeatures features_;
+
+    EmbeddingTable* embedding_ = nullptr;
+};
@@ -0,0 +1,469 @@
+#include "training/streaming_loader.h"
+#include "encoder/word_encoder.h"
+#include "tokenizer/simd_tokenizer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::string_view LABEL_PREFIX = "__label__";
+
+using Clock = std::chrono::steady_clock;
+
+int64_t elapsed_ns(Clock::time_point since)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - since).count();
+}
+
+double to_seconds(int64_t ns) { return ns * 1e-9; }
+
+size_t round_up_pow2(size_t n)
+{
+    size_t p = 2;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+bool is_blank(char c) { return c == ' ' || c == '\t'; }
+
+// Calls f(label) for each leading "__label__" word of line, without the
+// prefix, and returns the text after them.
+template <class F>
+std::string_view split_labels(std::string_view line, F&& f)
+{
+    size_t pos = 0;
+
+    for (;;) {
+        while (pos < line.size() && is_blank(line[pos]))
+            ++pos;
+
+        if (line.compare(pos, LABEL_PREFIX.size(), LABEL_PREFIX) != 0)
+            break;
+
+        size_t end = pos;
+        while (end < line.size() && !is_blank(line[end]))
+            ++end;
+
+        f(line.substr(pos + LABEL_PREFIX.size(),
+                      end - pos - LABEL_PREFIX.size()));
+        pos = end;
+    }
+
+    return line.substr(pos);
+}
+
+const StreamOptions& validated(const StreamOptions& options)
+{
+    if (options.block_bytes == 0)
+        throw std::invalid_argument("block_bytes must be > 0");
+    if (options.reader_threads <= 0)
+        throw std::invalid_argument("reader_threads must be > 0");
+    if (options.queue_capacity <= 0)
+        throw std::invalid_argument("queue_capacity must be > 0");
+    if (options.epochs <= 0)
+        throw std::invalid_argument("epochs must be > 0");
+    return options;
+}
+
+}  // namespace
+
+void FeatureBlock::clear()
+{
+    labels.clear();
+    sample_tokens.assign(1, 0);
+    token_buckets.assign(1, 0);
+    phonetic.clear();
+    buckets.clear();
+    order.clear();
+}
+
+const char* StreamReport::bottleneck() const
+{
+    if (trainer_wait_seconds <= reader_wait_seconds)
+        return "train";
+    return read_seconds > parse_seconds ? "read" : "parse";
+}
+
+std::string StreamReport::summary() const
+{
+    auto rate = [](double amount, double seconds) {
+        return seconds > 0.0 ? amount / seconds : 0.0;
+    };
+
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+        "%llu samples, %llu blocks, %.1f MB in %.3f s "
+        "(%.0f samples/s, %llu lines skipped)\n"
+        "  read   %8.3f s busy  %8.1f MB/s per thread\n"
+        "  parse  %8.3f s busy  %8.0f samples/s per thread\n"
+        "  train  %8.3f s busy  %8.0f samples/s per thread\n"
+        "  wait   readers %.3f s, trainers %.3f s\n"
+        "  bottleneck: %s",
+        static_cast<unsigned long long>(samples),
+        static_cast<unsigned long long>(blocks),
+        bytes / 1e6, wall_seconds, rate(samples, wall_seconds),
+        static_cast<unsigned long long>(skipped_lines),
+        read_seconds, rate(bytes / 1e6, read_seconds),
+        parse_seconds, rate(samples, parse_seconds),
+        train_seconds, rate(samples, train_seconds),
+        reader_wait_seconds, trainer_wait_seconds,
+        bottleneck());
+    return buf;
+}
+
+StreamingLoader::StreamingLoader(
+    const std::string& path,
+    const WordEncoder& encoder,
+    std::vector<std::string> labels,
+    const StreamOptions& options)
+    : path_(path),
+      encoder_(encoder),
+      labels_(std::move(labels)),
+      options_(validated(options)),
+      free_(round_up_pow2(options.queue_capacity + options.reader_threads)),
+      ready_(round_up_pow2(options.queue_capacity))
+{
+    if (labels_.empty())
+        throw std::invalid_argument("at least one label is required");
+
+    for (size_t i = 0; i < labels_.size(); ++i)
+        label_index_.emplace(labels_[i], static_cast<int>(i));
+
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0)
+        throw std::runtime_error("cannot open '" + path + "': " +
+                                 std::strerror(errno));
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        ::close(fd_);
+        throw std::runtime_error("cannot stat '" + path + "': " +
+                                 std::strerror(errno));
+    }
+
+    file_size_ = static_cast<size_t>(st.st_size);
+    num_blocks_ = (file_size_ + options_.block_bytes - 1) /
+                  options_.block_bytes;
+
+    // Block order of every epoch, fixed up front so it depends on the seed
+    // only and not on reader timing
+    std::mt19937_64 rng(options_.seed);
+    schedule_.reserve(num_blocks_ * options_.epochs);
+
+    for (int e = 0; e < options_.epochs; ++e) {
+        size_t first = schedule_.size();
+        for (size_t b = 0; b < num_blocks_; ++b)
+            schedule_.push_back(static_cast<uint32_t>(b));
+        if (options_.shuffle)
+            std::shuffle(schedule_.begin() + first, schedule_.end(), rng);
+    }
+
+    size_t pool = options_.queue_capacity + options_.reader_threads;
+    pool_.reserve(pool);
+    for (size_t i = 0; i < pool; ++i) {
+        pool_.push_back(std::make_unique<FeatureBlock>());
+        pool_.back()->clear();
+        free_.try_push(pool_.back().get());
+    }
+}
+
+StreamingLoader::~StreamingLoader()
+{
+    stop_.store(true);
+    for (auto& t : readers_)
+        t.join();
+
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+void StreamingLoader::start()
+{
+    std::call_once(started_, [this] {
+        start_time_ = Clock::now();
+
+        int threads = static_cast<int>(std::min<size_t>(
+            options_.reader_threads, std::max<size_t>(schedule_.size(), 1)));
+
+        active_readers_.store(threads);
+        readers_.reserve(threads);
+        for (int t = 0; t < threads; ++t)
+            readers_.emplace_back([this] { reader_loop(); });
+    });
+}
+
+FeatureBlock* StreamingLoader::next()
+{
+    start();
+
+    auto wait_start = Clock::now();
+    FeatureBlock* block = nullptr;
+    bool got = ready_.pop(block);
+    trainer_wait_ns_ += elapsed_ns(wait_start);
+
+    if (!got) {
+        int64_t zero = 0;
+        end_ns_.compare_exchange_strong(zero, elapsed_ns(start_time_));
+
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (error_)
+            std::rethrow_exception(error_);
+        return nullptr;
+    }
+
+    block->handed_out = Clock::now();
+    return block;
+}
+
+void StreamingLoader::release(FeatureBlock* block)
+{
+    train_ns_ += elapsed_ns(block->handed_out);
+    block->clear();
+
+    // The pool never outgrows the free ring, so this cannot fail
+    free_.try_push(block);
+}
+
+size_t StreamingLoader::pread_append(std::vector<char>& raw,
+                                     size_t offset,
+                                     size_t count)
+{
+    size_t have = raw.size();
+    raw.resize(have + count);
+
+    size_t done = 0;
+    while (done < count) {
+        ssize_t n = ::pread(fd_, raw.data() + have + done, count - done,
+                            static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("cannot read '" + path_ + "': " +
+                                     std::strerror(errno));
+        }
+        if (n == 0)
+            break;
+        done += static_cast<size_t>(n);
+    }
+
+    raw.resize(have + done);
+    return done;
+}
+
+size_t StreamingLoader::read_block(size_t b, std::vector<char>& raw)
+{
+    size_t begin = b * options_.block_bytes;
+    size_t end = std::min(begin + options_.block_bytes, file_size_);
+
+    // One byte of look-behind tells whether a line starts at begin
+    size_t from = begin > 0 ? begin - 1 : 0;
+
+    raw.clear();
+    pread_append(raw, from, end - from);
+
+    // Finish the last line that starts inside the block
+    for (size_t at = end; !raw.empty() && raw.back() != '\n' &&
+                          at < file_size_;) {
+        size_t old = raw.size();
+        size_t n = pread_append(raw, at, std::min<size_t>(
+            4096, file_size_ - at));
+        if (n == 0)
+            break;
+
+        auto nl = std::find(raw.begin() + old, raw.end(), '\n');
+        if (nl != raw.end()) {
+            raw.erase(nl + 1, raw.end());
+            break;
+        }
+        at += n;
+    }
+
+    return begin - from;
+}
+
+void StreamingLoader::reader_loop()
+{
+    SimdTokenizer tokenizer;
+    TokenBuffer tokens;
+    WordEncoder encoder(encoder_);
+    std::vector<char> raw;
+    std::mt19937_64 rng;
+
+    try {
+        for (;;) {
+            size_t task = next_task_.fetch_add(1);
+            if (task >= schedule_.size() || stop_.load())
+                break;
+
+            size_t b = schedule_[task];
+
+            auto t0 = Clock::now();
+            FeatureBlock* block = nullptr;
+            while (!free_.try_pop(block)) {
+                if (stop_.load())
+                    break;
+                std::this_thread::yield();
+            }
+            if (!block)
+                break;
+
+            auto t1 = Clock::now();
+            size_t start = read_block(b, raw);
+
+            auto t2 = Clock::now();
+            block->epoch = static_cast<int>(task / num_blocks_);
+
+            size_t block_end =
+                std::min(options_.block_bytes,
+                         file_size_ - b * options_.block_bytes) + start;
+
+            // Skip the tail of a line owned by the previous block
+            size_t pos = start;
+            if (start > 0 && raw[start - 1] != '\n') {
+                while (pos < raw.size() && raw[pos] != '\n')
+                    ++pos;
+                ++pos;
+            }
+
+            uint64_t skipped = 0;
+
+            while (pos < block_end && pos < raw.size()) {
+                size_t eol = pos;
+                while (eol < raw.size() && raw[eol] != '\n')
+                    ++eol;
+
+                std::string_view line(raw.data() + pos, eol - pos);
+                pos = eol + 1;
+
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+
+                std::string_view label;
+                bool labelled = false;
+                std::string_view text = split_labels(
+                    line, [&](std::string_view l) {
+                        if (!labelled)
+                            label = l;
+                        labelled = true;
+                    });
+
+                if (!labelled) {
+                    if (!text.empty())
+                        ++skipped;
+                    continue;
+                }
+
+                auto it = label_index_.find(label);
+                if (it == label_index_.end()) {
+                    ++skipped;
+                    continue;
+                }
+
+                tokenizer.tokenize(text, tokens);
+
+                for (std::string_view token : tokens) {
+                    block->phonetic.push_back(
+                        encoder.compute_buckets(token, block->buckets));
+                    block->token_buckets.push_back(
+                        static_cast<uint32_t>(block->buckets.size()));
+                }
+
+                block->labels.push_back(it->second);
+                block->sample_tokens.push_back(
+                    static_cast<uint32_t>(block->phonetic.size()));
+            }
+
+            block->order.resize(block->size());
+            for (size_t i = 0; i < block->order.size(); ++i)
+                block->order[i] = static_cast<uint32_t>(i);
+
+            if (options_.shuffle) {
+                rng.seed(options_.seed ^ (0x9E3779B97F4A7C15ULL * (task + 1)));
+                std::shuffle(block->order.begin(), block->order.end(), rng);
+            }
+
+            auto t3 = Clock::now();
+
+            bytes_ += block_end - start;
+            samples_ += block->size();
+            skipped_ += skipped;
+            ++blocks_;
+
+            bool pushed = ready_.push(block, stop_);
+
+            reader_wait_ns_ +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    t1 - t0).count() + elapsed_ns(t3);
+            read_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                t2 - t1).count();
+            parse_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                t3 - t2).count();
+
+            if (!pushed)
+                break;
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_)
+            error_ = std::current_exception();
+        stop_.store(true);
+    }
+
+    // The last reader out tells the trainers no more blocks will come
+    if (active_readers_.fetch_sub(1) == 1)
+        ready_.close();
+}
+
+StreamReport StreamingLoader::report() const
+{
+    StreamReport r;
+    r.bytes = bytes_.load();
+    r.samples = samples_.load();
+    r.blocks = blocks_.load();
+    r.skipped_lines = skipped_.load();
+
+    int64_t end = end_ns_.load();
+    if (end == 0 && !readers_.empty())
+        end = elapsed_ns(start_time_);
+    r.wall_seconds = to_seconds(end);
+
+    r.read_seconds = to_seconds(read_ns_.load());
+    r.parse_seconds = to_seconds(parse_ns_.load());
+    r.reader_wait_seconds = to_seconds(reader_wait_ns_.load());
+    r.train_seconds = to_seconds(train_ns_.load());
+    r.trainer_wait_seconds = to_seconds(trainer_wait_ns_.load());
+    r.reader_threads = static_cast<int>(readers_.size());
+    return r;
+}
+
+std::vector<std::string> StreamingLoader::scan_labels(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open '" + path + "'");
+
+    std::vector<std::string> labels;
+    std::unordered_map<std::string, int> seen;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        split_labels(line, [&](std::string_view label) {
+            if (seen.emplace(label, 0).second)
+                labels.emplace_back(label);
+        });
+    }
+
+    return labels;
+}
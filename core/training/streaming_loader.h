@@ -0,0 +1,185 @@
+#pragma once
+
+#include "encoder/hashed_tokens.h"
+#include "utils/mpmc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class WordEncoder;
+
+struct StreamOptions {
+    size_t block_bytes = 1 << 20;   // file bytes per block (one shuffle unit)
+    int reader_threads = 2;
+    int queue_capacity = 16;        // parsed blocks buffered ahead of training
+    int epochs = 1;
+    bool shuffle = true;            // block order per epoch and lines in a block
+    uint64_t seed = 42;
+};
+
+// One block of the input, tokenized and hashed. Sample i owns tokens
+// [sample_tokens[i], sample_tokens[i + 1]) and token t owns buckets
+// [token_buckets[t], token_buckets[t + 1]) plus phonetic[t].
+struct FeatureBlock {
+    int epoch = 0;
+
+    std::vector<int> labels;
+    std::vector<uint32_t> sample_tokens;
+    std::vector<uint32_t> token_buckets;
+    std::vector<int> phonetic;
+    std::vector<int> buckets;
+
+    // Visiting order of the samples (shuffled unless disabled)
+    std::vector<uint32_t> order;
+
+    size_t size() const { return labels.size(); }
+
+    HashedSentence sentence(size_t i) const
+    {
+        return HashedSentence(token_buckets.data() + sample_tokens[i],
+                              buckets.data(),
+                              phonetic.data() + sample_tokens[i],
+                              sample_tokens[i + 1] - sample_tokens[i]);
+    }
+
+    void clear();
+
+private:
+    friend class StreamingLoader;
+    std::chrono::steady_clock::time_point handed_out;
+};
+
+// Per-stage totals, summed over the threads of each stage. The *_wait
+// figures are time a stage sat blocked on the queue: readers wait when
+// training cannot keep up, trainers wait when input cannot.
+struct StreamReport {
+    uint64_t bytes = 0;
+    uint64_t samples = 0;
+    uint64_t blocks = 0;
+    uint64_t skipped_lines = 0;   // no label or a label not in the list
+
+    double wall_seconds = 0.0;
+    double read_seconds = 0.0;    // pread
+    double parse_seconds = 0.0;   // label split + tokenize + hash
+    double reader_wait_seconds = 0.0;
+    double train_seconds = 0.0;   // between next() and release()
+    double trainer_wait_seconds = 0.0;
+
+    int reader_threads = 0;
+
+    // "read", "parse" or "train"
+    const char* bottleneck() const;
+
+    std::string summary() const;
+};
+
+// Streams a fastText-format training file ("__label__x __label__y text...")
+// through a pipeline: reader threads pread fixed-size blocks, split labels,
+// tokenize and hash every line into a FeatureBlock, and hand the blocks to
+// the training workers through a bounded lock-free ring. Blocks are recycled
+// through a second ring, so steady-state streaming does not allocate.
+//
+// A line belongs to the block its first byte lies in. Each epoch re-reads
+// the file in a fresh block permutation. Only the first label of a line is
+// used; lines whose label is not in labels are skipped and counted.
+//
+// Typical loop, from any number of trainer threads:
+//
+//     while (FeatureBlock* block = loader.next()) {
+//         ... train on block ...
+//         loader.release(block);
+//     }
+class StreamingLoader {
+public:
+    // labels are the class names without the "__label__" prefix; class i is
+    // labels[i]. encoder must hash like the model being trained (usually
+    // the trainer's own WordEncoder); each reader hashes with a copy.
+    // Throws std::invalid_argument on bad options, std::runtime_error when
+    // the file cannot be opened.
+    StreamingLoader(const std::string& path,
+                    const WordEncoder& encoder,
+                    std::vector<std::string> labels,
+                    const StreamOptions& options = StreamOptions());
+
+    ~StreamingLoader();
+
+    StreamingLoader(const StreamingLoader&) = delete;
+    StreamingLoader& operator=(const StreamingLoader&) = delete;
+
+    // Launches the readers; next() does so on first use.
+    void start();
+
+    // Next parsed block, or nullptr once every epoch has been consumed.
+    // Rethrows a reader failure. Thread-safe.
+    FeatureBlock* next();
+
+    // Returns a block obtained from next() for reuse.
+    void release(FeatureBlock* block);
+
+    StreamReport report() const;
+
+    // The encoder the readers hash with
+    const WordEncoder& encoder() const { return encoder_; }
+
+    int num_labels() const { return static_cast<int>(labels_.size()); }
+    const std::vector<std::string>& labels() const { return labels_; }
+
+    // Distinct labels of a file in order of first appearance.
+    static std::vector<std::string> scan_labels(const std::string& path);
+
+private:
+    void reader_loop();
+
+    // Reads block b into raw; returns the offset of the block start in raw.
+    size_t read_block(size_t b, std::vector<char>& raw);
+
+    // Appends up to count bytes read at offset; returns how many were read.
+    size_t pread_append(std::vector<char>& raw, size_t offset, size_t count);
+
+    std::string path_;
+    int fd_ = -1;
+    size_t file_size_ = 0;
+
+    const WordEncoder& encoder_;
+    std::vector<std::string> labels_;
+    std::unordered_map<std::string_view, int> label_index_;
+
+    StreamOptions options_;
+    size_t num_blocks_ = 0;
+    std::vector<uint32_t> schedule_;   // epochs x num_blocks block ids
+
+    std::vector<std::unique_ptr<FeatureBlock>> pool_;
+    MPMCQueue<FeatureBlock*> free_;
+    MPMCQueue<FeatureBlock*> ready_;
+
+    std::once_flag started_;
+    std::vector<std::thread> readers_;
+    std::atomic<size_t> next_task_{0};
+    std::atomic<int> active_readers_{0};
+    std::atomic<bool> stop_{false};
+
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    std::chrono::steady_clock::time_point start_time_;
+    std::atomic<int64_t> end_ns_{0};   // since start_time_; 0 = running
+
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> blocks_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<int64_t> read_ns_{0};
+    std::atomic<int64_t> parse_ns_{0};
+    std::atomic<int64_t> reader_wait_ns_{0};
+    std::atomic<int64_t> train_ns_{0};
+    std::atomic<int64_t> trainer_wait_ns_{0};
+};
@@ -0,0 +1,66 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// err is the errno of the failed call, saved before any close()
+static std::runtime_error map_error(const std::string& what,
+                                    const std::string& path,
+                                    int err)
+{
+    return std::runtime_error(what + " '" + path + "': " +
+                              std::strerror(err));
+}
+
+MappedFile::MappedFile(const std::string& path, bool prewarm)
+    : path_(path),
+      data_(nullptr),
+      size_(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw map_error("cannot open", path, errno);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw map_error("cannot stat", path, err);
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        throw std::runtime_error("empty file '" + path + "'");
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (prewarm)
+        flags |= MAP_POPULATE;
+#endif
+
+    void* p = ::mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+    int err = errno;
+    ::close(fd);
+
+    if (p == MAP_FAILED)
+        throw map_error("cannot mmap", path, err);
+
+    if (prewarm)
+        ::madvise(p, size_, MADV_WILLNEED);
+
+    data_ = static_cast<const unsigned char*>(p);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages come from the page cache,
+// so every process mapping the same file shares one physical copy.
+class MappedFile {
+public:
+    // prewarm faults the pages in up front (MAP_POPULATE + MADV_WILLNEED)
+    // instead of on first touch. Throws std::runtime_error on failure.
+    explicit MappedFile(const std::string& path, bool prewarm = false);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    std::string path_;
+    const unsigned char* data_;
+    size_t size_;
+};
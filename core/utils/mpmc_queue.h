@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+// Bounded lock-free multi-producer / multi-consumer ring (Dmitry Vyukov's
+// design). Each cell carries a sequence number that tells producers and
+// consumers whether it is free for the current lap, so a push or pop is one
+// CAS on the shared cursor plus plain accesses to the cell. Capacity must be
+// a power of two.
+//
+// The blocking wrappers spin with std::this_thread::yield(); close() makes
+// pop() return false once the ring is drained.
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(size_t capacity)
+        : mask_(capacity - 1),
+          cells_(new Cell[capacity])
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument(
+                "MPMCQueue capacity must be a power of two >= 2");
+
+        for (size_t i = 0; i < capacity; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    bool try_push(const T& value)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask_ + 1,
+                                        std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Blocks while full. Returns false without pushing if stop becomes true.
+    bool push(const T& value, const std::atomic<bool>& stop)
+    {
+        while (!try_push(value)) {
+            if (stop.load(std::memory_order_relaxed))
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Blocks while empty; false once the queue is closed and drained.
+    bool pop(T& value)
+    {
+        for (;;) {
+            if (try_pop(value))
+                return true;
+            if (closed_.load(std::memory_order_acquire)) {
+                // A push may have landed just before close()
+                return try_pop(value);
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // No more pushes will follow.
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Producers and consumers hammer different cursors; keep them on
+    // separate cache lines.
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<bool> closed_{false};
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+};
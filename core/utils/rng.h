@@ -12,4 +12,32 @@ class RNG {
 
     private:
         std::mt19937_64 engine_;
+};
+
+// Small, fast generator for hot loops (negative sampling): splitmix64, one
+// add and three multiply-xorshifts per draw. Not thread-safe; keep one per
+// thread.
+class FastRNG {
+    public:
+        explicit FastRNG(uint64_t seed) : state_(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, n) for 0 < n < 2^32 (multiply-shift, no division)
+        uint32_t below(uint32_t n) {
+            return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+        }
+
+        // Uniform in [0, 1) with 24 random bits
+        float uniform() {
+            return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+        }
+
+    private:
+        uint64_t state_;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "thread_pool.h"
+
+#include <stdexcept>
+
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads <= 0)
+        throw std::invalid_argument("thread pool needs at least one thread");
+
+    workers_.reserve(threads);
+    for (int i = 0; i < threads; ++i)
+        workers_.emplace_back([this, i] { worker_loop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_ready_.notify_all();
+
+    for (auto& w : workers_)
+        w.join();
+}
+
+void ThreadPool::submit(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    work_ready_.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_done_.wait(lock, [this] { return tasks_.empty() && running_ == 0; });
+}
+
+void ThreadPool::worker_loop(int worker)
+{
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+
+            if (tasks_.empty())
+                return;   // stopping and drained
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++running_;
+        }
+
+        task(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+            if (tasks_.empty() && running_ == 0)
+                all_done_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO of tasks. Each task receives
+// the index of the worker running it, so callers can keep per-worker
+// contexts (encoder scratch, activations) in a plain vector. Tasks must not
+// throw; catch inside the task and hand errors back explicitly.
+class ThreadPool {
+public:
+    using Task = std::function<void(int worker)>;
+
+    // Throws std::invalid_argument unless threads > 0.
+    explicit ThreadPool(int threads);
+
+    // Finishes the queued tasks, then joins.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished.
+    void wait();
+
+    int size() const noexcept { return static_cast<int>(workers_.size()); }
+
+private:
+    void worker_loop(int worker);
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable all_done_;
+    std::deque<Task> tasks_;
+    int running_ = 0;
+    bool stop_ = false;
+
+    std::vector<std::thread> workers_;
+};
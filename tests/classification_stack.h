@@ -0,0 +1,45 @@
+#pragma once
+
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+
+#include <string>
+#include <vector>
+
+// Seeded word encoder + dense head shared by the inference and serving
+// tests, with unbatched reference paths to compare the batched ones against.
+template <int Dim, int Classes>
+struct ClassificationStack {
+    static constexpr int DIM = Dim;
+    static constexpr int BUCKETS = 5000;
+    static constexpr int CLASSES = Classes;
+
+    EmbeddingTable embedding{BUCKETS, DIM, 42};
+    NGramGenerator ngram{3, 6};
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder{embedding, ngram, &phonetic, BUCKETS, 0.2f};
+    LinearClassifier classifier{DIM, CLASSES, 7};
+
+    // Mean sentence vector of one text, tokenized and encoded on its own
+    std::vector<float> direct_sentence(const std::string& text)
+    {
+        EnglishTokenizer tokenizer;
+        MeanSentenceEncoder encoder(word_encoder);
+        std::vector<float> sentence(DIM);
+        encoder.encode(tokenizer.tokenize(text), sentence.data());
+        return sentence;
+    }
+
+    std::vector<float> direct_logits(const std::string& text)
+    {
+        std::vector<float> sentence = direct_sentence(text);
+        std::vector<float> logits(CLASSES);
+        classifier.forward(sentence.data(), logits.data());
+        return logits;
+    }
+};
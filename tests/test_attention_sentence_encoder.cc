@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include "encoder/attention_sentence_encoder.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "embedding/embedding_table.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "classifier/linear_classifier.h"
+#include "config/model_config.h"
+#include "tokenizer/english_tokenizer.h"
+#include "training/simple_trainer.h"
+#include "utils/rng.h"
+#include <cmath>
+#include <vector>
+
+class AttentionSentenceEncoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        embedding = std::make_unique<EmbeddingTable>(buckets, dim, 42);
+        ngram = std::make_unique<NGramGenerator>(3, 6);
+        phonetic = std::make_unique<PhoneticEncoder>();
+
+        word_encoder = std::make_unique<WordEncoder>(
+            *embedding, *ngram, phonetic.get(), buckets, 0.2f);
+    }
+
+    // L = r . encode(tokens) for a fixed random r
+    double loss(const AttentionSentenceEncoder& encoder,
+                const std::vector<std::string>& tokens,
+                const std::vector<float>& r)
+    {
+        std::vector<float> y(dim);
+        encoder.encode(tokens, y.data());
+
+        double l = 0.0;
+        for (int i = 0; i < dim; ++i)
+            l += static_cast<double>(r[i]) * y[i];
+        return l;
+    }
+
+    // Random non-zero weights, so attention is not uniform
+    void randomize(AttentionSentenceEncoder& encoder, uint64_t seed)
+    {
+        RNG rng(seed);
+        std::vector<float> q(dim), W(dim * dim);
+        for (auto& v : q) v = rng.normal(0.0f, 3.0f);
+        for (auto& v : W) v = rng.normal(0.0f, 0.3f);
+        encoder.load_parameters(q.data(), W.data());
+    }
+
+    int dim = 16;
+    int buckets = 2000;
+    std::unique_ptr<EmbeddingTable> embedding;
+    std::unique_ptr<NGramGenerator> ngram;
+    std::unique_ptr<PhoneticEncoder> phonetic;
+    std::unique_ptr<WordEncoder> word_encoder;
+
+    std::vector<std::string> tokens = {"attention", "pools", "word",
+                                       "vectors", "per", "head"};
+};
+
+TEST_F(AttentionSentenceEncoderTest, UntrainedEqualsMeanPooling) {
+    MeanSentenceEncoder mean(*word_encoder);
+    std::vector<float> expected(dim), got(dim);
+    mean.encode(tokens, expected.data());
+
+    for (bool projection : {false, true}) {
+        for (bool residual : {false, true}) {
+            if (!projection && residual)
+                continue;   // o + mean = 2 * mean by design
+
+            AttentionSentenceEncoder encoder(*word_encoder, 4,
+                                             projection, residual);
+            encoder.encode(tokens, got.data());
+
+            for (int i = 0; i < dim; ++i)
+                EXPECT_NEAR(got[i], expected[i], 1e-5f)
+                    << "projection " << projection
+                    << " residual " << residual;
+        }
+    }
+}
+
+TEST_F(AttentionSentenceEncoderTest, RejectsHeadsThatDoNotDivideDim) {
+    EXPECT_THROW(AttentionSentenceEncoder(*word_encoder, 3),
+                 std::invalid_argument);
+    EXPECT_THROW(AttentionSentenceEncoder(*word_encoder, 0),
+                 std::invalid_argument);
+}
+
+TEST_F(AttentionSentenceEncoderTest, FactoryReadsEncoderConfig) {
+    ModelConfig config;
+    config.embedding_dim = dim;
+    config.num_heads = 8;
+    config.use_projection = false;
+    config.use_residual = false;
+
+    auto encoder = make_sentence_encoder(config, *word_encoder);
+    EXPECT_EQ(encoder->num_heads(), 8);
+    EXPECT_EQ(encoder->head_dim(), 2);
+    EXPECT_FALSE(encoder->use_projection());
+    EXPECT_FALSE(encoder->use_residual());
+
+    config.num_heads = 3;
+    EXPECT_THROW(make_sentence_encoder(config, *word_encoder),
+                 std::invalid_argument);
+
+    config.num_heads = 4;
+    config.embedding_dim = dim * 2;
+    EXPECT_THROW(make_sentence_encoder(config, *word_encoder),
+                 std::invalid_argument);
+}
+
+TEST_F(AttentionSentenceEncoderTest, EmptySentenceGivesZeros) {
+    AttentionSentenceEncoder encoder(*word_encoder, 2);
+    randomize(encoder, 1);
+
+    std::vector<float> out(dim, 1.0f);
+    encoder.encode(std::vector<std::string>{}, out.data());
+
+    for (int i = 0; i < dim; ++i)
+        EXPECT_FLOAT_EQ(out[i], 0.0f);
+}
+
+TEST_F(AttentionSentenceEncoderTest, BackwardMatchesFiniteDifferences) {
+    RNG rng(7);
+    std::vector<float> r(dim);
+    for (auto& v : r) v = rng.normal(0.0f, 1.0f);
+
+    for (bool residual : {false, true}) {
+        AttentionSentenceEncoder encoder(*word_encoder, 4, true, residual);
+        randomize(encoder, 3);
+
+        std::vector<float> q0(encoder.queries(), encoder.queries() + dim);
+        std::vector<float> W0(encoder.projection(),
+                              encoder.projection() + dim * dim);
+
+        // Numerical gradients of a few queries and projection weights
+        const double eps = 1e-2;
+        auto numeric = [&](std::vector<float>& p, int i) {
+            float saved = p[i];
+            p[i] = saved + eps;
+            encoder.load_parameters(q0.data(), W0.data());
+            double up = loss(encoder, tokens, r);
+            p[i] = saved - eps;
+            encoder.load_parameters(q0.data(), W0.data());
+            double down = loss(encoder, tokens, r);
+            p[i] = saved;
+            encoder.load_parameters(q0.data(), W0.data());
+            return (up - down) / (2 * eps);
+        };
+
+        std::vector<int> q_idx = {0, 5, 9, 15};
+        std::vector<int> W_idx = {0, 17, 100, 255};
+        std::vector<double> dq, dW;
+        for (int i : q_idx) dq.push_back(numeric(q0, i));
+        for (int i : W_idx) dW.push_back(numeric(W0, i));
+
+        // One SGD step with dL/dy = r; the step recovers the gradient
+        const float lr = 1e-3f;
+        encoder.backward(tokens, r.data(), lr, nullptr);
+
+        for (size_t k = 0; k < q_idx.size(); ++k) {
+            double analytic = (q0[q_idx[k]] - encoder.queries()[q_idx[k]]) / lr;
+            EXPECT_NEAR(analytic, dq[k], 2e-2 + 2e-2 * std::abs(dq[k]))
+                << "query " << q_idx[k] << " residual " << residual;
+        }
+        for (size_t k = 0; k < W_idx.size(); ++k) {
+            double analytic =
+                (W0[W_idx[k]] - encoder.projection()[W_idx[k]]) / lr;
+            EXPECT_NEAR(analytic, dW[k], 2e-2 + 2e-2 * std::abs(dW[k]))
+                << "W " << W_idx[k] << " residual " << residual;
+        }
+    }
+}
+
+TEST_F(AttentionSentenceEncoderTest, EmbeddingGradientMatchesFiniteDifferences) {
+    RNG rng(11);
+    std::vector<float> r(dim);
+    for (auto& v : r) v = rng.normal(0.0f, 1.0f);
+
+    AttentionSentenceEncoder encoder(*word_encoder, 4);
+    randomize(encoder, 5);
+
+    // A row the first token reads
+    std::vector<int> token_buckets;
+    word_encoder->compute_buckets(tokens[0], token_buckets);
+    int bucket = token_buckets[0];
+
+    const double eps = 1e-2;
+    std::vector<double> numeric(dim);
+    for (int i = 0; i < dim; ++i) {
+        float saved = embedding->row(bucket)[i];
+        embedding->row(bucket)[i] = saved + eps;
+        double up = loss(encoder, tokens, r);
+        embedding->row(bucket)[i] = saved - eps;
+        double down = loss(encoder, tokens, r);
+        embedding->row(bucket)[i] = saved;
+        numeric[i] = (up - down) / (2 * eps);
+    }
+
+    std::vector<float> before(embedding->row(bucket),
+                              embedding->row(bucket) + dim);
+    const float lr = 1e-3f;
+    encoder.backward(tokens, r.data(), lr, embedding.get());
+
+    for (int i = 0; i < dim; ++i) {
+        double analytic = (before[i] - embedding->row(bucket)[i]) / lr;
+        EXPECT_NEAR(analytic, numeric[i], 2e-2 + 2e-2 * std::abs(numeric[i]))
+            << "dim " << i;
+    }
+}
+
+TEST_F(AttentionSentenceEncoderTest, BatchMatchesSingle) {
+    AttentionSentenceEncoder encoder(*word_encoder, 4);
+    randomize(encoder, 9);
+
+    EnglishTokenizer tokenizer;
+    std::vector<std::string> texts = {"one", "", "two words",
+                                      "a somewhat longer sentence here",
+                                      "and five more to fill tiles"};
+    std::vector<TokenBuffer> batch(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i)
+        tokenizer.tokenize(texts[i], batch[i]);
+
+    std::vector<float> batched(texts.size() * dim), single(dim);
+    encoder.encode_batch(batch.data(), static_cast<int>(batch.size()),
+                         batched.data());
+
+    for (size_t i = 0; i < texts.size(); ++i) {
+        encoder.encode(batch[i], single.data());
+        for (int d = 0; d < dim; ++d)
+            EXPECT_NEAR(batched[i * dim + d], single[d], 1e-5f);
+    }
+}
+
+TEST_F(AttentionSentenceEncoderTest, TrainsThroughSimpleTrainer) {
+    AttentionSentenceEncoder encoder(*word_encoder, 4);
+    LinearClassifier classifier(dim, 2, 42);
+    EnglishTokenizer tokenizer;
+
+    SimpleTrainer trainer(tokenizer, encoder, classifier, dim, 2);
+    trainer.enable_embedding_training(*embedding);
+
+    std::vector<Sample> data = {
+        {"good movie", 1}, {"bad movie", 0},
+        {"good good film", 1}, {"bad bad film", 0}};
+
+    float first = trainer.train_epoch(data, 0.1f);
+    float last = first;
+    for (int epoch = 0; epoch < 100; ++epoch)
+        last = trainer.train_epoch(data, 0.1f);
+
+    EXPECT_LT(last, first * 0.5f);
+
+    // The encoder's own weights moved off their initial values
+    float norm = 0.0f;
+    for (int i = 0; i < dim; ++i)
+        norm += std::abs(encoder.queries()[i]);
+    EXPECT_GT(norm, 0.0f);
+
+    // Hogwild workers train the same weights through clones
+    std::vector<float> q(encoder.queries(), encoder.queries() + dim);
+    trainer.set_num_threads(2);
+    trainer.train_epoch(data, 0.1f);
+    EXPECT_NE(std::vector<float>(encoder.queries(), encoder.queries() + dim),
+              q);
+}
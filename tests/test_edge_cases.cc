@@ -6,6 +6,7 @@
 #include "phonetic/phonetic_encoder.h"
 #include "classifier/linear_classifier.h"
 #include "tokenizer/english_tokenizer.h"
+#include <cmath>
 
 // Test edge cases and boundary conditions
 
@@ -1,5 +1,13 @@
 #include <gtest/gtest.h>
 #include "embedding/embedding_table.h"
+#include "utils/mapped_file.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
 
 TEST(EmbeddingTableTest, Construction) {
     EmbeddingTable table(1000, 50, 42);
@@ -30,3 +38,160 @@ TEST(EmbeddingTableTest, Deterministic) {
         EXPECT_FLOAT_EQ(row1[i], row2[i]);
     }
 }
+
+TEST(EmbeddingTableTest, SaveAndMapRoundTrip) {
+    std::string path = ::testing::TempDir() + "embedding_roundtrip.bin";
+
+    EmbeddingTable table(300, 24, 42);
+    table.save(path);
+
+    EmbeddingLoadOptions options;
+    options.prewarm = true;
+    options.verify_checksum = true;
+
+    EmbeddingTable mapped(path, options);
+
+    EXPECT_TRUE(mapped.is_mapped());
+    EXPECT_FALSE(table.is_mapped());
+    EXPECT_EQ(mapped.bucket_count(), 300);
+    EXPECT_EQ(mapped.dim(), 24);
+
+    const EmbeddingTable& view = mapped;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.row(0)) % 32, 0u);
+
+    for (int b = 0; b < 300; ++b)
+        EXPECT_EQ(std::memcmp(view.row(b), table.row(b),
+                              24 * sizeof(float)), 0);
+
+    std::remove(path.c_str());
+}
+
+TEST(EmbeddingTableTest, MapRejectsCorruptFiles) {
+    std::string path = ::testing::TempDir() + "embedding_corrupt.bin";
+
+    EmbeddingTable table(50, 8, 42);
+    table.save(path);
+
+    // Flip one byte inside the rows
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(4096 + 17);
+        f.put('\x7f');
+    }
+
+    EmbeddingLoadOptions verify;
+    verify.verify_checksum = true;
+    EXPECT_THROW(EmbeddingTable(path, verify), std::runtime_error);
+
+    // Without verification the header is still valid
+    EXPECT_NO_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}));
+
+    // Header sizes whose products or sums wrap around 2^64
+    auto patch = [&](std::streamoff offset, uint64_t value) {
+        EmbeddingTable(50, 8, 42).save(path);
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offset);
+        f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    const std::streamoff kBuckets = offsetof(EmbeddingFileHeader, bucket_count);
+    const std::streamoff kOffset = offsetof(EmbeddingFileHeader, data_offset);
+    const std::streamoff kBytes = offsetof(EmbeddingFileHeader, data_bytes);
+
+    patch(kBuckets, uint64_t{1} << 61);     // 2^61 * 8 * 4 wraps to 0
+    EXPECT_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}),
+                 std::runtime_error);
+
+    patch(kBuckets, uint64_t{INT_MAX} + 1);
+    EXPECT_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}),
+                 std::runtime_error);
+
+    patch(kOffset, ~uint64_t{0} - 4095);    // offset + bytes wraps past size
+    EXPECT_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}),
+                 std::runtime_error);
+
+    patch(kBytes, ~uint64_t{0});
+    EXPECT_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}),
+                 std::runtime_error);
+
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f << "not an embedding file, but long enough to hold a header........";
+    }
+    EXPECT_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}),
+                 std::runtime_error);
+
+    std::remove(path.c_str());
+
+    EXPECT_THROW(EmbeddingTable(path, EmbeddingLoadOptions{}),
+                 std::runtime_error);
+}
+
+TEST(EmbeddingTableTest, SectionViewRejectsWrappingOffsets) {
+    std::string path = ::testing::TempDir() + "embedding_section.bin";
+    {
+        std::vector<char> zeros(4096, 0);
+        std::ofstream out(path, std::ios::binary);
+        out.write(zeros.data(), zeros.size());
+    }
+    auto mapping = std::make_shared<MappedFile>(path);
+    std::remove(path.c_str());
+
+    EXPECT_NO_THROW(EmbeddingTable(mapping, 64, 8, 16));
+    EXPECT_THROW(EmbeddingTable(mapping, 4096 - 32, 8, 16),
+                 std::invalid_argument);
+
+    // offset + bytes wraps around to a small value
+    size_t offset = SIZE_MAX & ~size_t{31};
+    EXPECT_THROW(EmbeddingTable(mapping, offset, 1, 8),
+                 std::invalid_argument);
+
+    std::vector<float> centroids(ProductQuantizer::KSUB * 8, 0.0f);
+    auto quantizer =
+        std::make_shared<const ProductQuantizer>(8, 8, centroids.data());
+    EXPECT_THROW(EmbeddingTable(mapping, offset, 64, quantizer),
+                 std::invalid_argument);
+}
+
+TEST(EmbeddingTableTest, HalfPrecisionStorage) {
+    EmbeddingTable table(200, 20, 42);
+
+    for (EmbeddingDType dtype : {EmbeddingDType::F16, EmbeddingDType::BF16}) {
+        EmbeddingTable half(table, dtype);
+
+        EXPECT_EQ(half.dtype(), dtype);
+        EXPECT_EQ(half.memory_bytes(), table.memory_bytes() / 2);
+
+        // bf16 keeps 8 mantissa bits, f16 keeps 11
+        float tol = dtype == EmbeddingDType::F16 ? 1e-3f : 4e-3f;
+
+        std::vector<float> widened(20);
+        for (int b = 0; b < 200; ++b) {
+            const float* r = half.row_f32(b, widened.data());
+            for (int j = 0; j < 20; ++j)
+                EXPECT_NEAR(r[j], table.row(b)[j], tol);
+        }
+
+        std::vector<float> acc(20, 1.0f);
+        half.accumulate_row(7, 2.0f, acc.data());
+        for (int j = 0; j < 20; ++j)
+            EXPECT_NEAR(acc[j], 1.0f + 2.0f * table.row(7)[j], 2.0f * tol);
+    }
+}
+
+TEST(EmbeddingTableTest, HalfPrecisionSaveAndMap) {
+    std::string path = ::testing::TempDir() + "embedding_f16.bin";
+
+    EmbeddingTable table(EmbeddingTable(120, 16, 7), EmbeddingDType::F16);
+    table.save(path);
+
+    EmbeddingLoadOptions options;
+    options.verify_checksum = true;
+    EmbeddingTable mapped(path, options);
+
+    EXPECT_EQ(mapped.dtype(), EmbeddingDType::F16);
+    EXPECT_EQ(mapped.memory_bytes(), 120u * 16u * 2u);
+    EXPECT_EQ(std::memcmp(mapped.data(), table.data(),
+                          table.memory_bytes()), 0);
+
+    std::remove(path.c_str());
+}
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 #include "hashing/hash_function.h"
+#include "hashing/batch_hash.h"
+#include "hashing/bucket_policy.h"
+#include <algorithm>
+#include <string>
+#include "simd/kernels.h"
+#include "utils/rng.h"
+#include <vector>
 
 TEST(HashFunctionTest, FNV1aDeterministic) {
     uint64_t h1 = HashFunction::fnv1a("hello");
@@ -26,3 +33,72 @@ TEST(HashFunctionTest, EmptyString) {
     uint64_t h = HashFunction::fnv1a("");
     EXPECT_NE(h, 0);
 }
+
+TEST(HashFunctionTest, BatchNGramsMatchScalarFnv1a) {
+    SimdLevel saved = simd_level();
+    RNG rng(3);
+
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        simd_set_level(level);
+
+        for (auto range : {std::pair<int, int>{3, 6}, {1, 1}, {2, 9}, {4, 40}}) {
+            for (size_t length : {0, 1, 2, 5, 8, 9, 17, 40, 63, 64, 65, 200}) {
+                std::vector<unsigned char> data(length);
+                for (auto& c : data)
+                    c = static_cast<unsigned char>(rng.uniform(0.0f, 255.99f));
+
+                std::vector<uint64_t> expected;
+                for (size_t s = 0; s < length; ++s)
+                    for (int n = range.first; n <= range.second && s + n <= length; ++n)
+                        expected.push_back(HashFunction::fnv1a(std::string_view(
+                            reinterpret_cast<const char*>(data.data()) + s, n)));
+
+                size_t count = ngram_window_count(length, range.first, range.second);
+                ASSERT_EQ(count, expected.size());
+
+                std::vector<uint64_t> hashes(count + 1, 0);
+                size_t written = fnv1a_ngrams(data.data(), length, range.first,
+                                              range.second, hashes.data());
+                ASSERT_EQ(written, count);
+                hashes.pop_back();
+                EXPECT_EQ(hashes, expected)
+                    << simd_level_name(level) << " length " << length
+                    << " n=" << range.first << ".." << range.second;
+            }
+        }
+    }
+    simd_set_level(saved);
+}
+
+TEST(HashFunctionTest, WyHashCoversAllLengths) {
+    std::string text = "the quick brown fox jumps over the lazy dog, twice over";
+    std::vector<uint64_t> seen;
+    for (size_t len = 0; len <= text.size(); ++len) {
+        uint64_t h = HashFunction::wyhash(std::string_view(text.data(), len));
+        EXPECT_EQ(h, HashFunction::wyhash(text.substr(0, len)));
+        EXPECT_EQ(std::count(seen.begin(), seen.end(), h), 0) << len;
+        seen.push_back(h);
+    }
+    EXPECT_NE(HashFunction::wyhash("abc", 1), HashFunction::wyhash("abc", 2));
+}
+
+TEST(HashFunctionTest, ReductionPolicies) {
+    RNG rng(11);
+    std::vector<uint64_t> hashes = {0, 1, ~0ULL, ~0ULL - 1, 1ULL << 63};
+    for (int i = 0; i < 2000; ++i)
+        hashes.push_back(HashFunction::fnv1a(std::to_string(i)));
+
+    for (uint64_t count : {1ULL, 2ULL, 3ULL, 1000ULL, 200000ULL, 2000003ULL,
+                           (1ULL << 31) - 1, 1ULL << 40, ~0ULL}) {
+        BucketRange range(count);
+        for (uint64_t h : hashes) {
+            ASSERT_EQ(ModuloReduce::reduce(h, range), h % count)
+                << h << " % " << count;
+            EXPECT_LT(MultiplyShiftReduce::reduce(h, range), count);
+        }
+    }
+
+    BucketRange pow2(1 << 16);
+    for (uint64_t h : hashes)
+        EXPECT_EQ(Pow2MaskReduce::reduce(h, pow2), h & 0xFFFF);
+}
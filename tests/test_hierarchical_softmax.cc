@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+#include "classifier/hierarchical_softmax.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "tokenizer/english_tokenizer.h"
+#include "training/simple_trainer.h"
+#include "utils/rng.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+std::vector<float> random_vector(size_t n, uint64_t seed, float scale = 1.0f)
+{
+    RNG rng(seed);
+    std::vector<float> v(n);
+    for (auto& x : v)
+        x = rng.uniform(-scale, scale);
+    return v;
+}
+
+// Head over counts with random node vectors
+HierarchicalSoftmax random_head(int dim,
+                                const std::vector<int64_t>& counts,
+                                uint64_t seed)
+{
+    HierarchicalSoftmax head(dim, counts);
+    auto w = random_vector(static_cast<size_t>(head.num_nodes()) * dim, seed);
+    head.load_parameters(w.data());
+    return head;
+}
+
+}  // namespace
+
+TEST(HierarchicalSoftmaxTest, HuffmanGivesFrequentLabelsShortPaths) {
+    HierarchicalSoftmax head(4, {8, 1, 4, 1, 2});
+
+    EXPECT_EQ(head.num_nodes(), 4);
+    EXPECT_EQ(head.depth(0), 1);
+    EXPECT_EQ(head.depth(2), 2);
+    EXPECT_EQ(head.depth(4), 3);
+    EXPECT_EQ(head.depth(1), 4);
+    EXPECT_EQ(head.depth(3), 4);
+
+    // Every path starts at the root and distinct labels take distinct paths
+    for (int c = 0; c < 5; ++c)
+        EXPECT_EQ(head.path_nodes(c)[0], head.num_nodes() - 1);
+    EXPECT_NE(head.path_codes(1)[3], head.path_codes(3)[3]);
+
+    HierarchicalSoftmax single(4, {3});
+    EXPECT_EQ(single.num_nodes(), 0);
+    EXPECT_EQ(single.depth(0), 0);
+
+    EXPECT_THROW(HierarchicalSoftmax(4, {}), std::invalid_argument);
+    EXPECT_THROW(HierarchicalSoftmax(4, {1, -1}), std::invalid_argument);
+    EXPECT_THROW(HierarchicalSoftmax(0, {1, 1}), std::invalid_argument);
+}
+
+TEST(HierarchicalSoftmaxTest, LeafProbabilitiesSumToOne) {
+    int dim = 20, classes = 37, n = 6;
+    std::vector<int64_t> counts(classes);
+    for (int c = 0; c < classes; ++c)
+        counts[c] = 1 + (c * 7919) % 100;
+
+    auto head = random_head(dim, counts, 3);
+    auto X = random_vector(n * dim, 4);
+
+    std::vector<float> batch(n * classes), single(classes);
+    head.forward_batch(X.data(), n, batch.data());
+
+    for (int i = 0; i < n; ++i) {
+        head.forward(&X[i * dim], single.data());
+
+        double sum = 0.0;
+        for (int c = 0; c < classes; ++c) {
+            sum += std::exp(static_cast<double>(single[c]));
+            EXPECT_NEAR(batch[i * classes + c], single[c], 1e-5f);
+        }
+        EXPECT_NEAR(sum, 1.0, 1e-5);
+    }
+}
+
+TEST(HierarchicalSoftmaxTest, TopKMatchesBruteForce) {
+    int dim = 16, classes = 50;
+    std::vector<int64_t> counts(classes);
+    for (int c = 0; c < classes; ++c)
+        counts[c] = 1000 / (c + 1);
+
+    auto head = random_head(dim, counts, 5);
+    std::vector<float> logits(classes);
+    std::vector<Prediction> top(5);
+
+    for (uint64_t seed = 0; seed < 20; ++seed) {
+        auto x = random_vector(dim, 100 + seed, 2.0f);
+        head.forward(x.data(), logits.data());
+
+        std::vector<int> order(classes);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return logits[a] > logits[b];
+        });
+
+        head.predict_topk(x.data(), 5, top.data());
+        for (int j = 0; j < 5; ++j) {
+            EXPECT_EQ(top[j].label, order[j]) << "seed " << seed;
+            EXPECT_NEAR(top[j].probability, std::exp(logits[order[j]]), 1e-5f);
+        }
+
+        // Greedy may miss the argmax but reports its own leaf's p exactly
+        Prediction greedy = head.predict_top1(x.data());
+        EXPECT_NEAR(greedy.probability, std::exp(logits[greedy.label]), 1e-5f);
+        EXPECT_LE(greedy.probability, top[0].probability + 1e-6f);
+    }
+
+    EXPECT_THROW(head.predict_topk(logits.data(), 0, top.data()),
+                 std::invalid_argument);
+    EXPECT_THROW(head.predict_topk(logits.data(), classes + 1, top.data()),
+                 std::invalid_argument);
+}
+
+TEST(HierarchicalSoftmaxTest, BackwardMatchesFiniteDifferences) {
+    int dim = 8, classes = 6;
+    auto head = random_head(dim, {5, 3, 3, 2, 1, 1}, 6);
+
+    auto x = random_vector(dim, 7);
+    auto r = random_vector(classes, 8);   // L = r . log p
+
+    auto loss = [&](const float* input) {
+        std::vector<float> logits(classes);
+        head.forward(input, logits.data());
+        double l = 0.0;
+        for (int c = 0; c < classes; ++c)
+            l += static_cast<double>(r[c]) * logits[c];
+        return l;
+    };
+
+    std::vector<float> w0(head.weights(),
+                          head.weights() + head.num_nodes() * dim);
+
+    const double eps = 1e-2;
+    std::vector<int> idx = {0, 9, 21, 39};
+    std::vector<double> dw, dx(dim);
+
+    for (int i : idx) {
+        std::vector<float> w = w0;
+        w[i] += eps;
+        head.load_parameters(w.data());
+        double up = loss(x.data());
+        w[i] -= 2 * eps;
+        head.load_parameters(w.data());
+        dw.push_back((up - loss(x.data())) / (2 * eps));
+    }
+    head.load_parameters(w0.data());
+
+    for (int i = 0; i < dim; ++i) {
+        std::vector<float> xp = x;
+        xp[i] += eps;
+        double up = loss(xp.data());
+        xp[i] -= 2 * eps;
+        dx[i] = (up - loss(xp.data())) / (2 * eps);
+    }
+
+    const float lr = 1e-3f;
+    std::vector<float> dinput(dim);
+    head.backward_sgd(x.data(), r.data(), dinput.data(), lr);
+
+    for (size_t k = 0; k < idx.size(); ++k)
+        EXPECT_NEAR((w0[idx[k]] - head.weights()[idx[k]]) / lr, dw[k], 1e-2);
+    for (int i = 0; i < dim; ++i)
+        EXPECT_NEAR(dinput[i], dx[i], 1e-2);
+}
+
+TEST(HierarchicalSoftmaxTest, TrainSampleIsNegativeLogLikelihoodStep) {
+    int dim = 12, classes = 9;
+    std::vector<int64_t> counts = {9, 8, 7, 6, 5, 4, 3, 2, 1};
+
+    auto path = random_head(dim, counts, 9);
+    auto full = random_head(dim, counts, 9);
+    auto x = random_vector(dim, 10);
+
+    std::vector<float> logits(classes), da(dim), db(dim);
+    for (int label : {0, 4, 8}) {
+        full.forward(x.data(), logits.data());
+        float expected = -logits[label];
+
+        // -log p(label) through the generic O(C) backward
+        std::vector<float> onehot(classes, 0.0f);
+        onehot[label] = -1.0f;
+        full.backward_sgd(x.data(), onehot.data(), db.data(), 0.1f);
+
+        float loss = path.train_sample(x.data(), label, da.data(), 0.1f,
+                                       nullptr);
+        EXPECT_NEAR(loss, expected, 1e-5f);
+
+        for (int i = 0; i < dim; ++i)
+            EXPECT_NEAR(da[i], db[i], 1e-5f);
+        for (int k = 0; k < path.num_nodes() * dim; ++k)
+            EXPECT_NEAR(path.weights()[k], full.weights()[k], 1e-5f);
+    }
+}
+
+TEST(HierarchicalSoftmaxTest, BatchedStepsAverageSampleSteps) {
+    int dim = 10, n = 5;
+    std::vector<int64_t> counts = {4, 1, 3, 1, 2, 6, 1};
+    int classes = static_cast<int>(counts.size());
+
+    auto X = random_vector(n * dim, 11);
+    auto G = random_vector(n * classes, 12);
+    std::vector<int> labels = {0, 5, 5, 3, 2};
+
+    auto start = random_head(dim, counts, 13);
+    size_t size = static_cast<size_t>(start.num_nodes()) * dim;
+    std::vector<float> w0(start.weights(), start.weights() + size);
+
+    // Reference: per-sample steps at lr / n from the same weights
+    std::vector<float> dtrain(size, 0.0f), dgeneric(size, 0.0f);
+    std::vector<float> dinput_train(n * dim), dinput_generic(n * dim);
+    float loss = 0.0f;
+
+    for (int i = 0; i < n; ++i) {
+        auto one = random_head(dim, counts, 13);
+        loss += one.train_sample(&X[i * dim], labels[i],
+                                 &dinput_train[i * dim], 0.1f / n, nullptr);
+        for (size_t k = 0; k < size; ++k)
+            dtrain[k] += one.weights()[k] - w0[k];
+
+        auto two = random_head(dim, counts, 13);
+        two.backward_sgd(&X[i * dim], &G[i * classes],
+                         &dinput_generic[i * dim], 0.1f / n);
+        for (size_t k = 0; k < size; ++k)
+            dgeneric[k] += two.weights()[k] - w0[k];
+    }
+
+    auto trained = random_head(dim, counts, 13);
+    std::vector<float> dX(n * dim);
+    EXPECT_NEAR(trained.train_batch(X.data(), n, labels.data(), dX.data(),
+                                    0.1f, nullptr),
+                loss, 1e-4f);
+    for (int k = 0; k < n * dim; ++k)
+        EXPECT_NEAR(dX[k], dinput_train[k], 1e-5f);
+    for (size_t k = 0; k < size; ++k)
+        EXPECT_NEAR(trained.weights()[k], w0[k] + dtrain[k], 1e-5f);
+
+    auto generic = random_head(dim, counts, 13);
+    generic.backward_batch(X.data(), n, G.data(), dX.data(), 0.1f);
+    for (int k = 0; k < n * dim; ++k)
+        EXPECT_NEAR(dX[k], dinput_generic[k], 1e-5f);
+    for (size_t k = 0; k < size; ++k)
+        EXPECT_NEAR(generic.weights()[k], w0[k] + dgeneric[k], 1e-5f);
+}
+
+TEST(HierarchicalSoftmaxTest, TrainsThroughSimpleTrainer) {
+    int dim = 16, buckets = 2000;
+    std::vector<Sample> data = {
+        {"red apple", 0}, {"green leaf", 1}, {"blue sky", 2},
+        {"yellow sun", 3}, {"red cherry", 0}, {"green grass", 1}};
+
+    for (int batch_size : {1, 3}) {
+        EmbeddingTable embedding(buckets, dim, 42);
+        NGramGenerator ngram(3, 6);
+        WordEncoder word_encoder(embedding, ngram, nullptr, buckets, 0.0f);
+        MeanSentenceEncoder encoder(word_encoder);
+        EnglishTokenizer tokenizer;
+
+        HierarchicalSoftmax head(dim, {2, 2, 1, 1});
+        SimpleTrainer trainer(tokenizer, encoder, head, dim, 4);
+        trainer.enable_embedding_training(embedding);
+        trainer.set_batch_size(batch_size);
+
+        float first = trainer.train_epoch(data, 0.5f);
+        float last = first;
+        for (int epoch = 0; epoch < 200; ++epoch)
+            last = trainer.train_epoch(data, 0.5f);
+
+        EXPECT_LT(last, first * 0.1f) << "batch " << batch_size;
+
+        std::vector<float> sentence(dim);
+        for (const auto& s : data) {
+            TokenBuffer tokens;
+            tokenizer.tokenize(s.text, tokens);
+            encoder.encode(tokens, sentence.data());
+            EXPECT_EQ(head.predict_top1(sentence.data()).label, s.label)
+                << s.text;
+        }
+    }
+}
@@ -8,6 +8,9 @@
 #include "ngram/ngram_generator.h"
 #include "phonetic/phonetic_encoder.h"
 #include "loss/softmax.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 // Integration tests for full pipeline
 
@@ -280,3 +283,90 @@ TEST_F(IntegrationTest, NumbersInText) {
     for (float v : logits)
         EXPECT_FALSE(std::isnan(v));
 }
+
+// Accuracy drift of half-precision and product-quantized embedding storage
+// against FP32 on a trained model. Prints a small report and bounds the drift.
+TEST_F(IntegrationTest, HalfPrecisionDriftReport) {
+    std::vector<Sample> data = {
+        {"good movie", 0}, {"bad film", 1}, {"excellent show", 0},
+        {"terrible movie", 1}, {"great film", 0}, {"awful show", 1},
+        {"plain documentary", 2}, {"average news report", 2}
+    };
+
+    for (int i = 0; i < 30; ++i)
+        trainer->train_epoch(data, 0.1f);
+
+    std::vector<std::string> eval = {
+        "good movie", "bad film", "excellent show", "terrible movie",
+        "great film", "awful show", "plain documentary",
+        "average news report", "a good show", "the worst film ever",
+        "hello world", "Hello! How are you? I'm fine, thanks."
+    };
+
+    auto run = [&](const EmbeddingTable& table,
+                   std::vector<std::vector<float>>& sentences,
+                   std::vector<std::vector<float>>& logits) {
+        WordEncoder words(table, *ngram, phonetic.get(), buckets, 0.2f);
+        MeanSentenceEncoder encoder(words);
+        for (const auto& text : eval) {
+            std::vector<float> s(dim), l(num_classes);
+            encoder.encode(tokenizer->tokenize(text), s.data());
+            classifier->forward(s.data(), l.data());
+            sentences.push_back(s);
+            logits.push_back(l);
+        }
+    };
+
+    std::vector<std::vector<float>> ref_s, ref_l;
+    run(*embedding, ref_s, ref_l);
+
+    PQOptions pq_options;
+    pq_options.dsub = 4;
+    pq_options.max_training_rows = 4096;
+
+    for (EmbeddingDType dtype : {EmbeddingDType::F16, EmbeddingDType::BF16,
+                                 EmbeddingDType::PQ8}) {
+        EmbeddingTable half = dtype == EmbeddingDType::PQ8
+            ? EmbeddingTable(*embedding, pq_options)
+            : EmbeddingTable(*embedding, dtype);
+
+        std::vector<std::vector<float>> s, l;
+        run(half, s, l);
+
+        float sentence_drift = 0.0f, logit_drift = 0.0f;
+        int agree = 0;
+
+        for (size_t i = 0; i < eval.size(); ++i) {
+            for (int j = 0; j < dim; ++j)
+                sentence_drift = std::max(
+                    sentence_drift, std::fabs(s[i][j] - ref_s[i][j]));
+            for (int c = 0; c < num_classes; ++c)
+                logit_drift = std::max(
+                    logit_drift, std::fabs(l[i][c] - ref_l[i][c]));
+
+            auto top = [&](const std::vector<float>& v) {
+                return std::max_element(v.begin(), v.end()) - v.begin();
+            };
+            agree += top(l[i]) == top(ref_l[i]);
+        }
+
+        std::printf("[ drift    ] %-4s vs f32: %zu -> %zu bytes, "
+                    "max |d sentence| %.2e, max |d logit| %.2e, "
+                    "top-1 agreement %d/%zu\n",
+                    embedding_dtype_name(dtype),
+                    embedding->memory_bytes(), half.memory_bytes(),
+                    sentence_drift, logit_drift, agree, eval.size());
+
+        if (dtype == EmbeddingDType::PQ8) {
+            // Lossy by design: report, and only require most predictions
+            // to survive.
+            EXPECT_GE(agree, static_cast<int>(eval.size()) * 2 / 3);
+            continue;
+        }
+
+        float bound = dtype == EmbeddingDType::F16 ? 2e-4f : 2e-3f;
+        EXPECT_LT(sentence_drift, bound);
+        EXPECT_LT(logit_drift, 10 * bound);
+        EXPECT_GE(agree, static_cast<int>(eval.size()) - 1);
+    }
+}
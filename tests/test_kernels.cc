@@ -0,0 +1,455 @@
+#include <gtest/gtest.h>
+#include "simd/half.h"
+#include "simd/kernels.h"
+#include "utils/rng.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Restores the global kernel selection after each test.
+class KernelsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        saved_level = simd_level();
+        saved_deterministic = simd_deterministic();
+    }
+
+    void TearDown() override {
+        simd_set_level(saved_level);
+        simd_set_deterministic(saved_deterministic);
+    }
+
+    std::vector<SimdLevel> levels() const {
+        std::vector<SimdLevel> out = {SimdLevel::SCALAR};
+        if (simd_detect_level() >= SimdLevel::AVX2)
+            out.push_back(SimdLevel::AVX2);
+        if (simd_detect_level() >= SimdLevel::AVX512)
+            out.push_back(SimdLevel::AVX512);
+        return out;
+    }
+
+    static std::vector<float> random_vector(int n, uint64_t seed) {
+        RNG rng(seed);
+        std::vector<float> v(n);
+        for (auto& x : v)
+            x = rng.uniform(-1.0f, 1.0f);
+        return v;
+    }
+
+    SimdLevel saved_level;
+    bool saved_deterministic;
+};
+
+const int kSizes[] = {1, 7, 16, 31, 64, 100, 256, 1000};
+
+}  // namespace
+
+TEST_F(KernelsTest, DotMatchesReference) {
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+        for (int n : kSizes) {
+            auto a = random_vector(n, 1);
+            auto b = random_vector(n, 2);
+
+            double ref = 0.0;
+            for (int i = 0; i < n; ++i)
+                ref += static_cast<double>(a[i]) * b[i];
+
+            EXPECT_NEAR(vec_dot(a.data(), b.data(), n), ref, 1e-4)
+                << simd_level_name(level) << " n=" << n;
+        }
+    }
+}
+
+TEST_F(KernelsTest, AxpyAndScaleMatchReference) {
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+        for (int n : kSizes) {
+            auto x = random_vector(n, 3);
+            auto y = random_vector(n, 4);
+            auto expected = y;
+            for (int i = 0; i < n; ++i)
+                expected[i] = (expected[i] + 0.5f * x[i]) * 2.0f;
+
+            vec_axpy(0.5f, x.data(), y.data(), n);
+            vec_scale(2.0f, y.data(), n);
+
+            for (int i = 0; i < n; ++i)
+                EXPECT_NEAR(y[i], expected[i], 1e-6f);
+        }
+    }
+}
+
+TEST_F(KernelsTest, AxpyUpdateReadsRowBeforeUpdate) {
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+        int n = 37;
+        auto input = random_vector(n, 5);
+        auto row = random_vector(n, 6);
+        auto original = row;
+        std::vector<float> dinput(n, 0.0f);
+
+        vec_axpy_update(0.25f, -0.1f, input.data(),
+                        row.data(), dinput.data(), n);
+
+        for (int i = 0; i < n; ++i) {
+            EXPECT_NEAR(dinput[i], 0.25f * original[i], 1e-6f);
+            EXPECT_NEAR(row[i], original[i] - 0.1f * input[i], 1e-6f);
+        }
+    }
+}
+
+TEST_F(KernelsTest, DeterministicModeBitwiseAcrossLevels) {
+    simd_set_deterministic(true);
+
+    for (int n : kSizes) {
+        auto a = random_vector(n, 7);
+        auto b = random_vector(n, 8);
+
+        std::vector<float> dots;
+        std::vector<std::vector<float>> rows, dinputs;
+
+        for (SimdLevel level : levels()) {
+            simd_set_level(level);
+
+            dots.push_back(vec_dot(a.data(), b.data(), n));
+
+            auto row = b;
+            std::vector<float> dinput(n, 0.0f);
+            vec_axpy(0.3f, a.data(), row.data(), n);
+            vec_scale(0.7f, row.data(), n);
+            vec_axpy_update(0.9f, -0.05f, a.data(),
+                            row.data(), dinput.data(), n);
+            rows.push_back(row);
+            dinputs.push_back(dinput);
+        }
+
+        for (size_t l = 1; l < dots.size(); ++l) {
+            EXPECT_EQ(std::memcmp(&dots[0], &dots[l], sizeof(float)), 0)
+                << "n=" << n;
+            EXPECT_EQ(std::memcmp(rows[0].data(), rows[l].data(),
+                                  n * sizeof(float)), 0);
+            EXPECT_EQ(std::memcmp(dinputs[0].data(), dinputs[l].data(),
+                                  n * sizeof(float)), 0);
+        }
+    }
+}
+
+TEST_F(KernelsTest, SetLevelIsClampedToCpu) {
+    simd_set_level(SimdLevel::AVX512);
+    EXPECT_LE(static_cast<int>(simd_level()),
+              static_cast<int>(simd_detect_level()));
+}
+
+TEST_F(KernelsTest, GemmMatchesReference) {
+    int m = 11, n = 37, k = 70;
+    auto A = random_vector(m * k, 10);
+    auto B = random_vector(n * k, 11);
+    auto Bn = random_vector(k * n, 12);
+
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+
+        std::vector<float> C(m * n);
+        gemm_nt(m, n, k, A.data(), k, B.data(), k, C.data(), n);
+
+        std::vector<float> D(m * n, 1.0f);
+        gemm_nn_acc(m, n, k, 0.5f, A.data(), k, Bn.data(), n, D.data(), n);
+
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double nt = 0.0, nn = 0.0;
+                for (int p = 0; p < k; ++p) {
+                    nt += static_cast<double>(A[i * k + p]) * B[j * k + p];
+                    nn += static_cast<double>(A[i * k + p]) * Bn[p * n + j];
+                }
+                EXPECT_NEAR(C[i * n + j], nt, 1e-4);
+                EXPECT_NEAR(D[i * n + j], 1.0 + 0.5 * nn, 1e-4);
+            }
+        }
+    }
+}
+
+TEST_F(KernelsTest, DeterministicGemmBitwiseAcrossLevels) {
+    simd_set_deterministic(true);
+
+    int m = 9, n = 35, k = 300;
+    auto A = random_vector(m * k, 13);
+    auto B = random_vector(n * k, 14);
+
+    std::vector<std::vector<float>> nt, nn;
+
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+
+        std::vector<float> C(m * n);
+        gemm_nt(m, n, k, A.data(), k, B.data(), k, C.data(), n);
+
+        // gemm_nt elements equal vec_dot in this mode
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                float d = vec_dot(&A[i * k], &B[j * k], k);
+                EXPECT_EQ(std::memcmp(&d, &C[i * n + j], sizeof(float)), 0);
+            }
+        }
+        nt.push_back(C);
+
+        std::vector<float> D(m * k, 0.25f);
+        gemm_nn_acc(m, k, n, -0.1f, C.data(), n, B.data(), k, D.data(), k);
+        nn.push_back(D);
+    }
+
+    for (size_t l = 1; l < nt.size(); ++l) {
+        EXPECT_EQ(std::memcmp(nt[0].data(), nt[l].data(),
+                              nt[0].size() * sizeof(float)), 0);
+        EXPECT_EQ(std::memcmp(nn[0].data(), nn[l].data(),
+                              nn[0].size() * sizeof(float)), 0);
+    }
+}
+
+TEST_F(KernelsTest, HalfConversionsRoundTrip) {
+    const float values[] = {0.0f, -0.0f, 1.0f, -2.5f, 0.333333f, 65504.0f,
+                            1e-6f, 6.1e-5f, -3.0e-8f, 1e5f, 1.00048828125f};
+
+    for (float v : values) {
+        float h = half_to_float(float_to_half(v));
+        float b = bf16_to_float(float_to_bf16(v));
+
+        if (std::fabs(v) <= 65504.0f && std::fabs(v) >= 6.1e-5f) {
+            EXPECT_NEAR(h, v, std::fabs(v) * (1.0f / 2048.0f)) << v;
+        }
+        EXPECT_NEAR(b, v, std::fabs(v) * (1.0f / 256.0f)) << v;
+    }
+
+    EXPECT_TRUE(std::isinf(half_to_float(float_to_half(1e5f))));
+    EXPECT_TRUE(std::isnan(half_to_float(float_to_half(NAN))));
+    EXPECT_TRUE(std::isnan(bf16_to_float(float_to_bf16(NAN))));
+
+    // Ties round to even: 1 + 2^-11 sits halfway between two halves
+    EXPECT_EQ(float_to_half(1.00048828125f), 0x3c00);
+    EXPECT_EQ(float_to_bf16(1.00390625f), 0x3f80);
+}
+
+TEST_F(KernelsTest, VectorConversionsMatchSoftware) {
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+        for (int n : kSizes) {
+            auto x = random_vector(n, 20);
+            std::vector<uint16_t> h(n), b(n);
+
+            vec_f32_to_f16(x.data(), h.data(), n);
+            vec_f32_to_bf16(x.data(), b.data(), n);
+
+            for (int i = 0; i < n; ++i) {
+                EXPECT_EQ(h[i], float_to_half(x[i])) << simd_level_name(level);
+                EXPECT_EQ(b[i], float_to_bf16(x[i])) << simd_level_name(level);
+            }
+        }
+    }
+}
+
+TEST_F(KernelsTest, HalfAxpyMatchesReference) {
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+        for (int n : kSizes) {
+            auto x = random_vector(n, 21);
+            std::vector<uint16_t> h(n), b(n);
+            for (int i = 0; i < n; ++i) {
+                h[i] = float_to_half(x[i]);
+                b[i] = float_to_bf16(x[i]);
+            }
+
+            std::vector<float> yh(n, 1.0f), yb(n, 1.0f);
+            vec_axpy_f16(0.5f, h.data(), yh.data(), n);
+            vec_axpy_bf16(0.5f, b.data(), yb.data(), n);
+
+            for (int i = 0; i < n; ++i) {
+                EXPECT_NEAR(yh[i], 1.0f + 0.5f * half_to_float(h[i]), 1e-6f);
+                EXPECT_NEAR(yb[i], 1.0f + 0.5f * bf16_to_float(b[i]), 1e-6f);
+            }
+        }
+    }
+}
+
+TEST_F(KernelsTest, DeterministicHalfAxpyBitwiseAcrossLevels) {
+    simd_set_deterministic(true);
+
+    for (int n : kSizes) {
+        auto x = random_vector(n, 22);
+        auto y = random_vector(n, 23);
+        std::vector<uint16_t> h(n), b(n);
+        for (int i = 0; i < n; ++i) {
+            h[i] = float_to_half(x[i]);
+            b[i] = float_to_bf16(x[i]);
+        }
+
+        std::vector<std::vector<float>> out;
+        for (SimdLevel level : levels()) {
+            simd_set_level(level);
+            auto r = y;
+            vec_axpy_f16(0.37f, h.data(), r.data(), n);
+            vec_axpy_bf16(-1.3f, b.data(), r.data(), n);
+            out.push_back(r);
+        }
+
+        for (size_t l = 1; l < out.size(); ++l)
+            EXPECT_EQ(std::memcmp(out[0].data(), out[l].data(),
+                                  n * sizeof(float)), 0) << "n=" << n;
+    }
+}
+
+TEST_F(KernelsTest, DeterministicPQAxpyBitwiseAcrossLevels) {
+    simd_set_deterministic(true);
+
+    for (int dsub : {4, 8, 16, 12}) {
+        int nsub = 5;
+        auto codebook = random_vector(nsub * 256 * dsub, 24);
+        auto y = random_vector(nsub * dsub, 25);
+        std::vector<uint8_t> codes = {3, 250, 0, 17, 128};
+
+        std::vector<std::vector<float>> out;
+        for (SimdLevel level : levels()) {
+            simd_set_level(level);
+            auto r = y;
+            vec_pq_axpy(0.7f, codebook.data(), codes.data(), nsub, dsub,
+                        r.data());
+            out.push_back(r);
+        }
+
+        for (int s = 0; s < nsub; ++s)
+            for (int j = 0; j < dsub; ++j)
+                EXPECT_NEAR(out[0][s * dsub + j], y[s * dsub + j] + 0.7f *
+                            codebook[(s * 256 + codes[s]) * dsub + j], 1e-6f);
+
+        for (size_t l = 1; l < out.size(); ++l)
+            EXPECT_EQ(std::memcmp(out[0].data(), out[l].data(),
+                                  y.size() * sizeof(float)), 0)
+                << "dsub=" << dsub;
+    }
+}
+
+TEST_F(KernelsTest, ExpSumWithinDocumentedError) {
+    // Dense sweep of the range softmax feeds exp: x - max in [-87, 0]
+    int n = 1 << 16;
+    std::vector<float> x(n);
+    for (int i = 0; i < n; ++i)
+        x[i] = -87.0f * i / (n - 1);
+
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+
+        std::vector<float> e(n);
+        float sum = vec_exp_sum(x.data(), 0.0f, e.data(), n);
+
+        double max_rel = 0.0, ref_sum = 0.0;
+        for (int i = 0; i < n; ++i) {
+            double ref = std::exp(static_cast<double>(x[i]));
+            max_rel = std::max(max_rel, std::fabs(e[i] - ref) / ref);
+            ref_sum += ref;
+        }
+
+        EXPECT_LT(max_rel, 1.5e-7) << simd_level_name(level);
+        // The float sum of 65k terms rounds more than any one exp
+        EXPECT_NEAR(sum, ref_sum, 1e-4 * ref_sum);
+        EXPECT_EQ(vec_exp_sum(x.data(), 0.0f, nullptr, n), sum);
+    }
+
+    // Underflow flushes to 0 rather than going subnormal or wrapping
+    std::vector<float> tiny = {-1000.0f, -INFINITY, -88.0f, 0.0f};
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+        std::vector<float> e(tiny.size());
+        vec_exp_sum(tiny.data(), 0.0f, e.data(), 4);
+        EXPECT_EQ(e[0], 0.0f);
+        EXPECT_EQ(e[1], 0.0f);
+        EXPECT_LT(e[2], 1e-38f);
+        EXPECT_EQ(e[3], 1.0f);
+    }
+}
+
+TEST_F(KernelsTest, SoftmaxXentMatchesReference) {
+    for (SimdLevel level : levels()) {
+        simd_set_level(level);
+
+        for (int n : kSizes) {
+            int m = 3;
+            auto logits = random_vector(m * n, 26);
+            for (auto& l : logits)
+                l *= 20.0f;
+            std::vector<int> labels = {0, n / 2, n - 1};
+
+            std::vector<float> d(m * n);
+            float loss = softmax_xent(m, n, logits.data(), n, labels.data(),
+                                      d.data(), n);
+
+            double ref_loss = 0.0;
+            for (int i = 0; i < m; ++i) {
+                const float* l = &logits[i * n];
+                double mx = *std::max_element(l, l + n), sum = 0.0;
+                for (int j = 0; j < n; ++j)
+                    sum += std::exp(static_cast<double>(l[j]) - mx);
+
+                ref_loss += std::log(sum) - (l[labels[i]] - mx);
+                for (int j = 0; j < n; ++j) {
+                    double p = std::exp(l[j] - mx) / sum;
+                    EXPECT_NEAR(d[i * n + j], p - (j == labels[i]), 1e-6)
+                        << "n=" << n;
+                }
+            }
+            EXPECT_NEAR(loss, ref_loss, 1e-5 * (1.0 + ref_loss));
+
+            // In place, the way the classifier heads call it
+            auto aliased = logits;
+            EXPECT_EQ(softmax_xent(m, n, aliased.data(), n, labels.data(),
+                                   aliased.data(), n), loss);
+            EXPECT_EQ(aliased, d);
+
+            // Row softmax and log-softmax
+            std::vector<float> s(logits.begin(), logits.begin() + n);
+            std::vector<float> ls = s;
+            vec_softmax(s.data(), n);
+            vec_log_softmax(ls.data(), n);
+            for (int j = 0; j < n; ++j) {
+                EXPECT_NEAR(s[j], d[j] + (j == labels[0]), 1e-7);
+                EXPECT_NEAR(ls[j], std::log(static_cast<double>(s[j])),
+                            s[j] > 1e-30f ? 1e-4 : 1.0);
+            }
+        }
+    }
+
+    // The loss stays exact where the target probability underflows
+    std::vector<float> far = {0.0f, 200.0f};
+    std::vector<float> d(2);
+    int label = 0;
+    EXPECT_NEAR(softmax_xent(1, 2, far.data(), 2, &label, d.data(), 2),
+                200.0f, 1e-4f);
+}
+
+TEST_F(KernelsTest, DeterministicSoftmaxXentBitwiseAcrossLevels) {
+    simd_set_deterministic(true);
+
+    for (int n : kSizes) {
+        auto logits = random_vector(2 * n, 27);
+        std::vector<int> labels = {n - 1, 0};
+
+        std::vector<std::vector<float>> out;
+        std::vector<float> losses;
+        for (SimdLevel level : levels()) {
+            simd_set_level(level);
+            std::vector<float> d(2 * n);
+            losses.push_back(softmax_xent(2, n, logits.data(), n,
+                                          labels.data(), d.data(), n));
+            out.push_back(d);
+        }
+
+        for (size_t l = 1; l < out.size(); ++l) {
+            EXPECT_EQ(losses[0], losses[l]);
+            EXPECT_EQ(std::memcmp(out[0].data(), out[l].data(),
+                                  out[0].size() * sizeof(float)), 0)
+                << "n=" << n;
+        }
+    }
+}
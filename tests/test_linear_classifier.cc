@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "classifier/linear_classifier.h"
+#include "utils/rng.h"
+#include <vector>
 
 TEST(LinearClassifierTest, ForwardOutputShape) {
 
@@ -51,4 +53,67 @@ TEST(LinearClassifierTest, BackwardUpdatesWeights) {
         logits_after[0] == logits[0] &&
         logits_after[1] == logits[1]
     );
-}
\ No newline at end of file
+}
+
+TEST(LinearClassifierTest, ForwardBatchMatchesForward) {
+
+    // Odd sizes exercise the GEMM edge tiles
+    int dim = 70, classes = 37, n = 9;
+
+    LinearClassifier clf(dim, classes, 42);
+    RNG rng(7);
+
+    std::vector<float> X(n * dim);
+    for (auto& x : X)
+        x = rng.uniform(-1.0f, 1.0f);
+
+    std::vector<float> batch(n * classes);
+    clf.forward_batch(X.data(), n, batch.data());
+
+    std::vector<float> single(classes);
+    for (int i = 0; i < n; ++i) {
+        clf.forward(&X[i * dim], single.data());
+        for (int c = 0; c < classes; ++c)
+            EXPECT_NEAR(batch[i * classes + c], single[c], 1e-5f);
+    }
+}
+
+TEST(LinearClassifierTest, BackwardBatchAppliesMeanGradient) {
+
+    int dim = 70, classes = 5, n = 6;
+
+    LinearClassifier batched(dim, classes, 42);
+    LinearClassifier reference(dim, classes, 42);
+    RNG rng(9);
+
+    std::vector<float> X(n * dim), G(n * classes);
+    for (auto& x : X)
+        x = rng.uniform(-1.0f, 1.0f);
+    for (auto& g : G)
+        g = rng.uniform(-1.0f, 1.0f);
+
+    // Expected dX uses the weights from before the update
+    std::vector<float> dX(n * dim), expected_dX(n * dim, 0.0f);
+    for (int i = 0; i < n; ++i) {
+        LinearClassifier probe = reference;
+        probe.backward_sgd(&X[i * dim], &G[i * classes],
+                           &expected_dX[i * dim], 0.0f);
+    }
+
+    batched.backward_batch(X.data(), n, G.data(), dX.data(), 0.3f);
+
+    for (int j = 0; j < n * dim; ++j)
+        EXPECT_NEAR(dX[j], expected_dX[j], 1e-5f);
+
+    // Summing per-sample steps at lr / n equals one mean-gradient step
+    for (int i = 0; i < n; ++i)
+        reference.backward_sgd(&X[i * dim], &G[i * classes],
+                               nullptr, 0.3f / n);
+
+    std::vector<float> out1(classes), out2(classes);
+    batched.forward(X.data(), out1.data());
+    reference.forward(X.data(), out2.data());
+
+    for (int c = 0; c < classes; ++c)
+        EXPECT_NEAR(out1[c], out2[c], 1e-4f);
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "classifier/linear_classifier.h"
+#include "classifier/lowrank_classifier.h"
+#include "config/model_config.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "tokenizer/english_tokenizer.h"
+#include "training/simple_trainer.h"
+#include "utils/rng.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<float> random_vector(size_t n, uint64_t seed)
+{
+    RNG rng(seed);
+    std::vector<float> v(n);
+    for (auto& x : v)
+        x = rng.uniform(-1.0f, 1.0f);
+    return v;
+}
+
+}  // namespace
+
+TEST(LowRankClassifierTest, ForwardMatchesDenseProduct) {
+    int dim = 24, classes = 11, rank = 5;
+    LowRankClassifier lowrank(dim, classes, rank, 42);
+
+    auto bias = random_vector(classes, 3);
+    lowrank.load_parameters(lowrank.u(), lowrank.v(), bias.data());
+
+    // W = U V
+    std::vector<float> W(classes * dim, 0.0f);
+    for (int c = 0; c < classes; ++c)
+        for (int j = 0; j < rank; ++j)
+            for (int i = 0; i < dim; ++i)
+                W[c * dim + i] += lowrank.u()[c * rank + j] *
+                                  lowrank.v()[j * dim + i];
+
+    LinearClassifier dense(dim, classes, 0);
+    dense.load_parameters(W.data(), bias.data());
+
+    auto x = random_vector(dim, 7);
+    std::vector<float> a(classes), b(classes);
+    lowrank.forward(x.data(), a.data());
+    dense.forward(x.data(), b.data());
+
+    for (int c = 0; c < classes; ++c)
+        EXPECT_NEAR(a[c], b[c], 1e-5f);
+
+    EXPECT_EQ(lowrank.forward_flops(), static_cast<size_t>(rank * (classes + dim)));
+    EXPECT_EQ(dense.forward_flops(), static_cast<size_t>(classes * dim));
+}
+
+TEST(LowRankClassifierTest, RejectsNonPositiveSizes) {
+    EXPECT_THROW(LowRankClassifier(8, 4, 0, 1), std::invalid_argument);
+    EXPECT_THROW(LowRankClassifier(0, 4, 2, 1), std::invalid_argument);
+}
+
+TEST(LowRankClassifierTest, BackwardMatchesFiniteDifferences) {
+    int dim = 12, classes = 7, rank = 3;
+    LowRankClassifier clf(dim, classes, rank, 42);
+
+    auto x = random_vector(dim, 5);
+    auto r = random_vector(classes, 6);   // L = r . logits
+
+    auto loss = [&](const LowRankClassifier& c, const float* input) {
+        std::vector<float> logits(classes);
+        c.forward(input, logits.data());
+        double l = 0.0;
+        for (int i = 0; i < classes; ++i)
+            l += static_cast<double>(r[i]) * logits[i];
+        return l;
+    };
+
+    std::vector<float> u0(clf.u(), clf.u() + classes * rank);
+    std::vector<float> v0(clf.v(), clf.v() + rank * dim);
+    std::vector<float> b0(clf.bias(), clf.bias() + classes);
+
+    const double eps = 1e-2;
+    auto numeric = [&](std::vector<float>& p, int i) {
+        float saved = p[i];
+        p[i] = saved + eps;
+        clf.load_parameters(u0.data(), v0.data(), b0.data());
+        double up = loss(clf, x.data());
+        p[i] = saved - eps;
+        clf.load_parameters(u0.data(), v0.data(), b0.data());
+        double down = loss(clf, x.data());
+        p[i] = saved;
+        clf.load_parameters(u0.data(), v0.data(), b0.data());
+        return (up - down) / (2 * eps);
+    };
+
+    std::vector<int> u_idx = {0, 4, 20};
+    std::vector<int> v_idx = {0, 13, 35};
+    std::vector<double> du, dv, dx(dim);
+    for (int i : u_idx) du.push_back(numeric(u0, i));
+    for (int i : v_idx) dv.push_back(numeric(v0, i));
+    for (int i = 0; i < dim; ++i) {
+        std::vector<float> xp = x;
+        xp[i] += eps;
+        double up = loss(clf, xp.data());
+        xp[i] -= 2 * eps;
+        dx[i] = (up - loss(clf, xp.data())) / (2 * eps);
+    }
+
+    const float lr = 1e-3f;
+    std::vector<float> dinput(dim);
+    clf.backward_sgd(x.data(), r.data(), dinput.data(), lr);
+
+    for (size_t k = 0; k < u_idx.size(); ++k)
+        EXPECT_NEAR((u0[u_idx[k]] - clf.u()[u_idx[k]]) / lr, du[k], 1e-2);
+    for (size_t k = 0; k < v_idx.size(); ++k)
+        EXPECT_NEAR((v0[v_idx[k]] - clf.v()[v_idx[k]]) / lr, dv[k], 1e-2);
+    for (int i = 0; i < dim; ++i)
+        EXPECT_NEAR(dinput[i], dx[i], 1e-2);
+    for (int c = 0; c < classes; ++c)
+        EXPECT_NEAR((b0[c] - clf.bias()[c]) / lr, r[c], 1e-2);
+}
+
+TEST(LowRankClassifierTest, ForwardBatchMatchesForward) {
+    // Odd sizes exercise the GEMM edge tiles
+    int dim = 70, classes = 37, rank = 9, n = 9;
+    LowRankClassifier clf(dim, classes, rank, 42);
+
+    auto X = random_vector(n * dim, 7);
+    std::vector<float> batch(n * classes), single(classes);
+    clf.forward_batch(X.data(), n, batch.data());
+
+    for (int i = 0; i < n; ++i) {
+        clf.forward(&X[i * dim], single.data());
+        for (int c = 0; c < classes; ++c)
+            EXPECT_NEAR(batch[i * classes + c], single[c], 1e-5f);
+    }
+}
+
+TEST(LowRankClassifierTest, BackwardBatchAveragesSampleGradients) {
+    int dim = 10, classes = 6, rank = 4, n = 5;
+    LowRankClassifier batched(dim, classes, rank, 42);
+    LowRankClassifier reference(dim, classes, rank, 42);
+
+    auto X = random_vector(n * dim, 8);
+    auto G = random_vector(n * classes, 9);
+
+    std::vector<float> dX(n * dim);
+    batched.backward_batch(X.data(), n, G.data(), dX.data(), 0.01f);
+
+    // The mean-gradient step is the sum of the per-sample steps at lr / n,
+    // each taken from the same starting weights
+    std::vector<float> u(reference.u(), reference.u() + classes * rank);
+    std::vector<float> v(reference.v(), reference.v() + rank * dim);
+    std::vector<float> b(reference.bias(), reference.bias() + classes);
+    std::vector<float> du(u.size(), 0.0f), dv(v.size(), 0.0f);
+    std::vector<float> dinput(dim);
+
+    for (int i = 0; i < n; ++i) {
+        LowRankClassifier one(dim, classes, rank, 42);
+        one.backward_sgd(&X[i * dim], &G[i * classes], dinput.data(),
+                         0.01f / n);
+        for (size_t k = 0; k < u.size(); ++k) du[k] += one.u()[k] - u[k];
+        for (size_t k = 0; k < v.size(); ++k) dv[k] += one.v()[k] - v[k];
+        for (int d = 0; d < dim; ++d)
+            EXPECT_NEAR(dX[i * dim + d], dinput[d], 1e-5f);
+    }
+
+    for (size_t k = 0; k < u.size(); ++k)
+        EXPECT_NEAR(batched.u()[k], u[k] + du[k], 1e-5f);
+    for (size_t k = 0; k < v.size(); ++k)
+        EXPECT_NEAR(batched.v()[k], v[k] + dv[k], 1e-5f);
+}
+
+TEST(LowRankClassifierTest, MakeClassifierFollowsProjectionMode) {
+    ModelConfig config;
+    config.embedding_dim = 16;
+    config.projection_rank = 4;
+
+    auto dense = make_classifier(config, 10);
+    EXPECT_NE(dynamic_cast<LinearClassifier*>(dense.get()), nullptr);
+
+    config.projection_mode = ProjectionMode::LOWRANK;
+    auto lowrank = make_classifier(config, 10);
+    auto* head = dynamic_cast<LowRankClassifier*>(lowrank.get());
+    ASSERT_NE(head, nullptr);
+    EXPECT_EQ(head->rank(), 4);
+    EXPECT_EQ(head->input_dim(), 16);
+    EXPECT_EQ(head->num_classes(), 10);
+
+    config.projection_rank = 0;
+    EXPECT_THROW(config.validate(), std::invalid_argument);
+}
+
+TEST(LowRankClassifierTest, TrainsThroughSimpleTrainer) {
+    int dim = 16, buckets = 2000;
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    WordEncoder word_encoder(embedding, ngram, nullptr, buckets, 0.0f);
+    MeanSentenceEncoder encoder(word_encoder);
+    EnglishTokenizer tokenizer;
+
+    LowRankClassifier classifier(dim, 4, 2, 42);
+    SimpleTrainer trainer(tokenizer, encoder, classifier, dim, 4);
+    trainer.enable_embedding_training(embedding);
+
+    std::vector<Sample> data = {
+        {"red apple", 0}, {"green leaf", 1},
+        {"blue sky", 2}, {"yellow sun", 3}};
+
+    float first = trainer.train_epoch(data, 0.2f);
+    float last = first;
+    for (int epoch = 0; epoch < 200; ++epoch)
+        last = trainer.train_epoch(data, 0.2f);
+
+    EXPECT_LT(last, first * 0.2f);
+
+    std::vector<float> sentence(dim), logits(4);
+    for (const auto& s : data) {
+        TokenBuffer tokens;
+        tokenizer.tokenize(s.text, tokens);
+        encoder.encode(tokens, sentence.data());
+        classifier.forward(sentence.data(), logits.data());
+        int best = static_cast<int>(
+            std::max_element(logits.begin(), logits.end()) - logits.begin());
+        EXPECT_EQ(best, s.label) << s.text;
+    }
+}
@@ -5,6 +5,7 @@
 #include "ngram/ngram_generator.h"
 #include "phonetic/phonetic_encoder.h"
 #include <cmath>
+#include <cstring>
 
 class MeanSentenceEncoderTest : public ::testing::Test {
 protected:
@@ -184,3 +185,59 @@ TEST_F(MeanSentenceEncoderTest, SimilarSentencesSimilarVectors) {
     // (This is a weak test since we're using random embeddings)
     EXPECT_TRUE(true); // Just ensure no crash
 }
+
+TEST_F(MeanSentenceEncoderTest, BackwardUpdatesOnlyTouchedRows) {
+    std::vector<std::string> tokens = {"hello", "world", "hello"};
+
+    std::vector<float> before(static_cast<size_t>(buckets) * dim);
+    for (int b = 0; b < buckets; ++b)
+        std::memcpy(&before[b * dim], embedding->row(b), dim * sizeof(float));
+
+    // Expected per-row weights from the word encoder
+    std::vector<float> expected(buckets, 0.0f);
+    std::vector<BucketWeight> weights;
+    for (const auto& t : tokens)
+        word_encoder->accumulate_bucket_weights(t, 1.0f / tokens.size(),
+                                                weights);
+    for (const auto& w : weights)
+        expected[w.bucket] += w.weight;
+
+    std::vector<float> dout(dim);
+    for (int j = 0; j < dim; ++j)
+        dout[j] = 0.01f * (j + 1);
+
+    float lr = 0.5f;
+    sentence_encoder->backward(tokens, dout.data(), lr, *embedding);
+
+    for (int b = 0; b < buckets; ++b) {
+        const float* row = embedding->row(b);
+        for (int j = 0; j < dim; ++j)
+            EXPECT_NEAR(row[j],
+                        before[b * dim + j] - lr * expected[b] * dout[j],
+                        1e-6f);
+    }
+}
+
+TEST_F(MeanSentenceEncoderTest, BackwardDescendsLinearLoss) {
+    std::vector<std::string> tokens = {"gradient", "check"};
+    std::vector<float> out(dim), dout(dim);
+
+    sentence_encoder->encode(tokens, out.data());
+
+    // loss = dot(dout, out) must go down after one small step
+    for (int j = 0; j < dim; ++j)
+        dout[j] = (j % 2 ? 1.0f : -1.0f);
+
+    float before = 0.0f;
+    for (int j = 0; j < dim; ++j)
+        before += dout[j] * out[j];
+
+    sentence_encoder->backward(tokens, dout.data(), 0.01f, *embedding);
+    sentence_encoder->encode(tokens, out.data());
+
+    float after = 0.0f;
+    for (int j = 0; j < dim; ++j)
+        after += dout[j] * out[j];
+
+    EXPECT_LT(after, before);
+}
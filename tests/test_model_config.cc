@@ -11,4 +11,45 @@ TEST(ModelConfigTest, EqualityOperator){
     ModelConfig a;
     ModelConfig b;
     EXPECT_TRUE(a==b);
-}
\ No newline at end of file
+}
+TEST(ModelConfigTest, BucketHashingPolicy){
+    ModelConfig config;
+    EXPECT_EQ(config.hash_policy, HashPolicy::FNV1A);
+    EXPECT_EQ(config.bucket_reduction, BucketReduction::MODULO);
+
+    config.bucket_reduction = BucketReduction::POW2_MASK;
+    EXPECT_THROW(config.validate(), std::invalid_argument);
+
+    config.bucket_count = 1 << 18;
+    EXPECT_NO_THROW(config.validate());
+
+    ModelConfig other = config;
+    other.hash_policy = HashPolicy::MURMUR3;
+    EXPECT_FALSE(config == other);
+}
+
+TEST(ModelConfigTest, EqualityComparesHeadAndStorageFields){
+    ModelConfig a;
+
+    ModelConfig b = a;
+    b.projection_mode = ProjectionMode::LOWRANK;
+    EXPECT_FALSE(a == b);
+
+    b = a;
+    b.precision_mode = PrecisionMode::PQ8;
+    EXPECT_FALSE(a == b);
+
+    b = a;
+    b.projection_rank = a.projection_rank + 1;
+    EXPECT_FALSE(a == b);
+}
+
+TEST(ModelConfigTest, RejectsUnknownModes){
+    ModelConfig config;
+    config.projection_mode = static_cast<ProjectionMode>(7);
+    EXPECT_THROW(config.validate(), std::invalid_argument);
+
+    config = ModelConfig{};
+    config.precision_mode = static_cast<PrecisionMode>(7);
+    EXPECT_THROW(config.validate(), std::invalid_argument);
+}
@@ -0,0 +1,349 @@
+#include <gtest/gtest.h>
+#include "io/model_file.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/attention_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "hashing/hash_function.h"
+#include "ngram/ngram_generator.h"
+#include "utils/rng.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+class ModelFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.bucket_count = 500;
+        config.embedding_dim = 24;
+        config.ngram_min = 2;
+        config.ngram_max = 5;
+        config.phonetic_gamma = 0.3f;
+        config.use_phonetic = false;
+        config.seed = 7;
+
+        embedding = std::make_unique<EmbeddingTable>(
+            config.bucket_count, config.embedding_dim, config.seed);
+        classifier = std::make_unique<LinearClassifier>(
+            config.embedding_dim, 5, config.seed);
+
+        // Make the bias non-trivial so it is checked too
+        std::vector<float> dlogits = {0.1f, -0.2f, 0.3f, -0.4f, 0.5f};
+        std::vector<float> input(config.embedding_dim, 1.0f);
+        classifier->backward_sgd(input.data(), dlogits.data(),
+                                 nullptr, 0.5f);
+
+        path = ::testing::TempDir() + "model_file_test.glad";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void corrupt_byte(uint64_t offset) {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg(offset);
+        char c = static_cast<char>(f.get());
+        f.seekp(offset);
+        f.put(static_cast<char>(c ^ 0x5a));
+    }
+
+    // Offsets of the mode fields in the CONFIG section's record
+    static constexpr uint64_t kProjectionModeOffset = 48;
+    static constexpr uint64_t kPrecisionModeOffset = 52;
+
+    // Overwrites a 32-bit field of the saved config without re-signing it
+    void write_config_field(uint64_t field_offset, uint32_t value) {
+        ModelSectionEntry cfg;
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.seekg(sizeof(ModelFileHeader));
+            in.read(reinterpret_cast<char*>(&cfg), sizeof(cfg));
+        }
+        ASSERT_EQ(cfg.type, static_cast<uint32_t>(ModelSectionType::CONFIG));
+
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(cfg.offset + field_offset);
+        f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    ModelConfig config;
+    std::unique_ptr<EmbeddingTable> embedding;
+    std::unique_ptr<LinearClassifier> classifier;
+    std::string path;
+};
+
+TEST_F(ModelFileTest, RoundTrip) {
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    Model model = ModelFile::load(path);
+
+    EXPECT_TRUE(model.config == config);
+    EXPECT_EQ(model.config.use_phonetic, config.use_phonetic);
+    EXPECT_TRUE(model.embedding->is_mapped());
+
+    const EmbeddingTable& loaded = *model.embedding;
+    for (int b = 0; b < config.bucket_count; ++b)
+        EXPECT_EQ(std::memcmp(loaded.row(b), embedding->row(b),
+                              config.embedding_dim * sizeof(float)), 0);
+
+    ASSERT_EQ(model.classifier->num_classes(), 5);
+
+    RNG rng(3);
+    std::vector<float> x(config.embedding_dim);
+    for (auto& v : x)
+        v = rng.uniform(-1.0f, 1.0f);
+
+    std::vector<float> expected(5), actual(5);
+    classifier->forward(x.data(), expected.data());
+    model.classifier->forward(x.data(), actual.data());
+
+    for (int c = 0; c < 5; ++c)
+        EXPECT_EQ(expected[c], actual[c]);
+}
+
+TEST_F(ModelFileTest, SectionsAreAligned) {
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    std::ifstream in(path, std::ios::binary);
+    ModelFileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    EXPECT_EQ(header.version, ModelFile::VERSION);
+    ASSERT_EQ(header.section_count, 4u);
+
+    for (uint32_t i = 0; i < header.section_count; ++i) {
+        ModelSectionEntry e;
+        in.read(reinterpret_cast<char*>(&e), sizeof(e));
+        EXPECT_EQ(e.offset % 64, 0u);
+    }
+}
+
+TEST_F(ModelFileTest, DetectsCorruptTensor) {
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    std::ifstream in(path, std::ios::binary);
+    ModelFileHeader header;
+    ModelSectionEntry entries[4];
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    in.read(reinterpret_cast<char*>(entries), sizeof(entries));
+    in.close();
+
+    corrupt_byte(entries[1].offset + 100);
+
+    EXPECT_THROW(ModelFile::load(path), std::runtime_error);
+
+    ModelLoadOptions fast;
+    fast.verify_checksums = false;
+    EXPECT_NO_THROW(ModelFile::load(path, fast));
+}
+
+TEST_F(ModelFileTest, RejectsBadHeaders) {
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    // Corrupt the section table
+    corrupt_byte(sizeof(ModelFileHeader) + 8);
+    EXPECT_THROW(ModelFile::load(path), std::runtime_error);
+
+    // Future version
+    ModelFile::save(path, config, *embedding, *classifier);
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t version = ModelFile::VERSION + 1;
+        f.seekp(8);
+        f.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    EXPECT_THROW(ModelFile::load(path), std::runtime_error);
+
+    EXPECT_THROW(ModelFile::load(path + ".missing"), std::runtime_error);
+}
+
+TEST_F(ModelFileTest, RejectsSectionsThatWrapPastFileEnd) {
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    ModelSectionEntry entries[4];
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.seekg(sizeof(ModelFileHeader));
+        in.read(reinterpret_cast<char*>(entries), sizeof(entries));
+    }
+
+    // offset + bytes wraps around 2^64 to a small value; re-sign the table
+    // so only the range check can catch it
+    entries[3].offset = ~uint64_t{0} - 63;
+    entries[3].bytes = 128;
+    uint64_t checksum = HashFunction::checksum64(entries, sizeof(entries));
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offsetof(ModelFileHeader, table_checksum));
+        f.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        f.seekp(sizeof(ModelFileHeader));
+        f.write(reinterpret_cast<const char*>(entries), sizeof(entries));
+    }
+
+    try {
+        ModelFile::load(path);
+        FAIL() << "wrapped section was accepted";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("outside"), std::string::npos)
+            << e.what();
+    }
+}
+
+TEST_F(ModelFileTest, SaveRejectsMismatchedParts) {
+    ModelConfig other = config;
+    other.embedding_dim = 32;
+    EXPECT_THROW(ModelFile::save(path, other, *embedding, *classifier),
+                 std::invalid_argument);
+}
+
+TEST_F(ModelFileTest, OnlyDenseHeadsAreSaved) {
+    for (ProjectionMode mode : {ProjectionMode::LOWRANK,
+                                ProjectionMode::SPARSE,
+                                ProjectionMode::HYBRID}) {
+        ModelConfig other = config;
+        other.projection_mode = mode;
+        EXPECT_THROW(ModelFile::save(path, other, *embedding, *classifier),
+                     std::invalid_argument);
+    }
+
+    // A file claiming a LOWRANK head is refused at load too
+    ModelFile::save(path, config, *embedding, *classifier);
+    write_config_field(kProjectionModeOffset,
+                       static_cast<uint32_t>(ProjectionMode::LOWRANK));
+
+    ModelLoadOptions unchecked;
+    unchecked.verify_checksums = false;
+    EXPECT_THROW(ModelFile::load(path, unchecked), std::runtime_error);
+}
+
+TEST_F(ModelFileTest, OutOfRangeModesAreCorruptFiles) {
+    ModelLoadOptions unchecked;
+    unchecked.verify_checksums = false;
+
+    for (uint64_t field : {kProjectionModeOffset, kPrecisionModeOffset}) {
+        ModelFile::save(path, config, *embedding, *classifier);
+        write_config_field(field, 0x5a);
+
+        try {
+            ModelFile::load(path, unchecked);
+            FAIL() << "mode out of range was accepted";
+        } catch (const std::runtime_error& e) {
+            EXPECT_NE(std::string(e.what()).find("corrupt"),
+                      std::string::npos) << e.what();
+        }
+    }
+}
+
+TEST_F(ModelFileTest, HalfPrecisionEmbedding) {
+    EmbeddingTable half(*embedding, EmbeddingDType::BF16);
+
+    // The stored dtype has to agree with the config
+    EXPECT_THROW(ModelFile::save(path, config, half, *classifier),
+                 std::invalid_argument);
+
+    config.precision_mode = PrecisionMode::BF16;
+    ModelFile::save(path, config, half, *classifier);
+
+    Model model = ModelFile::load(path);
+
+    EXPECT_EQ(model.config.precision_mode, PrecisionMode::BF16);
+    EXPECT_EQ(model.embedding->dtype(), EmbeddingDType::BF16);
+    EXPECT_EQ(std::memcmp(model.embedding->data(), half.data(),
+                          half.memory_bytes()), 0);
+}
+
+TEST_F(ModelFileTest, ProductQuantizedEmbedding) {
+    PQOptions options;
+    options.dsub = 4;
+    options.iterations = 2;
+    EmbeddingTable pq(*embedding, options);
+
+    config.precision_mode = PrecisionMode::PQ8;
+    config.pq_subvector_dim = 8;
+    EXPECT_THROW(ModelFile::save(path, config, pq, *classifier),
+                 std::invalid_argument);
+
+    config.pq_subvector_dim = 4;
+    ModelFile::save(path, config, pq, *classifier);
+
+    Model model = ModelFile::load(path);
+
+    EXPECT_EQ(model.config.pq_subvector_dim, 4);
+    EXPECT_EQ(model.embedding->dtype(), EmbeddingDType::PQ8);
+    EXPECT_EQ(std::memcmp(model.embedding->data(), pq.data(),
+                          config.bucket_count * pq.row_bytes()), 0);
+
+    std::vector<float> a(config.embedding_dim, 0.0f);
+    std::vector<float> b(config.embedding_dim, 0.0f);
+    pq.accumulate_row(42, 1.0f, a.data());
+    model.embedding->accumulate_row(42, 1.0f, b.data());
+    EXPECT_EQ(std::memcmp(a.data(), b.data(), a.size() * sizeof(float)), 0);
+}
+
+TEST_F(ModelFileTest, RecordsBucketHashingPolicy) {
+    config.hash_policy = HashPolicy::WYHASH;
+    config.bucket_reduction = BucketReduction::MULTIPLY_SHIFT;
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    Model model = ModelFile::load(path);
+    EXPECT_EQ(model.config.hash_policy, HashPolicy::WYHASH);
+    EXPECT_EQ(model.config.bucket_reduction, BucketReduction::MULTIPLY_SHIFT);
+}
+
+TEST_F(ModelFileTest, RecordsProjectionRank) {
+    config.projection_rank = 12;
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    Model model = ModelFile::load(path);
+    EXPECT_EQ(model.config.projection_rank, 12);
+    EXPECT_TRUE(model.config == config);
+}
+
+TEST_F(ModelFileTest, RoundTripsAttentionEncoder) {
+    config.num_heads = 3;
+    NGramGenerator ngram(config.ngram_min, config.ngram_max);
+    WordEncoder word_encoder(*embedding, ngram, nullptr,
+                             config.bucket_count, config.phonetic_gamma);
+
+    auto encoder = make_sentence_encoder(config, word_encoder);
+    RNG rng(11);
+    std::vector<float> q(config.embedding_dim);
+    std::vector<float> W(config.embedding_dim * config.embedding_dim);
+    for (auto& v : q) v = rng.normal(0.0f, 2.0f);
+    for (auto& v : W) v = rng.normal(0.0f, 0.3f);
+    encoder->load_parameters(q.data(), W.data());
+
+    ModelConfig other = config;
+    other.num_heads = 4;
+    EXPECT_THROW(ModelFile::save(path, other, *embedding, *classifier,
+                                 encoder.get()),
+                 std::invalid_argument);
+
+    ModelFile::save(path, config, *embedding, *classifier, encoder.get());
+    Model model = ModelFile::load(path);
+
+    ASSERT_TRUE(model.has_attention_encoder());
+    EXPECT_EQ(model.encoder_queries, q);
+    EXPECT_EQ(model.encoder_projection, W);
+
+    WordEncoder loaded_words(*model.embedding, ngram, nullptr,
+                             config.bucket_count, config.phonetic_gamma);
+    auto loaded = model.sentence_encoder(loaded_words);
+
+    std::vector<std::string> tokens = {"saved", "attention", "weights"};
+    std::vector<float> a(config.embedding_dim), b(config.embedding_dim);
+    encoder->encode(tokens, a.data());
+    loaded->encode(tokens, b.data());
+    EXPECT_EQ(a, b);
+}
+
+TEST_F(ModelFileTest, MeanPoolingModelsHaveNoEncoderSections) {
+    ModelFile::save(path, config, *embedding, *classifier);
+
+    Model model = ModelFile::load(path);
+    EXPECT_FALSE(model.has_attention_encoder());
+    EXPECT_TRUE(model.encoder_projection.empty());
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "loss/negative_sampling.h"
+#include "loss/softmax.h"
+#include "ngram/ngram_generator.h"
+#include "tokenizer/english_tokenizer.h"
+#include "training/simple_trainer.h"
+#include "utils/rng.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+TEST(NegativeSamplingTest, AliasTableMatchesWeights) {
+    std::vector<double> weights = {5.0, 0.0, 1.0, 3.0, 1.0};
+    AliasTable table(weights);
+
+    std::vector<int> hits(weights.size(), 0);
+    FastRNG rng(1);
+    int draws = 200000;
+    for (int i = 0; i < draws; ++i)
+        ++hits[table.sample(rng)];
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+        double p = weights[i] / 10.0;
+        EXPECT_NEAR(table.probability(static_cast<int>(i)), p, 1e-6);
+        EXPECT_NEAR(static_cast<double>(hits[i]) / draws, p, 0.005);
+    }
+    EXPECT_EQ(hits[1], 0);
+
+    EXPECT_THROW(AliasTable({}), std::invalid_argument);
+    EXPECT_THROW(AliasTable({0.0, 0.0}), std::invalid_argument);
+    EXPECT_THROW(AliasTable({1.0, -1.0}), std::invalid_argument);
+}
+
+TEST(NegativeSamplingTest, SamplerUsesUnigramPowerAndSkipsLabel) {
+    std::vector<int64_t> counts = {16, 1, 81, 0};
+    NegativeSampler sampler(counts, 5, 42);
+
+    // 16^.75 = 8, 1^.75 = 1, 81^.75 = 27
+    EXPECT_NEAR(sampler.probability(0), 8.0 / 36.0, 1e-6);
+    EXPECT_NEAR(sampler.probability(1), 1.0 / 36.0, 1e-6);
+    EXPECT_NEAR(sampler.probability(2), 27.0 / 36.0, 1e-6);
+    EXPECT_EQ(sampler.probability(3), 0.0);
+
+    std::vector<int> out(5);
+    for (int i = 0; i < 1000; ++i) {
+        int label = i % 3;
+        sampler.sample(label, out.data());
+        for (int c : out) {
+            EXPECT_NE(c, label);
+            EXPECT_NE(c, 3);
+        }
+    }
+
+    // A fresh sampler with the same seed replays the same draws
+    NegativeSampler a(counts, 5, 9), b(counts, 5, 9);
+    std::vector<int> x(5), y(5);
+    a.sample(2, x.data());
+    b.sample(2, y.data());
+    EXPECT_EQ(x, y);
+
+    EXPECT_THROW(NegativeSampler(counts, 0, 1), std::invalid_argument);
+    EXPECT_THROW(NegativeSampler({5, 0}, 2, 1), std::invalid_argument);
+}
+
+TEST(NegativeSamplingTest, StepTouchesOnlySampledRows) {
+    int dim = 8, classes = 200, negatives = 3;
+    LinearClassifier clf(dim, classes, 42);
+
+    std::vector<int64_t> counts(classes, 1);
+    clf.set_negative_sampler(
+        std::make_shared<NegativeSampler>(counts, negatives, 5));
+
+    std::vector<float> w0(clf.weights(), clf.weights() + classes * dim);
+    std::vector<float> x(dim, 0.5f), dinput(dim);
+    int label = 17;
+
+    float z = 0.0f;
+    for (int i = 0; i < dim; ++i)
+        z += w0[label * dim + i] * x[i];
+    float loss = clf.train_sample(x.data(), label, dinput.data(), 0.1f,
+                                  nullptr);
+    EXPECT_GT(loss, -log_sigmoid(z) - 1e-5f);
+
+    int changed = 0;
+    for (int c = 0; c < classes; ++c) {
+        bool row_changed = clf.bias()[c] != 0.0f;
+        changed += row_changed;
+        if (c == label) {
+            EXPECT_NEAR(clf.bias()[c], -0.1f * (sigmoid(z) - 1.0f), 1e-6f);
+        }
+    }
+    EXPECT_GE(changed, 2);
+    EXPECT_LE(changed, negatives + 1);
+
+    EXPECT_THROW(clf.set_negative_sampler(
+                     std::make_shared<NegativeSampler>(
+                         std::vector<int64_t>(classes + 1, 1), 2, 1)),
+                 std::invalid_argument);
+}
+
+TEST(NegativeSamplingTest, TrainsThroughSimpleTrainer) {
+    int dim = 16, buckets = 2000, classes = 50;
+    std::vector<Sample> data = {
+        {"red apple", 0}, {"green leaf", 1}, {"blue sky", 2},
+        {"yellow sun", 3}, {"red cherry", 0}, {"green grass", 1}};
+
+    std::vector<int64_t> counts(classes, 1);
+    for (const auto& s : data)
+        ++counts[s.label];
+
+    for (int batch_size : {1, 3}) {
+        EmbeddingTable embedding(buckets, dim, 42);
+        NGramGenerator ngram(3, 6);
+        WordEncoder word_encoder(embedding, ngram, nullptr, buckets, 0.0f);
+        MeanSentenceEncoder encoder(word_encoder);
+        EnglishTokenizer tokenizer;
+
+        LinearClassifier head(dim, classes, 42);
+        head.set_negative_sampler(
+            std::make_shared<NegativeSampler>(counts, 5, 42));
+
+        SimpleTrainer trainer(tokenizer, encoder, head, dim, classes);
+        trainer.enable_embedding_training(embedding);
+        trainer.set_batch_size(batch_size);
+
+        float first = trainer.train_epoch(data, 0.5f);
+        float last = first;
+        for (int epoch = 0; epoch < 200; ++epoch)
+            last = trainer.train_epoch(data, 0.5f);
+
+        EXPECT_LT(last, first * 0.2f) << "batch " << batch_size;
+
+        // forward still ranks every class
+        std::vector<float> sentence(dim), logits(classes);
+        for (const auto& s : data) {
+            TokenBuffer tokens;
+            tokenizer.tokenize(s.text, tokens);
+            encoder.encode(tokens, sentence.data());
+            head.forward(sentence.data(), logits.data());
+            int best = static_cast<int>(
+                std::max_element(logits.begin(), logits.end()) -
+                logits.begin());
+            EXPECT_EQ(best, s.label) << s.text;
+        }
+    }
+}
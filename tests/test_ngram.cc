@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "ngram/ngram_generator.h"
+#include "hashing/hash_function.h"
+#include <algorithm>
 
 TEST(NGramGeneratorTest, BasicGeneration) {
     NGramGenerator gen(3, 6);
@@ -31,3 +33,33 @@ TEST(NGramGeneratorTest, MinMaxRange) {
     EXPECT_EQ(gen.min_n(), 2);
     EXPECT_EQ(gen.max_n(), 4);
 }
+
+TEST(NGramGeneratorTest, RollingBucketsMatchMaterializedNGrams) {
+    const uint64_t bucket_count = 2000003;
+    const char* words[] = {"", "a", "ab", "cat", "hello", "rolling",
+                           "internationalization", "caf\xc3\xa9", "x9"};
+
+    for (auto range : {std::pair<int, int>{3, 6}, {1, 1}, {2, 4}, {5, 12}}) {
+        NGramGenerator gen(range.first, range.second);
+
+        for (const char* word : words) {
+            std::string wrapped;
+            std::vector<std::string_view> ngrams;
+            gen.generate(word, wrapped, ngrams);
+
+            std::vector<int> expected;
+            for (auto g : ngrams)
+                expected.push_back(
+                    static_cast<int>(HashFunction::fnv1a(g) % bucket_count));
+
+            std::vector<int> buckets = {-7};  // appends, keeps existing
+            gen.generate_buckets(word, bucket_count, buckets);
+
+            ASSERT_EQ(buckets.size(), expected.size() + 1) << word;
+            EXPECT_EQ(buckets[0], -7);
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                                   buckets.begin() + 1))
+                << word << " n=" << range.first << ".." << range.second;
+        }
+    }
+}
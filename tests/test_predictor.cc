@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "inference/predictor.h"
+#include "classification_stack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+struct PredictorFixture : ::testing::Test, ClassificationStack<24, 7> {
+    // More than a few chunks, with a short last one
+    std::vector<std::string> docs()
+    {
+        std::vector<std::string> out;
+        for (size_t i = 0; i < 3 * Predictor::CHUNK + 5; ++i)
+            out.push_back("document " + std::to_string(i) +
+                          (i % 3 ? " about cats" : " on dogs, mostly") +
+                          std::string(i % 5, '!'));
+        out.push_back("");
+        return out;
+    }
+};
+
+}  // namespace
+
+TEST_F(PredictorFixture, EncodeBatchMatchesSentenceEncoder) {
+    auto texts = docs();
+    Predictor predictor(word_encoder, classifier, 3);
+
+    std::vector<float> batch = predictor.encode_batch(texts);
+    ASSERT_EQ(batch.size(), texts.size() * DIM);
+
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::vector<float> expected = direct_sentence(texts[i]);
+        for (int d = 0; d < DIM; ++d)
+            ASSERT_EQ(batch[i * DIM + d], expected[d]) << "doc " << i;
+    }
+}
+
+TEST_F(PredictorFixture, PredictBatchTopKMatchesSingleForward) {
+    auto texts = docs();
+    const int k = 3;
+    Predictor predictor(word_encoder, classifier, 2);
+
+    std::vector<Prediction> out = predictor.predict_batch(texts, k);
+    ASSERT_EQ(out.size(), texts.size() * k);
+
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::vector<float> logits = direct_logits(texts[i]);
+
+        float max_logit = *std::max_element(logits.begin(), logits.end());
+        float sum = 0.0f;
+        for (float l : logits)
+            sum += std::exp(l - max_logit);
+
+        for (int j = 0; j < k; ++j) {
+            const Prediction& p = out[i * k + j];
+            EXPECT_NEAR(p.probability,
+                        std::exp(logits[p.label] - max_logit) / sum, 1e-5f);
+            if (j > 0) {
+                EXPECT_GE(out[i * k + j - 1].probability, p.probability);
+            }
+        }
+
+        // Nothing outside the top k beats the k-th entry
+        for (int c = 0; c < CLASSES; ++c) {
+            bool listed = false;
+            for (int j = 0; j < k; ++j)
+                listed |= out[i * k + j].label == c;
+            if (!listed) {
+                EXPECT_LE(std::exp(logits[c] - max_logit) / sum,
+                          out[i * k + k - 1].probability + 1e-6f);
+            }
+        }
+    }
+}
+
+TEST_F(PredictorFixture, ResultsIndependentOfThreadCount) {
+    auto texts = docs();
+
+    Predictor one(word_encoder, classifier, 1);
+    Predictor four(word_encoder, classifier, 4);
+
+    auto a = one.predict_batch(texts, 2);
+    auto b = four.predict_batch(texts, 2);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].label, b[i].label);
+        EXPECT_EQ(a[i].probability, b[i].probability);
+    }
+
+    EXPECT_EQ(one.encode_batch(texts), four.encode_batch(texts));
+}
+
+TEST_F(PredictorFixture, ConcurrentCallsShareOnePredictor) {
+    auto texts = docs();
+    Predictor predictor(word_encoder, classifier, 2);
+    auto expected = predictor.predict_batch(texts, 1);
+
+    std::vector<std::vector<Prediction>> results(3);
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 3; ++t)
+        callers.emplace_back([&, t] {
+            results[t] = predictor.predict_batch(texts, 1);
+        });
+    for (auto& c : callers)
+        c.join();
+
+    for (const auto& r : results)
+        for (size_t i = 0; i < r.size(); ++i)
+            EXPECT_EQ(r[i].label, expected[i].label);
+}
+
+TEST_F(PredictorFixture, RejectsBadArguments) {
+    Predictor predictor(word_encoder, classifier, 1);
+    auto texts = docs();
+
+    EXPECT_THROW(predictor.predict_batch(texts, 0), std::invalid_argument);
+    EXPECT_THROW(predictor.predict_batch(texts, CLASSES + 1),
+                 std::invalid_argument);
+
+    LinearClassifier wrong_dim(DIM + 1, CLASSES, 7);
+    EXPECT_THROW(Predictor(word_encoder, wrong_dim), std::invalid_argument);
+
+    EXPECT_TRUE(predictor.predict_batch(std::vector<std::string>{}).empty());
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "embedding/embedding_table.h"
+#include "embedding/product_quantizer.h"
+#include "simd/kernels.h"
+#include "utils/rng.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// n points scattered tightly around `clusters` random centres
+std::vector<float> clustered_points(int n, int dim, int clusters, uint64_t seed)
+{
+    RNG rng(seed);
+    std::vector<float> centres(static_cast<size_t>(clusters) * dim);
+    for (auto& c : centres)
+        c = rng.uniform(-1.0f, 1.0f);
+
+    std::vector<float> points(static_cast<size_t>(n) * dim);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < dim; ++j)
+            points[static_cast<size_t>(i) * dim + j] =
+                centres[static_cast<size_t>(i % clusters) * dim + j] +
+                rng.uniform(-0.01f, 0.01f);
+    return points;
+}
+
+}  // namespace
+
+TEST(ProductQuantizerTest, RejectsBadSubvectorSize) {
+    EXPECT_THROW(ProductQuantizer(30, 8), std::invalid_argument);
+    EXPECT_THROW(ProductQuantizer(32, 0), std::invalid_argument);
+    EXPECT_NO_THROW(ProductQuantizer(32, 4));
+}
+
+TEST(ProductQuantizerTest, RecoversClusteredData) {
+    int dim = 32, n = 2000;
+    auto points = clustered_points(n, dim, 100, 1);
+
+    PQOptions options;
+    options.dsub = 8;
+    ProductQuantizer pq(dim, options.dsub);
+    pq.train(points.data(), n, options);
+
+    std::vector<uint8_t> codes(static_cast<size_t>(n) * pq.nsub());
+    pq.encode_batch(points.data(), n, codes.data());
+
+    std::vector<float> decoded(dim);
+    float max_err = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        pq.decode(&codes[static_cast<size_t>(i) * pq.nsub()], decoded.data());
+        for (int j = 0; j < dim; ++j)
+            max_err = std::max(max_err, std::fabs(
+                decoded[j] - points[static_cast<size_t>(i) * dim + j]));
+    }
+
+    // 100 clusters fit in 256 centroids, so only the jitter remains
+    EXPECT_LT(max_err, 0.03f);
+
+    // encode() agrees with the batched path
+    std::vector<uint8_t> one(pq.nsub());
+    pq.encode(&points[5 * dim], one.data());
+    EXPECT_EQ(std::memcmp(one.data(), &codes[5 * pq.nsub()], pq.nsub()), 0);
+}
+
+TEST(ProductQuantizerTest, AccumulateMatchesDecodeOnAllLevels) {
+    int dim = 48;
+    SimdLevel saved = simd_level();
+
+    for (int dsub : {4, 8, 16, 6}) {
+        auto points = clustered_points(600, dim, 300, 2);
+        PQOptions options;
+        options.dsub = dsub;
+        options.iterations = 3;
+        ProductQuantizer pq(dim, dsub);
+        pq.train(points.data(), 600, options);
+
+        std::vector<uint8_t> code(pq.nsub());
+        pq.encode(points.data(), code.data());
+
+        std::vector<float> decoded(dim);
+        simd_set_level(SimdLevel::SCALAR);
+        pq.decode(code.data(), decoded.data());
+
+        for (SimdLevel level : {SimdLevel::AVX2, SimdLevel::AVX512}) {
+            simd_set_level(level);
+            std::vector<float> acc(dim, 1.0f);
+            pq.accumulate(code.data(), 0.5f, acc.data());
+            for (int j = 0; j < dim; ++j)
+                EXPECT_NEAR(acc[j], 1.0f + 0.5f * decoded[j], 1e-6f)
+                    << "dsub=" << dsub;
+        }
+    }
+
+    simd_set_level(saved);
+}
+
+TEST(ProductQuantizerTest, QuantizedEmbeddingTable) {
+    EmbeddingTable table(5000, 64, 42);
+
+    PQOptions options;
+    options.dsub = 8;
+    options.iterations = 5;
+    EmbeddingTable pq(table, options);
+
+    EXPECT_EQ(pq.dtype(), EmbeddingDType::PQ8);
+    ASSERT_NE(pq.quantizer(), nullptr);
+    EXPECT_EQ(pq.row_bytes(), 8u);
+    EXPECT_GT(table.memory_bytes(), 10 * pq.memory_bytes());
+
+    // Uniform random rows are the worst case for PQ; the reconstruction
+    // still has to be much closer than an unrelated row.
+    std::vector<float> scratch(64);
+    double err = 0.0, base = 0.0;
+    for (int b = 0; b < 5000; ++b) {
+        const float* r = pq.row_f32(b, scratch.data());
+        for (int j = 0; j < 64; ++j) {
+            err += (r[j] - table.row(b)[j]) * (r[j] - table.row(b)[j]);
+            base += table.row(b)[j] * table.row(b)[j];
+        }
+    }
+    EXPECT_LT(err, 0.5 * base);
+}
+
+TEST(ProductQuantizerTest, QuantizedTableSaveAndMap) {
+    std::string path = ::testing::TempDir() + "embedding_pq.bin";
+
+    PQOptions options;
+    options.dsub = 4;
+    options.iterations = 2;
+    EmbeddingTable table(EmbeddingTable(700, 16, 3), options);
+    table.save(path);
+
+    EmbeddingLoadOptions load;
+    load.verify_checksum = true;
+    EmbeddingTable mapped(path, load);
+
+    EXPECT_EQ(mapped.dtype(), EmbeddingDType::PQ8);
+    ASSERT_NE(mapped.quantizer(), nullptr);
+    EXPECT_EQ(mapped.quantizer()->dsub(), 4);
+    EXPECT_EQ(mapped.memory_bytes(), table.memory_bytes());
+    EXPECT_EQ(std::memcmp(mapped.data(), table.data(), 700 * 4), 0);
+
+    std::vector<float> a(16, 0.0f), b(16, 0.0f);
+    table.accumulate_row(123, 1.0f, a.data());
+    mapped.accumulate_row(123, 1.0f, b.data());
+    EXPECT_EQ(std::memcmp(a.data(), b.data(), sizeof(float) * 16), 0);
+
+    std::remove(path.c_str());
+}
@@ -9,4 +9,23 @@ TEST(RNGTest, DeterministicUniform){
     float v2 = rng2.uniform(0.0f, 1.0f);
     
     EXPECT_FLOAT_EQ(v1,v2);
-}
\ No newline at end of file
+}
+
+TEST(RNGTest, FastRNGIsDeterministicAndInRange){
+    FastRNG a(7), b(7), c(8);
+
+    EXPECT_EQ(a.next(), b.next());
+    EXPECT_NE(a.next(), c.next());
+
+    double sum = 0.0;
+    for (int i = 0; i < 100000; ++i) {
+        EXPECT_LT(a.below(10), 10u);
+
+        float u = a.uniform();
+        EXPECT_GE(u, 0.0f);
+        EXPECT_LT(u, 1.0f);
+        sum += u;
+    }
+
+    EXPECT_NEAR(sum / 100000, 0.5, 0.01);
+}
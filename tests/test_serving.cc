@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include "serving/batch_server.h"
+#include "serving/line_server.h"
+#include "utils/thread_pool.h"
+#include "classification_stack.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct ServingFixture : ::testing::Test, ClassificationStack<16, 5> {
+    std::vector<std::string> texts = {
+        "the quick brown fox", "jumps over", "the lazy dog",
+        "Serving, in micro-batches!", "", "a b c d e f g",
+        "latency versus throughput", "one more request"};
+
+    int direct_label(const std::string& text)
+    {
+        std::vector<float> logits = direct_logits(text);
+        return static_cast<int>(
+            std::max_element(logits.begin(), logits.end()) - logits.begin());
+    }
+
+    std::string expected_output()
+    {
+        std::string out;
+        for (const auto& t : texts)
+            out += std::to_string(direct_label(t)) + "\t";
+        return out;
+    }
+
+    // Labels of a response stream, tab-joined like expected_output()
+    static std::string labels_of(const std::string& responses)
+    {
+        std::istringstream in(responses);
+        std::string line, out;
+        while (std::getline(in, line))
+            out += line.substr(0, line.find('\t')) + "\t";
+        return out;
+    }
+};
+
+// Dense head whose batched forward always fails
+struct FailingClassifier : LinearClassifier {
+    using LinearClassifier::LinearClassifier;
+
+    void forward_batch(const float*, int, float*) const override
+    {
+        throw std::runtime_error("head\tunavailable\n");
+    }
+};
+
+}  // namespace
+
+TEST(ThreadPoolTest, RunsEveryTaskAndReportsWorkerIndex) {
+    ThreadPool pool(3);
+    std::atomic<int> sum{0};
+    std::atomic<bool> bad_worker{false};
+
+    for (int i = 1; i <= 100; ++i)
+        pool.submit([&, i](int worker) {
+            if (worker < 0 || worker >= 3)
+                bad_worker = true;
+            sum += i;
+        });
+
+    pool.wait();
+    EXPECT_EQ(sum.load(), 5050);
+    EXPECT_FALSE(bad_worker.load());
+    EXPECT_THROW(ThreadPool(0), std::invalid_argument);
+}
+
+TEST_F(ServingFixture, ConcurrentRequestsMatchDirectClassification) {
+    ServeOptions options;
+    options.max_batch = 4;
+    options.max_wait_us = 500;
+    options.workers = 2;
+    BatchServer server(word_encoder, classifier, options);
+
+    const int clients = 4;
+    const int rounds = 25;
+    std::atomic<int> mismatches{0};
+
+    std::vector<int> expected;
+    for (const auto& t : texts)
+        expected.push_back(direct_label(t));
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c)
+        threads.emplace_back([&, c] {
+            for (int r = 0; r < rounds; ++r) {
+                size_t i = (c + r) % texts.size();
+                Prediction p = server.classify(texts[i]);
+                if (p.label != expected[i] ||
+                    !(p.probability > 0.0f && p.probability <= 1.0f))
+                    ++mismatches;
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT_EQ(mismatches.load(), 0);
+
+    ServeStats stats = server.stats();
+    EXPECT_EQ(stats.requests, static_cast<uint64_t>(clients * rounds));
+    EXPECT_GE(stats.mean_batch, 1.0);
+    EXPECT_LE(stats.mean_batch, 4.0);
+    EXPECT_LE(stats.p50_us, stats.p99_us);
+    EXPECT_GT(stats.qps, 0.0);
+}
+
+TEST_F(ServingFixture, FullBatchGoesOutWithoutWaiting) {
+    ServeOptions options;
+    options.max_batch = 8;
+    options.max_wait_us = 10 * 1000 * 1000;   // never reached
+    options.workers = 1;
+    BatchServer server(word_encoder, classifier, options);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::future<Prediction>> results;
+    for (const auto& t : texts)
+        results.push_back(server.submit(t));
+    for (auto& r : results)
+        r.get();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::seconds(5));
+
+    ServeStats stats = server.stats();
+    EXPECT_EQ(stats.batches, 1u);
+    EXPECT_DOUBLE_EQ(stats.mean_batch, 8.0);
+}
+
+TEST_F(ServingFixture, LoneRequestWaitsAtMostMaxWait) {
+    ServeOptions options;
+    options.max_batch = 64;
+    options.max_wait_us = 20 * 1000;
+    options.workers = 1;
+    BatchServer server(word_encoder, classifier, options);
+
+    auto start = std::chrono::steady_clock::now();
+    server.classify("just one");
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(19));
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
+
+TEST_F(ServingFixture, RejectsBadOptions) {
+    ServeOptions options;
+    options.max_batch = 0;
+    EXPECT_THROW(BatchServer(word_encoder, classifier, options),
+                 std::invalid_argument);
+
+    LinearClassifier wrong_dim(DIM + 1, CLASSES, 7);
+    EXPECT_THROW(BatchServer(word_encoder, wrong_dim),
+                 std::invalid_argument);
+}
+
+TEST_F(ServingFixture, LineProtocolOverPipes) {
+    ServeOptions options;
+    options.workers = 1;
+    BatchServer server(word_encoder, classifier, options);
+
+    int in[2], out[2];
+    ASSERT_EQ(pipe(in), 0);
+    ASSERT_EQ(pipe(out), 0);
+
+    std::string input;
+    for (size_t i = 0; i < texts.size(); ++i)
+        input += texts[i] + (i + 1 == texts.size() ? "" : i % 2 ? "\r\n" : "\n");
+    ASSERT_EQ(write(in[1], input.data(), input.size()),
+              static_cast<ssize_t>(input.size()));
+    close(in[1]);
+
+    EXPECT_EQ(serve_fd(server, in[0], out[1]), texts.size());
+    close(in[0]);
+    close(out[1]);
+
+    std::string responses;
+    char buf[4096];
+    for (ssize_t n; (n = read(out[0], buf, sizeof(buf))) > 0;)
+        responses.append(buf, n);
+    close(out[0]);
+
+    EXPECT_EQ(labels_of(responses), expected_output());
+}
+
+TEST_F(ServingFixture, LineProtocolOverUnixSocket) {
+    ServeOptions options;
+    options.workers = 2;
+    BatchServer server(word_encoder, classifier, options);
+
+    std::string path = ::testing::TempDir() + "gladtotext_serve_test.sock";
+    std::atomic<bool> stop{false};
+    std::thread listener([&] { serve_unix_socket(server, path, stop); });
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+
+    int fd = -1;
+    for (int attempt = 0; attempt < 200; ++attempt) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr),
+                    sizeof(addr)) == 0)
+            break;
+        close(fd);
+        fd = -1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_GE(fd, 0);
+
+    std::string input;
+    for (const auto& t : texts)
+        input += t + "\n";
+    ASSERT_EQ(write(fd, input.data(), input.size()),
+              static_cast<ssize_t>(input.size()));
+    shutdown(fd, SHUT_WR);
+
+    std::string responses;
+    char buf[4096];
+    for (ssize_t n; (n = read(fd, buf, sizeof(buf))) > 0;)
+        responses.append(buf, n);
+    close(fd);
+
+    stop = true;
+    listener.join();
+
+    EXPECT_EQ(labels_of(responses), expected_output());
+}
+
+TEST_F(ServingFixture, FailedBatchesAnswerWithErrorLines) {
+    FailingClassifier failing(DIM, CLASSES, 7);
+    BatchServer server(word_encoder, failing);
+
+    int in[2], out[2];
+    ASSERT_EQ(pipe(in), 0);
+    ASSERT_EQ(pipe(out), 0);
+
+    std::string input = "first\nsecond\nthird\n";
+    ASSERT_EQ(write(in[1], input.data(), input.size()),
+              static_cast<ssize_t>(input.size()));
+    close(in[1]);
+
+    // Every request is answered, in order, and the server keeps running
+    EXPECT_EQ(serve_fd(server, in[0], out[1]), 3u);
+    close(in[0]);
+    close(out[1]);
+
+    std::string responses;
+    char buf[4096];
+    for (ssize_t n; (n = read(out[0], buf, sizeof(buf))) > 0;)
+        responses.append(buf, n);
+    close(out[0]);
+
+    std::string line = "error\thead unavailable \n";
+    EXPECT_EQ(responses, line + line + line);
+}
+
+TEST_F(ServingFixture, ClientHangupIsAnErrorNotASignal) {
+    BatchServer server(word_encoder, classifier);
+
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+
+    // Requests are buffered, then the client goes away without reading
+    std::string input;
+    for (int i = 0; i < 64; ++i)
+        input += "request " + std::to_string(i) + "\n";
+    ASSERT_EQ(write(sv[1], input.data(), input.size()),
+              static_cast<ssize_t>(input.size()));
+    close(sv[1]);
+
+    // Without MSG_NOSIGNAL the response write would raise SIGPIPE
+    EXPECT_THROW(serve_fd(server, sv[0], sv[0]), std::runtime_error);
+    close(sv[0]);
+}
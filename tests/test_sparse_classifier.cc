@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include "classifier/linear_classifier.h"
+#include "classifier/sparse_classifier.h"
+#include "config/model_config.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/sparse_features.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "simd/kernels.h"
+#include "tokenizer/english_tokenizer.h"
+#include "training/sparse_trainer.h"
+#include "utils/rng.h"
+#include <algorithm>
+#include <vector>
+
+class SparseClassifierTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        embedding = std::make_unique<EmbeddingTable>(buckets, dim, 42);
+        ngram = std::make_unique<NGramGenerator>(3, 6);
+        phonetic = std::make_unique<PhoneticEncoder>();
+        word_encoder = std::make_unique<WordEncoder>(
+            *embedding, *ngram, phonetic.get(), buckets, 0.2f);
+        encoder = std::make_unique<MeanSentenceEncoder>(*word_encoder);
+    }
+
+    int dim = 16;
+    int buckets = 2000;
+    std::unique_ptr<EmbeddingTable> embedding;
+    std::unique_ptr<NGramGenerator> ngram;
+    std::unique_ptr<PhoneticEncoder> phonetic;
+    std::unique_ptr<WordEncoder> word_encoder;
+    std::unique_ptr<MeanSentenceEncoder> encoder;
+
+    std::vector<std::string> tokens = {"sparse", "bag", "of", "hashed",
+                                       "features"};
+};
+
+TEST_F(SparseClassifierTest, SpmmCsrMatchesNaive) {
+    RNG rng(3);
+    int m = 5, n = 19, k = 40;
+
+    SparseFeatures F;
+    for (int i = 0; i < m; ++i) {
+        int nnz = i * 3;   // includes an empty row
+        for (int p = 0; p < nnz; ++p)
+            F.add(static_cast<int>(rng.uniform(0.0f, k - 0.001f)),
+                  rng.uniform(-1.0f, 1.0f));
+        F.add(7, 0.5f);    // a repeated index in every row
+        F.end_row();
+    }
+
+    std::vector<float> B(k * n), C(m * n, 1.0f), expected(m * n, 1.0f);
+    for (auto& b : B) b = rng.uniform(-1.0f, 1.0f);
+
+    for (int i = 0; i < m; ++i)
+        for (int p = F.offsets[i]; p < F.offsets[i + 1]; ++p)
+            for (int j = 0; j < n; ++j)
+                expected[i * n + j] += F.values[p] * B[F.indices[p] * n + j];
+
+    spmm_csr_acc(m, n, F.offsets.data(), F.indices.data(), F.values.data(),
+                 B.data(), n, C.data(), n);
+
+    for (size_t i = 0; i < C.size(); ++i)
+        EXPECT_NEAR(C[i], expected[i], 1e-5f);
+
+    // Transposed accumulate: B += 0.5 * F^T C
+    std::vector<float> Bt = B;
+    for (int i = 0; i < m; ++i)
+        for (int p = F.offsets[i]; p < F.offsets[i + 1]; ++p)
+            for (int j = 0; j < n; ++j)
+                Bt[F.indices[p] * n + j] += 0.5f * F.values[p] * C[i * n + j];
+
+    spmm_csr_t_acc(m, n, 0.5f, F.offsets.data(), F.indices.data(),
+                   F.values.data(), C.data(), n, B.data(), n);
+
+    for (size_t i = 0; i < B.size(); ++i)
+        EXPECT_NEAR(B[i], Bt[i], 1e-5f);
+}
+
+TEST_F(SparseClassifierTest, FeaturesReproduceMeanEncoding) {
+    SparseFeatures F;
+    encoder->append_features(tokens, F);
+    encoder->append_features(std::vector<std::string>{}, F);
+    ASSERT_EQ(F.rows(), 2);
+    EXPECT_EQ(F.row_size(1), 0);
+
+    std::vector<float> expected(dim), got(dim, 0.0f);
+    encoder->encode(tokens, expected.data());
+
+    for (int p = 0; p < F.row_size(0); ++p)
+        for (int i = 0; i < dim; ++i)
+            got[i] += F.row_values(0)[p] *
+                      embedding->row(F.row_indices(0)[p])[i];
+
+    for (int i = 0; i < dim; ++i)
+        EXPECT_NEAR(got[i], expected[i], 1e-5f);
+
+    encoder->encode_features(F, 0, got.data());
+    for (int i = 0; i < dim; ++i)
+        EXPECT_NEAR(got[i], expected[i], 1e-5f);
+}
+
+TEST_F(SparseClassifierTest, SparseEqualsGatherThenDenseForProjectedTable) {
+    int classes = 5;
+    LinearClassifier dense(dim, classes, 7);
+
+    // S[b] = W E[b] makes S^T f = W (sum_p f_p E[b_p]) = W x
+    std::vector<float> S(static_cast<size_t>(buckets) * classes);
+    for (int b = 0; b < buckets; ++b)
+        for (int c = 0; c < classes; ++c)
+            S[b * classes + c] =
+                vec_dot(dense.weights() + c * dim, embedding->row(b), dim);
+
+    SparseClassifier sparse(0, buckets, classes, 1);
+    sparse.load_parameters(S.data(), nullptr, dense.bias());
+
+    std::vector<float> x(dim), a(classes), b(classes);
+    encoder->encode(tokens, x.data());
+    dense.forward(x.data(), a.data());
+
+    SparseFeatures F;
+    encoder->append_features(tokens, F);
+    sparse.forward(nullptr, F.row_indices(0), F.row_values(0),
+                   F.row_size(0), b.data());
+
+    for (int c = 0; c < classes; ++c)
+        EXPECT_NEAR(a[c], b[c], 1e-4f);
+}
+
+TEST_F(SparseClassifierTest, HybridBatchMatchesSingle) {
+    int classes = 6;
+    SparseClassifier hybrid(dim, buckets, classes, 42);
+
+    // Non-zero sparse weights
+    RNG rng(5);
+    std::vector<float> S(static_cast<size_t>(buckets) * classes);
+    for (auto& s : S) s = rng.uniform(-1.0f, 1.0f);
+    std::vector<float> bias(classes, 0.25f);
+    hybrid.load_parameters(S.data(), hybrid.dense_weights(), bias.data());
+
+    std::vector<std::vector<std::string>> docs = {
+        {"one"}, {}, {"two", "words"}, tokens};
+
+    SparseFeatures F;
+    std::vector<float> X(docs.size() * dim);
+    for (size_t i = 0; i < docs.size(); ++i) {
+        encoder->append_features(docs[i], F);
+        encoder->encode(docs[i], &X[i * dim]);
+    }
+
+    std::vector<float> batch(docs.size() * classes), single(classes);
+    hybrid.forward_batch(X.data(), F, batch.data());
+
+    for (int i = 0; i < F.rows(); ++i) {
+        hybrid.forward(&X[i * dim], F.row_indices(i), F.row_values(i),
+                       F.row_size(i), single.data());
+        for (int c = 0; c < classes; ++c)
+            EXPECT_NEAR(batch[i * classes + c], single[c], 1e-5f);
+    }
+}
+
+TEST_F(SparseClassifierTest, BackwardTouchesOnlyFeatureRows) {
+    int classes = 3;
+    SparseClassifier sparse(0, buckets, classes, 1);
+
+    SparseFeatures F;
+    encoder->append_features(tokens, F);
+
+    std::vector<float> dlogits = {0.5f, -0.25f, -0.25f};
+    sparse.backward_sgd(nullptr, F.row_indices(0), F.row_values(0),
+                        F.row_size(0), dlogits.data(), nullptr, 0.1f);
+
+    std::vector<bool> touched(buckets, false);
+    for (int p = 0; p < F.row_size(0); ++p)
+        touched[F.row_indices(0)[p]] = true;
+
+    for (int b = 0; b < buckets; ++b) {
+        bool nonzero = false;
+        for (int c = 0; c < classes; ++c)
+            nonzero |= sparse.sparse_weights()[b * classes + c] != 0.0f;
+        if (!touched[b]) {
+            EXPECT_FALSE(nonzero) << "bucket " << b;
+        }
+    }
+
+    EXPECT_FLOAT_EQ(sparse.bias()[0], -0.05f);
+}
+
+TEST_F(SparseClassifierTest, MakeSparseClassifierFollowsProjectionMode) {
+    ModelConfig config;
+    config.bucket_count = 1000;
+    config.embedding_dim = 8;
+
+    EXPECT_THROW(make_sparse_classifier(config, 4), std::invalid_argument);
+
+    config.projection_mode = ProjectionMode::SPARSE;
+    auto sparse = make_sparse_classifier(config, 4);
+    EXPECT_EQ(sparse->dense_dim(), 0);
+    EXPECT_EQ(sparse->num_features(), 1000);
+    EXPECT_THROW(make_classifier(config, 4), std::invalid_argument);
+
+    config.projection_mode = ProjectionMode::HYBRID;
+    auto hybrid = make_sparse_classifier(config, 4);
+    EXPECT_EQ(hybrid->dense_dim(), 8);
+}
+
+TEST_F(SparseClassifierTest, TrainsSparseAndHybridHeads) {
+    std::vector<Sample> data = {
+        {"red apple", 0}, {"green leaf", 1},
+        {"blue sky", 2}, {"yellow sun", 3}};
+
+    EnglishTokenizer tokenizer;
+
+    for (int dense_dim : {0, dim}) {
+        SparseClassifier head(dense_dim, buckets, 4, 42);
+        SparseTrainer trainer(tokenizer, *encoder, head);
+        if (dense_dim > 0)
+            trainer.enable_embedding_training(*embedding);
+
+        // Feature values are mean weights (~1 / ngrams per token), so the
+        // sparse part takes larger steps than a dense head
+        float lr = 5.0f;
+        float first = trainer.train_epoch(data, lr);
+        float last = first;
+        for (int epoch = 0; epoch < 50; ++epoch)
+            last = trainer.train_epoch(data, lr);
+
+        EXPECT_LT(last, first * 0.1f) << "dense_dim " << dense_dim;
+    }
+
+    SparseClassifier sparse(0, buckets, 4, 42);
+    SparseTrainer trainer(tokenizer, *encoder, sparse);
+    EXPECT_THROW(trainer.enable_embedding_training(*embedding),
+                 std::invalid_argument);
+
+    SparseClassifier mismatched(dim + 1, buckets, 4, 42);
+    EXPECT_THROW(SparseTrainer(tokenizer, *encoder, mismatched),
+                 std::invalid_argument);
+}
@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+#include "training/streaming_loader.h"
+#include "training/simple_trainer.h"
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+#include "utils/mpmc_queue.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string write_file(const std::string& name, const std::string& text)
+{
+    std::string path = ::testing::TempDir() + name;
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+    return path;
+}
+
+// Label plus every token's buckets, to compare samples independent of order
+std::string signature(int label,
+                      const std::vector<std::vector<int>>& tokens,
+                      const std::vector<int>& phonetic)
+{
+    std::string s = std::to_string(label) + ":";
+    for (size_t t = 0; t < tokens.size(); ++t) {
+        for (int b : tokens[t])
+            s += std::to_string(b) + ",";
+        s += "|" + std::to_string(phonetic[t]) + ";";
+    }
+    return s;
+}
+
+}  // namespace
+
+TEST(MPMCQueueTest, RejectsCapacityThatIsNotAPowerOfTwo) {
+    EXPECT_THROW(MPMCQueue<int>(3), std::invalid_argument);
+    EXPECT_THROW(MPMCQueue<int>(1), std::invalid_argument);
+}
+
+TEST(MPMCQueueTest, DeliversEveryItemOnceAcrossThreads) {
+    MPMCQueue<int> queue(8);
+    std::atomic<bool> stop{false};
+
+    const int producers = 3;
+    const int per_producer = 20000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i)
+                queue.push(p * per_producer + i + 1, stop);
+        });
+
+    std::vector<long long> sums(2, 0);
+    std::vector<int> counts(2, 0);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c)
+        consumers.emplace_back([&, c] {
+            int v;
+            while (queue.pop(v)) {
+                sums[c] += v;
+                ++counts[c];
+            }
+        });
+
+    for (auto& t : threads)
+        t.join();
+    queue.close();
+    for (auto& t : consumers)
+        t.join();
+
+    long long n = static_cast<long long>(producers) * per_producer;
+    EXPECT_EQ(counts[0] + counts[1], n);
+    EXPECT_EQ(sums[0] + sums[1], n * (n + 1) / 2);
+}
+
+TEST(StreamingLoaderTest, EveryLineOncePerEpoch) {
+
+    std::vector<std::string> labels = {"pos", "neg"};
+    std::vector<std::string> texts = {
+        "great movie really", "awful plot", "", "Loved IT!",
+        "meh, it was fine i guess", "worst acting ever seen",
+        "a", "superb", "terrible terrible terrible", "ok"};
+
+    std::string file;
+    std::vector<int> expected_labels;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        int label = static_cast<int>(i % 2);
+        expected_labels.push_back(label);
+        file += "__label__" + labels[label];
+        if (i % 3 == 0)
+            file += " __label__extra";
+        file += " " + texts[i] + (i % 4 == 0 ? "\r\n" : "\n");
+    }
+    file += "__label__unknown dropped line\n";
+    file += "no label either\n";
+    file += "\n";
+    file += "__label__neg last line without newline";
+    texts.push_back("last line without newline");
+    expected_labels.push_back(1);
+
+    std::string path = write_file("stream_lines.txt", file);
+
+    EmbeddingTable embedding(5000, 8, 42);
+    NGramGenerator ngram(3, 5);
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder(embedding, ngram, &phonetic, 5000, 0.2f);
+
+    std::multiset<std::string> expected;
+    EnglishTokenizer tokenizer;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::vector<std::vector<int>> tokens;
+        std::vector<int> ph;
+        for (const auto& tok : tokenizer.tokenize(texts[i])) {
+            tokens.emplace_back();
+            ph.push_back(word_encoder.compute_buckets(tok, tokens.back()));
+        }
+        expected.insert(signature(expected_labels[i], tokens, ph));
+    }
+
+    const int epochs = 3;
+
+    // Block sizes from one byte up, so lines straddle every boundary
+    for (size_t block_bytes : {1, 7, 16, 64, 1 << 20}) {
+
+        StreamOptions options;
+        options.block_bytes = block_bytes;
+        options.reader_threads = 3;
+        options.queue_capacity = 2;
+        options.epochs = epochs;
+
+        StreamingLoader loader(path, word_encoder, labels, options);
+
+        std::vector<std::multiset<std::string>> seen(epochs);
+
+        while (FeatureBlock* block = loader.next()) {
+            ASSERT_EQ(block->order.size(), block->size());
+            for (size_t i = 0; i < block->size(); ++i) {
+                HashedSentence sentence = block->sentence(i);
+                std::vector<std::vector<int>> tokens;
+                std::vector<int> ph;
+                for (HashedToken tok : sentence) {
+                    tokens.emplace_back(tok.buckets, tok.buckets + tok.count);
+                    ph.push_back(tok.phonetic_bucket);
+                }
+                seen[block->epoch].insert(
+                    signature(block->labels[i], tokens, ph));
+            }
+            loader.release(block);
+        }
+
+        for (int e = 0; e < epochs; ++e)
+            EXPECT_EQ(seen[e], expected) << "block_bytes " << block_bytes;
+
+        StreamReport report = loader.report();
+        EXPECT_EQ(report.samples, texts.size() * epochs);
+        EXPECT_EQ(report.bytes, file.size() * epochs);
+        EXPECT_EQ(report.skipped_lines, 2u * epochs);
+        EXPECT_FALSE(report.summary().empty());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(StreamingLoaderTest, ScanLabelsInOrderOfFirstAppearance) {
+    std::string path = write_file("stream_labels.txt",
+        "__label__b text\n"
+        "__label__a __label__c more\n"
+        "no labels\n"
+        "__label__b again\n");
+
+    EXPECT_EQ(StreamingLoader::scan_labels(path),
+              (std::vector<std::string>{"b", "a", "c"}));
+
+    std::remove(path.c_str());
+}
+
+TEST(StreamingLoaderTest, RejectsBadOptionsAndMissingFile) {
+    EmbeddingTable embedding(100, 4, 42);
+    NGramGenerator ngram(3, 5);
+    WordEncoder word_encoder(embedding, ngram, nullptr, 100, 0.0f);
+
+    StreamOptions options;
+    options.reader_threads = 0;
+    EXPECT_THROW(StreamingLoader(::testing::TempDir() + "x", word_encoder,
+                                 {"a"}, options),
+                 std::invalid_argument);
+
+    EXPECT_THROW(StreamingLoader(::testing::TempDir() + "missing_stream.txt",
+                                 word_encoder, {"a"}),
+                 std::runtime_error);
+}
+
+TEST(StreamingLoaderTest, TrainStreamLearnsFromFile) {
+    std::string file;
+    for (int i = 0; i < 50; ++i) {
+        file += "__label__pos good great movie\n";
+        file += "__label__neg bad awful movie\n";
+    }
+    std::string path = write_file("stream_train.txt", file);
+
+    int dim = 16;
+    int buckets = 10000;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder word_encoder(embedding, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder encoder(word_encoder);
+    LinearClassifier classifier(dim, 2, 42);
+    EnglishTokenizer tokenizer;
+
+    SimpleTrainer trainer(tokenizer, encoder, classifier, dim, 2);
+    trainer.enable_embedding_training(embedding);
+    trainer.set_num_threads(2);
+
+    auto labels = StreamingLoader::scan_labels(path);
+
+    StreamOptions options;
+    options.block_bytes = 256;
+    options.epochs = 1;
+    StreamingLoader first_pass(path, word_encoder, labels, options);
+    float first = trainer.train_stream(first_pass, 0.1f);
+
+    options.epochs = 10;
+    StreamingLoader more(path, word_encoder, labels, options);
+    float later = trainer.train_stream(more, 0.1f);
+
+    EXPECT_LT(later, first);
+    EXPECT_EQ(more.report().samples, 1000u);
+
+    std::remove(path.c_str());
+}
+
+TEST(StreamingLoaderTest, TrainStreamRejectsOtherHashing) {
+    std::string path = write_file("stream_mismatch.txt",
+                                  "__label__pos good movie\n");
+
+    int dim = 8;
+    EmbeddingTable embedding(1000, dim, 42);
+    EmbeddingTable bigger(2000, dim, 42);
+    NGramGenerator ngram(3, 6);
+    NGramGenerator shorter(2, 4);
+    WordEncoder word_encoder(embedding, ngram, nullptr, 1000, 0.2f);
+    MeanSentenceEncoder encoder(word_encoder);
+    LinearClassifier classifier(dim, 2, 42);
+    EnglishTokenizer tokenizer;
+    SimpleTrainer trainer(tokenizer, encoder, classifier, dim, 2);
+
+    WordEncoder more_buckets(bigger, ngram, nullptr, 2000, 0.2f);
+    StreamingLoader wide(path, more_buckets, {"pos"});
+    EXPECT_THROW(trainer.train_stream(wide, 0.1f), std::invalid_argument);
+
+    WordEncoder other_ngrams(embedding, shorter, nullptr, 1000, 0.2f);
+    StreamingLoader ngrams(path, other_ngrams, {"pos"});
+    EXPECT_THROW(trainer.train_stream(ngrams, 0.1f), std::invalid_argument);
+
+    StreamingLoader same(path, word_encoder, {"pos"});
+    EXPECT_NO_THROW(trainer.train_stream(same, 0.1f));
+
+    std::remove(path.c_str());
+}
+
+TEST(StreamingLoaderTest, ReaderFailureReachesMultiThreadedTrainer) {
+    // pread on a directory fails with EISDIR once a reader gets to it
+    std::string dir = ::testing::TempDir() + "stream_dir";
+    ::mkdir(dir.c_str(), 0700);
+    std::string inner = write_file("stream_dir/inner.txt", "x\n");
+
+    struct stat st;
+    ASSERT_EQ(::stat(dir.c_str(), &st), 0);
+    if (st.st_size == 0) {
+        std::remove(inner.c_str());
+        ::rmdir(dir.c_str());
+        GTEST_SKIP() << "directory reports no size on this file system";
+    }
+
+    int dim = 8;
+    EmbeddingTable embedding(1000, dim, 42);
+    NGramGenerator ngram(3, 6);
+    WordEncoder word_encoder(embedding, ngram, nullptr, 1000, 0.2f);
+    MeanSentenceEncoder encoder(word_encoder);
+    LinearClassifier classifier(dim, 2, 42);
+    EnglishTokenizer tokenizer;
+
+    for (int threads : {1, 2}) {
+        SimpleTrainer trainer(tokenizer, encoder, classifier, dim, 2);
+        trainer.set_num_threads(threads);
+
+        StreamingLoader loader(dir, word_encoder, {"pos"});
+        EXPECT_THROW(trainer.train_stream(loader, 0.1f), std::runtime_error)
+            << threads << " threads";
+    }
+
+    std::remove(inner.c_str());
+    ::rmdir(dir.c_str());
+}
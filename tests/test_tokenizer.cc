@@ -1,5 +1,32 @@
 #include <gtest/gtest.h>
 #include "tokenizer/english_tokenizer.h"
+#include "tokenizer/simd_tokenizer.h"
+#include "simd/kernels.h"
+#include "utils/rng.h"
+#include "embedding/embedding_table.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "encoder/word_encoder.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts global heap allocations so the zero-copy path can be checked.
+namespace {
+std::atomic<long> g_allocations{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
 
 TEST(TokenizerTest, BasicTokenization) {
     EnglishTokenizer tokenizer;
@@ -42,3 +69,132 @@ TEST(TokenizerTest, MultipleSpaces) {
     EXPECT_EQ(tokens[0], "hello");
     EXPECT_EQ(tokens[1], "world");
 }
+
+TEST(TokenizerTest, TokenBufferMatchesVectorOverload) {
+    EnglishTokenizer tokenizer;
+    TokenBuffer buffer;
+
+    const char* texts[] = {
+        "Hello, world!", "", "   ", "a", "Internationalization IS long",
+        "I have 123 apples", "caf\xc3\xa9 na\xc3\xafve", "end."
+    };
+
+    for (const char* text : texts) {
+        std::vector<std::string> expected;
+        tokenizer.tokenize(text, expected);
+
+        tokenizer.tokenize(std::string_view(text), buffer);
+
+        ASSERT_EQ(buffer.size(), expected.size()) << text;
+        for (size_t i = 0; i < expected.size(); ++i)
+            EXPECT_EQ(buffer[i], expected[i]);
+    }
+}
+
+TEST(TokenizerTest, DefaultTokenBufferOverload) {
+    // Tokenizers that only implement the vector overload still work
+    struct SplitOnSpace : ITokenizer {
+        using ITokenizer::tokenize;
+        void tokenize(const std::string& text,
+                      std::vector<std::string>& tokens) const override {
+            tokens.clear();
+            size_t start = 0;
+            while (start < text.size()) {
+                size_t end = text.find(' ', start);
+                if (end == std::string::npos)
+                    end = text.size();
+                if (end > start)
+                    tokens.push_back(text.substr(start, end - start));
+                start = end + 1;
+            }
+        }
+    };
+
+    SplitOnSpace tokenizer;
+    TokenBuffer buffer;
+    const ITokenizer& base = tokenizer;
+    base.tokenize(std::string_view("Keep  Case"), buffer);
+
+    ASSERT_EQ(buffer.size(), 2u);
+    EXPECT_EQ(buffer[0], "Keep");
+    EXPECT_EQ(buffer[1], "Case");
+}
+
+TEST(TokenizerTest, SteadyStateEncodingDoesNotAllocate) {
+    int dim = 16, buckets = 1000;
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder words(embedding, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder encoder(words);
+    EnglishTokenizer tokenizer;
+
+    TokenBuffer buffer;
+    std::vector<float> out(dim);
+    std::string text = "Internationalization of the supercalifragilistic "
+                       "tokenizer, quickly!";
+
+    // Warm up the scratch buffers
+    for (int i = 0; i < 2; ++i) {
+        tokenizer.tokenize(text, buffer);
+        encoder.encode(buffer, out.data());
+    }
+
+    long before = g_allocations.load();
+    for (int i = 0; i < 10; ++i) {
+        tokenizer.tokenize(text, buffer);
+        encoder.encode(buffer, out.data());
+    }
+    EXPECT_EQ(g_allocations.load() - before, 0);
+
+    // Same vector as the std::string path
+    std::vector<float> expected(dim);
+    encoder.encode(tokenizer.tokenize(text), expected.data());
+    for (int j = 0; j < dim; ++j)
+        EXPECT_EQ(out[j], expected[j]);
+}
+
+TEST(TokenizerTest, SimdTokenizerMatchesEnglishTokenizer) {
+    EnglishTokenizer reference;
+    SimdTokenizer tokenizer;
+    RNG rng(7);
+
+    // Mostly ASCII with some UTF-8 and control bytes; lengths cross the
+    // 32 / 64-byte block edges and tokens span blocks.
+    const char alphabet[] = "abcXYZ019 .,!?-_@[`{\t\n";
+    std::vector<std::string> texts = {
+        "", " ", "A", "Hello, World! 42",
+        std::string(63, 'Q') + "!" + std::string(70, 'z'),
+        "caf\xc3\xa9 na\xc3\xafve \xff\x80 plain ascii afterwards"
+    };
+    for (int t = 0; t < 300; ++t) {
+        int len = static_cast<int>(rng.uniform(0.0f, 300.0f));
+        std::string text;
+        for (int i = 0; i < len; ++i) {
+            float r = rng.uniform(0.0f, 1.0f);
+            if (r < 0.02f)
+                text += static_cast<char>(0x80 + static_cast<int>(rng.uniform(0.0f, 127.0f)));
+            else
+                text += alphabet[static_cast<int>(rng.uniform(0.0f, sizeof(alphabet) - 1.01f))];
+        }
+        texts.push_back(text);
+    }
+
+    SimdLevel saved = simd_level();
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        simd_set_level(level);
+        TokenBuffer buffer;
+        for (const auto& text : texts) {
+            std::vector<std::string> expected;
+            reference.tokenize(text, expected);
+
+            tokenizer.tokenize(std::string_view(text), buffer);
+            ASSERT_EQ(buffer.size(), expected.size()) << text;
+            for (size_t i = 0; i < expected.size(); ++i)
+                ASSERT_EQ(buffer[i], expected[i]) << text;
+
+            EXPECT_EQ(tokenizer.tokenize(text), expected);
+        }
+    }
+    simd_set_level(saved);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "classifier/hierarchical_softmax.h"
+#include "classifier/linear_classifier.h"
+#include "classifier/lowrank_classifier.h"
+#include "classifier/topk.h"
+#include "loss/softmax.h"
+#include "utils/rng.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+std::vector<float> random_vector(size_t n, uint64_t seed, float scale = 1.0f)
+{
+    RNG rng(seed);
+    std::vector<float> v(n);
+    for (auto& x : v)
+        x = rng.uniform(-scale, scale);
+    return v;
+}
+
+// Full softmax, then sort: the reference the fused paths replace
+std::vector<Prediction> reference_topk(std::vector<float> logits, int k)
+{
+    int n = static_cast<int>(logits.size());
+    softmax(logits.data(), n);
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return logits[a] > logits[b];
+    });
+
+    std::vector<Prediction> out(k);
+    for (int j = 0; j < k; ++j)
+        out[j] = {order[j], logits[order[j]]};
+    return out;
+}
+
+}  // namespace
+
+TEST(TopKTest, SelectMatchesSoftmaxThenSort) {
+    for (int n : {1, 7, 100, 1000}) {
+        auto logits = random_vector(n, n, 5.0f);
+
+        for (int k : {1, 3, 5}) {
+            if (k > n) continue;
+
+            std::vector<Prediction> got(k);
+            select_topk(logits.data(), n, k, got.data());
+            auto expected = reference_topk(logits, k);
+
+            for (int j = 0; j < k; ++j) {
+                EXPECT_EQ(got[j].label, expected[j].label) << n << " " << k;
+                EXPECT_NEAR(got[j].probability, expected[j].probability,
+                            1e-6f);
+            }
+        }
+
+        EXPECT_EQ(argmax(logits.data(), n), reference_topk(logits, 1)[0].label);
+    }
+}
+
+TEST(TopKTest, TiesPreferLowerLabelAndLargeLogitsStayFinite) {
+    std::vector<float> logits = {1000.0f, 3000.0f, 2000.0f, 3000.0f, 3000.0f};
+
+    std::vector<Prediction> top(3);
+    select_topk(logits.data(), 5, 3, top.data());
+
+    EXPECT_EQ(top[0].label, 1);
+    EXPECT_EQ(top[1].label, 3);
+    EXPECT_EQ(top[2].label, 4);
+    for (const auto& p : top)
+        EXPECT_NEAR(p.probability, 1.0f / 3.0f, 1e-6f);
+
+    // k == 1 takes the argmax path with the same tie rule
+    Prediction best;
+    select_topk(logits.data(), 5, 1, &best);
+    EXPECT_EQ(best.label, 1);
+    EXPECT_NEAR(best.probability, 1.0f / 3.0f, 1e-6f);
+
+    EXPECT_EQ(argmax(logits.data(), 5), 1);
+}
+
+TEST(TopKTest, FusedLinearPathMatchesForward) {
+    int dim = 32, classes = 300;
+    LinearClassifier clf(dim, classes, 42);
+    auto bias = random_vector(classes, 1, 3.0f);
+    clf.load_parameters(clf.weights(), bias.data());
+
+    std::vector<float> logits(classes);
+    std::vector<Prediction> fused(5), reference(5);
+
+    for (uint64_t seed = 0; seed < 10; ++seed) {
+        auto x = random_vector(dim, 10 + seed, 2.0f);
+
+        clf.forward(x.data(), logits.data());
+        select_topk(logits.data(), classes, 5, reference.data());
+        clf.predict_topk(x.data(), 5, fused.data());
+
+        for (int j = 0; j < 5; ++j) {
+            EXPECT_EQ(fused[j].label, reference[j].label);
+            EXPECT_NEAR(fused[j].probability, reference[j].probability, 1e-6f);
+        }
+
+        EXPECT_EQ(clf.predict_label(x.data()), reference[0].label);
+    }
+
+    EXPECT_THROW(clf.predict_topk(logits.data(), 0, fused.data()),
+                 std::invalid_argument);
+    EXPECT_THROW(clf.predict_topk(logits.data(), classes + 1, fused.data()),
+                 std::invalid_argument);
+}
+
+TEST(TopKTest, DefaultAndTreePathsAgreeWithForward) {
+    int dim = 16, classes = 40;
+    LowRankClassifier lowrank(dim, classes, 4, 42);
+
+    std::vector<int64_t> counts(classes);
+    for (int c = 0; c < classes; ++c)
+        counts[c] = 1 + c % 7;
+    HierarchicalSoftmax hs(dim, counts);
+    auto w = random_vector(static_cast<size_t>(hs.num_nodes()) * dim, 2);
+    hs.load_parameters(w.data());
+
+    std::vector<float> logits(classes);
+    std::vector<Prediction> got(3), expected(3);
+
+    for (const IClassifier* head :
+         {static_cast<const IClassifier*>(&lowrank),
+          static_cast<const IClassifier*>(&hs)}) {
+        auto x = random_vector(dim, 3, 2.0f);
+
+        head->forward(x.data(), logits.data());
+        select_topk(logits.data(), classes, 3, expected.data());
+        head->predict_topk(x.data(), 3, got.data());
+
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_EQ(got[j].label, expected[j].label);
+            EXPECT_NEAR(got[j].probability, expected[j].probability, 1e-5f);
+        }
+
+        EXPECT_EQ(head->predict_label(x.data()), expected[0].label);
+    }
+}
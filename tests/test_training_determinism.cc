@@ -7,6 +7,8 @@
 #include "encoder/word_encoder.h"
 #include "ngram/ngram_generator.h"
 #include "phonetic/phonetic_encoder.h"
+#include "simd/kernels.h"
+#include <cstring>
 
 
 TEST(TrainingTest, DeterministicTraining) {
@@ -61,4 +63,51 @@ TEST(TrainingTest, DeterministicTraining) {
 
     for (int i = 0; i < 2; ++i)
         EXPECT_FLOAT_EQ(logits1[i], logits2[i]);
-}
\ No newline at end of file
+}
+
+TEST(TrainingTest, DeterministicAcrossSimdLevels) {
+
+    int dim = 48;
+    int buckets = 5000;
+
+    SimdLevel saved_level = simd_level();
+    bool saved_deterministic = simd_deterministic();
+    simd_set_deterministic(true);
+
+    std::vector<Sample> data = {
+        {"hello world", 0},
+        {"good day", 1},
+        {"another sample sentence", 0}
+    };
+
+    auto run = [&](SimdLevel level, std::vector<float>& logits) {
+        simd_set_level(level);
+
+        EmbeddingTable embedding(buckets, dim, 7);
+        NGramGenerator ngram(3, 6);
+        PhoneticEncoder phonetic;
+        WordEncoder word_encoder(
+            embedding, ngram, &phonetic, buckets, 0.2f);
+        MeanSentenceEncoder encoder(word_encoder);
+        LinearClassifier clf(dim, 2, 7);
+        EnglishTokenizer tokenizer;
+        SimpleTrainer trainer(tokenizer, encoder, clf, dim, 2);
+
+        for (int epoch = 0; epoch < 5; ++epoch)
+            trainer.train_epoch(data, 0.05f);
+
+        std::vector<float> sentence(dim);
+        encoder.encode(tokenizer.tokenize("hello day"), sentence.data());
+        clf.forward(sentence.data(), logits.data());
+    };
+
+    std::vector<float> reference(2), logits(2);
+    run(SimdLevel::SCALAR, reference);
+    run(simd_detect_level(), logits);
+
+    simd_set_level(saved_level);
+    simd_set_deterministic(saved_deterministic);
+
+    EXPECT_EQ(std::memcmp(reference.data(), logits.data(),
+                          2 * sizeof(float)), 0);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "training/simple_trainer.h"
+#include "config/model_config.h"
 #include "classifier/linear_classifier.h"
 #include "encoder/mean_sentence_encoder.h"
 #include "tokenizer/english_tokenizer.h"
@@ -8,6 +9,22 @@
 #include "ngram/ngram_generator.h"
 #include "phonetic/phonetic_encoder.h"
 #include "loss/softmax.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Dense head whose per-sample step always fails
+struct FailingClassifier : LinearClassifier {
+    using LinearClassifier::LinearClassifier;
+
+    float train_sample(const float*, int, float*, float, float*) override
+    {
+        throw std::runtime_error("train_sample failed");
+    }
+};
+
+}  // namespace
 
 TEST(TrainingTest, OverfitTinyDataset) {
 
@@ -74,4 +91,208 @@ TEST(TrainingTest, OverfitTinyDataset) {
     }
 
     EXPECT_EQ(correct, data.size());
-}
\ No newline at end of file
+}
+
+TEST(TrainingTest, OverfitTinyDatasetMiniBatch) {
+
+    ModelConfig config;
+    config.embedding_dim = 32;
+    config.bucket_count = 10000;
+    config.batch_size = 4;
+
+    int dim = config.embedding_dim;
+    int buckets = config.bucket_count;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+
+    WordEncoder word_encoder(
+        embedding, ngram, &phonetic, buckets, 0.2f);
+
+    MeanSentenceEncoder sentence_encoder(word_encoder);
+
+    LinearClassifier classifier(dim, 2, 42);
+
+    EnglishTokenizer tokenizer;
+
+    SimpleTrainer trainer(
+        tokenizer, sentence_encoder, classifier, config, 2);
+
+    EXPECT_EQ(trainer.batch_size(), 4);
+    EXPECT_THROW(trainer.set_batch_size(0), std::invalid_argument);
+
+    std::vector<Sample> data = {
+        {"good movie", 1},
+        {"bad movie", 0},
+        {"good good", 1},
+        {"bad bad", 0},
+        {"good film", 1}
+    };
+
+    float first = trainer.train_epoch(data, 0.5f);
+    float last = first;
+    for (int epoch = 0; epoch < 400; ++epoch)
+        last = trainer.train_epoch(data, 0.5f);
+
+    EXPECT_LT(last, first);
+
+    int correct = 0;
+
+    std::vector<float> sentence(dim);
+    std::vector<float> logits(2);
+
+    for (auto& s : data) {
+        sentence_encoder.encode(tokenizer.tokenize(s.text),
+                                sentence.data());
+        classifier.forward(sentence.data(), logits.data());
+
+        int pred = logits[0] > logits[1] ? 0 : 1;
+        if (pred == s.label)
+            correct++;
+    }
+
+    EXPECT_EQ(correct, data.size());
+}
+
+
+TEST(TrainingTest, HogwildWorkerErrorsReachTheCaller) {
+    int dim = 16;
+    int buckets = 1000;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    WordEncoder word_encoder(embedding, ngram, nullptr, buckets, 0.2f);
+    MeanSentenceEncoder sentence_encoder(word_encoder);
+    FailingClassifier classifier(dim, 2, 42);
+    EnglishTokenizer tokenizer;
+
+    SimpleTrainer trainer(tokenizer, sentence_encoder, classifier, dim, 2);
+
+    std::vector<Sample> data(8, {"good movie", 1});
+
+    // Serial and Hogwild epochs fail the same way
+    EXPECT_THROW(trainer.train_epoch(data, 0.1f), std::runtime_error);
+    trainer.set_num_threads(4);
+    EXPECT_THROW(trainer.train_epoch(data, 0.1f), std::runtime_error);
+}
+
+TEST(TrainingTest, HogwildTrainingConverges) {
+
+    int dim = 32;
+    int buckets = 10000;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+
+    WordEncoder word_encoder(
+        embedding, ngram, &phonetic, buckets, 0.2f);
+
+    MeanSentenceEncoder sentence_encoder(word_encoder);
+
+    LinearClassifier classifier(dim, 2, 42);
+
+    EnglishTokenizer tokenizer;
+
+    SimpleTrainer trainer(
+        tokenizer, sentence_encoder, classifier, dim, 2);
+
+    trainer.set_num_threads(4);
+    EXPECT_THROW(trainer.set_num_threads(0), std::invalid_argument);
+
+    std::vector<Sample> data;
+    for (int i = 0; i < 16; ++i) {
+        data.push_back({"good movie", 1});
+        data.push_back({"bad movie", 0});
+    }
+
+    float first = trainer.train_epoch(data, 0.1f);
+    float last = first;
+    for (int epoch = 0; epoch < 50; ++epoch)
+        last = trainer.train_epoch(data, 0.1f);
+
+    EXPECT_LT(last, first);
+
+    std::vector<float> sentence(dim);
+    std::vector<float> logits(2);
+
+    sentence_encoder.encode(tokenizer.tokenize("good movie"),
+                            sentence.data());
+    classifier.forward(sentence.data(), logits.data());
+    EXPECT_GT(logits[1], logits[0]);
+
+    sentence_encoder.encode(tokenizer.tokenize("bad movie"),
+                            sentence.data());
+    classifier.forward(sentence.data(), logits.data());
+    EXPECT_GT(logits[0], logits[1]);
+}
+
+
+TEST(TrainingTest, EmbeddingTrainingUpdatesEmbeddings) {
+
+    int dim = 32;
+    int buckets = 10000;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    EmbeddingTable other(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+
+    WordEncoder word_encoder(
+        embedding, ngram, &phonetic, buckets, 0.2f);
+
+    MeanSentenceEncoder sentence_encoder(word_encoder);
+
+    LinearClassifier classifier(dim, 2, 42);
+    LinearClassifier head_only_classifier(dim, 2, 42);
+
+    EnglishTokenizer tokenizer;
+
+    SimpleTrainer trainer(
+        tokenizer, sentence_encoder, classifier, dim, 2);
+
+    EXPECT_THROW(trainer.enable_embedding_training(other),
+                 std::invalid_argument);
+    trainer.enable_embedding_training(embedding);
+
+    std::vector<Sample> data = {
+        {"good movie", 1},
+        {"bad movie", 0},
+        {"good good", 1},
+        {"bad bad", 0}
+    };
+
+    // Baseline: same setup, linear head only
+    EmbeddingTable frozen(buckets, dim, 42);
+    WordEncoder frozen_word_encoder(
+        frozen, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder frozen_encoder(frozen_word_encoder);
+    SimpleTrainer head_only(
+        tokenizer, frozen_encoder, head_only_classifier, dim, 2);
+
+    float loss = 0.0f, head_only_loss = 0.0f;
+    for (int epoch = 0; epoch < 50; ++epoch) {
+        loss = trainer.train_epoch(data, 0.1f);
+        head_only_loss = head_only.train_epoch(data, 0.1f);
+    }
+
+    EXPECT_LT(loss, head_only_loss);
+
+    // A bucket no sample touched keeps its initial values
+    std::vector<int> touched;
+    for (const auto& s : data)
+        for (const auto& t : tokenizer.tokenize(s.text)) {
+            int p = word_encoder.compute_buckets(t, touched);
+            if (p >= 0)
+                touched.push_back(p);
+        }
+
+    int untouched = 0;
+    while (std::find(touched.begin(), touched.end(), untouched) !=
+           touched.end())
+        ++untouched;
+
+    for (int j = 0; j < dim; ++j)
+        EXPECT_EQ(embedding.row(untouched)[j], other.row(untouched)[j]);
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "encoder/vocab_index.h"
+#include "encoder/word_encoder.h"
+#include "embedding/embedding_table.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "tokenizer/english_tokenizer.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class VocabIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        embedding = std::make_unique<EmbeddingTable>(buckets, dim, 42);
+        encoder = std::make_unique<WordEncoder>(
+            *embedding, ngram, &phonetic, buckets, 0.2f);
+        path = ::testing::TempDir() + "vocab_index_test.bin";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void expect_matches_encoder(const VocabIndex& index,
+                                const std::vector<std::string>& vocabulary) {
+        ASSERT_EQ(index.size(), static_cast<int>(vocabulary.size()));
+        for (const auto& token : vocabulary) {
+            int id = index.find(token);
+            ASSERT_GE(id, 0) << token;
+            EXPECT_EQ(index.token(id), token);
+
+            std::vector<int> expected;
+            int phonetic_bucket = encoder->compute_buckets(token, expected);
+
+            ASSERT_EQ(index.bucket_count(id), static_cast<int>(expected.size()));
+            for (size_t i = 0; i < expected.size(); ++i)
+                EXPECT_EQ(index.buckets(id)[i], expected[i]);
+            EXPECT_EQ(index.phonetic_bucket(id), phonetic_bucket);
+        }
+    }
+
+    int dim = 16;
+    int buckets = 5000;
+    NGramGenerator ngram{3, 6};
+    PhoneticEncoder phonetic;
+    std::unique_ptr<EmbeddingTable> embedding;
+    std::unique_ptr<WordEncoder> encoder;
+    std::string path;
+};
+
+TEST_F(VocabIndexTest, StoresEncoderBuckets) {
+    std::vector<std::string> vocabulary = {
+        "hello", "world", "a", "", "encoder", "hello", "xylophone"};
+    VocabIndex index(*encoder, vocabulary);
+
+    EXPECT_EQ(index.size(), 6);  // duplicate dropped
+    expect_matches_encoder(index, {"hello", "world", "a", "", "encoder",
+                                   "xylophone"});
+
+    EXPECT_EQ(index.find("unknown"), -1);
+    EXPECT_EQ(index.find("hell"), -1);
+}
+
+TEST_F(VocabIndexTest, EncoderOutputUnchanged) {
+    std::vector<std::string> vocabulary = {"the", "quick", "brown", "fox"};
+    VocabIndex index(*encoder, vocabulary);
+
+    WordEncoder indexed(*embedding, ngram, &phonetic, buckets, 0.2f);
+    indexed.set_vocab_index(&index);
+
+    for (const std::string token : {"the", "quick", "fox", "jumps"}) {
+        std::vector<float> a(dim), b(dim);
+        encoder->encode(token, a.data());
+        indexed.encode(token, b.data());
+        EXPECT_EQ(std::memcmp(a.data(), b.data(), dim * sizeof(float)), 0);
+
+        std::vector<BucketWeight> wa, wb;
+        encoder->accumulate_bucket_weights(token, 0.5f, wa);
+        indexed.accumulate_bucket_weights(token, 0.5f, wb);
+        ASSERT_EQ(wa.size(), wb.size());
+        for (size_t i = 0; i < wa.size(); ++i) {
+            EXPECT_EQ(wa[i].bucket, wb[i].bucket);
+            EXPECT_EQ(wa[i].weight, wb[i].weight);
+        }
+    }
+}
+
+TEST_F(VocabIndexTest, RejectsOtherEncoderSettings) {
+    VocabIndex index(*encoder, {"token"});
+
+    NGramGenerator other_ngram(2, 4);
+    WordEncoder other(*embedding, other_ngram, &phonetic, buckets, 0.2f);
+    EXPECT_THROW(other.set_vocab_index(&index), std::invalid_argument);
+
+    WordEncoder no_phonetic(*embedding, ngram, nullptr, buckets, 0.2f);
+    EXPECT_THROW(no_phonetic.set_vocab_index(&index), std::invalid_argument);
+
+    EXPECT_NO_THROW(encoder->set_vocab_index(&index));
+}
+
+TEST_F(VocabIndexTest, CollectFromCorpus) {
+    EnglishTokenizer tokenizer;
+    std::vector<std::string> texts = {
+        "the cat sat", "the dog sat", "The bird flew", "a cat"};
+
+    auto all = VocabIndex::collect(tokenizer, texts);
+    ASSERT_FALSE(all.empty());
+    EXPECT_EQ(all[0], "the");
+
+    auto frequent = VocabIndex::collect(tokenizer, texts, 2);
+    EXPECT_EQ(frequent, (std::vector<std::string>{"the", "cat", "sat"}));
+
+    auto top = VocabIndex::collect(tokenizer, texts, 1, 2);
+    EXPECT_EQ(top.size(), 2u);
+}
+
+TEST_F(VocabIndexTest, SaveAndMapRoundTrip) {
+    std::vector<std::string> vocabulary;
+    for (int i = 0; i < 500; ++i)
+        vocabulary.push_back("tok" + std::to_string(i));
+
+    VocabIndex built(*encoder, vocabulary);
+    EXPECT_FALSE(built.is_mapped());
+    built.save(path);
+
+    VocabIndex mapped(path, false, true);
+    EXPECT_TRUE(mapped.is_mapped());
+    EXPECT_EQ(mapped.memory_bytes(), built.memory_bytes());
+    EXPECT_EQ(mapped.fingerprint(), built.fingerprint());
+    expect_matches_encoder(mapped, vocabulary);
+
+    EXPECT_NO_THROW(encoder->set_vocab_index(&mapped));
+}
+
+TEST_F(VocabIndexTest, MapRejectsCorruptFiles) {
+    VocabIndex built(*encoder, {"alpha", "beta", "gamma"});
+    built.save(path);
+
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg(0, std::ios::end);
+        f.seekp(static_cast<std::streamoff>(f.tellg()) - 70);
+        f.put('\x55');
+    }
+
+    EXPECT_THROW(VocabIndex(path, false, true), std::runtime_error);
+
+    // Without checksum verification, out-of-range array contents are still
+    // caught at open: a bucket id past bucket_count and a token offset past
+    // token_bytes.
+    built.save(path);
+    VocabFileHeader header;
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    uint64_t slots_end = 64 + ((uint64_t(header.table_slots) * sizeof(VocabSlot)
+                                + 63) & ~uint64_t{63});
+    uint64_t chars = slots_end + (((header.token_count + 1) * 8 + 63) &
+                                  ~uint64_t{63});
+    uint64_t bucket_offsets = chars + ((header.token_bytes + 63) & ~uint64_t{63});
+    uint64_t bucket_ids = bucket_offsets +
+        (((header.token_count + 1) * 4 + 63) & ~uint64_t{63});
+
+    auto patch = [&](uint64_t offset, auto value) {
+        built.save(path);
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(static_cast<std::streamoff>(offset));
+        f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    patch(bucket_ids, static_cast<int32_t>(buckets));
+    EXPECT_THROW(VocabIndex(path, false, false), std::runtime_error);
+
+    patch(slots_end + 8, uint64_t{1} << 40);
+    EXPECT_THROW(VocabIndex(path, false, false), std::runtime_error);
+
+    patch(bucket_offsets + 4, uint32_t{1} << 30);
+    EXPECT_THROW(VocabIndex(path, false, false), std::runtime_error);
+
+    built.save(path);
+    EXPECT_NO_THROW(VocabIndex(path, false, false));
+
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f << "definitely not a vocabulary index file but long enough.........";
+    }
+    EXPECT_THROW(VocabIndex(path, false, false), std::runtime_error);
+}
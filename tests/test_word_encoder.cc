@@ -3,6 +3,7 @@
 #include "embedding/embedding_table.h"
 #include "ngram/ngram_generator.h"
 #include "phonetic/phonetic_encoder.h"
+#include "hashing/hash_function.h"
 #include <cmath>
 
 TEST(WordEncoderTest, BasicEncoding) {
@@ -172,3 +173,89 @@ TEST(WordEncoderTest, DimensionAccessor) {
     
     EXPECT_EQ(encoder.dim(), dim);
 }
+
+TEST(WordEncoderTest, DefaultBucketsMatchFnv1aModulo) {
+    int dim = 8;
+    int buckets = 200003;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+    WordEncoder encoder(embedding, ngram, &phonetic, buckets, 0.2f);
+
+    for (const char* word : {"a", "hello", "internationalization", "robert"}) {
+        std::string wrapped;
+        std::vector<std::string_view> ngrams;
+        ngram.generate(word, wrapped, ngrams);
+
+        std::vector<int> expected;
+        for (auto g : ngrams)
+            expected.push_back(static_cast<int>(HashFunction::fnv1a(g) % buckets));
+
+        std::vector<int> actual;
+        int phonetic_bucket = encoder.compute_buckets(word, actual);
+
+        EXPECT_EQ(actual, expected) << word;
+        EXPECT_EQ(phonetic_bucket, static_cast<int>(
+            HashFunction::fnv1a(phonetic.encode(word)) % buckets));
+    }
+}
+
+TEST(WordEncoderTest, HashAndReductionPolicies) {
+    int dim = 8;
+    int buckets = 1 << 14;
+
+    EmbeddingTable embedding(buckets, dim, 42);
+    NGramGenerator ngram(3, 6);
+    PhoneticEncoder phonetic;
+
+    std::string wrapped;
+    std::vector<std::string_view> ngrams;
+    ngram.generate("policy", wrapped, ngrams);
+
+    uint64_t (*hashes[])(std::string_view) = {
+        [](std::string_view s) { return HashFunction::fnv1a(s); },
+        [](std::string_view s) { return HashFunction::murmur3(s); },
+        [](std::string_view s) { return HashFunction::wyhash(s); },
+    };
+    uint64_t (*reductions[])(uint64_t, uint64_t) = {
+        [](uint64_t h, uint64_t n) { return h % n; },
+        [](uint64_t h, uint64_t n) {
+            return static_cast<uint64_t>((static_cast<__uint128_t>(h) * n) >> 64);
+        },
+        [](uint64_t h, uint64_t n) { return h & (n - 1); },
+    };
+
+    std::vector<std::vector<int>> seen;
+    for (int hp = 0; hp < 3; ++hp) {
+        for (int rp = 0; rp < 3; ++rp) {
+            WordEncoder encoder(embedding, ngram, &phonetic, buckets, 0.2f,
+                                static_cast<HashPolicy>(hp),
+                                static_cast<BucketReduction>(rp));
+            EXPECT_EQ(encoder.hash_policy(), static_cast<HashPolicy>(hp));
+
+            std::vector<int> expected;
+            for (auto g : ngrams)
+                expected.push_back(static_cast<int>(
+                    reductions[rp](hashes[hp](g), buckets)));
+
+            std::vector<int> actual;
+            encoder.compute_buckets("policy", actual);
+            EXPECT_EQ(actual, expected) << hp << "/" << rp;
+
+            std::vector<float> out(dim);
+            encoder.encode("policy", out.data());
+            seen.push_back(actual);
+        }
+    }
+
+    // Hashes differ; with a power-of-two count MODULO and POW2_MASK agree
+    EXPECT_NE(seen[0], seen[3]);
+    EXPECT_NE(seen[0], seen[6]);
+    EXPECT_NE(seen[0], seen[1]);
+    EXPECT_EQ(seen[0], seen[2]);
+
+    EXPECT_THROW(WordEncoder(embedding, ngram, &phonetic, 1000, 0.2f,
+                             HashPolicy::FNV1A, BucketReduction::POW2_MASK),
+                 std::invalid_argument);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include "encoder/word_vector_cache.h"
+#include "encoder/word_encoder.h"
+#include "encoder/mean_sentence_encoder.h"
+#include "embedding/embedding_table.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+class WordVectorCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        embedding = std::make_unique<EmbeddingTable>(buckets, dim, 42);
+        encoder = std::make_unique<WordEncoder>(
+            *embedding, ngram, &phonetic, buckets, 0.2f);
+    }
+
+    std::vector<float> uncached(const std::string& token) {
+        WordEncoder plain(*embedding, ngram, &phonetic, buckets, 0.2f);
+        std::vector<float> v(dim);
+        plain.encode(token, v.data());
+        return v;
+    }
+
+    int dim = 32;
+    int buckets = 5000;
+    NGramGenerator ngram{3, 6};
+    PhoneticEncoder phonetic;
+    std::unique_ptr<EmbeddingTable> embedding;
+    std::unique_ptr<WordEncoder> encoder;
+};
+
+TEST_F(WordVectorCacheTest, HitsReturnTheEncodedVector) {
+    WordVectorCache cache(dim, 1 << 20, 4);
+    encoder->set_cache(&cache);
+
+    std::vector<float> first(dim), second(dim);
+    encoder->encode("hello", first.data());
+    encoder->encode("hello", second.data());
+
+    WordCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.5);
+
+    auto expected = uncached("hello");
+    EXPECT_EQ(std::memcmp(first.data(), expected.data(), dim * sizeof(float)), 0);
+    EXPECT_EQ(std::memcmp(second.data(), expected.data(), dim * sizeof(float)), 0);
+
+    cache.reset_stats();
+    EXPECT_EQ(cache.stats().hits, 0u);
+}
+
+TEST_F(WordVectorCacheTest, BudgetBoundsEntries) {
+    size_t budget = 64 * WordVectorCache::entry_bytes(dim);
+    WordVectorCache cache(dim, budget, 4);
+    encoder->set_cache(&cache);
+
+    EXPECT_EQ(cache.capacity(), 64u);
+
+    std::vector<float> out(dim);
+    for (int i = 0; i < 1000; ++i)
+        encoder->encode("word" + std::to_string(i), out.data());
+
+    WordCacheStats stats = cache.stats();
+    EXPECT_LE(stats.entries, 64u);
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_EQ(stats.misses, 1000u);
+
+    // Evicted or not, every answer is still correct
+    for (int i = 0; i < 1000; i += 97) {
+        std::string w = "word" + std::to_string(i);
+        encoder->encode(w, out.data());
+        auto expected = uncached(w);
+        EXPECT_EQ(std::memcmp(out.data(), expected.data(),
+                              dim * sizeof(float)), 0);
+    }
+
+    EXPECT_THROW(WordVectorCache(dim, 10, 4), std::invalid_argument);
+}
+
+TEST_F(WordVectorCacheTest, ClockKeepsReferencedEntries) {
+    WordVectorCache cache(dim, 8 * WordVectorCache::entry_bytes(dim), 1);
+    encoder->set_cache(&cache);
+
+    std::vector<float> out(dim);
+    encoder->encode("hot", out.data());
+
+    for (int i = 0; i < 100; ++i) {
+        encoder->encode("hot", out.data());          // sets the reference bit
+        encoder->encode("cold" + std::to_string(i), out.data());
+    }
+
+    // "hot" missed once and hit on every later access
+    EXPECT_EQ(cache.stats().hits, 100u);
+}
+
+TEST_F(WordVectorCacheTest, EmbeddingUpdatesInvalidate) {
+    WordVectorCache cache(dim, 1 << 20);
+    encoder->set_cache(&cache);
+    MeanSentenceEncoder sentence(*encoder);
+
+    std::vector<std::string> tokens = {"cache", "me"};
+    std::vector<float> before(dim), after(dim), dout(dim, 1.0f);
+
+    sentence.encode(tokens, before.data());
+    uint64_t version = embedding->version();
+
+    sentence.backward(tokens, dout.data(), 0.5f, *embedding);
+    EXPECT_GT(embedding->version(), version);
+
+    sentence.encode(tokens, after.data());
+    EXPECT_EQ(cache.stats().hits, 0u);
+
+    WordEncoder plain(*embedding, ngram, &phonetic, buckets, 0.2f);
+    MeanSentenceEncoder reference(plain);
+    std::vector<float> expected(dim);
+    reference.encode(tokens, expected.data());
+
+    EXPECT_EQ(std::memcmp(after.data(), expected.data(), dim * sizeof(float)), 0);
+    EXPECT_NE(std::memcmp(after.data(), before.data(), dim * sizeof(float)), 0);
+}
+
+TEST_F(WordVectorCacheTest, KeysSeparateTablesAndSettings) {
+    WordVectorCache cache(dim, 1 << 20);
+    encoder->set_cache(&cache);
+
+    // Same token, different table / phonetic weight: never served the
+    // other encoder's vector
+    EmbeddingTable other_table(buckets, dim, 7);
+    WordEncoder other(other_table, ngram, &phonetic, buckets, 0.2f);
+    other.set_cache(&cache);
+    WordEncoder heavier(*embedding, ngram, &phonetic, buckets, 0.9f);
+    heavier.set_cache(&cache);
+
+    std::vector<float> a(dim), b(dim), c(dim);
+    encoder->encode("shared", a.data());
+    other.encode("shared", b.data());
+    heavier.encode("shared", c.data());
+    EXPECT_EQ(cache.stats().hits, 0u);
+
+    WordEncoder plain_other(other_table, ngram, &phonetic, buckets, 0.2f);
+    std::vector<float> expected(dim);
+    plain_other.encode("shared", expected.data());
+    EXPECT_EQ(std::memcmp(b.data(), expected.data(), dim * sizeof(float)), 0);
+    EXPECT_NE(std::memcmp(a.data(), b.data(), dim * sizeof(float)), 0);
+    EXPECT_NE(std::memcmp(a.data(), c.data(), dim * sizeof(float)), 0);
+
+    // An identically configured encoder shares the entry
+    WordEncoder twin(*embedding, ngram, &phonetic, buckets, 0.2f);
+    twin.set_cache(&cache);
+    twin.encode("shared", b.data());
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST_F(WordVectorCacheTest, TrainableTablesBypassTheCache) {
+    WordVectorCache cache(dim, 1 << 20);
+    encoder->set_cache(&cache);
+    embedding->set_trainable(true);
+
+    std::vector<float> out(dim);
+    encoder->encode("train", out.data());
+    encoder->encode("train", out.data());
+
+    WordCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 0u);
+    EXPECT_EQ(stats.entries, 0u);
+
+    embedding->set_trainable(false);
+    encoder->encode("train", out.data());
+    encoder->encode("train", out.data());
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST_F(WordVectorCacheTest, RejectsDimMismatch) {
+    WordVectorCache cache(dim + 1, 1 << 20);
+    EXPECT_THROW(encoder->set_cache(&cache), std::invalid_argument);
+}
+
+TEST_F(WordVectorCacheTest, ConcurrentEncodersShareTheCache) {
+    WordVectorCache cache(dim, 200 * WordVectorCache::entry_bytes(dim), 8);
+
+    std::vector<std::vector<float>> expected;
+    for (int i = 0; i < 300; ++i)
+        expected.push_back(uncached("tok" + std::to_string(i)));
+
+    std::vector<int> errors(4, 0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            WordEncoder local(*embedding, ngram, &phonetic, buckets, 0.2f);
+            local.set_cache(&cache);
+            std::vector<float> out(dim);
+            for (int r = 0; r < 2000; ++r) {
+                int i = (r * 7 + t * 13) % 300;
+                local.encode("tok" + std::to_string(i), out.data());
+                if (std::memcmp(out.data(), expected[i].data(),
+                                dim * sizeof(float)) != 0)
+                    ++errors[t];
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    for (int e : errors)
+        EXPECT_EQ(e, 0);
+
+    WordCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 8000u);
+    EXPECT_LE(stats.entries, stats.capacity);
+}
@@ -0,0 +1,123 @@
+// Micro-batching classification server for a saved model file.
+//
+//   gladtotext_serve --model PATH [--socket PATH] [--max-batch N]
+//                    [--max-wait-us N] [--workers N]
+//
+// Reads one text per line and answers "<label>\t<probability>" per line,
+// in order. Without --socket it serves stdin -> stdout until end of input;
+// with --socket it listens on a Unix domain socket until SIGINT / SIGTERM.
+// Latency percentiles and QPS are printed to stderr on exit.
+
+#include "classifier/linear_classifier.h"
+#include "embedding/embedding_table.h"
+#include "encoder/word_encoder.h"
+#include "io/model_file.h"
+#include "ngram/ngram_generator.h"
+#include "phonetic/phonetic_encoder.h"
+#include "serving/batch_server.h"
+#include "serving/line_server.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void on_signal(int) { g_stop.store(true); }
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: gladtotext_serve --model PATH [--socket PATH] "
+        "[--max-batch N] [--max-wait-us N] [--workers N]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::string model_path;
+    std::string socket_path;
+    ServeOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!value) {
+            usage();
+            return 2;
+        }
+
+        if (std::strcmp(arg, "--model") == 0)
+            model_path = value;
+        else if (std::strcmp(arg, "--socket") == 0)
+            socket_path = value;
+        else if (std::strcmp(arg, "--max-batch") == 0)
+            options.max_batch = std::atoi(value);
+        else if (std::strcmp(arg, "--max-wait-us") == 0)
+            options.max_wait_us = std::atoi(value);
+        else if (std::strcmp(arg, "--workers") == 0)
+            options.workers = std::atoi(value);
+        else {
+            usage();
+            return 2;
+        }
+        ++i;
+    }
+
+    if (model_path.empty()) {
+        usage();
+        return 2;
+    }
+
+    try {
+        Model model = ModelFile::load(model_path);
+        const ModelConfig& config = model.config;
+
+        // Batched serving encodes with mean pooling only
+        if (model.has_attention_encoder())
+            throw std::runtime_error(
+                "models with an attention encoder cannot be served yet");
+
+        NGramGenerator ngram(config.ngram_min, config.ngram_max);
+        PhoneticEncoder phonetic;
+        WordEncoder word_encoder(*model.embedding, ngram,
+                                 config.use_phonetic ? &phonetic : nullptr,
+                                 config.bucket_count, config.phonetic_gamma,
+                                 config.hash_policy, config.bucket_reduction);
+
+        BatchServer server(word_encoder, *model.classifier, options);
+
+        // A client closing early must not kill the server
+        std::signal(SIGPIPE, SIG_IGN);
+
+        if (socket_path.empty()) {
+            serve_fd(server, 0, 1);
+        } else {
+            std::signal(SIGINT, on_signal);
+            std::signal(SIGTERM, on_signal);
+            std::fprintf(stderr, "listening on %s (max batch %d, "
+                         "max wait %d us, %d workers)\n",
+                         socket_path.c_str(), server.options().max_batch,
+                         server.options().max_wait_us,
+                         server.options().workers);
+            serve_unix_socket(server, socket_path, g_stop);
+        }
+
+        std::fprintf(stderr, "%s\n", server.stats().summary().c_str());
+
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "gladtotext_serve: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}